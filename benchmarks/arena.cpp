@@ -0,0 +1,117 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <docpp/docpp.hpp>
+#include "counters.hpp"
+
+namespace {
+    // 5000 products of 10 nodes each
+    constexpr std::size_t product_count{5000};
+
+    // kept out of the loop, so that only allocations made by the object model are counted
+    const std::string item_class{"product-listing-item"};
+    const std::string details_class{"product-listing-details"};
+    const std::string price_class{"product-listing-price"};
+    const std::string stock_class{"product-listing-stock"};
+    const std::string thumbnail{"/images/products/thumbnail.png"};
+    const std::string description{"A short description of the product that is shown in the listing."};
+
+    void build_listing(docpp::HTML::Document& document, const std::vector<std::string>& names, const docpp::allocator_type& allocator) {
+        using namespace docpp::HTML;
+
+        Section& html{document.get_section()};
+        html.set_tag(Tag::Html);
+
+        Section body{Tag::Body, {}, allocator};
+
+        for (const std::string& name : names) {
+            Section product{Tag::Div, Properties{Property{"class", item_class, allocator}, allocator}, allocator};
+            Section details{Tag::Div, Properties{Property{"class", details_class, allocator}, allocator}, allocator};
+
+            product.push_back(Element{Tag::Img, Properties{Property{"src", thumbnail, allocator}, allocator}, {}, allocator});
+            product.push_back(Element{Tag::H2, {}, name, allocator});
+            details.push_back(Element{Tag::P, {}, description, allocator});
+            details.push_back(Element{Tag::Span, Properties{Property{"class", price_class, allocator}, allocator}, "$19.99", allocator});
+            details.push_back(Element{Tag::Span, Properties{Property{"class", stock_class, allocator}, allocator}, "In stock", allocator});
+            product.push_back(std::move(details));
+            product.push_back(Element{Tag::Anchor, Properties{Property{"href", "/products/view", allocator}, allocator}, "View product", allocator});
+            product.push_back(Element{Tag::Button, {}, "Add to cart", allocator});
+
+            body.push_back(std::move(product));
+        }
+
+        html.push_back(std::move(body));
+    }
+
+    std::vector<std::string> make_names() {
+        std::vector<std::string> names{};
+        names.reserve(product_count);
+
+        for (std::size_t i{0}; i < product_count; ++i) {
+            names.push_back("Product listing item number " + std::to_string(i));
+        }
+
+        return names;
+    }
+
+    void BM_build_heap(benchmark::State& state) {
+        const std::vector<std::string> names{make_names()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Document document{};
+            build_listing(document, names, {});
+            benchmark::DoNotOptimize(document);
+        }
+
+        counter.report(state);
+    }
+
+    void BM_build_arena(benchmark::State& state) {
+        const std::vector<std::string> names{make_names()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::Arena arena{};
+            docpp::HTML::Document document{arena};
+            build_listing(document, names, arena);
+            benchmark::DoNotOptimize(document);
+        }
+
+        counter.report(state);
+    }
+
+    void BM_render_heap(benchmark::State& state) {
+        const std::vector<std::string> names{make_names()};
+        docpp::HTML::Document document{};
+        build_listing(document, names, {});
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(document.get());
+        }
+    }
+
+    void BM_render_arena(benchmark::State& state) {
+        const std::vector<std::string> names{make_names()};
+        docpp::Arena arena{};
+        docpp::HTML::Document document{arena};
+        build_listing(document, names, arena);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(document.get());
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_build_heap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_build_arena)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_render_heap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_render_arena)->Unit(benchmark::kMillisecond);
\ No newline at end of file
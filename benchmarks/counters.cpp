@@ -0,0 +1,53 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <cstdlib>
+#include <new>
+#include "counters.hpp"
+
+std::atomic<std::size_t> bench::allocations{0};
+std::atomic<std::size_t> bench::allocated_bytes{0};
+
+void* operator new(std::size_t size) {
+    ++bench::allocations;
+    bench::allocated_bytes += size;
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// std::pmr::new_delete_resource() allocates with the aligned overloads
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++bench::allocations;
+    bench::allocated_bytes += size;
+
+    const std::size_t align{static_cast<std::size_t>(alignment)};
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
\ No newline at end of file
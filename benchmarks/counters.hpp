@@ -0,0 +1,44 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Helpers shared by the benchmarks. The global operator new is replaced in counters.cpp to count every heap allocation.
+ */
+namespace bench {
+    /**
+     * @brief Number of heap allocations made by the process so far
+     */
+    extern std::atomic<std::size_t> allocations;
+    /**
+     * @brief Number of bytes allocated from the heap by the process so far
+     */
+    extern std::atomic<std::size_t> allocated_bytes;
+
+    /**
+     * @brief Measures the heap allocations made while a benchmark runs, and reports them per iteration.
+     * Construct it right before the benchmark loop, and call report() right after it.
+     */
+    class AllocationCounter {
+        private:
+            std::size_t allocations_before{allocations};
+            std::size_t bytes_before{allocated_bytes};
+        public:
+            /**
+             * @brief Report allocations/op and bytes/op as counters of a benchmark
+             * @param state The state of the benchmark
+             */
+            void report(benchmark::State& state) const {
+                state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocations - this->allocations_before), benchmark::Counter::kAvgIterations);
+                state.counters["bytes/op"] = benchmark::Counter(static_cast<double>(allocated_bytes - this->bytes_before), benchmark::Counter::kAvgIterations);
+            }
+    };
+} // namespace bench
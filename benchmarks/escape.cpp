@@ -0,0 +1,87 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <string>
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include <docpp/docpp.hpp>
+
+namespace {
+    constexpr std::size_t text_size{1 << 20};
+
+    // mostly clean text, with a character to escape every 'interval' characters
+    std::string make_text(const std::size_t interval) {
+        std::string text{};
+        text.reserve(text_size);
+
+        for (std::size_t i{0}; text.size() < text_size; ++i) {
+            text += i % interval == 0 ? '&' : static_cast<char>('a' + i % 26);
+        }
+
+        return text;
+    }
+
+    // character by character, as a baseline for the vectorized scan
+    std::string escape_scalar(const std::string_view str) {
+        std::string ret{};
+        ret.reserve(str.size());
+
+        for (const char c : str) {
+            switch (c) {
+                case '&': ret += "&amp;"; break;
+                case '<': ret += "&lt;"; break;
+                case '>': ret += "&gt;"; break;
+                case '"': ret += "&quot;"; break;
+                case '\'': ret += "&#39;"; break;
+                default: ret += c; break;
+            }
+        }
+
+        return ret;
+    }
+
+    void BM_escape_scalar(benchmark::State& state) {
+        const std::string text{make_text(static_cast<std::size_t>(state.range(0)))};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(escape_scalar(text));
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+    }
+
+    void BM_escape(benchmark::State& state) {
+        const std::string text{make_text(static_cast<std::size_t>(state.range(0)))};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(docpp::escape(text));
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+    }
+
+    void BM_render_escaped(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        Section body{Tag::Body};
+
+        for (std::size_t i{0}; i < 5000; ++i) {
+            body.push_back(Element{Tag::P, make_properties(Property{"class", "comment"}), "User comment number " + std::to_string(i) + ", which says that 1 < 2 & 3 > 2."});
+        }
+
+        Document document{Section{Tag::Html, {}, std::vector<Section>{std::move(body)}}};
+        document.set_escaping(state.range(0) != 0);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(document.get());
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_escape_scalar)->Arg(1 << 30)->Arg(64)->Arg(8)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_escape)->Arg(1 << 30)->Arg(64)->Arg(8)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_render_escaped)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,238 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <array>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <docpp/docpp.hpp>
+#include "counters.hpp"
+
+namespace {
+    const std::array<std::string, 8> tag_names{"div", "span", "blockquote", "a", "img", "table", "h1", "xmp"};
+
+    void BM_resolve_tag_name(benchmark::State& state) {
+        const bench::AllocationCounter counter{};
+        std::size_t i{0};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(docpp::HTML::resolve_tag(tag_names[i++ % tag_names.size()]));
+        }
+
+        counter.report(state);
+    }
+
+    void BM_resolve_tag(benchmark::State& state) {
+        const bench::AllocationCounter counter{};
+        int i{0};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(docpp::HTML::resolve_tag(static_cast<docpp::HTML::Tag>(i++ % static_cast<int>(docpp::HTML::impl_tag_table.size()))));
+        }
+
+        counter.report(state);
+    }
+
+    void BM_get_tag_name(benchmark::State& state) {
+        const bench::AllocationCounter counter{};
+        int i{0};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(docpp::HTML::get_tag_name(static_cast<docpp::HTML::Tag>(i++ % static_cast<int>(docpp::HTML::impl_tag_table.size()))));
+        }
+
+        counter.report(state);
+    }
+
+    void BM_properties_push_back(benchmark::State& state) {
+        const docpp::HTML::Property property{"class", "product-listing-item"};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Properties properties{};
+
+            for (std::int64_t i{0}; i < state.range(0); ++i) {
+                properties.push_back(property);
+            }
+
+            benchmark::DoNotOptimize(properties);
+        }
+
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_properties_push_front(benchmark::State& state) {
+        const docpp::HTML::Property property{"class", "product-listing-item"};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Properties properties{};
+
+            for (std::int64_t i{0}; i < state.range(0); ++i) {
+                properties.push_front(property);
+            }
+
+            benchmark::DoNotOptimize(properties);
+        }
+
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // post-processing: looking up the attributes of an anchor, the last of them missing
+    void BM_properties_get(benchmark::State& state) {
+        const docpp::HTML::Properties properties{docpp::HTML::Property{"class", "nav-link"}, docpp::HTML::Property{"href", "/products/item"},
+            docpp::HTML::Property{"id", "link-1"}};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(properties.get("id"));
+            benchmark::DoNotOptimize(properties.get("href"));
+            benchmark::DoNotOptimize(properties.get("title"));
+        }
+
+        counter.report(state);
+    }
+
+    void BM_section_push_back(benchmark::State& state) {
+        const docpp::HTML::Element element{docpp::HTML::Tag::P, {}, "A paragraph of text"};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Section section{docpp::HTML::Tag::Div};
+
+            for (std::int64_t i{0}; i < state.range(0); ++i) {
+                section.push_back(element);
+            }
+
+            benchmark::DoNotOptimize(section);
+        }
+
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // building a list newest first, as navigation and feeds are: every item is prepended, and every eighth is a nested list
+    void BM_section_push_front(benchmark::State& state) {
+        const docpp::HTML::Element element{docpp::HTML::Tag::Li, {}, "A list item"};
+        const docpp::HTML::Section nested{"ul", {}, std::vector<docpp::HTML::Element>{element, element}};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Section section{"ul"};
+
+            for (std::int64_t i{0}; i < state.range(0); ++i) {
+                if (i % 8 == 0) {
+                    section.push_front(nested);
+                } else {
+                    section.push_front(element);
+                }
+            }
+
+            benchmark::DoNotOptimize(section);
+        }
+
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // building a list in sorted order from unsorted input: every item is inserted between others, and every eighth is a nested list
+    void BM_section_insert_before(benchmark::State& state) {
+        const docpp::HTML::Element element{docpp::HTML::Tag::Li, {}, "A list item"};
+        const docpp::HTML::Section nested{"ul", {}, std::vector<docpp::HTML::Element>{element, element}};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Section section{"ul"};
+
+            for (std::int64_t i{0}; i < state.range(0); ++i) {
+                const docpp::size_type index{static_cast<docpp::size_type>(i * 7919 % (i + 1))};
+
+                if (i % 8 == 0) {
+                    section.insert_before(index, nested);
+                } else {
+                    section.insert_before(index, element);
+                }
+            }
+
+            benchmark::DoNotOptimize(section);
+        }
+
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_element_get(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        const Element element{Tag::Anchor, make_properties(Property{"href", "/products/view"}, Property{"class", "button"}), "View product"};
+        const Formatting formatting{static_cast<Formatting>(state.range(0))};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(element.get(formatting, 2));
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * element.rendered_size(formatting, 2)));
+    }
+
+    void BM_css_element_get(benchmark::State& state) {
+        using namespace docpp::CSS;
+
+        const Element element{".product-listing-item", {Property{"display", "flex"}, Property{"color", "#333333"}, Property{"margin", "0 auto"}}};
+        const Formatting formatting{static_cast<Formatting>(state.range(0))};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(element.get(formatting, 1));
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * element.rendered_size(formatting, 1)));
+    }
+
+    void BM_color_formatter(benchmark::State& state) {
+        using namespace docpp::CSS;
+
+        const ColorFormatter formatter{from_rgba(18, 52, 86, 255)};
+        const ColorFormatting formatting{static_cast<ColorFormatting>(state.range(0))};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(formatter.get(formatting));
+        }
+
+        counter.report(state);
+    }
+
+    void BM_color_from_hex(benchmark::State& state) {
+        const std::string hex{"#123456FF"};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(docpp::CSS::from_hex(hex));
+        }
+
+        counter.report(state);
+    }
+} // namespace
+
+BENCHMARK(BM_resolve_tag_name);
+BENCHMARK(BM_resolve_tag);
+BENCHMARK(BM_get_tag_name);
+BENCHMARK(BM_properties_push_back)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(BM_properties_push_front)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(BM_properties_get);
+
+BENCHMARK(BM_section_push_back)->Arg(16)->Arg(1024);
+BENCHMARK(BM_section_push_front)->Arg(16)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_section_insert_before)->Arg(16)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_element_get)->DenseRange(0, 2)->ArgName("formatting");
+BENCHMARK(BM_css_element_get)->DenseRange(0, 2)->ArgName("formatting");
+BENCHMARK(BM_color_formatter)->DenseRange(1, 4)->ArgName("formatting");
+BENCHMARK(BM_color_from_hex);
\ No newline at end of file
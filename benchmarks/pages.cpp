@@ -0,0 +1,402 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <docpp/docpp.hpp>
+#include "counters.hpp"
+
+namespace {
+    // a page of cards of 10 nodes each: a section holding a heading, an image, a paragraph, a list of three items and two links
+    docpp::HTML::Document make_page(const std::size_t node_count) {
+        using namespace docpp::HTML;
+
+        Section main{Tag::Main, make_properties(Property{"id", "content"})};
+
+        for (std::size_t i{0}; i < node_count / 10; ++i) {
+            Section card{Tag::Article, make_properties(Property{"class", "card"}, Property{"data-index", std::to_string(i)})};
+            Section list{"ul", make_properties(Property{"class", "card-tags"})};
+
+            card.push_back(Element{Tag::H2, make_properties(Property{"class", "card-title"}), "Card number " + std::to_string(i)});
+            card.push_back(Element{Tag::Img, make_properties(Property{"src", "/images/card.png"}, Property{"alt", "Card image"})});
+            card.push_back(Element{Tag::P, {}, "Some text describing the card, long enough to be representative of real content."});
+            list.push_back(Element{Tag::Li, {}, "First"});
+            list.push_back(Element{Tag::Li, {}, "Second"});
+            list.push_back(Element{Tag::Li, {}, "Third"});
+            card.push_back(std::move(list));
+            card.push_back(Element{Tag::Anchor, make_properties(Property{"href", "/cards/view"}), "View"});
+            card.push_back(Element{Tag::Anchor, make_properties(Property{"href", "/cards/edit"}), "Edit"});
+
+            main.push_back(std::move(card));
+        }
+
+        Section html{Tag::Html};
+        html.push_back(Section{Tag::Head, {}, {Element{Tag::Title, {}, "Benchmark page"}}});
+        html.push_back(Section{Tag::Body, {}, std::vector<Section>{std::move(main)}});
+
+        return Document{std::move(html)};
+    }
+
+    docpp::CSS::Stylesheet make_stylesheet(const std::size_t rule_count) {
+        using namespace docpp::CSS;
+
+        Stylesheet stylesheet{};
+
+        for (std::size_t i{0}; i < rule_count; ++i) {
+            const std::string n{std::to_string(i)};
+
+            stylesheet.push_back(Element{".component-" + n + " > .item:hover", {
+                Property{"display", "flex"},
+                Property{"color", "#" + std::string(6, static_cast<char>('0' + i % 10))},
+                Property{"margin", std::to_string(i % 16) + "px auto"},
+                Property{"font-family", "\"Inter\", sans-serif"},
+            }});
+        }
+
+        return stylesheet;
+    }
+
+    void BM_page_build(benchmark::State& state) {
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(make_page(static_cast<std::size_t>(state.range(0))));
+        }
+
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_page_get(benchmark::State& state) {
+        const docpp::HTML::Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        const docpp::HTML::Formatting formatting{static_cast<docpp::HTML::Formatting>(state.range(1))};
+        const docpp::size_type size{document.rendered_size(formatting)};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(document.get(formatting));
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+        state.counters["size"] = static_cast<double>(size);
+    }
+
+    void BM_page_get_parallel(benchmark::State& state) {
+        const docpp::HTML::Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        const docpp::HTML::Section& section{document.section_ref()};
+        const docpp::HTML::Formatting formatting{docpp::HTML::Formatting::Pretty};
+        const docpp::size_type size{section.rendered_size(formatting)};
+        docpp::ThreadPool pool{static_cast<docpp::size_type>(state.range(1))};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(section.get_parallel(formatting, pool));
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+    // a site of pages sharing the same navigation header and footer, which are frozen if the second argument is 1
+    void BM_site_get(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        Section header{Tag::Header, make_properties(Property{"class", "site-header"})};
+        Section nav{Tag::Nav};
+        for (int i{0}; i < 50; ++i) {
+            nav.push_back(Element{Tag::Anchor, make_properties(Property{"href", "/section/" + std::to_string(i)}, Property{"class", "nav-link"}), "Section " + std::to_string(i)});
+        }
+        header.push_back(std::move(nav));
+
+        Section footer{Tag::Footer, make_properties(Property{"class", "site-footer"})};
+        for (int i{0}; i < 20; ++i) {
+            footer.push_back(Element{Tag::P, {}, "Footer line " + std::to_string(i) + " with some legal text in it."});
+        }
+
+        if (state.range(1) != 0) {
+            header.freeze();
+            footer.freeze();
+        }
+
+        std::vector<Section> pages{};
+        for (std::int64_t i{0}; i < state.range(0); ++i) {
+            Section page{Tag::Body};
+            page.push_back(header);
+            page.push_back(Element{Tag::P, {}, "Page " + std::to_string(i)});
+            page.push_back(footer);
+            pages.push_back(std::move(page));
+        }
+
+        docpp::size_type size{0};
+        for (const Section& it : pages) {
+            size += it.rendered_size(Formatting::Pretty);
+        }
+
+        for (auto _ : state) {
+            for (const Section& it : pages) {
+                benchmark::DoNotOptimize(it.get(Formatting::Pretty));
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+    void BM_page_write(benchmark::State& state) {
+        const docpp::HTML::Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        const docpp::HTML::Formatting formatting{static_cast<docpp::HTML::Formatting>(state.range(1))};
+        const docpp::size_type size{document.rendered_size(formatting)};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::CallbackSink sink{[](const std::string_view chunk) { benchmark::DoNotOptimize(chunk.data()); }};
+            document.write(sink, formatting);
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+#ifdef DOCPP_WITH_ZLIB
+    // compressing a page for sending: compressing the output of get() against compressing while writing, which never holds
+    // the whole page, uncompressed or compressed
+    void BM_page_deflate(benchmark::State& state) {
+        const docpp::HTML::Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        const bool streaming{state.range(1) != 0};
+        const docpp::size_type size{document.rendered_size()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::CallbackSink sink{[](const std::string_view chunk) { benchmark::DoNotOptimize(chunk.data()); }};
+
+            if (streaming) {
+                docpp::DeflateSink deflate_sink{sink};
+                document.write(deflate_sink);
+            } else {
+                const docpp::DeflatedChunk chunk{docpp::deflate_chunk(document.get())};
+                sink.write(chunk.data);
+            }
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+#endif
+
+    void BM_stylesheet_get(benchmark::State& state) {
+        const docpp::CSS::Stylesheet stylesheet{make_stylesheet(static_cast<std::size_t>(state.range(0)))};
+        const docpp::CSS::Formatting formatting{static_cast<docpp::CSS::Formatting>(state.range(1))};
+        const docpp::size_type size{stylesheet.rendered_size(formatting)};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(stylesheet.get(formatting));
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+    // optimizing a stylesheet before writing it minified; the counters compare the output with and without optimize()
+    void BM_stylesheet_optimize(benchmark::State& state) {
+        const docpp::CSS::Stylesheet stylesheet{make_stylesheet(static_cast<std::size_t>(state.range(0)))};
+        docpp::size_type size{0};
+
+        for (auto _ : state) {
+            docpp::CSS::Stylesheet copy{stylesheet};
+            copy.optimize();
+            size = copy.rendered_size(docpp::CSS::Formatting::Minified);
+            benchmark::DoNotOptimize(size);
+        }
+
+        state.counters["size"] = static_cast<double>(size);
+        state.counters["unoptimized"] = static_cast<double>(stylesheet.rendered_size(docpp::CSS::Formatting::Minified));
+    }
+    // deduplicating fragments: every lookup is a find() over the children of a section, or the elements of a stylesheet
+    void BM_section_find(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        Section fragments{Tag::Div};
+        for (std::int64_t i{0}; i < state.range(0); ++i) {
+            fragments.push_back(Section{Tag::Article, make_properties(Property{"class", "card"}), {
+                Element{Tag::H2, {}, "Card number " + std::to_string(i)},
+                Element{Tag::P, {}, "Some text describing the card, long enough to be representative of real content."},
+            }});
+        }
+
+        const Section last{fragments.at_section(fragments.size() - 1)};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(fragments.find(last));
+        }
+
+        counter.report(state);
+    }
+
+    void BM_stylesheet_find(benchmark::State& state) {
+        const docpp::CSS::Stylesheet stylesheet{make_stylesheet(static_cast<std::size_t>(state.range(0)))};
+        const docpp::CSS::Element last{stylesheet.back()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(stylesheet.find(last));
+        }
+
+        counter.report(state);
+    }
+    // a long-lived page that is rendered after changing the title of a few cards, incrementally if the second argument is 1
+    void BM_page_get_incremental(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        document.set_incremental(state.range(1) != 0);
+
+        Section& main{document.get_section().at_section(1).at_section(0)};
+        const std::size_t card_count{main.size()};
+        const docpp::size_type size{document.rendered_size()};
+        std::size_t n{0};
+
+        benchmark::DoNotOptimize(document.get());
+
+        for (auto _ : state) {
+            // less than 1% of the nodes change between renders
+            for (std::size_t i{0}; i < card_count / 1000 + 1; ++i, ++n) {
+                main.at_section((n * 7919) % card_count).at(0).set_data("Card updated " + std::to_string(n));
+            }
+
+            benchmark::DoNotOptimize(document.get());
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+    // the same, written to a sink that does not keep the output, so that what is measured is the update and not the allocation of the page
+    void BM_page_write_incremental(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        document.set_incremental(state.range(1) != 0);
+
+        Section& main{document.get_section().at_section(1).at_section(0)};
+        const std::size_t card_count{main.size()};
+        const docpp::size_type size{document.rendered_size()};
+        std::size_t n{0};
+
+        for (auto _ : state) {
+            for (std::size_t i{0}; i < card_count / 1000 + 1; ++i, ++n) {
+                main.at_section((n * 7919) % card_count).at(0).set_data("Card updated " + std::to_string(n));
+            }
+
+            docpp::CallbackSink sink{[](const std::string_view chunk) { benchmark::DoNotOptimize(chunk.data()); }};
+            document.write(sink);
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+    // the patch between two versions of a page that differ in the title of a few cards
+    void BM_section_diff(benchmark::State& state) {
+        const docpp::HTML::Document old_document{make_page(static_cast<std::size_t>(state.range(0)))};
+        docpp::HTML::Document new_document{old_document};
+        docpp::HTML::Section& main{new_document.get_section().at_section(1).at_section(0)};
+
+        for (std::size_t i{0}; i < main.size(); i += 1000) {
+            main.at_section(i).at(0).set_data("Card updated " + std::to_string(i));
+        }
+
+        const docpp::HTML::Section& old_section{old_document.section_ref()};
+        const docpp::HTML::Section& new_section{new_document.section_ref()};
+        static_cast<void>(old_section.hash());
+        static_cast<void>(new_section.hash());
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(docpp::HTML::diff(old_section, new_section));
+        }
+    }
+
+    // the title of every card of a page, found by walking the tree, or through the index of its classes, which is built once
+    void BM_section_query(benchmark::State& state) {
+        const docpp::HTML::Document document{make_page(static_cast<std::size_t>(state.range(0)))};
+        const docpp::HTML::Section& section{document.section_ref()};
+        const docpp::HTML::Selector selector{"article.card > h2.card-title"};
+        const docpp::HTML::QueryIndex index{section};
+
+        for (auto _ : state) {
+            if (state.range(1) != 0) {
+                benchmark::DoNotOptimize(selector.query_all(index));
+            } else {
+                benchmark::DoNotOptimize(selector.query_all(section));
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * state.range(0)));
+    }
+
+    // a page of mostly static cards, with the title of every card filled in per request, either by building and rendering
+    // the page or by writing a template of it
+    void BM_template_get(benchmark::State& state) {
+        using namespace docpp::HTML;
+
+        const std::size_t card_count{static_cast<std::size_t>(state.range(0)) / 10};
+        const auto make = [card_count](const std::vector<std::string>* titles) {
+            Section main{Tag::Main, make_properties(Property{"id", "content"})};
+
+            for (std::size_t i{0}; i < card_count; ++i) {
+                const std::string n{std::to_string(i)};
+                Section card{Tag::Article, make_properties(Property{"class", "card"})};
+                Section title{Tag::H2};
+                title.push_back(titles ? Element{"", {}, (*titles)[i], Type::Text_No_Formatting} : make_slot("title-" + n));
+                card.push_back(std::move(title));
+                card.push_back(Element{Tag::Img, make_properties(Property{"src", "/images/card.png"}, Property{"alt", "Card image"})});
+                card.push_back(Element{Tag::P, {}, "Some text describing the card, long enough to be representative of real content."});
+                card.push_back(Section{"ul", make_properties(Property{"class", "card-tags"}), {Element{Tag::Li, {}, "First"}, Element{Tag::Li, {}, "Second"}}});
+                card.push_back(Element{Tag::Anchor, make_properties(Property{"href", "/cards/view"}), "View"});
+                main.push_back(std::move(card));
+            }
+
+            return Document{Section{Tag::Html, {}, std::vector<Section>{std::move(main)}}};
+        };
+
+        std::vector<std::string> titles{};
+        for (std::size_t i{0}; i < card_count; ++i) {
+            titles.push_back("Card number " + std::to_string(i));
+        }
+
+        const Template t{make(nullptr)};
+        const std::vector<std::string_view> values{titles.begin(), titles.end()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            if (state.range(1) != 0) {
+                benchmark::DoNotOptimize(t.get(values));
+            } else {
+                benchmark::DoNotOptimize(make(&titles).get());
+            }
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * t.rendered_size(values)));
+    }
+} // namespace
+
+BENCHMARK(BM_page_build)->Arg(1000)->Arg(100000)->Arg(1000000)->ArgName("nodes")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_page_get)->ArgsProduct({{1000, 100000, 1000000}, {0, 1, 2, 3}})->ArgNames({"nodes", "formatting"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_page_get_parallel)->ArgsProduct({{100000, 1000000}, {1, 2, 4, 8}})->ArgNames({"nodes", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_site_get)->ArgsProduct({{1000}, {0, 1}})->ArgNames({"pages", "frozen"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_page_write)->ArgsProduct({{1000, 100000, 1000000}, {0, 1, 2, 3}})->ArgNames({"nodes", "formatting"})->Unit(benchmark::kMillisecond);
+#ifdef DOCPP_WITH_ZLIB
+BENCHMARK(BM_page_deflate)->ArgsProduct({{100000, 1000000}, {0, 1}})->ArgNames({"nodes", "streaming"})->Unit(benchmark::kMillisecond);
+#endif
+BENCHMARK(BM_page_get_incremental)->ArgsProduct({{100000, 1000000}, {0, 1}})->ArgNames({"nodes", "incremental"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_page_write_incremental)->ArgsProduct({{100000, 1000000}, {0, 1}})->ArgNames({"nodes", "incremental"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_section_diff)->Arg(100000)->Arg(1000000)->ArgName("nodes")->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_section_query)->ArgsProduct({{100000, 1000000}, {0, 1}})->ArgNames({"nodes", "indexed"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_template_get)->ArgsProduct({{1000, 100000}, {0, 1}})->ArgNames({"nodes", "template"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_section_find)->Arg(1000)->ArgName("fragments")->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_stylesheet_find)->Arg(1000)->ArgName("rules")->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_stylesheet_get)->ArgsProduct({{1000, 100000}, {0, 1, 2, 3}})->ArgNames({"rules", "formatting"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stylesheet_optimize)->Arg(1000)->Arg(100000)->ArgName("rules")->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <cstdio>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <docpp/docpp.hpp>
+#include "counters.hpp"
+
+namespace {
+    // 5000 products of 10 nodes each, pretty-formatted
+    constexpr std::size_t product_count{5000};
+
+    std::string make_markup() {
+        using namespace docpp::HTML;
+
+        Section body{Tag::Body};
+
+        for (std::size_t i{0}; i < product_count; ++i) {
+            Section product{Tag::Div, make_properties(Property{"class", "product-listing-item"})};
+            Section details{Tag::Div, make_properties(Property{"class", "product-listing-details"})};
+
+            product.push_back(Element{Tag::Img, make_properties(Property{"src", "/images/products/thumbnail.png"}, Property{"alt", "Thumbnail"})});
+            product.push_back(Element{Tag::H2, {}, "Product listing item number " + std::to_string(i)});
+            details.push_back(Element{Tag::P, {}, "A short description of the product that is shown in the listing."});
+            details.push_back(Element{Tag::Span, make_properties(Property{"class", "product-listing-price"}), "$19.99"});
+            details.push_back(Element{Tag::Span, make_properties(Property{"class", "product-listing-stock"}), "In stock"});
+            product.push_back(std::move(details));
+            product.push_back(Element{Tag::Anchor, make_properties(Property{"href", "/products/view"}), "View product"});
+            product.push_back(Element{Tag::Button, {}, "Add to cart"});
+
+            body.push_back(std::move(product));
+        }
+
+        return Document{Section{Tag::Html, {}, std::vector<Section>{std::move(body)}}}.get(Formatting::Pretty);
+    }
+
+    // modelled on a large framework stylesheet: utility classes, vendor prefixes, media queries, font faces and comments
+    constexpr std::size_t css_component_count{2000};
+
+    std::string make_css() {
+        std::string css{"@charset \"UTF-8\";\n/*!\n * Generated stylesheet, used to benchmark the CSS parser.\n */\n"};
+        css += "@import url(\"https://fonts.example.com/css2?family=Inter:wght@400;700&display=swap\");\n";
+
+        for (std::size_t i{0}; i < css_component_count; ++i) {
+            const std::string n{std::to_string(i)};
+
+            css += "/* Component " + n + " */\n";
+            css += ".component-" + n + ", .component-" + n + "::before, .component-" + n + " > .item:not(:last-child) {\n"
+                "  display: -webkit-box;\n  display: -ms-flexbox;\n  display: flex;\n"
+                "  -webkit-box-align: center;\n  align-items: center;\n"
+                "  font-family: \"Inter\", -apple-system, \"Segoe UI\", Roboto, sans-serif;\n"
+                "  background: linear-gradient(180deg, rgba(255, 255, 255, 0.15), rgba(255, 255, 255, 0)) #0d6efd;\n"
+                "  transition: color .15s ease-in-out, background-color .15s ease-in-out, border-color .15s ease-in-out;\n"
+                "  content: \"\\201C\";\n"
+                "}\n";
+            css += ".btn-" + n + ":hover { color: #fff !important; border: 1px solid var(--border-" + n + ", #dee2e6); }\n";
+
+            if (i % 10 == 0) {
+                css += "@media (min-width: 768px) and (max-width: 991.98px) {\n"
+                    "  .col-md-" + n + " { flex: 0 0 auto; width: 33.33333333%; }\n"
+                    "  .offset-md-" + n + " { margin-left: 8.33333333%; }\n"
+                    "}\n";
+            }
+
+            if (i % 100 == 0) {
+                css += "@font-face {\n  font-family: \"Icons-" + n + "\";\n"
+                    "  src: url(data:font/woff2;base64,d09GMgABAAAAAAXsAA0AAAAACrQAAAWWAAEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAP0ZGVE0cGh4GYACC) format(\"woff2\");\n"
+                    "  font-display: swap;\n}\n";
+            }
+        }
+
+        return css;
+    }
+
+    void BM_parse_heap(benchmark::State& state) {
+        const std::string markup{make_markup()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::HTML::Document document{docpp::HTML::parse_document(markup)};
+            benchmark::DoNotOptimize(document);
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * markup.size()));
+    }
+
+    void BM_parse_arena(benchmark::State& state) {
+        const std::string markup{make_markup()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::Arena arena{markup.size() * 2};
+            docpp::HTML::Document document{docpp::HTML::parse_document(markup, arena)};
+            benchmark::DoNotOptimize(document);
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * markup.size()));
+    }
+
+    void BM_parse_file(benchmark::State& state) {
+        const std::string markup{make_markup()};
+        const std::string path{"docpp_bench_parser.html"};
+
+        std::FILE* file{std::fopen(path.c_str(), "wb")};
+        if (file == nullptr) {
+            state.SkipWithError("Failed to create file");
+            return;
+        }
+        std::fwrite(markup.data(), 1, markup.size(), file);
+        std::fclose(file);
+
+        for (auto _ : state) {
+            docpp::Arena arena{markup.size() * 2};
+            docpp::HTML::Document document{docpp::HTML::parse_file(path, arena)};
+            benchmark::DoNotOptimize(document);
+        }
+
+        std::remove(path.c_str());
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * markup.size()));
+    }
+
+    void BM_parse_css(benchmark::State& state) {
+        const std::string css{make_css()};
+        const bench::AllocationCounter counter{};
+
+        for (auto _ : state) {
+            docpp::CSS::Stylesheet stylesheet{docpp::CSS::parse(css)};
+            benchmark::DoNotOptimize(stylesheet);
+        }
+
+        counter.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * css.size()));
+    }
+} // namespace
+
+BENCHMARK(BM_parse_heap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parse_arena)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parse_file)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parse_css)->Unit(benchmark::kMillisecond);
\ No newline at end of file
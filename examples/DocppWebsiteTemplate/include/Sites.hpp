@@ -13,7 +13,7 @@ namespace Sites {
     docpp::HTML::Section get_generic_header(const std::string&, const std::string& = {});
     docpp::HTML::Section get_generic_footer();
     docpp::HTML::Section get_index_site();
-    docpp::HTML::Section create_body_container(const std::vector<docpp::HTML::Element>&);
+    docpp::HTML::Section create_body_container(std::vector<docpp::HTML::Element>);
 }
 
 #endif //SITES_HPP
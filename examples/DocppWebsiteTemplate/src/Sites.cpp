@@ -24,10 +24,12 @@ docpp::HTML::Section Sites::get_generic_footer() {
     }};
 }
 
-docpp::HTML::Section Sites::create_body_container(const std::vector<docpp::HTML::Element>& elements) {
-    return docpp::HTML::Section{docpp::HTML::Tag::Body, {}, std::vector<docpp::HTML::Section> {
-        docpp::HTML::Section{docpp::HTML::Tag::Div, docpp::HTML::make_properties(docpp::HTML::Property{"id", "content"}, docpp::HTML::Property{"class", "content"}), elements}
-    }};
+docpp::HTML::Section Sites::create_body_container(std::vector<docpp::HTML::Element> elements) {
+    docpp::HTML::Section body{docpp::HTML::Tag::Body};
+
+    body.emplace_back<docpp::HTML::Section>(docpp::HTML::Tag::Div, docpp::HTML::make_properties(docpp::HTML::Property{"id", "content"}, docpp::HTML::Property{"class", "content"}), std::move(elements));
+
+    return body;
 }
 
 
@@ -7,6 +7,10 @@ int main() {
         {"index.html", Sites::get_index_site(), PageProperties{"Example.com", "This is a test description", "en"}}
     };
 
+    // the footer is the same on every page, so it is frozen to only render it once
+    docpp::HTML::Section footer{Sites::get_generic_footer()};
+    footer.freeze();
+
     for (const auto& it : website_tree) {
         Endpoint endpoint(std::get<0>(it));
 
@@ -14,7 +18,7 @@ int main() {
 
         root += Sites::get_generic_header(std::get<2>(it).name, std::get<2>(it).description);
         root += std::get<1>(it);
-        root += Sites::get_generic_footer();
+        root += footer;
 
         endpoint.open();
         endpoint.append_string(docpp::HTML::Document(root).get<std::string>(docpp::HTML::Formatting::Pretty));
@@ -12,6 +12,7 @@
 #include <docpp/CSS/property.hpp>
 #include <docpp/CSS/element.hpp>
 #include <docpp/CSS/stylesheet.hpp>
+#include <docpp/CSS/parser.hpp>
 #include <docpp/CSS/color_type_enum.hpp>
 #include <docpp/CSS/color_struct.hpp>
 #include <docpp/CSS/color.hpp>
\ No newline at end of file
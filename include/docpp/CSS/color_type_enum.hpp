@@ -23,6 +23,7 @@ namespace docpp {
           Hex_A,
           Rgb,
           Rgb_A,
+          Hex_Short,
         };
     } // namespace CSS
 } // namespace docpp
@@ -6,9 +6,17 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <docpp/types.hpp>
+#include <docpp/except.hpp>
+#include <docpp/sink.hpp>
+#include <docpp/view.hpp>
 #include <docpp/HTML/tag.hpp>
 #include <docpp/CSS/property.hpp>
 #include <docpp/CSS/formatting_enum.hpp>
@@ -18,10 +26,31 @@
  */
 namespace docpp::CSS {
     /**
-     * @brief A class to represent the properties of a CSS element
+     * @brief A class to represent the properties of a CSS element. An element may also hold nested rules, which is how
+     * at-rules such as @media are represented. An at-rule (a tag starting with '@') without properties and rules
+     * is written as a statement, for example "@import url(style.css);".
      */
     class Element {
             std::pair<string_type, std::vector<Property>> element{};
+            std::vector<Element> rules{};
+            /**
+             * @brief The hash of the element, or 0 if it has not been computed since the element was last modified
+             */
+            mutable std::atomic<std::uint64_t> cached_hash{0};
+            /**
+             * @brief Whether a reference or iterator to a property has been handed out. A write through it cannot reset the cached hash,
+             * so from then on the hash is computed every time it is asked for.
+             */
+            bool exposed{false};
+
+            /**
+             * @brief Mark the element as modified, resetting its cached hash
+             */
+            void impl_modified() { this->cached_hash.store(0, std::memory_order_relaxed); }
+            /**
+             * @brief Mark the element as modified, and a reference to one of its properties as handed out
+             */
+            void impl_exposed() { this->impl_modified(); this->exposed = true; }
         public:
             using iterator = std::vector<Property>::iterator;
             using const_iterator = std::vector<Property>::const_iterator;
@@ -32,12 +61,12 @@ namespace docpp::CSS {
              * @brief Return an iterator to the beginning.
              * @return iterator The iterator to the beginning.
              */
-            iterator begin() { return element.second.begin(); }
+            iterator begin() { this->impl_exposed(); return element.second.begin(); }
             /**
              * @brief Return an iterator to the end.
              * @return iterator The iterator to the end.
              */
-            iterator end() { return element.second.end(); }
+            iterator end() { this->impl_exposed(); return element.second.end(); }
             /**
              * @brief Return a const_iterator to the beginning.
              * @return const_iterator The const_iterator to the beginning.
@@ -62,12 +91,12 @@ namespace docpp::CSS {
              * @brief Return a reverse iterator to the beginning.
              * @return reverse_iterator The reverse iterator to the beginning.
              */
-            reverse_iterator rbegin() { return element.second.rbegin(); }
+            reverse_iterator rbegin() { this->impl_exposed(); return element.second.rbegin(); }
             /**
              * @brief Return a reverse iterator to the end.
              * @return reverse_iterator The reverse iterator to the end.
              */
-            reverse_iterator rend() { return element.second.rend(); }
+            reverse_iterator rend() { this->impl_exposed(); return element.second.rend(); }
             /**
              * @brief Return a const reverse iterator to the beginning.
              * @return const_reverse_iterator The const reverse iterator to the beginning.
@@ -89,12 +118,24 @@ namespace docpp::CSS {
              * @param tag The tag of the element
              * @param properties The properties of the element
              */
-            Element(const string_type& tag, const std::vector<Property>& properties) : element(std::make_pair(tag, properties)) {};
+            Element(string_type tag, std::vector<Property> properties) : element(std::move(tag), std::move(properties)) {};
+            /**
+             * @brief Construct a new Element object
+             * @param tag The tag of the element
+             * @param properties The properties of the element
+             * @param rules The nested rules of the element
+             */
+            Element(string_type tag, std::vector<Property> properties, std::vector<Element> rules) : element(std::move(tag), std::move(properties)), rules(std::move(rules)) {};
             /**
              * @brief Construct a new Element object
              * @param element The element to set
              */
-            Element(const Element& element) = default;
+            Element(const Element& element) : element(element.element), rules(element.rules), cached_hash(element.cached_hash.load(std::memory_order_relaxed)) {};
+            /**
+             * @brief Construct a new Element object
+             * @param element The element to move from
+             */
+            Element(Element&& element) noexcept : element(std::move(element.element)), rules(std::move(element.rules)), cached_hash(element.cached_hash.load(std::memory_order_relaxed)), exposed(element.exposed) {};
             /**
              * @brief Construct a new Element object
              */
@@ -109,17 +150,56 @@ namespace docpp::CSS {
              * @param property The property to push
              */
             void push_front(const Property& property);
+            /**
+             * @brief Prepend a property to the element
+             * @param property The property to push
+             */
+            void push_front(Property&& property);
             /**
              * @brief Append a property to the element
              * @param property The property to push
              */
             void push_back(const Property& property);
+            /**
+             * @brief Append a property to the element
+             * @param property The property to push
+             */
+            void push_back(Property&& property);
+            /**
+             * @brief Construct a property in place, at the end of the element
+             * @param args The arguments to construct the property with, for example a key and a value
+             * @return Property& The appended property
+             */
+            template <typename... Args> Property& emplace_back(Args&&... args) {
+                this->impl_exposed();
+                return this->element.second.emplace_back(std::forward<Args>(args)...);
+            }
             /**
              * @brief Insert a property into the element
              * @param index The index to insert the property
              * @param property The property to insert
              */
             void insert(size_type index, const Property& property);
+            /**
+             * @brief Insert a property into the element
+             * @param index The index to insert the property
+             * @param property The property to insert
+             */
+            void insert(size_type index, Property&& property);
+            /**
+             * @brief Construct a property in place, before an index
+             * @param index The index to insert the property
+             * @param args The arguments to construct the property with, for example a key and a value
+             * @return Property& The inserted property
+             */
+            template <typename... Args> Property& emplace(const size_type index, Args&&... args) {
+                this->impl_exposed();
+                if (index >= this->element.second.size()) {
+                    throw out_of_range("Index out of range");
+                }
+
+                return *this->element.second.emplace(this->element.second.begin() + static_cast<std::ptrdiff_t>(index), std::forward<Args>(args)...);
+            }
             /**
              * @brief Erase a property from the element
              * @param index The index of the property to erase
@@ -191,7 +271,7 @@ namespace docpp::CSS {
              */
             void clear();
             /**
-             * @brief Check if the element is empty
+             * @brief Check if the element is empty, that is, if it has neither properties nor nested rules
              * @return bool True if the element is empty, false otherwise
              */
             [[nodiscard]] bool empty() const;
@@ -200,7 +280,7 @@ namespace docpp::CSS {
              * @param tag The tag of the element
              * @param properties The properties to set
              */
-            void set(const string_type& tag, const std::vector<Property>& properties);
+            void set(string_type tag, std::vector<Property> properties);
             /**
              * @brief Set the properties of the element
              * @param tag The tag of the element
@@ -222,6 +302,53 @@ namespace docpp::CSS {
              * @param properties The properties to set
              */
             void set_properties(const std::vector<Property>& properties);
+            /**
+             * @brief Set the properties of the element
+             * @param properties The properties to set
+             */
+            void set_properties(std::vector<Property>&& properties);
+            /**
+             * @brief Append a nested rule to the element
+             * @param rule The rule to push
+             */
+            void push_back_rule(const Element& rule);
+            /**
+             * @brief Append a nested rule to the element
+             * @param rule The rule to push
+             */
+            void push_back_rule(Element&& rule);
+            /**
+             * @brief Set the nested rules of the element
+             * @param rules The rules to set
+             */
+            void set_rules(std::vector<Element> rules);
+            /**
+             * @brief Get the nested rules of the element
+             * @return std::vector<Element> The nested rules of the element
+             */
+            [[nodiscard]] std::vector<Element> get_rules() const;
+            /**
+             * @brief Optimize the element for size, without changing what it styles. Declarations overridden later in the element
+             * are dropped, along with fallbacks for older browsers. Values are stripped of needless whitespace, colors are shortened
+             * (#ffffff to #fff, rgb(255, 0, 0) to #f00) and zero lengths lose their unit, except in flex. The values of custom properties
+             * (--name) are kept as they are. Nested rules are optimized like the rules of
+             * a stylesheet, see Stylesheet::optimize().
+             */
+            void optimize();
+            /**
+             * @brief Write the element to a sink
+             * @param sink The sink to write to
+             * @param formatting The formatting type to use
+             * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+             */
+            void write(Sink& sink, Formatting formatting = Formatting::None, integer_type tabc = 0) const;
+            /**
+             * @brief Get the exact size of the element in bytes, as written by write() and returned by get(), without generating it
+             * @param formatting The formatting type to use
+             * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+             * @return size_type The size of the element
+             */
+            [[nodiscard]] size_type rendered_size(Formatting formatting = Formatting::None, integer_type tabc = 0) const;
             /**
              * @brief Get the element
              * @return std::pair<string_type, std::vector<Property>> The element
@@ -257,10 +384,34 @@ namespace docpp::CSS {
              * @return std::vector<Property> The properties of the element
              */
             [[nodiscard]] std::vector<Property> get_properties() const;
+            /**
+             * @brief Get a view of the tag of the element, without copying it
+             * @return std::string_view The tag of the element, valid until the element is modified or destroyed
+             */
+            [[nodiscard]] std::string_view tag_view() const { return this->element.first; }
+            /**
+             * @brief Get a view of the properties of the element, without copying them
+             * @return View<const_iterator> The properties of the element, valid until the element is modified or destroyed
+             */
+            [[nodiscard]] View<const_iterator> properties_view() const { return {this->element.second.begin(), this->element.second.end()}; }
+            /**
+             * @brief Get a view of the nested rules of the element, without copying them
+             * @return View<std::vector<Element>::const_iterator> The nested rules of the element, valid until the element is modified or destroyed
+             */
+            [[nodiscard]] View<std::vector<Element>::const_iterator> rules_view() const { return {this->rules.begin(), this->rules.end()}; }
+            /**
+             * @brief Get a hash of the tag, properties and nested rules of the element. The hash is cached until the element is modified,
+             * and is not cached once a non-const iterator or reference to a property has been handed out, since a write through it can
+             * not be seen by the element. Equal elements have equal hashes, so elements with different hashes can be told apart without comparing them.
+             * @return std::uint64_t The hash, never 0
+             */
+            [[nodiscard]] std::uint64_t hash() const;
 
             Element& operator=(const Element& element);
+            Element& operator=(Element&& element) noexcept;
             Element& operator=(const std::pair<string_type, std::vector<Property>>& element);
             Element& operator+=(const Property& property);
+            Element& operator+=(Property&& property);
             Property operator[](const size_type& index) const;
             bool operator==(const Element& element) const;
             bool operator!=(const Element& element) const;
@@ -268,3 +419,12 @@ namespace docpp::CSS {
 
     template <typename... Args> Element make_element(Args&&... args) { return Element(std::forward<Args>(args)...); }
 } // namespace docpp
+
+namespace std {
+    /**
+     * @brief Hash a CSS element by its structural hash, see docpp::CSS::Element::hash()
+     */
+    template <> struct hash<docpp::CSS::Element> {
+        size_t operator()(const docpp::CSS::Element& element) const { return static_cast<size_t>(element.hash()); }
+    };
+} // namespace std
@@ -21,6 +21,7 @@ namespace docpp {
             None,
             Pretty,
             Newline,
+            Minified,
         };
     } // namespace CSS
 } // namespace docpp
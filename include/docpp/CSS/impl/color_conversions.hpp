@@ -23,6 +23,12 @@ namespace docpp {
      * @return docpp::string_type
      */
     docpp::string_type impl_color_to_string_a(const docpp::CSS::ColorStruct& color);
+    /**
+     * @brief Convert a docpp::CSS::ColorStruct to an #RGB formatted docpp::string_type if every channel is a pair of equal digits, and #RRGGBB otherwise
+     * @param color The color to parse from.
+     * @return docpp::string_type
+     */
+    docpp::string_type impl_color_to_string_short(const docpp::CSS::ColorStruct& color);
     /**
      * @brief Convert a docpp::CSS::ColorStruct to an std::tuple<int, int, int>
      * @param color The color to parse from.
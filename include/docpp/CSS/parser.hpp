@@ -0,0 +1,41 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+#include <docpp/CSS/stylesheet.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent CSS elements and documents
+     */
+    namespace CSS {
+        /**
+         * @brief Parse a CSS stylesheet.
+         *
+         * Every rule becomes an Element, with its selector as the tag. Blocks nested in a rule, such as the rules of an @media
+         * at-rule, become nested rules of the element. At-rules without a block, such as @import, become elements without properties.
+         * Comments are dropped, and strings, escapes and parentheses are respected when looking for the end of a declaration,
+         * so values such as url(data:...;base64,...) and quoted strings are kept intact. Declarations without a colon are ignored,
+         * and blocks that are never closed are closed at the end of the input, like a browser would.
+         * @param input The stylesheet to parse
+         * @return Stylesheet The parsed stylesheet
+         */
+        [[nodiscard]] Stylesheet parse(std::string_view input);
+        /**
+         * @brief Parse a CSS stylesheet from a file. The file is mapped into memory rather than read into a buffer.
+         * @param path The path to the file
+         * @return Stylesheet The parsed stylesheet
+         */
+        [[nodiscard]] Stylesheet parse_file(const string_type& path);
+    } // namespace CSS
+} // namespace docpp
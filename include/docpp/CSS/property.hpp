@@ -7,8 +7,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <docpp/types.hpp>
+#include <docpp/intern.hpp>
 
 /**
  * @brief A namespace to represent HTML elements and documents
@@ -23,7 +25,8 @@ namespace docpp {
          */
         class Property {
             private:
-                std::pair<string_type, string_type> property{};
+                InternedString key{};
+                string_type value{};
             protected:
             public:
                 /**
@@ -36,11 +39,22 @@ namespace docpp {
                  * @param key The key of the property
                  * @param value The value of the property
                  */
-                Property(const string_type& key, const string_type& value) : property(std::make_pair(key, value)) {};
+                Property(const string_type& key, string_type value) : key(key), value(std::move(value)) {};
+                /**
+                 * @brief Construct a new Property object
+                 * @param key The interned key of the property
+                 * @param value The value of the property
+                 */
+                Property(InternedString key, string_type value) : key(std::move(key)), value(std::move(value)) {};
                 /**
                  * @brief Construct a new Property object
                  */
                 Property(const Property& property) = default;
+                /**
+                 * @brief Construct a new Property object
+                 * @param property The property to move from
+                 */
+                Property(Property&& property) noexcept = default;
                 /**
                  * @brief Construct a new Property object
                  */
@@ -60,10 +74,7 @@ namespace docpp {
                  * @return T The key of the property
                  */
                 template <typename T> T get_key() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->property.first;
-                    }
-                    return T(this->property.first);
+                    return T(this->get_key());
                 }
                 /**
                  * @brief Get the value of the property
@@ -76,10 +87,25 @@ namespace docpp {
                  */
                 template <typename T> T get_value() const {
                     if (std::is_same_v<T, string_type>) {
-                        return this->property.second;
+                        return this->value;
                     }
-                    return T(this->property.second);
+                    return T(this->value);
                 }
+                /**
+                 * @brief Get a view of the key of the property, without copying it
+                 * @return std::string_view The key of the property, valid until the property is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view key_view() const { return this->key.view(); }
+                /**
+                 * @brief Get the key of the property as a handle, which compares equal to another key by address if the key is interned
+                 * @return InternedString The key of the property
+                 */
+                [[nodiscard]] InternedString interned_key() const { return this->key; }
+                /**
+                 * @brief Get a view of the value of the property, without copying it
+                 * @return std::string_view The value of the property, valid until the property is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view value_view() const { return this->value; }
                 /**
                  * @brief Get the property.
                  * @return std::pair<string_type, string_type> The value of the property
@@ -90,10 +116,7 @@ namespace docpp {
                  * @return std::pair<T, T> The value of the property
                  */
                 template <typename T> std::pair<T, T> get() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return std::make_pair(this->property.first, this->property.second);
-                    }
-                    return std::pair<T, T>(this->property.first, this->property.second);
+                    return std::pair<T, T>(this->get_key<T>(), this->get_value<T>());
                 }
                 /**
                  * @brief Set the key of the property.
@@ -110,9 +133,10 @@ namespace docpp {
                  * @param key The key of the property
                  * @param value The value of the property
                  */
-                void set(const string_type& key, const string_type& value);
+                void set(const string_type& key, string_type value);
 
                 Property& operator=(const Property& property);
+                Property& operator=(Property&& property) noexcept = default;
                 bool operator==(const Property& property) const;
                 bool operator!=(const Property& property) const;
         };
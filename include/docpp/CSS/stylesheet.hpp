@@ -6,9 +6,17 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <docpp/types.hpp>
+#include <docpp/except.hpp>
+#include <docpp/sink.hpp>
+#include <docpp/view.hpp>
 #include <docpp/CSS/formatting_enum.hpp>
 #include <docpp/CSS/element.hpp>
 
@@ -26,6 +34,24 @@ namespace docpp {
         class Stylesheet {
             private:
                 std::vector<Element> elements{};
+                /**
+                 * @brief The hash of the stylesheet, or 0 if it has not been computed since the stylesheet was last modified
+                 */
+                mutable std::atomic<std::uint64_t> cached_hash{0};
+                /**
+                 * @brief Whether a reference or iterator to an element has been handed out. A write through it cannot reset the cached hash,
+                 * so from then on the hash is computed every time it is asked for, from the hashes of the elements.
+                 */
+                bool exposed{false};
+
+                /**
+                 * @brief Mark the stylesheet as modified, resetting its cached hash
+                 */
+                void impl_modified() { this->cached_hash.store(0, std::memory_order_relaxed); }
+                /**
+                 * @brief Mark the stylesheet as modified, and a reference to one of its elements as handed out
+                 */
+                void impl_exposed() { this->impl_modified(); this->exposed = true; }
             protected:
             public:
                 using iterator = std::vector<Element>::iterator;
@@ -37,12 +63,12 @@ namespace docpp {
                  * @brief Return an iterator to the beginning.
                  * @return iterator The iterator to the beginning.
                  */
-                iterator begin() { return elements.begin(); }
+                iterator begin() { this->impl_exposed(); return elements.begin(); }
                 /**
                  * @brief Return an iterator to the end.
                  * @return iterator The iterator to the end.
                  */
-                iterator end() { return elements.end(); }
+                iterator end() { this->impl_exposed(); return elements.end(); }
                 /**
                  * @brief Return a const_iterator to the beginning.
                  * @return const_iterator The iterator to the beginning.
@@ -67,12 +93,12 @@ namespace docpp {
                  * @brief Return a reverse iterator to the beginning.
                  * @return reverse_iterator The reverse iterator to the beginning.
                  */
-                reverse_iterator rbegin() { return elements.rbegin(); }
+                reverse_iterator rbegin() { this->impl_exposed(); return elements.rbegin(); }
                 /**
                  * @brief Return a reverse iterator to the end.
                  * @return reverse_iterator The reverse iterator to the end.
                  */
-                reverse_iterator rend() { return elements.rend(); }
+                reverse_iterator rend() { this->impl_exposed(); return elements.rend(); }
                 /**
                  * @brief Return a const reverse iterator to the beginning.
                  * @return const_reverse_iterator The const reverse iterator to the beginning.
@@ -92,13 +118,22 @@ namespace docpp {
                 /**
                  * @brief Construct a new Stylesheet object
                  */
-                template <typename... Args> explicit Stylesheet(Args... args) { (this->push_back(args), ...); }
-                explicit Stylesheet(const std::vector<Element>& elements) : elements(elements) {};
+                template <typename... Args, typename = std::enable_if_t<std::conjunction_v<std::is_convertible<Args, Element>...>>>
+                explicit Stylesheet(Args&&... args) {
+                    this->elements.reserve(sizeof...(Args));
+                    (this->push_back(std::forward<Args>(args)), ...);
+                }
+                explicit Stylesheet(std::vector<Element> elements) : elements(std::move(elements)) {};
                 /**
                  * @brief Construct a new Stylesheet object
                  * @param stylesheet The stylesheet to set
                  */
-                Stylesheet(const Stylesheet& stylesheet) = default;
+                Stylesheet(const Stylesheet& stylesheet) : elements(stylesheet.elements), cached_hash(stylesheet.cached_hash.load(std::memory_order_relaxed)) {};
+                /**
+                 * @brief Construct a new Stylesheet object
+                 * @param stylesheet The stylesheet to move from
+                 */
+                Stylesheet(Stylesheet&& stylesheet) noexcept : elements(std::move(stylesheet.elements)), cached_hash(stylesheet.cached_hash.load(std::memory_order_relaxed)), exposed(stylesheet.exposed) {};
                 /**
                  * @brief Construct a new Stylesheet object
                  */
@@ -113,17 +148,56 @@ namespace docpp {
                  * @param element The element to add
                  */
                 void push_front(const Element& element);
+                /**
+                 * @brief Prepend an element to the stylesheet
+                 * @param element The element to add
+                 */
+                void push_front(Element&& element);
                 /**
                  * @brief Append an element to the stylesheet
                  * @param element The element to add
                  */
                 void push_back(const Element& element);
+                /**
+                 * @brief Append an element to the stylesheet
+                 * @param element The element to add
+                 */
+                void push_back(Element&& element);
+                /**
+                 * @brief Construct an element in place, at the end of the stylesheet
+                 * @param args The arguments to construct the element with, for example a tag and properties
+                 * @return Element& The appended element
+                 */
+                template <typename... Args> Element& emplace_back(Args&&... args) {
+                    this->impl_exposed();
+                    return this->elements.emplace_back(std::forward<Args>(args)...);
+                }
                 /**
                  * @brief Insert an element into the stylesheet
                  * @param index The index to insert the element
                  * @param element The element to insert
                  */
                 void insert(size_type index, const Element& element);
+                /**
+                 * @brief Insert an element into the stylesheet
+                 * @param index The index to insert the element
+                 * @param element The element to insert
+                 */
+                void insert(size_type index, Element&& element);
+                /**
+                 * @brief Construct an element in place, before an index
+                 * @param index The index to insert the element
+                 * @param args The arguments to construct the element with, for example a tag and properties
+                 * @return Element& The inserted element
+                 */
+                template <typename... Args> Element& emplace(const size_type index, Args&&... args) {
+                    this->impl_exposed();
+                    if (index >= this->elements.size()) {
+                        throw out_of_range("Index out of range");
+                    }
+
+                    return *this->elements.emplace(this->elements.begin() + static_cast<std::ptrdiff_t>(index), std::forward<Args>(args)...);
+                }
                 /**
                  * @brief Erase an element from the stylesheet. Note that this will NOT change the size/index.
                  * @param index The index of the element to erase
@@ -188,11 +262,50 @@ namespace docpp {
                  * @param elements The elements to set
                  */
                 void set(const std::vector<Element>& elements);
+                /**
+                 * @brief Set the elements of the stylesheet
+                 * @param elements The elements to set
+                 */
+                void set(std::vector<Element>&& elements);
                 /**
                  * @brief Get the elements of the stylesheet
                  * @return std::vector<Element> The elements of the stylesheet
                  */
                 [[nodiscard]] std::vector<Element> get_elements() const;
+                /**
+                 * @brief Get a view of the elements of the stylesheet, without copying them
+                 * @return View<const_iterator> The elements of the stylesheet, valid until the stylesheet is modified or destroyed
+                 */
+                [[nodiscard]] View<const_iterator> elements_view() const { return {this->elements.begin(), this->elements.end()}; }
+                /**
+                 * @brief Get a hash of the elements of the stylesheet. The hashes of the stylesheet and its elements are cached until they are modified,
+                 * and that of the stylesheet is not cached once a non-const iterator or reference to an element has been handed out, since a write
+                 * through it can not be seen by the stylesheet. Equal stylesheets have equal hashes, so stylesheets with different hashes can be told apart without comparing them.
+                 * @return std::uint64_t The hash, never 0
+                 */
+                [[nodiscard]] std::uint64_t hash() const;
+                /**
+                 * @brief Optimize the stylesheet for size, without changing what it styles. Every element is optimized (see Element::optimize()),
+                 * rules with the same selector are merged, rules with the same declarations are grouped under one selector list, and empty rules
+                 * are dropped. Selectors with pseudo-classes or pseudo-elements that not every browser knows, such as :focus-visible, are not
+                 * grouped, since a browser drops a selector list it does not fully understand. Rules are only moved past rules that set none of the same properties, so the order of the cascade is kept.
+                 * Pair with Formatting::Minified.
+                 */
+                void optimize();
+                /**
+                 * @brief Write the stylesheet to a sink, as it is generated
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                void write(Sink& sink, Formatting formatting = Formatting::None, integer_type tabc = 0) const;
+                /**
+                 * @brief Get the exact size of the stylesheet in bytes, as written by write() and returned by get(), without generating it
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @return size_type The size of the stylesheet
+                 */
+                [[nodiscard]] size_type rendered_size(Formatting formatting = Formatting::None, integer_type tabc = 0) const;
                 /**
                  * @brief Get the stylesheet
                  * @return string_type The stylesheet
@@ -210,7 +323,9 @@ namespace docpp {
                 }
 
                 Stylesheet& operator=(const Stylesheet& stylesheet);
+                Stylesheet& operator=(Stylesheet&& stylesheet) noexcept;
                 Stylesheet& operator+=(const Element& element);
+                Stylesheet& operator+=(Element&& element);
                 Element operator[](const int& index) const;
                 bool operator==(const Stylesheet& stylesheet) const;
                 bool operator!=(const Stylesheet& stylesheet) const;
@@ -219,3 +334,12 @@ namespace docpp {
         template <typename... Args> Stylesheet make_stylesheet(Args&&... args) { return Stylesheet(std::forward<Args>(args)...); }
     } // namespace CSS
 } // namespace docpp
+
+namespace std {
+    /**
+     * @brief Hash a stylesheet by its structural hash, see docpp::CSS::Stylesheet::hash()
+     */
+    template <> struct hash<docpp::CSS::Stylesheet> {
+        size_t operator()(const docpp::CSS::Stylesheet& stylesheet) const { return static_cast<size_t>(stylesheet.hash()); }
+    };
+} // namespace std
@@ -11,8 +11,14 @@
 #include <docpp/HTML/tag.hpp>
 #include <docpp/HTML/type_enum.hpp>
 #include <docpp/HTML/formatting_enum.hpp>
+#include <docpp/HTML/minify.hpp>
 #include <docpp/HTML/property.hpp>
 #include <docpp/HTML/properties.hpp>
 #include <docpp/HTML/element.hpp>
 #include <docpp/HTML/section.hpp>
 #include <docpp/HTML/document.hpp>
+#include <docpp/HTML/parser.hpp>
+#include <docpp/HTML/template.hpp>
+#include <docpp/HTML/operation_enum.hpp>
+#include <docpp/HTML/patch.hpp>
+#include <docpp/HTML/query.hpp>
@@ -6,8 +6,13 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/sink.hpp>
 #include <docpp/HTML/section.hpp>
 
 /**
@@ -24,14 +29,33 @@ namespace docpp {
         class Document {
             private:
                 Section document{};
-                string_type doctype{"<!DOCTYPE html>"};
+                pmr_string doctype{"<!DOCTYPE html>"};
+                bool escape{false};
             protected:
             public:
+                /**
+                 * @brief The allocator type
+                 */
+                using allocator_type = docpp::allocator_type;
                 /**
                  * @brief The npos value
                  */
                 static constexpr size_type npos = -1;
 
+                /**
+                 * @brief Write the document to a sink, as it is generated
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                void write(Sink& sink, Formatting formatting = Formatting::None, integer_type tabc = 0) const;
+                /**
+                 * @brief Get the exact size of the document in bytes, as written by write() and returned by get(), without generating it
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @return size_type The size of the document
+                 */
+                [[nodiscard]] size_type rendered_size(Formatting formatting = Formatting::None, integer_type tabc = 0) const;
                 /**
                  * @brief Get the document
                  * @param formatting The formatting type to use
@@ -59,6 +83,11 @@ namespace docpp {
                  * @return Section The section
                  */
                 Section& get_section();
+                /**
+                 * @brief Get a reference to the section, without copying it
+                 * @return const Section& The section, valid until the document is destroyed
+                 */
+                [[nodiscard]] const Section& section_ref() const { return this->document; }
                 /**
                  * @brief Get the doctype of the document
                  * @return string_type The doctype of the document
@@ -69,22 +98,55 @@ namespace docpp {
                  * @return T The doctype of the document
                  */
                 template <typename T> T get_doctype() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->doctype;
-                    }
-                    return T(this->doctype);
+                    return T(this->get_doctype());
                 }
+                /**
+                 * @brief Get a view of the doctype of the document, without copying it
+                 * @return std::string_view The doctype of the document, valid until the document is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view doctype_view() const { return this->doctype; }
 
                 /**
                  * @brief Set the document
                  * @param document The document to set
                  */
                 void set(const Section& document);
+                /**
+                 * @brief Set the document
+                 * @param document The document to set
+                 */
+                void set(Section&& document);
                 /**
                  * @brief Set the doctype of the document
                  * @param doctype The doctype to set
                  */
                 void set_doctype(const string_type& doctype);
+                /**
+                 * @brief Set whether the text and attribute values of every element in the document are escaped when it is written.
+                 * Elements of Type::Raw are never escaped.
+                 * @param escape True to escape
+                 */
+                void set_escaping(bool escape);
+                /**
+                 * @brief Check whether the text and attribute values of every element in the document are escaped when it is written
+                 * @return bool True if they are escaped
+                 */
+                [[nodiscard]] bool is_escaping() const;
+                /**
+                 * @brief Enable or disable incremental rendering of the section of the document, see Section::set_incremental()
+                 * @param incremental Whether to render the document incrementally
+                 */
+                void set_incremental(bool incremental);
+                /**
+                 * @brief Check whether the section of the document is rendered incrementally
+                 * @return bool True if it is rendered incrementally
+                 */
+                [[nodiscard]] bool is_incremental() const;
+                /**
+                 * @brief Get a hash of the doctype, escaping and section of the document. The hash of the section is cached, see Section::hash().
+                 * @return std::uint64_t The hash, never 0
+                 */
+                [[nodiscard]] std::uint64_t hash() const;
                 /**
                  * @brief Get the size of the document
                  * @return size_type The size of the document
@@ -98,10 +160,20 @@ namespace docpp {
                  * @brief Clear the document
                  */
                 void clear();
+                /**
+                 * @brief Get the allocator the document allocates its section and doctype with
+                 * @return allocator_type The allocator
+                 */
+                [[nodiscard]] allocator_type get_allocator() const;
                 /**
                  * @brief Construct a new Document object
                  */
                 Document() = default;
+                /**
+                 * @brief Construct a new Document object. Everything added to the document's section is allocated with the allocator.
+                 * @param allocator The allocator to use, for example an Arena
+                 */
+                explicit Document(const allocator_type& allocator) : document(allocator), doctype("<!DOCTYPE html>", allocator) {};
                 /**
                  * @brief Destroy the Document object
                  */
@@ -110,16 +182,24 @@ namespace docpp {
                  * @brief Construct a new Document object
                  * @param document The section to be assigned to the document
                  * @param doctype The doctype to prepend at the top, before the section
+                 * @param allocator The allocator to use
                  */
-                explicit Document(const Section& document, string_type doctype = "<!DOCTYPE html>") : document(document), doctype(std::move(doctype)) {};
+                explicit Document(Section document, const string_type& doctype = "<!DOCTYPE html>", const allocator_type& allocator = {}) : document(std::move(document), allocator), doctype(impl_to_pmr_string(doctype, allocator)) {};
                 /**
                  * @brief Construct a new Document object
                  * @param document The document to set
                  */
                 Document(const Document& document) = default;
+                /**
+                 * @brief Construct a new Document object
+                 * @param document The document to move from
+                 */
+                Document(Document&& document) noexcept = default;
 
                 Document& operator=(const Document& document);
+                Document& operator=(Document&& document) = default;
                 Document& operator=(const Section& section);
+                Document& operator=(Section&& section);
                 bool operator==(const Document& document) const;
                 bool operator==(const Section& section) const;
                 bool operator!=(const Document& document) const;
@@ -127,3 +207,12 @@ namespace docpp {
         };
     } // namespace HTML
 } // namespace docpp
+
+namespace std {
+    /**
+     * @brief Hash a document by its structural hash, see docpp::HTML::Document::hash()
+     */
+    template <> struct hash<docpp::HTML::Document> {
+        size_t operator()(const docpp::HTML::Document& document) const { return static_cast<size_t>(document.hash()); }
+    };
+} // namespace std
@@ -6,8 +6,15 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/sink.hpp>
 #include <docpp/HTML/formatting_enum.hpp>
 #include <docpp/HTML/type_enum.hpp>
 #include <docpp/HTML/tag.hpp>
@@ -21,16 +28,38 @@ namespace docpp {
      * @brief A namespace to represent HTML elements and documents
      */
     namespace HTML {
+        class Section;
+
         /**
          * @brief A class to represent an HTML element
          */
         class Element {
             private:
-                string_type tag{};
+                friend class Section;
+
+                InternedString tag{};
                 Properties properties{};
-                string_type data{};
+                pmr_string data{};
                 Type type{Type::Non_Self_Closing};
+                bool escape{false};
+                /**
+                 * @brief The hash of the element, or 0 if it has not been computed since the element was last modified
+                 */
+                mutable std::atomic<std::uint64_t> cached_hash{0};
+                /**
+                 * @brief The section the element is a child of, or nullptr. Set by the section, and never copied or moved with the element.
+                 */
+                Section* parent{nullptr};
+
+                /**
+                 * @brief Mark the element as modified, resetting its cached hash and the cached hashes of the sections above it
+                 */
+                void impl_modified();
             public:
+                /**
+                 * @brief The allocator type
+                 */
+                using allocator_type = docpp::allocator_type;
                 /**
                  * @brief The npos value
                  */
@@ -42,24 +71,62 @@ namespace docpp {
                  * @param properties The properties of the element
                  * @param data The data of the element
                  * @param type The close tag type.
+                 * @param allocator The allocator to use
+                 */
+                explicit Element(const string_type& tag, Properties properties = {}, const string_type& data = {}, const Type& type = Type::Non_Self_Closing, const allocator_type& allocator = {}) : tag(tag, allocator), properties(std::move(properties), allocator), data(impl_to_pmr_string(data, allocator)), type(type) {};
+                /**
+                 * @brief Construct a new Element object
+                 * @param tag The interned tag of the element
+                 * @param properties The properties of the element
+                 * @param data The data of the element
+                 * @param type The close tag type.
+                 * @param allocator The allocator to use
                  */
-                explicit Element(string_type tag, const Properties& properties = {}, string_type data = {}, const Type& type = Type::Non_Self_Closing) : tag(std::move(tag)), properties(properties), data(std::move(data)), type(type) {};
+                Element(const InternedString& tag, Properties properties, const std::string_view data, const Type& type, const allocator_type& allocator = {}) : tag(tag, allocator), properties(std::move(properties), allocator), data(impl_to_pmr_string(data, allocator)), type(type) {};
                 /**
                  * @brief Construct a new Element object
                  * @param tag The tag of the element
                  * @param properties The properties of the element
                  * @param data The data of the element
+                 * @param allocator The allocator to use
+                 */
+                explicit Element(const Tag tag, Properties properties = {}, const string_type& data = {}, const allocator_type& allocator = {}) : tag(get_interned_tag_name(tag)), properties(std::move(properties), allocator), data(impl_to_pmr_string(data, allocator)), type(get_tag_type(tag)) {};
+                /**
+                 * @brief Construct a new Element object
+                 * @param element The element to set
                  */
-                explicit Element(const Tag tag, const Properties& properties = {}, string_type data = {}) : tag(resolve_tag(tag).first), properties(properties), data(std::move(data)), type(resolve_tag(tag).second) {};
+                Element(const Element& element) : tag(element.tag, allocator_type{}), properties(element.properties), data(element.data), type(element.type), escape(element.escape),
+                    cached_hash(element.cached_hash.load(std::memory_order_relaxed)) {};
                 /**
                  * @brief Construct a new Element object
                  * @param element The element to set
+                 * @param allocator The allocator to use
+                 */
+                Element(const Element& element, const allocator_type& allocator) : tag(element.tag, allocator), properties(element.properties, allocator), data(element.data, allocator), type(element.type), escape(element.escape),
+                    cached_hash(element.cached_hash.load(std::memory_order_relaxed)) {};
+                /**
+                 * @brief Construct a new Element object. The element keeps the allocator of the element it is moved from.
+                 * The element moved from is emptied, so the sections above it have changed.
+                 * @param element The element to move from
+                 */
+                Element(Element&& element) noexcept : tag(std::exchange(element.tag, {})), properties(std::move(element.properties)), data(std::move(element.data)), type(element.type), escape(element.escape),
+                    cached_hash(element.cached_hash.load(std::memory_order_relaxed)) { element.impl_modified(); };
+                /**
+                 * @brief Construct a new Element object. The element is moved if it uses the same allocator, and copied otherwise.
+                 * @param element The element to move from
+                 * @param allocator The allocator to use
                  */
-                Element(const Element& element) = default;
+                Element(Element&& element, const allocator_type& allocator) : tag(std::move(element.tag), allocator), properties(std::move(element.properties), allocator), data(std::move(element.data), allocator), type(element.type), escape(element.escape),
+                    cached_hash(element.cached_hash.load(std::memory_order_relaxed)) { element.impl_modified(); };
                 /**
                  * @brief Construct a new Element object
                  */
                 Element() = default;
+                /**
+                 * @brief Construct a new Element object
+                 * @param allocator The allocator to use
+                 */
+                explicit Element(const allocator_type& allocator) : properties(allocator), data(allocator) {};
                 /**
                  * @brief Destroy the Element object
                  */
@@ -99,12 +166,56 @@ namespace docpp {
                  * @param properties The properties of the element
                  */
                 void set_properties(const Properties& properties);
+                /**
+                 * @brief Set the properties of the element
+                 * @param properties The properties of the element
+                 */
+                void set_properties(Properties&& properties);
+                /**
+                 * @brief Set the value of the first property of the element with a key, or append a property if there is none
+                 * @param key The key of the property
+                 * @param value The value of the property
+                 */
+                void set_property(const string_type& key, const string_type& value);
                 /**
                  * @brief Set the type of the element
                  * @param type The type of the element
                  */
                 void set_type(Type type);
+                /**
+                 * @brief Set whether the data and attribute values of the element are escaped when it is written. Elements of Type::Raw are never escaped.
+                 * @param escape True to escape
+                 */
+                void set_escaping(bool escape);
+                /**
+                 * @brief Check whether the data and attribute values of the element are escaped when it is written
+                 * @return bool True if they are escaped
+                 */
+                [[nodiscard]] bool is_escaping() const;
 
+                /**
+                 * @brief Write the element in the form of an HTML tag to a sink.
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                void write(Sink& sink, Formatting formatting = Formatting::None, integer_type tabc = 0) const;
+                /**
+                 * @brief Write the element to a sink, as a child of a section. Used by Section, which knows what surrounds the element.
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @param preformatted Whether the element is inside a pre, textarea, script or style section, where whitespace is kept with Formatting::Minified
+                 * @param close Whether to write the end tag; only false with Formatting::Minified, when it is implied by what follows the element
+                 */
+                void impl_write(Sink& sink, Formatting formatting, integer_type tabc, bool preformatted, bool close) const;
+                /**
+                 * @brief Get the exact size of the element in bytes, as written by write() and returned by get(), without generating it
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @return size_type The size of the element
+                 */
+                [[nodiscard]] size_type rendered_size(Formatting formatting = Formatting::None, integer_type tabc = 0) const;
                 /**
                  * @brief Get the element in the form of an HTML tag.
                  * @return string_type The tag of the element
@@ -131,12 +242,20 @@ namespace docpp {
                  * @return T The tag of the element
                  */
                 template <typename T> T get_tag() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->tag;
-                    }
-                    return T(this->tag);
+                    return T(this->get_tag());
                 }
 
+                /**
+                 * @brief Get a view of the tag of the element, without copying it
+                 * @return std::string_view The tag of the element, valid until the element is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view tag_view() const { return this->tag.view(); }
+                /**
+                 * @brief Get the tag of the element as a handle, which compares equal to another tag by address if the tag is interned
+                 * @return InternedString The tag of the element
+                 */
+                [[nodiscard]] InternedString interned_tag() const { return this->tag; }
+
                 /**
                  * @brief Get the data of the element
                  * @return string_type The data of the element
@@ -147,16 +266,23 @@ namespace docpp {
                  * @return T The data of the element
                  */
                 template <typename T> T get_data() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->data;
-                    }
-                    return T(this->data);
+                    return T(this->get_data());
                 }
+                /**
+                 * @brief Get a view of the data of the element, without copying it
+                 * @return std::string_view The data of the element, valid until the element is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view data_view() const { return this->data; }
                 /**
                  * @brief Get the properties of the element
                  * @return Properties The properties of the element
                  */
                 [[nodiscard]] Properties get_properties() const;
+                /**
+                 * @brief Get a reference to the properties of the element, without copying them
+                 * @return const Properties& The properties of the element, valid until the element is destroyed
+                 */
+                [[nodiscard]] const Properties& properties_ref() const { return this->properties; }
                 /**
                  * @brief Get the type of the element
                  * @return Type The type of the element
@@ -171,11 +297,32 @@ namespace docpp {
                  * @return bool True if the element is empty, false otherwise.
                  */
                 [[nodiscard]] bool empty() const;
+                /**
+                 * @brief Get the allocator the element allocates its tag, properties and data with
+                 * @return allocator_type The allocator
+                 */
+                [[nodiscard]] allocator_type get_allocator() const;
+                /**
+                 * @brief Get a hash of the tag, properties, data, type and escaping of the element. The hash is cached until the element is modified.
+                 * Equal elements have equal hashes, so elements with different hashes can be told apart without comparing them.
+                 * @return std::uint64_t The hash, never 0
+                 */
+                [[nodiscard]] std::uint64_t hash() const;
 
                 Element& operator=(const Element& element);
+                Element& operator=(Element&& element);
                 Element& operator+=(const string_type& data);
                 bool operator==(const Element& element) const;
                 bool operator!=(const Element& element) const;
         };
     } // namespace HTML
 } // namespace docpp
+
+namespace std {
+    /**
+     * @brief Hash an element by its structural hash, see docpp::HTML::Element::hash()
+     */
+    template <> struct hash<docpp::HTML::Element> {
+        size_t operator()(const docpp::HTML::Element& element) const { return static_cast<size_t>(element.hash()); }
+    };
+} // namespace std
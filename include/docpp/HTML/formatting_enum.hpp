@@ -21,6 +21,7 @@ namespace docpp {
             None, /* No formatting. Output is in the form of one long string of text, and a single newline character. */
             Pretty, /* Pretty formatting. Output is formatted with newlines and tabs as deemed appropriate. */
             Newline, /* Newline formatting. Each element has a newline appended. */
+            Minified, /* Minified formatting. Like None, but end tags that are implied by what follows them are left out, attribute values are only quoted where needed, and runs of whitespace in text are collapsed, except inside pre, textarea, script and style. */
         };
     } // namespace HTML
 } // namespace docpp
@@ -0,0 +1,56 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string_view>
+#include <docpp/types.hpp>
+#include <docpp/sink.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent HTML elements and documents
+     */
+    namespace HTML {
+        /**
+         * @brief Check whether whitespace in the content of an element is significant, so that it is kept with Formatting::Minified
+         * @param tag The tag of the element
+         * @return bool True for pre, textarea, script and style
+         */
+        bool impl_minify_preformatted(std::string_view tag);
+        /**
+         * @brief Check whether an attribute value can be written without quotes with Formatting::Minified
+         * @param value The value of the attribute
+         * @return bool True if the value is not empty and has no whitespace, quotes, =, <, > or `
+         */
+        bool impl_minify_unquoted(std::string_view value);
+        /**
+         * @brief Check whether the end tag of an element can be left out with Formatting::Minified
+         * @param tag The tag of the element
+         * @param next The tag of the next sibling, or empty if the next sibling is not an element with a tag
+         * @param last Whether the element is the last content of its parent
+         * @param parent The tag of the parent
+         * @return bool True if the end tag is implied by what follows it
+         */
+        bool impl_minify_omit_end(std::string_view tag, std::string_view next, bool last, std::string_view parent);
+        /**
+         * @brief Check whether the end tag of an element can ever be left out with Formatting::Minified, before looking at what follows it
+         * @param tag The tag of the element
+         * @return bool True for li, dt, dd, p, td, th, tr and option
+         */
+        bool impl_minify_optional_end(std::string_view tag);
+        /**
+         * @brief Write text with every run of whitespace collapsed to a single space
+         * @param sink The sink to write to
+         * @param text The text to write
+         * @param escape Whether to escape the text
+         */
+        void impl_minify_write_text(Sink& sink, std::string_view text, bool escape);
+    } // namespace HTML
+} // namespace docpp
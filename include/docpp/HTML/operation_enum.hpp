@@ -0,0 +1,28 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent HTML elements and documents
+     */
+    namespace HTML {
+        /**
+         * @brief Enum for the operations of a patch.
+         */
+        enum class Operation {
+            Insert, /* Insert a node before the child at an index, or after the last child. */
+            Remove, /* Remove the child at an index, moving the children after it forward. */
+            Replace, /* Replace the child at an index, or the section itself, with a node. */
+            Set_Attribute, /* Set an attribute of the child at an index, or of the section itself. An empty value removes the attribute. */
+            Set_Text, /* Set the text of the element at an index. */
+        };
+    }
+} // namespace docpp
@@ -0,0 +1,60 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/HTML/section.hpp>
+#include <docpp/HTML/document.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent HTML elements and documents
+     */
+    namespace HTML {
+        /**
+         * @brief Parse HTML markup into a container section (a section without a tag), holding the top-level nodes of the markup.
+         *
+         * Known tag names are resolved through the tag table, and other tag names and attribute names are stored in lower case,
+         * as names in HTML are not case-sensitive. An element that only contains text becomes an Element, any other element
+         * becomes a Section, and text between tags becomes a Text_No_Formatting element. Text consisting only of whitespace
+         * between tags is dropped. Comments and other markup declarations are kept verbatim as Raw elements. Character references are not decoded,
+         * so parsed text should not be escaped again.
+         * Elements that are never closed are closed at the end of the input, and end tags without a start tag become Non_Opened elements.
+         * Start tags close the elements whose end tag they imply: an open p is closed by block elements such as div and table, li by li,
+         * dt and dd by dt and dd, td and th by td, th and tr, tr by tr, and option by option and optgroup.
+         * Attributes without a value are stored with their name as the value, since attributes with an empty value are not written.
+         * Double quotes in a single-quoted attribute value are stored as &quot;, since attribute values are written in double quotes.
+         *
+         * The output of Section::get() with Formatting::None or Formatting::Minified parses back into a section that produces the same output.
+         * @param input The markup to parse
+         * @param allocator The allocator to allocate the nodes from
+         * @return Section The parsed markup
+         */
+        [[nodiscard]] Section parse(std::string_view input, const allocator_type& allocator = {});
+        /**
+         * @brief Parse an HTML document. A leading doctype declaration becomes the doctype of the document, and if the markup
+         * has a single root element that is a section (usually <html>), it becomes the section of the document.
+         * @param input The markup to parse
+         * @param allocator The allocator to allocate the nodes from
+         * @return Document The parsed document
+         */
+        [[nodiscard]] Document parse_document(std::string_view input, const allocator_type& allocator = {});
+        /**
+         * @brief Parse an HTML document from a file. The file is mapped into memory rather than read into a buffer.
+         * @param path The path to the file
+         * @param allocator The allocator to allocate the nodes from
+         * @return Document The parsed document
+         */
+        [[nodiscard]] Document parse_file(const string_type& path, const allocator_type& allocator = {});
+    } // namespace HTML
+} // namespace docpp
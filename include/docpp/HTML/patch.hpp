@@ -0,0 +1,235 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <docpp/types.hpp>
+#include <docpp/sink.hpp>
+#include <docpp/HTML/operation_enum.hpp>
+#include <docpp/HTML/element.hpp>
+#include <docpp/HTML/section.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent HTML elements and documents
+     */
+    namespace HTML {
+        /**
+         * @brief A class to represent a single change of a patch. The change applies to the section found by following the path
+         * of child indices from the root, and to the child at the index of that section, or to the section itself if the index is npos.
+         */
+        class Change {
+            private:
+                Operation operation{Operation::Remove};
+                std::vector<size_type> path{};
+                size_type index{npos};
+                Section::node_type node{};
+                string_type key{};
+                string_type value{};
+            public:
+                /**
+                 * @brief The npos value
+                 */
+                static constexpr size_type npos = -1;
+
+                /**
+                 * @brief Construct a new Change object, for Operation::Remove
+                 * @param operation The operation
+                 * @param path The indices of the sections leading to the section the change applies to
+                 * @param index The index of the child the change applies to, or npos for the section itself
+                 */
+                Change(Operation operation, std::vector<size_type> path, size_type index);
+                /**
+                 * @brief Construct a new Change object, for Operation::Insert and Operation::Replace
+                 * @param operation The operation
+                 * @param path The indices of the sections leading to the section the change applies to
+                 * @param index The index of the child the change applies to, or npos for the section itself
+                 * @param node The element or section to insert or replace with
+                 */
+                Change(Operation operation, std::vector<size_type> path, size_type index, Section::node_type node);
+                /**
+                 * @brief Construct a new Change object, for Operation::Set_Attribute and Operation::Set_Text
+                 * @param operation The operation
+                 * @param path The indices of the sections leading to the section the change applies to
+                 * @param index The index of the child the change applies to, or npos for the section itself
+                 * @param key The key of the attribute. Unused by Operation::Set_Text.
+                 * @param value The value of the attribute, or the text
+                 */
+                Change(Operation operation, std::vector<size_type> path, size_type index, const string_type& key, const string_type& value);
+                /**
+                 * @brief Construct a new Change object
+                 * @param change The change to set
+                 */
+                Change(const Change& change) = default;
+                /**
+                 * @brief Construct a new Change object
+                 * @param change The change to move from
+                 */
+                Change(Change&& change) noexcept = default;
+                /**
+                 * @brief Destroy the Change object
+                 */
+                ~Change() = default;
+
+                /**
+                 * @brief Get the operation of the change
+                 * @return Operation The operation
+                 */
+                [[nodiscard]] Operation get_operation() const;
+                /**
+                 * @brief Get the indices of the sections leading to the section the change applies to
+                 * @return const std::vector<size_type>& The path, empty for the root section
+                 */
+                [[nodiscard]] const std::vector<size_type>& get_path() const;
+                /**
+                 * @brief Get the index of the child the change applies to
+                 * @return size_type The index, or npos for the section itself
+                 */
+                [[nodiscard]] size_type get_index() const;
+                /**
+                 * @brief Get the element or section that is inserted or replaced with
+                 * @return const Section::node_type& The node, or std::monostate for other operations
+                 */
+                [[nodiscard]] const Section::node_type& get_node() const;
+                /**
+                 * @brief Get the key of the attribute that is set
+                 * @return string_type The key
+                 */
+                [[nodiscard]] string_type get_key() const;
+                /**
+                 * @brief Get the value of the attribute, or the text, that is set
+                 * @return string_type The value
+                 */
+                [[nodiscard]] string_type get_value() const;
+
+                Change& operator=(const Change& change) = default;
+                Change& operator=(Change&& change) noexcept = default;
+        };
+
+        /**
+         * @brief A class to represent a list of changes that turn one section into another, as produced by diff() and applied by apply().
+         * Child indices count the children of a section that have not been erased, and the changes are applied in order:
+         * inserting a child moves the children after it back by one, and removing a child moves them forward by one.
+         */
+        class Patch {
+            private:
+                std::vector<Change> changes{};
+            public:
+                using const_iterator = std::vector<Change>::const_iterator;
+
+                /**
+                 * @brief The npos value
+                 */
+                static constexpr size_type npos = -1;
+
+                /**
+                 * @brief Return an iterator to the beginning.
+                 * @return const_iterator The iterator to the beginning.
+                 */
+                [[nodiscard]] const_iterator begin() const { return this->changes.begin(); }
+                /**
+                 * @brief Return an iterator to the end.
+                 * @return const_iterator The iterator to the end.
+                 */
+                [[nodiscard]] const_iterator end() const { return this->changes.end(); }
+
+                /**
+                 * @brief Construct a new, empty Patch object
+                 */
+                Patch() = default;
+                /**
+                 * @brief Construct a new Patch object
+                 * @param changes The changes of the patch
+                 */
+                explicit Patch(std::vector<Change> changes) : changes(std::move(changes)) {};
+                /**
+                 * @brief Construct a new Patch object
+                 * @param patch The patch to set
+                 */
+                Patch(const Patch& patch) = default;
+                /**
+                 * @brief Construct a new Patch object
+                 * @param patch The patch to move from
+                 */
+                Patch(Patch&& patch) noexcept = default;
+                /**
+                 * @brief Destroy the Patch object
+                 */
+                ~Patch() = default;
+
+                /**
+                 * @brief Add a change to the end of the patch
+                 * @param change The change to add
+                 */
+                void push_back(const Change& change);
+                /**
+                 * @brief Add a change to the end of the patch
+                 * @param change The change to add
+                 */
+                void push_back(Change&& change);
+                /**
+                 * @brief Get the change at an index
+                 * @param index The index of the change
+                 * @return const Change& The change at the index
+                 */
+                [[nodiscard]] const Change& at(size_type index) const;
+                /**
+                 * @brief Get the number of changes
+                 * @return size_type The number of changes
+                 */
+                [[nodiscard]] size_type size() const;
+                /**
+                 * @brief Check if the patch has no changes
+                 * @return bool True if the patch has no changes
+                 */
+                [[nodiscard]] bool empty() const;
+                /**
+                 * @brief Clear the patch
+                 */
+                void clear();
+                /**
+                 * @brief Write the patch to a sink as a JSON array, with an object per change:
+                 * {"op":"set-text","path":[1,0],"index":2,"value":"Text"}. The operation is one of "insert", "remove", "replace",
+                 * "set-attribute" and "set-text". "index" is left out for changes to the section itself, "key" is written for
+                 * set-attribute, and inserted and replacing nodes are written as "html", with Formatting::None and the escaping of the sink.
+                 * @param sink The sink to write to
+                 */
+                void write(Sink& sink) const;
+                /**
+                 * @brief Get the patch as a JSON array, see write()
+                 * @return string_type The patch
+                 */
+                [[nodiscard]] string_type get() const;
+
+                Patch& operator=(const Patch& patch) = default;
+                Patch& operator=(Patch&& patch) noexcept = default;
+        };
+
+        /**
+         * @brief Get the changes that turn a section into another. Children are matched by hash: the unchanged children at the start
+         * and the end are skipped, and of the rest, the longest run of children found in the same order in both sections is kept.
+         * Children with equal hashes are taken to be identical and are not walked, so the time taken grows with the size of the
+         * changed parts rather than with the size of the sections. The children between two kept ones are paired up in order and the
+         * rest are removed or inserted. Of a pair, elements with the same tag, type and escaping are changed through their attributes and
+         * text, and sections with the same tag are changed through their attributes and children; anything else is replaced.
+         * @param old_section The section to change
+         * @param new_section The section to change it into
+         * @return Patch The changes. Applying them to old_section gives a section equal to new_section.
+         */
+        [[nodiscard]] Patch diff(const Section& old_section, const Section& new_section);
+        /**
+         * @brief Apply the changes of a patch to a section
+         * @param section The section to change
+         * @param patch The patch to apply
+         */
+        void apply(Section& section, const Patch& patch);
+    } // namespace HTML
+} // namespace docpp
@@ -6,9 +6,17 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <docpp/types.hpp>
+#include <docpp/except.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/small_vector.hpp>
+#include <docpp/view.hpp>
 #include <docpp/HTML/property.hpp>
 
 /**
@@ -19,18 +27,31 @@ namespace docpp {
      * @brief A namespace to represent HTML elements and documents
      */
     namespace HTML {
+#ifndef DOCPP_INLINE_PROPERTIES
+        /**
+         * @brief The number of properties stored inside a Properties object, without allocating. Define DOCPP_INLINE_PROPERTIES to change it.
+         */
+        constexpr size_type inline_properties{1};
+#else
+        constexpr size_type inline_properties{DOCPP_INLINE_PROPERTIES};
+#endif
+
         /**
          * @brief A class to represent the properties of an HTML element
          */
         class Properties {
             private:
-                std::vector<Property> properties{};
+                SmallVector<Property, inline_properties> properties{};
             protected:
             public:
-                using iterator = std::vector<Property>::iterator;
-                using const_iterator = std::vector<Property>::const_iterator;
-                using reverse_iterator = std::vector<Property>::reverse_iterator;
-                using const_reverse_iterator = std::vector<Property>::const_reverse_iterator;
+                using iterator = SmallVector<Property, inline_properties>::iterator;
+                using const_iterator = SmallVector<Property, inline_properties>::const_iterator;
+                using reverse_iterator = SmallVector<Property, inline_properties>::reverse_iterator;
+                using const_reverse_iterator = SmallVector<Property, inline_properties>::const_reverse_iterator;
+                /**
+                 * @brief The allocator type
+                 */
+                using allocator_type = docpp::allocator_type;
 
                 /**
                  * @brief Return an iterator to the beginning.
@@ -93,11 +114,29 @@ namespace docpp {
                  * @return std::vector<Property> The properties of the element
                  */
                 [[nodiscard]] std::vector<Property> get_properties() const;
+                /**
+                 * @brief Get a view of the properties of the element, without copying them
+                 * @return View<const_iterator> The properties of the element, valid until the properties are modified or destroyed
+                 */
+                [[nodiscard]] View<const_iterator> properties_view() const { return {this->properties.begin(), this->properties.end()}; }
                 /**
                  * @brief Set the properties of the element
                  * @param properties The properties to set
                  */
                 void set(const std::vector<Property>& properties);
+                /**
+                 * @brief Set the value of the first property with a key, or append a property if there is none
+                 * @param key The key of the property
+                 * @param value The value of the property
+                 */
+                void set(const string_type& key, const string_type& value);
+                /**
+                 * @brief Get the value of the first property with a key. Unlike find(), the key must match exactly.
+                 * @param key The key of the property
+                 * @return std::optional<std::string_view> The value of the property, valid until the properties are modified or destroyed,
+                 * or std::nullopt if there is no property with the key
+                 */
+                [[nodiscard]] std::optional<std::string_view> get(std::string_view key) const;
                 /**
                  * @brief Get the property at an index
                  * @param index The index of the property
@@ -110,6 +149,25 @@ namespace docpp {
                  * @param property The property to insert
                  */
                 void insert(size_type index, const Property& property);
+                /**
+                 * @brief Insert a property into the element
+                 * @param index The index to insert the property
+                 * @param property The property to insert
+                 */
+                void insert(size_type index, Property&& property);
+                /**
+                 * @brief Construct a property in place, before an index
+                 * @param index The index to insert the property
+                 * @param args The arguments to construct the property with, for example a key and a value
+                 * @return Property& The inserted property
+                 */
+                template <typename... Args> Property& emplace(const size_type index, Args&&... args) {
+                    if (index >= this->properties.size()) {
+                        throw out_of_range("Index out of range");
+                    }
+
+                    return *this->properties.emplace(this->properties.begin() + static_cast<std::ptrdiff_t>(index), std::forward<Args>(args)...);
+                }
                 /**
                  * @brief Erase a property from the element
                  * @param index The index of the property to erase
@@ -163,41 +221,97 @@ namespace docpp {
                  * @return bool True if the properties are empty, false otherwise
                  */
                 [[nodiscard]] bool empty() const;
+                /**
+                 * @brief Get the allocator the properties are allocated with
+                 * @return allocator_type The allocator
+                 */
+                [[nodiscard]] allocator_type get_allocator() const;
                 /**
                  * @brief Prepend a property to the element
                  * @param property The property to add
                  */
                 void push_front(const Property& property);
+                /**
+                 * @brief Prepend a property to the element
+                 * @param property The property to add
+                 */
+                void push_front(Property&& property);
                 /**
                  * @brief Append a property to the element
                  * @param property The property to add
                  */
                 void push_back(const Property& property);
-                template <typename... Args> explicit Properties(Args... args) { (this->push_back(args), ...); }
+                /**
+                 * @brief Append a property to the element
+                 * @param property The property to add
+                 */
+                void push_back(Property&& property);
+                /**
+                 * @brief Construct a property in place, at the end of the element
+                 * @param args The arguments to construct the property with, for example a key and a value
+                 * @return Property& The appended property
+                 */
+                template <typename... Args> Property& emplace_back(Args&&... args) {
+                    return this->properties.emplace_back(std::forward<Args>(args)...);
+                }
+                template <typename... Args, typename = std::enable_if_t<std::conjunction_v<std::is_convertible<Args, Property>...>>>
+                explicit Properties(Args&&... args) {
+                    this->properties.reserve(sizeof...(Args));
+                    (this->push_back(std::forward<Args>(args)), ...);
+                }
                 /**
                  * @brief Construct a new Properties object
                  * @param properties The properties to set
+                 * @param allocator The allocator to use
                  */
-                explicit Properties(const std::vector<Property>& properties) : properties(properties) {};
+                explicit Properties(const std::vector<Property>& properties, const allocator_type& allocator = {}) : properties(allocator) {
+                    this->properties.assign(properties.begin(), properties.end());
+                };
                 /**
                  * @brief Construct a new Properties object
                  * @param property The property to add
+                 * @param allocator The allocator to use
                  */
-                explicit Properties(const Property& property) : properties({property}) {};
+                explicit Properties(const Property& property, const allocator_type& allocator = {}) : properties(allocator) {
+                    this->properties.push_back(property);
+                };
                 /**
                  * @brief Construct a new Properties object
                  * @param properties The properties to set
                  */
                 Properties(const Properties& properties) = default;
+                /**
+                 * @brief Construct a new Properties object
+                 * @param properties The properties to set
+                 * @param allocator The allocator to use
+                 */
+                Properties(const Properties& properties, const allocator_type& allocator) : properties(properties.properties, allocator) {};
+                /**
+                 * @brief Construct a new Properties object. The properties keep the allocator of the properties they are moved from.
+                 * @param properties The properties to move from
+                 */
+                Properties(Properties&& properties) noexcept = default;
+                /**
+                 * @brief Construct a new Properties object. The properties are moved if they use the same allocator, and copied otherwise.
+                 * @param properties The properties to move from
+                 * @param allocator The allocator to use
+                 */
+                Properties(Properties&& properties, const allocator_type& allocator) : properties(std::move(properties.properties), allocator) {};
                 /**
                  * @brief Construct a new Properties object
                  */
                 Properties() = default;
+                /**
+                 * @brief Construct a new Properties object
+                 * @param allocator The allocator to use
+                 */
+                explicit Properties(const allocator_type& allocator) : properties(allocator) {};
                 /**
                  * @brief Destroy the Properties object
                  */
                 ~Properties() = default;
                 Properties& operator=(const Properties& properties);
+                Properties& operator=(Properties&& properties) = default;
                 Properties& operator=(const std::vector<Property>& properties);
                 Properties& operator=(const Property& property);
                 bool operator==(const Properties& properties) const;
@@ -206,6 +320,7 @@ namespace docpp {
                 bool operator!=(const Property& property) const;
                 Property operator[](const size_type& index) const;
                 Properties& operator+=(const Property& property);
+                Properties& operator+=(Property&& property);
                 Properties& operator+=(const Properties& properties);
         };
 
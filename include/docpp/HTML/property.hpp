@@ -7,7 +7,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/intern.hpp>
 
 /**
  * @brief A namespace to represent HTML elements and documents
@@ -22,9 +25,15 @@ namespace docpp {
          */
         class Property {
             private:
-                std::pair<string_type, string_type> property{};
+                InternedString key{};
+                pmr_string value{};
             protected:
             public:
+                /**
+                 * @brief The allocator type
+                 */
+                using allocator_type = docpp::allocator_type;
+
                 /**
                  * @brief The npos value
                  */
@@ -34,17 +43,47 @@ namespace docpp {
                  * @brief Construct a new Property object
                  * @param key The key of the property
                  * @param value The value of the property
+                 * @param allocator The allocator to use
+                 */
+                Property(const string_type& key, const string_type& value, const allocator_type& allocator = {}) : key(key, allocator), value(impl_to_pmr_string(value, allocator)) {};
+                /**
+                 * @brief Construct a new Property object
+                 * @param key The interned key of the property
+                 * @param value The value of the property
+                 * @param allocator The allocator to use
                  */
-                Property(const string_type& key, const string_type& value) : property(std::make_pair(key, value)) {};
+                Property(const InternedString& key, const std::string_view value, const allocator_type& allocator = {}) : key(key, allocator), value(impl_to_pmr_string(value, allocator)) {};
                 /**
                  * @brief Construct a new Property object
                  * @param property The property to set
                  */
-                Property(const Property& property) = default;
+                Property(const Property& property) : key(property.key, allocator_type{}), value(property.value) {};
+                /**
+                 * @brief Construct a new Property object
+                 * @param property The property to set
+                 * @param allocator The allocator to use
+                 */
+                Property(const Property& property, const allocator_type& allocator) : key(property.key, allocator), value(property.value, allocator) {};
+                /**
+                 * @brief Construct a new Property object. The property keeps the allocator of the property it is moved from.
+                 * @param property The property to move from
+                 */
+                Property(Property&& property) noexcept = default;
+                /**
+                 * @brief Construct a new Property object. The property is moved if it uses the same allocator, and copied otherwise.
+                 * @param property The property to move from
+                 * @param allocator The allocator to use
+                 */
+                Property(Property&& property, const allocator_type& allocator) : key(std::move(property.key), allocator), value(std::move(property.value), allocator) {};
                 /**
                  * @brief Construct a new Property object
                  */
                 Property() = default;
+                /**
+                 * @brief Construct a new Property object
+                 * @param allocator The allocator to use
+                 */
+                explicit Property(const allocator_type& allocator) : value(allocator) {};
                 /**
                  * @brief Destroy the Property object
                  */
@@ -60,11 +99,7 @@ namespace docpp {
                  * @return T The key of the property
                  */
                 template <typename T> T get_key() const {
-                    if (std::is_same_v<T, string_type>) {
-                     return this->property.first;
-                    }
-
-                    return T(this->property.first);
+                    return T(this->get_key());
                 };
                 /**
                  * @brief Get the value of the property
@@ -76,11 +111,23 @@ namespace docpp {
                  * @return T The value of the property
                  */
                 template <typename T> T get_value() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->property.second;
-                    }
-                    return T(this->property.second);
+                    return T(this->get_value());
                 }
+                /**
+                 * @brief Get a view of the key of the property, without copying it
+                 * @return std::string_view The key of the property, valid until the property is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view key_view() const { return this->key.view(); }
+                /**
+                 * @brief Get the key of the property as a handle, which compares equal to another key by address if the key is interned
+                 * @return InternedString The key of the property
+                 */
+                [[nodiscard]] InternedString interned_key() const { return this->key; }
+                /**
+                 * @brief Get a view of the value of the property, without copying it
+                 * @return std::string_view The value of the property, valid until the property is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view value_view() const { return this->value; }
                 /**
                  * @brief Get the property.
                  * @return std::pair<string_type, string_type> The value of the property
@@ -91,11 +138,7 @@ namespace docpp {
                  * @return std::pair<T, T> The value of the property
                  */
                 template <typename T> std::pair<T, T> get() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->property;
-                    }
-
-                    return T(this->property);
+                    return std::make_pair(this->get_key<T>(), this->get_value<T>());
                 }
                 /**
                  * @brief Set the key of the property.
@@ -121,8 +164,14 @@ namespace docpp {
                  * @return bool True if the property is empty, false otherwise
                  */
                 [[nodiscard]] bool empty() const;
+                /**
+                 * @brief Get the allocator the property allocates its value with. The key is interned, and not allocated with it.
+                 * @return allocator_type The allocator
+                 */
+                [[nodiscard]] allocator_type get_allocator() const;
 
                 Property& operator=(const Property& property);
+                Property& operator=(Property&& property) = default;
                 bool operator==(const Property& property) const;
                 bool operator!=(const Property& property) const;
 
@@ -0,0 +1,217 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <docpp/types.hpp>
+#include <docpp/intern.hpp>
+#include <docpp/HTML/element.hpp>
+#include <docpp/HTML/section.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent HTML elements and documents
+     */
+    namespace HTML {
+        class QueryIndex;
+
+        /**
+         * @brief A class to represent a compiled CSS selector, to find elements and sections in any number of trees.
+         *
+         * Type and universal selectors, ids, classes, attribute selectors ([key], [key=value], [key~=value], [key|=value], [key^=value],
+         * [key$=value] and [key*=value]), the descendant and child combinators and lists of selectors are supported. Tag and attribute
+         * names are matched in lower case, as docpp writes them. Nodes are matched as they are written: nodes without a tag are never
+         * matched, and the children of a section without a tag are children of the nearest section with one.
+         */
+        class Selector {
+            private:
+                enum class impl_operator {
+                    Exists,
+                    Equals,
+                    Includes,
+                    Dash,
+                    Prefix,
+                    Suffix,
+                    Substring,
+                };
+
+                struct impl_attribute {
+                    InternedString key{};
+                    string_type value{};
+                    impl_operator op{impl_operator::Exists};
+                };
+
+                struct impl_compound {
+                    InternedString tag{}; // empty for any tag
+                    std::vector<impl_attribute> attributes{};
+                    bool child{false}; // joined to the compound before it by the child combinator, rather than the descendant combinator
+                };
+
+                std::vector<std::vector<impl_compound>> selectors{};
+
+                /**
+                 * @brief Check if a node matches a selector of the list
+                 * @param compounds The compounds of the selector
+                 * @param node The node
+                 * @param ancestors The sections with a tag that contain the node, outermost first
+                 * @return bool True if the node matches
+                 */
+                [[nodiscard]] static bool impl_match(const std::vector<impl_compound>& compounds, const Section::node_type& node, const std::vector<const Section*>& ancestors);
+                /**
+                 * @brief Check if a node matches any selector of the list
+                 * @param node The node
+                 * @param ancestors The sections with a tag that contain the node, outermost first
+                 * @return bool True if the node matches
+                 */
+                [[nodiscard]] bool impl_match(const Section::node_type& node, const std::vector<const Section*>& ancestors) const;
+                /**
+                 * @brief Find the nodes that match in a tree, in document order
+                 * @param section The root of the tree, which is not matched itself
+                 * @param first Stop at the first node that matches
+                 * @return std::vector<const Section::node_type*> The nodes
+                 */
+                [[nodiscard]] std::vector<const Section::node_type*> impl_query(const Section& section, bool first) const;
+                /**
+                 * @brief Find the nodes that match in an indexed tree, in document order
+                 * @param index The index of the tree
+                 * @param first Stop at the first node that matches
+                 * @return std::vector<const Section::node_type*> The nodes
+                 */
+                [[nodiscard]] std::vector<const Section::node_type*> impl_query(const QueryIndex& index, bool first) const;
+            public:
+                /**
+                 * @brief The npos value
+                 */
+                static constexpr size_type npos = -1;
+
+                /**
+                 * @brief Construct a new Selector object
+                 * @param selector The selector, for example "div.content > p#intro"
+                 * @throws docpp::invalid_argument If the selector is invalid or uses unsupported syntax
+                 */
+                explicit Selector(std::string_view selector);
+
+                /**
+                 * @brief Check if a node matches the selector
+                 * @param node The node
+                 * @param ancestors The sections with a tag that contain the node, outermost first
+                 * @return bool True if the node matches
+                 */
+                [[nodiscard]] bool matches(const Section::node_type& node, const std::vector<const Section*>& ancestors = {}) const;
+                /**
+                 * @brief Find the first node in a tree that matches the selector, in document order. The root is not matched itself.
+                 * @param section The root of the tree
+                 * @return const Section::node_type* The node, valid until the tree is modified or destroyed, or nullptr if there is none
+                 */
+                [[nodiscard]] const Section::node_type* query(const Section& section) const;
+                /**
+                 * @brief Find the first node in an indexed tree that matches the selector, in document order
+                 * @param index The index of the tree
+                 * @return const Section::node_type* The node, valid until the tree is modified or destroyed, or nullptr if there is none
+                 */
+                [[nodiscard]] const Section::node_type* query(const QueryIndex& index) const;
+                /**
+                 * @brief Find every node in a tree that matches the selector, in document order. The root is not matched itself.
+                 * @param section The root of the tree
+                 * @return std::vector<const Section::node_type*> The nodes, valid until the tree is modified or destroyed
+                 */
+                [[nodiscard]] std::vector<const Section::node_type*> query_all(const Section& section) const;
+                /**
+                 * @brief Find every node in an indexed tree that matches the selector, in document order
+                 * @param index The index of the tree
+                 * @return std::vector<const Section::node_type*> The nodes, valid until the tree is modified or destroyed
+                 */
+                [[nodiscard]] std::vector<const Section::node_type*> query_all(const QueryIndex& index) const;
+        };
+
+        /**
+         * @brief A class to represent an index of the ids and classes of a tree, for selectors that are run against it many times.
+         * A selector whose last compound has an id or a class only looks at the nodes with it. The index of each is built on its
+         * first use, and can be used from multiple threads. The index is valid until the tree is modified or destroyed.
+         */
+        class QueryIndex {
+            private:
+                struct impl_node {
+                    const Section::node_type* node{nullptr};
+                    size_type parent{npos}; // the index of the nearest section with a tag that contains the node, or npos
+                };
+
+                const Section& section;
+                mutable std::once_flag nodes_flag{};
+                mutable std::once_flag ids_flag{};
+                mutable std::once_flag classes_flag{};
+                mutable std::vector<impl_node> nodes{};
+                mutable std::unordered_map<std::string_view, std::vector<size_type>> ids{};
+                mutable std::unordered_map<std::string_view, std::vector<size_type>> classes{};
+
+                /**
+                 * @brief Get the nodes with a tag in the tree, in document order, collecting them on first use
+                 * @return const std::vector<impl_node>& The nodes
+                 */
+                [[nodiscard]] const std::vector<impl_node>& impl_nodes() const;
+                /**
+                 * @brief Get the nodes with each id, building the index on first use
+                 * @return const std::unordered_map<std::string_view, std::vector<size_type>>& The indices of the nodes by id
+                 */
+                [[nodiscard]] const std::unordered_map<std::string_view, std::vector<size_type>>& impl_ids() const;
+                /**
+                 * @brief Get the nodes with each class, building the index on first use
+                 * @return const std::unordered_map<std::string_view, std::vector<size_type>>& The indices of the nodes by class
+                 */
+                [[nodiscard]] const std::unordered_map<std::string_view, std::vector<size_type>>& impl_classes() const;
+            public:
+                /**
+                 * @brief The npos value
+                 */
+                static constexpr size_type npos = -1;
+
+                /**
+                 * @brief Construct a new QueryIndex object. Nothing is indexed until the index is used.
+                 * @param section The root of the tree, which must outlive the index
+                 */
+                explicit QueryIndex(const Section& section) : section(section) {};
+                QueryIndex(const QueryIndex& index) = delete;
+                QueryIndex& operator=(const QueryIndex& index) = delete;
+                /**
+                 * @brief Destroy the QueryIndex object
+                 */
+                ~QueryIndex() = default;
+
+                /**
+                 * @brief Get the root of the indexed tree
+                 * @return const Section& The root of the tree
+                 */
+                [[nodiscard]] const Section& section_ref() const { return this->section; }
+
+                friend class Selector;
+        };
+
+        /**
+         * @brief Find the first node in a tree that matches a selector, in document order. The root is not matched itself.
+         * @param section The root of the tree
+         * @param selector The selector, for example "div.content > p#intro"
+         * @return const Section::node_type* The node, valid until the tree is modified or destroyed, or nullptr if there is none
+         * @throws docpp::invalid_argument If the selector is invalid or uses unsupported syntax
+         */
+        [[nodiscard]] const Section::node_type* query(const Section& section, std::string_view selector);
+        /**
+         * @brief Find every node in a tree that matches a selector, in document order. The root is not matched itself.
+         * @param section The root of the tree
+         * @param selector The selector, for example "article.card > h2"
+         * @return std::vector<const Section::node_type*> The nodes, valid until the tree is modified or destroyed
+         * @throws docpp::invalid_argument If the selector is invalid or uses unsupported syntax
+         */
+        [[nodiscard]] std::vector<const Section::node_type*> query_all(const Section& section, std::string_view selector);
+    } // namespace HTML
+} // namespace docpp
@@ -6,11 +6,25 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <unordered_map>
-#include <map>
+#include <variant>
 #include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/devector.hpp>
+#include <docpp/except.hpp>
+#include <docpp/sink.hpp>
+#include <docpp/thread_pool.hpp>
+#include <docpp/view.hpp>
 #include <docpp/HTML/tag.hpp>
 #include <docpp/HTML/properties.hpp>
 #include <docpp/HTML/element.hpp>
@@ -29,21 +43,59 @@ namespace docpp {
         class Section {
             public:
                 /**
-                 * @brief A class to represent an iterator for the Section class
+                 * @brief A child of a section: an element, a section, or nothing, if the slot has been erased.
                  */
-                template <typename T>
+                using node_type = std::variant<std::monostate, Element, Section>;
+                /**
+                 * @brief The list of children of a section. Children are added to the front as cheaply as to the back.
+                 */
+                using children_type = Devector<node_type>;
+                /**
+                 * @brief The allocator type. Children are allocated with the allocator of the section they are added to.
+                 */
+                using allocator_type = docpp::allocator_type;
+
+                /**
+                 * @brief A class to represent an iterator over the elements (or, if R is a Section reference, the sections) of the Section class. Other children and erased slots are skipped.
+                 */
+                template <typename T, typename R>
                 class sect_iterator {
                     private:
                         T element{};
+                        T last{};
+
+                        void skip() {
+                            while (element != last && !std::holds_alternative<value_type>(*element)) {
+                                ++element;
+                            }
+                        }
                     public:
-                        explicit sect_iterator(const T& element) : element(element) {}
+                        using iterator_category = std::forward_iterator_tag;
+                        using value_type = std::remove_cv_t<std::remove_reference_t<R>>;
+                        using difference_type = std::ptrdiff_t;
+                        using pointer = std::remove_reference_t<R>*;
+                        using reference = R;
+
+                        sect_iterator(const T& element, const T& last) : element(element), last(last) {
+                            skip();
+                        }
                         sect_iterator& operator++() {
                             ++element;
+                            skip();
                             return *this;
                         }
+                        sect_iterator operator++(int) {
+                            sect_iterator ret{*this};
+                            ++*this;
+                            return ret;
+                        }
 
-                        auto operator*() const -> decltype(element->second) {
-                            return element->second;
+                        R operator*() const {
+                            return std::get<value_type>(*element);
+                        }
+
+                        pointer operator->() const {
+                            return &std::get<value_type>(*element);
                         }
 
                         bool operator==(const sect_iterator& other) const {
@@ -55,62 +107,62 @@ namespace docpp {
                         }
                 };
 
-                using element_map = std::map<size_type, Element>;
-                using iterator = sect_iterator<element_map::iterator>;
-                using const_iterator = sect_iterator<element_map::const_iterator>;
-                using reverse_iterator = sect_iterator<element_map::reverse_iterator>;
-                using const_reverse_iterator = sect_iterator<element_map::const_reverse_iterator>;
+                using iterator = sect_iterator<children_type::iterator, Element&>;
+                using const_iterator = sect_iterator<children_type::const_iterator, const Element&>;
+                using reverse_iterator = sect_iterator<children_type::reverse_iterator, Element&>;
+                using const_reverse_iterator = sect_iterator<children_type::const_reverse_iterator, const Element&>;
+                using const_section_iterator = sect_iterator<children_type::const_iterator, const Section&>;
 
                 /**
                  * @brief Return an iterator to the beginning.
                  * @return iterator The iterator to the beginning.
                  */
-                iterator begin() { return iterator(elements.begin()); }
+                iterator begin() { return iterator(children.begin(), children.end()); }
                 /**
                  * @brief Return an iterator to the end.
                  * @return iterator The iterator to the end.
                  */
-                iterator end() { return iterator(elements.end()); }
+                iterator end() { return iterator(children.end(), children.end()); }
                 /**
                  * @brief Return an iterator to the beginning.
                  * @return const_iterator The iterator to the beginning.
                  */
-                [[nodiscard]] const_iterator begin() const { return const_iterator(elements.begin()); }
+                [[nodiscard]] const_iterator begin() const { return const_iterator(children.begin(), children.end()); }
                 /**
                  * @brief Return an iterator to the end.
                  * @return const_iterator The iterator to the end.
                  */
-                [[nodiscard]] const_iterator end() const { return const_iterator(elements.end()); }
+                [[nodiscard]] const_iterator end() const { return const_iterator(children.end(), children.end()); }
                 /**
                  * @brief Return a const iterator to the beginning.
                  * @return const_iterator The const iterator to the beginning.
                  */
-                [[nodiscard]] const_iterator cbegin() const { return const_iterator(elements.cbegin()); }
+                [[nodiscard]] const_iterator cbegin() const { return const_iterator(children.cbegin(), children.cend()); }
                 /**
                  * @brief Return a const iterator to the end.
                  * @return const_iterator The const iterator to the end.
                  */
-                [[nodiscard]] const_iterator cend() const { return const_iterator(elements.cend()); }
+                [[nodiscard]] const_iterator cend() const { return const_iterator(children.cend(), children.cend()); }
                 /**
                  * @brief Return a reverse iterator to the beginning.
                  * @return reverse_iterator The reverse iterator to the beginning.
                  */
-                reverse_iterator rbegin() { return reverse_iterator(elements.rbegin()); }
+                reverse_iterator rbegin() { return reverse_iterator(children.rbegin(), children.rend()); }
                 /**
                  * @brief Return a reverse iterator to the end.
                  * @return reverse_iterator The reverse iterator to the end.
                  */
-                reverse_iterator rend() { return reverse_iterator(elements.rend()); }
+                reverse_iterator rend() { return reverse_iterator(children.rend(), children.rend()); }
                 /**
                  * @brief Return a const reverse iterator to the beginning.
                  * @return const_reverse_iterator The const reverse iterator to the beginning.
                  */
-                [[nodiscard]] const_reverse_iterator crbegin() const { return const_reverse_iterator(elements.crbegin()); }
+                [[nodiscard]] const_reverse_iterator crbegin() const { return const_reverse_iterator(children.crbegin(), children.crend()); }
                 /**
                  * @brief Return a const reverse iterator to the end.
                  * @return const_reverse_iterator The const reverse iterator to the end.
                  */
-                [[nodiscard]] const_reverse_iterator crend() const { return const_reverse_iterator(elements.crend()); }
+                [[nodiscard]] const_reverse_iterator crend() const { return const_reverse_iterator(children.crend(), children.crend()); }
 
                 /**
                  * @brief The npos value
@@ -127,6 +179,16 @@ namespace docpp {
                  * @param section The section to add
                  */
                 void push_front(const Section& section);
+                /**
+                 * @brief Prepend an element to the section
+                 * @param element The element to add
+                 */
+                void push_front(Element&& element);
+                /**
+                 * @brief Prepend a section to the section
+                 * @param section The section to add
+                 */
+                void push_front(Section&& section);
                 /**
                  * @brief Append an element to the section
                  * @param element The element to add
@@ -137,6 +199,49 @@ namespace docpp {
                  * @param section The section to add
                  */
                 void push_back(const Section& section);
+                /**
+                 * @brief Append an element to the section
+                 * @param element The element to add
+                 */
+                void push_back(Element&& element);
+                /**
+                 * @brief Append a section to the section
+                 * @param section The section to add
+                 */
+                void push_back(Section&& section);
+                /**
+                 * @brief Construct an element or a section in place, at the beginning of the section
+                 * @param args The arguments to construct the child with
+                 * @return T& The prepended child
+                 */
+                template <typename T, typename... Args> T& emplace_front(Args&&... args) {
+                    this->impl_modified();
+                    return std::get<T>(this->impl_emplace(0, this->impl_make_node<T>(std::forward<Args>(args)...)));
+                }
+                /**
+                 * @brief Construct an element or a section in place, at the end of the section
+                 * @param args The arguments to construct the child with
+                 * @return T& The appended child
+                 */
+                template <typename T, typename... Args> T& emplace_back(Args&&... args) {
+                    this->impl_modified();
+                    return std::get<T>(this->impl_emplace(this->children.size(), this->impl_make_node<T>(std::forward<Args>(args)...)));
+                }
+                /**
+                 * @brief Construct an element or a section in place, before the child at an index. The children from the index on
+                 * move back by one, unlike with insert(), and the ones on the shorter side of the index are moved.
+                 * @param index The index to construct the child at, at most size()
+                 * @param args The arguments to construct the child with
+                 * @return T& The inserted child
+                 */
+                template <typename T, typename... Args> T& emplace(const size_type index, Args&&... args) {
+                    if (index > this->children.size()) {
+                        throw docpp::out_of_range("Index out of range");
+                    }
+
+                    this->impl_modified();
+                    return std::get<T>(this->impl_emplace(index, this->impl_make_node<T>(std::forward<Args>(args)...)));
+                }
 
                 /**
                  * @brief Get the element at an index. To get a section, use at_section()
@@ -197,7 +302,8 @@ namespace docpp {
                  */
                 [[nodiscard]] size_type find(const string_type& str) const;
                 /**
-                 * @brief Insert an element into the section
+                 * @brief Insert an element into the section, writing it to the slot at the index, past the end if need be. The other
+                 * children keep their index; to insert between children, use insert_before().
                  * @param index The index to insert the element
                  * @param element The element to insert
                  */
@@ -208,6 +314,43 @@ namespace docpp {
                  * @param section The section to insert
                  */
                 void insert(size_type index, const Section& section);
+                /**
+                 * @brief Insert an element into the section
+                 * @param index The index to insert the element
+                 * @param element The element to insert
+                 */
+                void insert(size_type index, Element&& element);
+                /**
+                 * @brief Insert a section into the section
+                 * @param index The index to insert the section
+                 * @param section The section to insert
+                 */
+                void insert(size_type index, Section&& section);
+                /**
+                 * @brief Insert an element before the child at an index. Unlike insert(), no slot is overwritten: the children from
+                 * the index on move back by one, and the ones on the shorter side of the index are moved.
+                 * @param index The index to insert the element at, at most size()
+                 * @param element The element to insert
+                 */
+                void insert_before(size_type index, const Element& element);
+                /**
+                 * @brief Insert a section before the child at an index, moving the children from the index on back by one
+                 * @param index The index to insert the section at, at most size()
+                 * @param section The section to insert
+                 */
+                void insert_before(size_type index, const Section& section);
+                /**
+                 * @brief Insert an element before the child at an index, moving the children from the index on back by one
+                 * @param index The index to insert the element at, at most size()
+                 * @param element The element to insert
+                 */
+                void insert_before(size_type index, Element&& element);
+                /**
+                 * @brief Insert a section before the child at an index, moving the children from the index on back by one
+                 * @param index The index to insert the section at, at most size()
+                 * @param section The section to insert
+                 */
+                void insert_before(size_type index, Section&& section);
                 /**
                  * @brief Get the first element of the section
                  * @return Element The first element of the section
@@ -266,65 +409,104 @@ namespace docpp {
                  * @brief Construct a new Section object
                  * @param tag The tag of the section
                  * @param properties The properties of the section
+                 * @param allocator The allocator to use
+                 */
+                explicit Section(const string_type& tag, Properties properties = {}, const allocator_type& allocator = {}) : tag(tag, allocator), properties(std::move(properties), allocator), children(allocator) {};
+                /**
+                 * @brief Construct a new Section object
+                 * @param tag The interned tag of the section
+                 * @param properties The properties of the section
+                 * @param allocator The allocator to use
                  */
-                explicit Section(string_type tag, const Properties& properties = {}) : tag(std::move(tag)), properties(properties) {};
+                Section(const InternedString& tag, Properties properties, const allocator_type& allocator = {}) : tag(tag, allocator), properties(std::move(properties), allocator), children(allocator) {};
                 /**
                  * @brief Construct a new Section object
                  * @param tag The tag of the section
                  * @param properties The properties of the section
+                 * @param allocator The allocator to use
                  */
-                explicit Section(const Tag tag, const Properties& properties = {}) : tag(resolve_tag(tag).first), properties(properties) {};
+                explicit Section(const Tag tag, Properties properties = {}, const allocator_type& allocator = {}) : tag(get_interned_tag_name(tag)), properties(std::move(properties), allocator), children(allocator) {};
                 /**
                  * @brief Construct a new Section object
                  * @param tag The tag of the section
                  * @param properties The properties of the section
                  * @param elements The elements of the section
+                 * @param allocator The allocator to use
                  */
-                Section(string_type tag, const Properties& properties, const std::vector<Element>& elements) : tag(std::move(tag)), properties(properties) {
-                    for (const auto& element : elements) this->push_back(element);
+                Section(const string_type& tag, Properties properties, std::vector<Element> elements, const allocator_type& allocator = {}) : Section(tag, std::move(properties), allocator) {
+                    this->children.reserve(elements.size());
+                    for (auto& element : elements) this->push_back(std::move(element));
                 };
                 /**
                  * @brief Construct a new Section object
                  * @param tag The tag of the section
                  * @param properties The properties of the section
                  * @param elements The elements of the section
+                 * @param allocator The allocator to use
                  */
-                Section(const Tag tag, const Properties& properties, const std::vector<Element>& elements) : tag(resolve_tag(tag).first), properties(properties) {
-                    for (const auto& element : elements) this->push_back(element);
+                Section(const Tag tag, Properties properties, std::vector<Element> elements, const allocator_type& allocator = {}) : Section(tag, std::move(properties), allocator) {
+                    this->children.reserve(elements.size());
+                    for (auto& element : elements) this->push_back(std::move(element));
                 };
                 /**
                  * @brief Construct a new Section object
                  * @param tag The tag of the section
                  * @param properties The properties of the section
                  * @param sections The sections of the section
+                 * @param allocator The allocator to use
                  */
-                Section(string_type tag, const Properties& properties, const std::vector<Section>& sections) : tag(std::move(tag)), properties(properties) {
-                    for (const auto& section : sections) this->push_back(section);
+                Section(const string_type& tag, Properties properties, std::vector<Section> sections, const allocator_type& allocator = {}) : Section(tag, std::move(properties), allocator) {
+                    this->children.reserve(sections.size());
+                    for (auto& section : sections) this->push_back(std::move(section));
                 };
                 /**
                  * @brief Construct a new Section object
                  * @param tag The tag of the section
                  * @param properties The properties of the section
                  * @param sections The sections of the section
+                 * @param allocator The allocator to use
                  */
-                Section(const Tag tag, const Properties& properties, const std::vector<Section>& sections) : tag(resolve_tag(tag).first), properties(properties) {
-                    for (const auto& section : sections) this->push_back(section);
+                Section(const Tag tag, Properties properties, std::vector<Section> sections, const allocator_type& allocator = {}) : Section(tag, std::move(properties), allocator) {
+                    this->children.reserve(sections.size());
+                    for (auto& section : sections) this->push_back(std::move(section));
                 };
                 /**
                  * @brief Construct a new Section object
                  * @param section The section to set
                  */
-                Section(const Section& section) {
-                    this->tag = section.tag;
-                    this->properties = section.properties;
-                    this->elements = section.elements;
-                    this->sections = section.sections;
-                    this->index = section.index;
-                }
+                Section(const Section& section) : tag(section.tag, allocator_type{}), properties(section.properties), children(section.children), prerendered(section.prerendered),
+                    incremental(impl_copy_incremental(section.incremental)), cached_hash(section.cached_hash.load(std::memory_order_relaxed)),
+                    cached_nodes(section.cached_nodes.load(std::memory_order_relaxed)) { this->impl_link(); };
+                /**
+                 * @brief Construct a new Section object, copying the section and all of its children with an allocator
+                 * @param section The section to set
+                 * @param allocator The allocator to use
+                 */
+                Section(const Section& section, const allocator_type& allocator);
+                /**
+                 * @brief Construct a new Section object. The section keeps the allocator of the section it is moved from.
+                 * The children are not moved, but are linked to the new section, which takes time linear in their number.
+                 * The section moved from is emptied, so the sections above it have changed.
+                 * @param section The section to move from
+                 */
+                Section(Section&& section) noexcept : tag(std::exchange(section.tag, {})), properties(std::move(section.properties)), children(std::move(section.children)),
+                    prerendered(std::move(section.prerendered)), incremental(std::move(section.incremental)), changes(std::move(section.changes)),
+                    cached_hash(section.cached_hash.load(std::memory_order_relaxed)), cached_nodes(section.cached_nodes.load(std::memory_order_relaxed)) { this->impl_link(); section.impl_modified(); };
+                /**
+                 * @brief Construct a new Section object. The section is moved if it uses the same allocator, and copied otherwise.
+                 * @param section The section to move from
+                 * @param allocator The allocator to use
+                 */
+                Section(Section&& section, const allocator_type& allocator);
                 /**
                  * @brief Construct a new Section object
                  */
                 Section() = default;
+                /**
+                 * @brief Construct a new Section object
+                 * @param allocator The allocator to use
+                 */
+                explicit Section(const allocator_type& allocator) : properties(allocator), children(allocator) {};
                 /**
                  * @brief Destroy the Section object
                  */
@@ -356,6 +538,17 @@ namespace docpp {
                  * @param properties The properties of the section
                  */
                 void set_properties(const Properties& properties);
+                /**
+                 * @brief Set the properties of the section
+                 * @param properties The properties of the section
+                 */
+                void set_properties(Properties&& properties);
+                /**
+                 * @brief Set the value of the first property of the section with a key, or append a property if there is none
+                 * @param key The key of the property
+                 * @param value The value of the property
+                 */
+                void set_property(const string_type& key, const string_type& value);
                 /**
                  * @brief Swap two elements in the section
                  * @param index1 The index of the first element
@@ -384,12 +577,83 @@ namespace docpp {
                  * @return std::vector<Section> The sections of the section
                  */
                 [[nodiscard]] std::vector<Section> get_sections() const;
+                /**
+                 * @brief Get a view of the elements of the section, without copying them
+                 * @return View<const_iterator> The elements of the section, valid until the section is modified or destroyed
+                 */
+                [[nodiscard]] View<const_iterator> elements_view() const { return {this->begin(), this->end()}; }
+                /**
+                 * @brief Get a view of the sections of the section, without copying them
+                 * @return View<const_section_iterator> The sections of the section, valid until the section is modified or destroyed
+                 */
+                [[nodiscard]] View<const_section_iterator> sections_view() const {
+                    return {const_section_iterator(this->children.begin(), this->children.end()), const_section_iterator(this->children.end(), this->children.end())};
+                }
 
+                /**
+                 * @brief Write the entire section to a sink, as it is generated.
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                void write(Sink& sink, Formatting formatting = Formatting::None, integer_type tabc = 0) const;
+                /**
+                 * @brief Get the exact size of the section in bytes, as written by write() and returned by get(), without generating it
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @return size_type The size of the section
+                 */
+                [[nodiscard]] size_type rendered_size(Formatting formatting = Formatting::None, integer_type tabc = 0) const;
                 /**
                  * @brief Dump the entire section.
                  * @return string_type The section
                  */
                 [[nodiscard]] string_type get(Formatting formatting = Formatting::None, integer_type tabc = 0) const;
+                /**
+                 * @brief Dump the entire section, rendering it on a thread pool. Runs of sibling subtrees are written into separate buffers
+                 * by the workers and joined in document order, so the output is identical to that of get(). Subtrees too large for one
+                 * run are split further. Small sections are written by get() instead.
+                 * The section must not be modified until the call returns.
+                 * @param formatting The formatting type to use
+                 * @param pool The thread pool to render on. The calling thread helps running the pieces, so it may be a worker of the pool.
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @return string_type The section
+                 */
+                [[nodiscard]] string_type get_parallel(Formatting formatting, ThreadPool& pool, integer_type tabc = 0) const;
+                /**
+                 * @brief Freeze the section. The output of a frozen section is cached per formatting and tab count the first time it is written,
+                 * and copied into the output from then on. Copies of the section share the cache, so a section that is added to many
+                 * documents is only rendered once. The cache is keyed by a hash of the contents of the section, so changes to the section
+                 * or to its children are picked up by the next write, including changes made through a reference to a child kept from at().
+                 */
+                void freeze();
+                /**
+                 * @brief Thaw the section, dropping its cached output. Copies of the section keep sharing the cache.
+                 */
+                void thaw();
+                /**
+                 * @brief Check whether the section is frozen
+                 * @return bool True if the section is frozen
+                 */
+                [[nodiscard]] bool is_frozen() const;
+                /**
+                 * @brief Enable or disable incremental rendering. An incremental section keeps the output of its last write, split into small
+                 * subtrees, and only renders the subtrees modified since then again when it is written; the rest is copied from the cache.
+                 * Every child is linked to the section it is in, and a modified child resets the cached hash of every section above it,
+                 * whether it is modified through its parent or through a reference kept from at() or at_section(), so only the sections
+                 * on the path to a change are walked. Of a section with many children, only the children noted in its log of modified
+                 * children are walked.
+                 * This suits a long-lived section or document that is changed a little between writes. The cache is only used when the section
+                 * itself is written, not when it is written as part of another section. Copies of the section are incremental as well, with a
+                 * cache of their own.
+                 * @param incremental Whether to render the section incrementally. Disabling it drops the cache.
+                 */
+                void set_incremental(bool incremental);
+                /**
+                 * @brief Check whether the section is rendered incrementally
+                 * @return bool True if the section is rendered incrementally
+                 */
+                [[nodiscard]] bool is_incremental() const;
                 /**
                  * @brief Get the element in the form of a specific type.
                  * @return T The element in the form of a specific type
@@ -411,20 +675,54 @@ namespace docpp {
                  * @return T The tag of the section
                  */
                 template <typename T> T get_tag() const {
-                    if (std::is_same_v<T, string_type>) {
-                        return this->tag;
-                    }
-                    return T(this->tag);
+                    return T(this->get_tag());
                 }
+                /**
+                 * @brief Get a view of the tag of the section, without copying it
+                 * @return std::string_view The tag of the section, valid until the section is modified or destroyed
+                 */
+                [[nodiscard]] std::string_view tag_view() const { return this->tag.view(); }
+                /**
+                 * @brief Get the tag of the section as a handle, which compares equal to another tag by address if the tag is interned
+                 * @return InternedString The tag of the section
+                 */
+                [[nodiscard]] InternedString interned_tag() const { return this->tag; }
                 /**
                  * @brief Get the properties of the section
                  * @return Properties The properties of the section
                  */
                 [[nodiscard]] Properties get_properties() const;
+                /**
+                 * @brief Get a reference to the properties of the section, without copying them
+                 * @return const Properties& The properties of the section, valid until the section is destroyed
+                 */
+                [[nodiscard]] const Properties& properties_ref() const { return this->properties; }
+                /**
+                 * @brief Get a reference to the children of the section, erased slots included, without copying them
+                 * @return const children_type& The children of the section, valid until the section is modified or destroyed
+                 */
+                [[nodiscard]] const children_type& children_ref() const { return this->children; }
+                /**
+                 * @brief Get the allocator the section allocates its tag, properties and children with
+                 * @return allocator_type The allocator
+                 */
+                [[nodiscard]] allocator_type get_allocator() const;
+                /**
+                 * @brief Get a hash of the tag, properties and children of the section. The hashes of the section, its nested sections and
+                 * its elements are cached, and only the ones modified since they were last hashed are computed again. Modifying a child,
+                 * also through a reference to it, resets the cached hashes of the sections above it. A section with many children keeps a log
+                 * of the ones modified, so that only those are hashed again rather than all of their siblings.
+                 * Equal sections have equal hashes, so sections with different hashes can be told apart without comparing them.
+                 * @return std::uint64_t The hash, never 0
+                 */
+                [[nodiscard]] std::uint64_t hash() const;
 
                 Section& operator=(const Section& section);
+                Section& operator=(Section&& section);
                 Section& operator+=(const Element& element);
                 Section& operator+=(const Section& section);
+                Section& operator+=(Element&& element);
+                Section& operator+=(Section&& section);
                 bool operator==(const Element& element) const;
                 bool operator==(const Section& section) const;
                 bool operator!=(const Element& element) const;
@@ -433,14 +731,188 @@ namespace docpp {
                 std::unordered_map<string_type, Element> operator[](const string_type& tag) const;
                 std::unordered_map<string_type, Element> operator[](Tag tag) const;
             private:
-                size_type index{};
-                string_type tag{};
+                friend class Element;
+
+                InternedString tag{};
                 Properties properties{};
 
-                std::map<size_type, Element> elements{};
-                std::unordered_map<size_type, Section> sections{};
+                children_type children{};
+                /**
+                 * @brief The section the section is a child of, or nullptr. Set by the parent, and never copied or moved with the section.
+                 */
+                Section* parent{nullptr};
+
+                struct impl_prerendered;
+                std::shared_ptr<impl_prerendered> prerendered{};
+                struct impl_incremental;
+                std::shared_ptr<impl_incremental> incremental{};
+                /**
+                 * @brief The log of the children modified since the section was last hashed, kept by sections with many children, so that
+                 * hashing and incremental writes only walk the children that have changed. Moved along with the children, never copied,
+                 * and dropped when children are moved to other indices. Only changed by const members while holding a lock.
+                 */
+                struct impl_changes;
+                mutable std::shared_ptr<impl_changes> changes{};
+                /**
+                 * @brief The hash of the section, or 0 if it has not been computed since the section or one of its children was last modified.
+                 * A modified child resets it through its link to the section. If it is 0, it is 0 for every section above it as well.
+                 */
+                mutable std::atomic<std::uint64_t> cached_hash{0};
+                /**
+                 * @brief The number of sections and elements in the section, including itself. Computed along with the hash, and valid while it is.
+                 */
+                mutable std::atomic<size_type> cached_nodes{0};
+
+                /**
+                 * @brief Copy a child, allocated with the section's allocator, to the end of a list of children
+                 * @param children The list of children to append to
+                 * @param node The child to copy
+                 */
+                static void impl_push_back(children_type& children, const node_type& node);
+                /**
+                 * @brief Move a child to the end of a list of children. It is copied if it does not use the list's allocator.
+                 * @param children The list of children to append to
+                 * @param node The child to move
+                 */
+                static void impl_push_back(children_type& children, node_type&& node);
+                /**
+                 * @brief Write the start tag of the section, followed by a newline if the formatting calls for one
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents, when using Formatting::Pretty
+                 */
+                void impl_write_open(Sink& sink, Formatting formatting, integer_type tabc) const;
+                /**
+                 * @brief Write the end tag of the section
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents, when using Formatting::Pretty
+                 */
+                void impl_write_close(Sink& sink, Formatting formatting, integer_type tabc) const;
+                /**
+                 * @brief Write the entire section to a sink
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @param prerendered Whether to use the cached output if the section is frozen. The cached output of frozen children is always used.
+                 * @param preformatted Whether the section is inside a pre, textarea, script or style section, where whitespace is kept with Formatting::Minified
+                 * @param close Whether to write the end tag; only false with Formatting::Minified, when it is implied by what follows the section
+                 */
+                void impl_write(Sink& sink, Formatting formatting, integer_type tabc, bool prerendered, bool preformatted = false, bool close = true) const;
+                /**
+                 * @brief Write the cached output of a frozen section, rendering it first if the section has changed since it was cached
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 * @param preformatted Whether the section is inside a pre, textarea, script or style section
+                 * @param close Whether to write the end tag
+                 */
+                void impl_write_prerendered(Sink& sink, Formatting formatting, integer_type tabc, bool preformatted, bool close) const;
+                /**
+                 * @brief Check whether a child writes its end tag with Formatting::Minified, which depends on the child that follows it
+                 * @param index The index of the child
+                 * @return bool False if the end tag of the child is implied by what follows it
+                 */
+                [[nodiscard]] bool impl_minify_close(size_type index) const;
+                /**
+                 * @brief Check whether the children of the section are written with their whitespace kept with Formatting::Minified
+                 * @param formatting The formatting type to use
+                 * @param preformatted Whether the section is inside a pre, textarea, script or style section
+                 * @return bool True if whitespace in the children is kept
+                 */
+                [[nodiscard]] bool impl_keeps_whitespace(Formatting formatting, bool preformatted) const;
+                /**
+                 * @brief Write the entire section, copying the subtrees that have not changed since the last write from the incremental cache
+                 * @param sink The sink to write to
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                void impl_write_incremental(Sink& sink, Formatting formatting, integer_type tabc) const;
+                /**
+                 * @brief Get an empty incremental cache for a copy of a section
+                 * @param incremental The cache of the section that is copied
+                 * @return std::shared_ptr<impl_incremental> A new cache, or nullptr if the section is not incremental
+                 */
+                static std::shared_ptr<impl_incremental> impl_copy_incremental(const std::shared_ptr<impl_incremental>& incremental);
+                /**
+                 * @brief Mark the section as modified, resetting its cached hash and the cached hashes of the sections above it
+                 */
+                void impl_modified();
+                /**
+                 * @brief Mark a child as modified, noting it in the log of the section, and mark the section as modified
+                 * @param child The address of the element or section
+                 * @param section Whether the child is a section
+                 * @param hash The cached hash of the child before it was modified, not 0
+                 * @param nodes The number of nodes in the child before it was modified
+                 */
+                void impl_modified(const void* child, bool section, std::uint64_t hash, size_type nodes);
+                /**
+                 * @brief Mark the child at an index as about to be replaced or added, noting it in the log of the section, and mark the section as modified
+                 * @param index The index of the child, which may be past the end
+                 */
+                void impl_modified(size_type index);
+                /**
+                 * @brief Note a child in the log of the section, if it keeps one
+                 * @param index The index of the child
+                 * @param section Whether the child is a section
+                 * @param hash The cached hash of the child when the section was last hashed, or 0 if it was not there
+                 * @param nodes The number of nodes in the child when the section was last hashed
+                 */
+                void impl_log(size_type index, bool section, std::uint64_t hash, size_type nodes) noexcept;
+                /**
+                 * @brief Link a child to the section, so that modifying it marks the section as modified
+                 * @param node The child
+                 */
+                void impl_link(node_type& node);
+                /**
+                 * @brief Link every child to the section, after the section or its list of children has moved
+                 */
+                void impl_link();
+                /**
+                 * @brief Link the children after a child was added at an index. The children on the side of it where the first or last
+                 * child has moved are linked again, and every child if both have, as the list was reallocated.
+                 * @param index The index of the added child
+                 * @param first The address of the first child before the child was added, or nullptr if there was none
+                 * @param last The address of the last child before the child was added, or nullptr if there was none
+                 * @return node_type& The added child
+                 */
+                node_type& impl_link(size_type index, const node_type* first, const node_type* last);
+                /**
+                 * @brief Add a child before the child at an index, and link the children
+                 * @param index The index to add the child at, at most size()
+                 * @param node The child, allocated with the section's allocator
+                 * @return node_type& The added child
+                 */
+                node_type& impl_emplace(size_type index, node_type&& node);
+                /**
+                 * @brief Construct a child with the section's allocator
+                 * @param args The arguments to construct the child with
+                 * @return node_type The child
+                 */
+                template <typename T, typename... Args> node_type impl_make_node(Args&&... args) const {
+                    static_assert(std::is_same_v<T, Element> || std::is_same_v<T, Section>, "Only elements and sections can be added to a section");
+
+                    if constexpr (std::is_constructible_v<T, Args&&..., const allocator_type&>) {
+                        return node_type{std::in_place_type<T>, std::forward<Args>(args)..., this->get_allocator()};
+                    } else {
+                        return node_type{std::in_place_type<T>, T(std::forward<Args>(args)...), this->get_allocator()};
+                    }
+                }
         };
 
-        template <typename... Args> Section make_section_container(Args&&... args) { return Section(docpp::HTML::Tag::Empty, {}, {std::forward<Args>(args)...}); }
+        template <typename... Args> Section make_section_container(Args&&... args) {
+            Section section{docpp::HTML::Tag::Empty};
+            (section.push_back(std::forward<Args>(args)), ...);
+            return section;
+        }
     } // namespace HTML
-} // namespace docpp
\ No newline at end of file
+} // namespace docpp
+
+namespace std {
+    /**
+     * @brief Hash a section by its structural hash, see docpp::HTML::Section::hash()
+     */
+    template <> struct hash<docpp::HTML::Section> {
+        size_t operator()(const docpp::HTML::Section& section) const { return static_cast<size_t>(section.hash()); }
+    };
+} // namespace std
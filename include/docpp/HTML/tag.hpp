@@ -6,10 +6,15 @@
  */
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <docpp/types.hpp>
-#include <docpp/HTML/tag.hpp>
+#include <docpp/except.hpp>
+#include <docpp/intern.hpp>
 #include <docpp/HTML/type_enum.hpp>
 
 /**
@@ -169,10 +174,322 @@ namespace docpp {
             Video, /* <video></video> */
             Wbr, /* <wbr></wbr> */
             Xmp, /* <xmp></xmp> */
+            Raw, /* Trusted markup, that is never escaped and ignores any formatting by get() calls. */
+            Slot, /* A hole in a Template, named by the data of the element. */
         };
 
         /**
-         * @brief Get a map of tags to strings and types.
+         * @brief An entry in the tag table.
+         */
+        struct impl_tag_entry {
+            Tag tag{Tag::Empty};
+            std::string_view name{};
+            Type type{Type::Non_Self_Closing};
+        };
+
+        /**
+         * @brief Table of tag names and types, indexed by the Tag enum. Entries must be kept in the same order as the enum.
+         */
+        inline constexpr std::array<impl_tag_entry, 147> impl_tag_table{{
+                {Tag::Empty, "", Type::Text},
+                {Tag::Empty_No_Formatting, "", Type::Text_No_Formatting},
+                {Tag::Abbreviation, "abbr", Type::Non_Self_Closing},
+                {Tag::Abbr, "abbr", Type::Non_Self_Closing},
+                {Tag::Acronym, "acronym", Type::Non_Self_Closing},
+                {Tag::Address, "address", Type::Non_Self_Closing},
+                {Tag::Anchor, "a", Type::Non_Self_Closing},
+                {Tag::A, "a", Type::Non_Self_Closing},
+                {Tag::Applet, "applet", Type::Non_Self_Closing},
+                {Tag::Article, "article", Type::Non_Self_Closing},
+                {Tag::Area, "area", Type::Self_Closing},
+                {Tag::Aside, "aside", Type::Non_Self_Closing},
+                {Tag::Audio, "audio", Type::Non_Self_Closing},
+                {Tag::Base, "base", Type::Self_Closing},
+                {Tag::Basefont, "basefont", Type::Self_Closing},
+                {Tag::Bdi, "bdi", Type::Non_Self_Closing},
+                {Tag::Bdo, "bdo", Type::Non_Self_Closing},
+                {Tag::Bgsound, "bgsound", Type::Non_Self_Closing},
+                {Tag::Big, "big", Type::Non_Self_Closing},
+                {Tag::Blockquote, "blockquote", Type::Non_Self_Closing},
+                {Tag::Body, "body", Type::Non_Self_Closing},
+                {Tag::Bold, "b", Type::Non_Self_Closing},
+                {Tag::B, "b", Type::Non_Self_Closing},
+                {Tag::Br, "br", Type::Self_Closing},
+                {Tag::Break, "br", Type::Self_Closing},
+                {Tag::Button, "button", Type::Non_Self_Closing},
+                {Tag::Caption, "caption", Type::Non_Self_Closing},
+                {Tag::Canvas, "canvas", Type::Non_Self_Closing},
+                {Tag::Center, "center", Type::Non_Self_Closing},
+                {Tag::Cite, "cite", Type::Non_Self_Closing},
+                {Tag::Code, "code", Type::Non_Self_Closing},
+                {Tag::Colgroup, "colgroup", Type::Non_Self_Closing},
+                {Tag::Col, "col", Type::Self_Closing},
+                {Tag::Column, "col", Type::Self_Closing},
+                {Tag::Data, "data", Type::Non_Self_Closing},
+                {Tag::Datalist, "datalist", Type::Non_Self_Closing},
+                {Tag::Dd, "dd", Type::Non_Self_Closing},
+                {Tag::Dfn, "dfn", Type::Non_Self_Closing},
+                {Tag::Define, "dfn", Type::Non_Self_Closing},
+                {Tag::Delete, "del", Type::Non_Self_Closing},
+                {Tag::Del, "del", Type::Non_Self_Closing},
+                {Tag::Details, "details", Type::Non_Self_Closing},
+                {Tag::Dialog, "dialog", Type::Non_Self_Closing},
+                {Tag::Dir, "dir", Type::Non_Self_Closing},
+                {Tag::Div, "div", Type::Non_Self_Closing},
+                {Tag::Dl, "dl", Type::Non_Self_Closing},
+                {Tag::Dt, "dt", Type::Non_Self_Closing},
+                {Tag::Embed, "embed", Type::Self_Closing},
+                {Tag::Fieldset, "fieldset", Type::Non_Self_Closing},
+                {Tag::Figcaption, "figcaption", Type::Non_Self_Closing},
+                {Tag::Figure, "figure", Type::Non_Self_Closing},
+                {Tag::Font, "font", Type::Non_Self_Closing},
+                {Tag::Footer, "footer", Type::Non_Self_Closing},
+                {Tag::Form, "form", Type::Non_Self_Closing},
+                {Tag::Frame, "frame", Type::Self_Closing},
+                {Tag::Frameset, "frameset", Type::Non_Self_Closing},
+                {Tag::Head, "head", Type::Non_Self_Closing},
+                {Tag::Header, "header", Type::Non_Self_Closing},
+                {Tag::H1, "h1", Type::Non_Self_Closing},
+                {Tag::H2, "h2", Type::Non_Self_Closing},
+                {Tag::H3, "h3", Type::Non_Self_Closing},
+                {Tag::H4, "h4", Type::Non_Self_Closing},
+                {Tag::H5, "h5", Type::Non_Self_Closing},
+                {Tag::H6, "h6", Type::Non_Self_Closing},
+                {Tag::Hgroup, "hgroup", Type::Non_Self_Closing},
+                {Tag::Hr, "hr", Type::Self_Closing},
+                {Tag::Html, "html", Type::Non_Self_Closing},
+                {Tag::Iframe, "iframe", Type::Non_Self_Closing},
+                {Tag::Image, "img", Type::Self_Closing},
+                {Tag::Img, "img", Type::Self_Closing},
+                {Tag::Input, "input", Type::Self_Closing},
+                {Tag::Ins, "ins", Type::Non_Self_Closing},
+                {Tag::Isindex, "isindex", Type::Self_Closing},
+                {Tag::Italic, "i", Type::Non_Self_Closing},
+                {Tag::I, "i", Type::Non_Self_Closing},
+                {Tag::Kbd, "kbd", Type::Non_Self_Closing},
+                {Tag::Keygen, "keygen", Type::Self_Closing},
+                {Tag::Label, "label", Type::Non_Self_Closing},
+                {Tag::Legend, "legend", Type::Non_Self_Closing},
+                {Tag::List, "li", Type::Non_Self_Closing},
+                {Tag::Li, "li", Type::Non_Self_Closing},
+                {Tag::Link, "link", Type::Self_Closing},
+                {Tag::Main, "main", Type::Non_Self_Closing},
+                {Tag::Mark, "mark", Type::Non_Self_Closing},
+                {Tag::Marquee, "marquee", Type::Non_Self_Closing},
+                {Tag::Menuitem, "menuitem", Type::Non_Self_Closing},
+                {Tag::Meta, "meta", Type::Self_Closing},
+                {Tag::Meter, "meter", Type::Non_Self_Closing},
+                {Tag::Nav, "nav", Type::Non_Self_Closing},
+                {Tag::Nobreak, "nobr", Type::Non_Self_Closing},
+                {Tag::Nobr, "nobr", Type::Non_Self_Closing},
+                {Tag::Noembed, "noembed", Type::Non_Self_Closing},
+                {Tag::Noscript, "noscript", Type::Non_Self_Closing},
+                {Tag::Object, "object", Type::Non_Self_Closing},
+                {Tag::Optgroup, "optgroup", Type::Non_Self_Closing},
+                {Tag::Option, "option", Type::Non_Self_Closing},
+                {Tag::Output, "output", Type::Non_Self_Closing},
+                {Tag::Paragraph, "p", Type::Non_Self_Closing},
+                {Tag::P, "p", Type::Non_Self_Closing},
+                {Tag::Param, "param", Type::Self_Closing},
+                {Tag::Phrase, "phrase", Type::Non_Self_Closing},
+                {Tag::Pre, "pre", Type::Non_Self_Closing},
+                {Tag::Progress, "progress", Type::Non_Self_Closing},
+                {Tag::Quote, "q", Type::Non_Self_Closing},
+                {Tag::Q, "q", Type::Non_Self_Closing},
+                {Tag::Rp, "rp", Type::Non_Self_Closing},
+                {Tag::Rt, "rt", Type::Non_Self_Closing},
+                {Tag::Ruby, "ruby", Type::Non_Self_Closing},
+                {Tag::Outdated, "s", Type::Non_Self_Closing},
+                {Tag::S, "s", Type::Non_Self_Closing},
+                {Tag::Sample, "samp", Type::Non_Self_Closing},
+                {Tag::Samp, "samp", Type::Non_Self_Closing},
+                {Tag::Script, "script", Type::Non_Self_Closing},
+                {Tag::Section, "section", Type::Non_Self_Closing},
+                {Tag::Small, "small", Type::Non_Self_Closing},
+                {Tag::Source, "source", Type::Non_Self_Closing},
+                {Tag::Spacer, "spacer", Type::Non_Self_Closing},
+                {Tag::Span, "span", Type::Non_Self_Closing},
+                {Tag::Strike, "strike", Type::Non_Self_Closing},
+                {Tag::Strong, "strong", Type::Non_Self_Closing},
+                {Tag::Style, "style", Type::Non_Self_Closing},
+                {Tag::Sub, "sub", Type::Non_Self_Closing},
+                {Tag::Subscript, "sub", Type::Non_Self_Closing},
+                {Tag::Sup, "sup", Type::Non_Self_Closing},
+                {Tag::Superscript, "sup", Type::Non_Self_Closing},
+                {Tag::Summary, "summary", Type::Non_Self_Closing},
+                {Tag::Svg, "svg", Type::Self_Closing},
+                {Tag::Table, "table", Type::Non_Self_Closing},
+                {Tag::Tbody, "tbody", Type::Non_Self_Closing},
+                {Tag::Td, "td", Type::Non_Self_Closing},
+                {Tag::Template, "template", Type::Non_Self_Closing},
+                {Tag::Tfoot, "tfoot", Type::Non_Self_Closing},
+                {Tag::Th, "th", Type::Non_Self_Closing},
+                {Tag::Thead, "thead", Type::Non_Self_Closing},
+                {Tag::Time, "time", Type::Non_Self_Closing},
+                {Tag::Title, "title", Type::Non_Self_Closing},
+                {Tag::Tr, "tr", Type::Non_Self_Closing},
+                {Tag::Track, "track", Type::Self_Closing},
+                {Tag::Tt, "tt", Type::Non_Self_Closing},
+                {Tag::Underline, "u", Type::Non_Self_Closing},
+                {Tag::U, "u", Type::Non_Self_Closing},
+                {Tag::Var, "var", Type::Non_Self_Closing},
+                {Tag::Video, "video", Type::Non_Self_Closing},
+                {Tag::Wbr, "wbr", Type::Self_Closing},
+                {Tag::Xmp, "xmp", Type::Non_Self_Closing},
+                {Tag::Raw, "", Type::Raw},
+                {Tag::Slot, "", Type::Slot},
+        }};
+
+        /**
+         * @brief Check that every entry in the tag table is stored at the index of its tag.
+         * @return bool True if the table is ordered correctly
+         */
+        constexpr bool impl_tag_table_is_ordered() {
+            for (size_type i{0}; i < impl_tag_table.size(); i++) {
+                if (static_cast<size_type>(impl_tag_table[i].tag) != i) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static_assert(impl_tag_table_is_ordered(), "impl_tag_table must be ordered like the Tag enum");
+
+        /**
+         * @brief Size of the reverse lookup table. Must be a power of two.
+         */
+        inline constexpr size_type impl_tag_hash_size{1024};
+        /**
+         * @brief Seed for the reverse lookup hash. Chosen so that every distinct tag name gets its own slot.
+         */
+        inline constexpr std::uint32_t impl_tag_hash_seed{10698};
+        /**
+         * @brief Marker for an unused slot in the reverse lookup table.
+         */
+        inline constexpr std::uint8_t impl_tag_hash_empty{0xFF};
+
+        /**
+         * @brief Hash a tag name into a slot of the reverse lookup table.
+         * @param name The tag name
+         * @param seed The seed to use
+         * @return size_type The slot
+         */
+        constexpr size_type impl_tag_hash(const std::string_view name, const std::uint32_t seed = impl_tag_hash_seed) {
+            std::uint32_t hash{2166136261U ^ seed};
+
+            for (const char c : name) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 16777619U;
+            }
+
+            hash ^= hash >> 15;
+
+            return hash & (impl_tag_hash_size - 1);
+        }
+
+        /**
+         * @brief Build the reverse lookup table. Aliases (e.g. Tag::Bold and Tag::B) resolve to the tag declared first.
+         * @return std::array<std::uint8_t, impl_tag_hash_size> Slots holding an index into impl_tag_table, or impl_tag_hash_empty
+         */
+        constexpr std::array<std::uint8_t, impl_tag_hash_size> impl_make_tag_hash_table() {
+            std::array<std::uint8_t, impl_tag_hash_size> ret{};
+
+            for (auto& it : ret) {
+                it = impl_tag_hash_empty;
+            }
+
+            for (size_type i{0}; i < impl_tag_table.size(); i++) {
+                if (impl_tag_table[i].name.empty()) {
+                    continue;
+                }
+
+                const size_type slot{impl_tag_hash(impl_tag_table[i].name)};
+
+                if (ret[slot] == impl_tag_hash_empty) {
+                    ret[slot] = static_cast<std::uint8_t>(i);
+                }
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief The reverse lookup table, from tag name hash to index into impl_tag_table.
+         */
+        inline constexpr std::array<std::uint8_t, impl_tag_hash_size> impl_tag_hash_table{impl_make_tag_hash_table()};
+
+        /**
+         * @brief Check that no two distinct tag names share a slot in the reverse lookup table.
+         * @return bool True if the hash is perfect
+         */
+        constexpr bool impl_tag_hash_is_perfect() {
+            for (const impl_tag_entry& it : impl_tag_table) {
+                if (it.name.empty()) {
+                    continue;
+                }
+
+                if (impl_tag_table[impl_tag_hash_table[impl_tag_hash(it.name)]].name != it.name) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static_assert(impl_tag_hash_is_perfect(), "impl_tag_hash_seed no longer yields a perfect hash; pick another seed");
+
+        /**
+         * @brief Get the name of a tag, without allocating.
+         * @param tag The tag
+         * @return std::string_view The name of the tag
+         */
+        constexpr std::string_view get_tag_name(const Tag tag) {
+            if (static_cast<size_type>(tag) >= impl_tag_table.size()) {
+                throw docpp::invalid_argument{"Invalid tag"};
+            }
+
+            return impl_tag_table[static_cast<size_type>(tag)].name;
+        }
+        /**
+         * @brief Get the type of a tag.
+         * @param tag The tag
+         * @return Type The type of the tag
+         */
+        constexpr Type get_tag_type(const Tag tag) {
+            if (static_cast<size_type>(tag) >= impl_tag_table.size()) {
+                throw docpp::invalid_argument{"Invalid tag"};
+            }
+
+            return impl_tag_table[static_cast<size_type>(tag)].type;
+        }
+        /**
+         * @brief Find the tag with a name, without allocating. An empty name resolves to Tag::Empty.
+         * @param name The name of the tag
+         * @return std::optional<Tag> The tag, or std::nullopt if there is no such tag
+         */
+        constexpr std::optional<Tag> find_tag(const std::string_view name) {
+            if (name.empty()) {
+                return Tag::Empty;
+            }
+
+            const std::uint8_t index{impl_tag_hash_table[impl_tag_hash(name)]};
+
+            if (index == impl_tag_hash_empty || impl_tag_table[index].name != name) {
+                return std::nullopt;
+            }
+
+            return impl_tag_table[index].tag;
+        }
+        /**
+         * @brief Get the interned name of a tag. The names of all tags are in the intern pool from the start.
+         * @param tag The tag
+         * @return InternedString The name of the tag
+         */
+        [[nodiscard]] InternedString get_interned_tag_name(Tag tag);
+
+        /**
+         * @brief Get a map of tags to strings and types. Kept for compatibility; prefer get_tag_name() and get_tag_type(), which do not allocate.
          * @return std::unordered_map<docpp::HTML::Tag, std::pair<string_type, docpp::HTML::Type>> The map of tags to strings and types.
          */
         std::unordered_map<docpp::HTML::Tag, std::pair<string_type, docpp::HTML::Type>> get_tag_map();
@@ -189,4 +506,4 @@ namespace docpp {
          */
         Tag resolve_tag(const string_type& tag);
     } // namespace HTML
-} // namespace docpp
+} // namespace docpp
\ No newline at end of file
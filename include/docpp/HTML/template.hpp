@@ -0,0 +1,154 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <docpp/types.hpp>
+#include <docpp/sink.hpp>
+#include <docpp/HTML/formatting_enum.hpp>
+#include <docpp/HTML/tag.hpp>
+#include <docpp/HTML/element.hpp>
+#include <docpp/HTML/section.hpp>
+#include <docpp/HTML/document.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A namespace to represent HTML elements and documents
+     */
+    namespace HTML {
+        /**
+         * @brief A class to represent a page of static markup with named holes, slots, that are filled in when it is written.
+         *
+         * The template is built from a section or document holding elements of Type::Slot (see make_slot()). It is rendered once,
+         * when the template is constructed, and split at the slots into chunks of static markup. Writing the template only writes
+         * the chunks and the values of the slots, without walking or serializing the tree again.
+         * Build a template once, for example as a static local, and write it for every page.
+         *
+         * The formatting, indentation and escaping are fixed when the template is built. Values are escaped if the slot element,
+         * or the document or sink the template was built with, is escaping. Frozen and incremental sections are rendered rather than
+         * written from their cached output, so that the slots inside them are seen.
+         */
+        class Template {
+            private:
+                struct impl_piece {
+                    size_type size{0};
+                    size_type slot{0};
+                    bool escape{false};
+                };
+
+                string_type markup{};
+                std::vector<impl_piece> pieces{};
+                std::vector<string_type> slots{};
+
+                /**
+                 * @brief Build the template from the output of a section or document
+                 * @param node The section or document to build the template from
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                template <typename T> void impl_build(const T& node, Formatting formatting, integer_type tabc);
+            public:
+                /**
+                 * @brief The npos value
+                 */
+                static constexpr size_type npos = -1;
+
+                /**
+                 * @brief Construct a new Template object
+                 * @param section The section to build the template from
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                explicit Template(const Section& section, Formatting formatting = Formatting::None, integer_type tabc = 0);
+                /**
+                 * @brief Construct a new Template object
+                 * @param document The document to build the template from
+                 * @param formatting The formatting type to use
+                 * @param tabc Number of tab indents to start with, when using Formatting::Pretty
+                 */
+                explicit Template(const Document& document, Formatting formatting = Formatting::None, integer_type tabc = 0);
+                /**
+                 * @brief Construct a new Template object
+                 * @param t The template to set
+                 */
+                Template(const Template& t) = default;
+                /**
+                 * @brief Construct a new Template object
+                 * @param t The template to move from
+                 */
+                Template(Template&& t) noexcept = default;
+                /**
+                 * @brief Construct a new, empty Template object
+                 */
+                Template() = default;
+                /**
+                 * @brief Destroy the Template object
+                 */
+                ~Template() = default;
+
+                /**
+                 * @brief Get the names of the slots, in the order their values are passed to write() and get()
+                 * @return const std::vector<string_type>& The names of the slots. A slot used more than once is listed once.
+                 */
+                [[nodiscard]] const std::vector<string_type>& get_slots() const;
+                /**
+                 * @brief Find a slot by name
+                 * @param name The name of the slot
+                 * @return size_type The index of the slot, or npos if there is no such slot
+                 */
+                [[nodiscard]] size_type find(std::string_view name) const;
+                /**
+                 * @brief Get the number of slots
+                 * @return size_type The number of slots
+                 */
+                [[nodiscard]] size_type size() const;
+                /**
+                 * @brief Get the size of the static markup of the template, without the values of the slots
+                 * @return size_type The size of the static markup
+                 */
+                [[nodiscard]] size_type static_size() const;
+                /**
+                 * @brief Write the template to a sink, with values for its slots
+                 * @param sink The sink to write to
+                 * @param values The values of the slots, in the order of get_slots()
+                 */
+                void write(Sink& sink, const std::vector<std::string_view>& values) const;
+                /**
+                 * @brief Get the exact size of the template in bytes, as written by write() and returned by get(), without generating it
+                 * @param values The values of the slots, in the order of get_slots()
+                 * @return size_type The size of the template
+                 */
+                [[nodiscard]] size_type rendered_size(const std::vector<std::string_view>& values) const;
+                /**
+                 * @brief Get the template, with values for its slots
+                 * @param values The values of the slots, in the order of get_slots()
+                 * @return string_type The template
+                 */
+                [[nodiscard]] string_type get(const std::vector<std::string_view>& values) const;
+
+                Template& operator=(const Template& t) = default;
+                Template& operator=(Template&& t) noexcept = default;
+        };
+
+        /**
+         * @brief Make a slot, an element that is filled in when a Template is written
+         * @param name The name of the slot
+         * @param escape Whether the value of the slot is escaped
+         * @return Element The slot
+         */
+        inline Element make_slot(const string_type& name, const bool escape = false) {
+            Element ret{Tag::Slot, {}, name};
+            ret.set_escaping(escape);
+            return ret;
+        }
+    } // namespace HTML
+} // namespace docpp
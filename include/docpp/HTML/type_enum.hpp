@@ -24,6 +24,8 @@ namespace docpp {
             Non_Opened, /* Non-opened element (</tag>) */
             Text_No_Formatting, /* Text element with no formatting (my text here). */
             Text, /* Text element with tab characters appropriately prepended (my text here). Note that this does *not* append a newline character. */
+            Raw, /* Trusted markup, written as-is (<b>my markup here</b>). Never escaped, and ignores formatting. */
+            Slot, /* A hole in a Template, named by the data of the element, and filled in when the template is written. Written as nothing outside of a template. */
         };
     }
 } // namespace docpp
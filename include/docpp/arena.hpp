@@ -0,0 +1,97 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+#include <docpp/stats.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief The allocator used by the HTML object model. A default-constructed allocator allocates from the heap.
+     */
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+    /**
+     * @brief The string type objects use to store their tags, data and attributes internally.
+     */
+    using pmr_string = std::pmr::string;
+
+    /**
+     * @brief A class to represent a memory arena. Every object constructed with its allocator, and every object stored in such an
+     * object, is allocated from the arena. Memory is only given back when the arena is released or destroyed, all at once.
+     * The arena must outlive every object allocated from it.
+     */
+    class Arena {
+        private:
+            std::pmr::monotonic_buffer_resource resource{};
+        public:
+            /**
+             * @brief Construct a new Arena object
+             */
+            Arena() = default;
+            /**
+             * @brief Construct a new Arena object
+             * @param initial_size The size of the first block allocated from the heap
+             */
+            explicit Arena(size_type initial_size) : resource(initial_size) {};
+            /**
+             * @brief Construct a new Arena object, which allocates from a buffer until it is exhausted
+             * @param buffer The buffer to allocate from
+             * @param size The size of the buffer
+             */
+            Arena(void* buffer, size_type size) : resource(buffer, size) {};
+            Arena(const Arena& arena) = delete;
+            Arena& operator=(const Arena& arena) = delete;
+            /**
+             * @brief Destroy the Arena object, releasing all memory at once
+             */
+            ~Arena() = default;
+
+            /**
+             * @brief Get the memory resource of the arena
+             * @return std::pmr::memory_resource* The memory resource
+             */
+            [[nodiscard]] std::pmr::memory_resource* get_resource();
+            /**
+             * @brief Get an allocator that allocates from the arena
+             * @return allocator_type The allocator
+             */
+            [[nodiscard]] allocator_type get_allocator();
+            /**
+             * @brief Release all memory allocated from the arena. Objects allocated from the arena must not be used afterwards.
+             */
+            void release();
+
+            operator allocator_type(); // NOLINT(google-explicit-constructor)
+    };
+
+    /**
+     * @brief Convert an internally stored string to a string_type.
+     * @param str The string to convert
+     * @return string_type The converted string
+     */
+    inline string_type impl_to_string(const pmr_string& str) {
+        impl_stats_add_string(str.size());
+        return string_type(str.data(), str.size());
+    }
+    /**
+     * @brief Convert a string_type to an internally stored string, allocated with an allocator.
+     * @param str The string to convert
+     * @param allocator The allocator to use
+     * @return pmr_string The converted string
+     */
+    inline pmr_string impl_to_pmr_string(const std::string_view str, const allocator_type& allocator) {
+        impl_stats_add_string(str.size());
+        return pmr_string(str.data(), str.size(), allocator);
+    }
+} // namespace docpp
\ No newline at end of file
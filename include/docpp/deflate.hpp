@@ -0,0 +1,112 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <docpp/types.hpp>
+#include <docpp/sink.hpp>
+
+#ifdef DOCPP_WITH_ZLIB
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief The container format written by a DeflateSink
+     */
+    enum class DeflateFormat {
+        Gzip, /* Content-Encoding: gzip */
+        Zlib, /* Content-Encoding: deflate */
+        Raw, /* Raw deflate, without a header or checksum */
+    };
+
+    /**
+     * @brief A piece of output compressed ahead of time, for example a static section, to be written to a DeflateSink as-is
+     */
+    struct DeflatedChunk {
+        string_type data{};
+        std::uint32_t crc32{0};
+        std::uint32_t adler32{1};
+        size_type size{0};
+    };
+
+    /**
+     * @brief Compress a piece of output once, so that it can be written to any number of DeflateSinks without compressing it again
+     * @param data The data to compress
+     * @param level The compression level, 0 to 9, or -1 for the default
+     * @return DeflatedChunk The compressed data
+     */
+    [[nodiscard]] DeflatedChunk deflate_chunk(std::string_view data, integer_type level = -1);
+
+    /**
+     * @brief A sink that compresses data with deflate as it is written, and writes the compressed data to another sink.
+     *
+     * The output can be sent before the document is finished: flush() pushes everything written so far through the encoder,
+     * and flush_size makes the sink do so on its own every flush_size bytes. Each flush costs a few bytes of output and resets
+     * nothing, so flush where the client can start working, for example after the head of a document.
+     * The stream is finished by finish(), or when the sink is destroyed.
+     */
+    class DeflateSink : public Sink {
+        private:
+            struct impl_stream;
+
+            Sink& sink;
+            std::unique_ptr<impl_stream> stream;
+            DeflateFormat format{DeflateFormat::Gzip};
+            string_type buffer{};
+            std::uint32_t checksum{0};
+            size_type total{0};
+            size_type flush_size{0};
+            size_type unflushed{0};
+            bool aligned{true};
+            bool finished{false};
+
+            /**
+             * @brief Pass data through the encoder, writing the compressed output to the underlying sink
+             * @param data The data to compress
+             * @param flush The zlib flush mode
+             */
+            void impl_deflate(std::string_view data, int flush);
+        public:
+            /**
+             * @brief Construct a new DeflateSink object. The header of the format is written to the sink right away.
+             * @param sink The sink to write the compressed data to
+             * @param format The container format
+             * @param level The compression level, 0 to 9, or -1 for the default
+             * @param flush_size Flush after this many bytes have been written since the last flush. If 0, only flush() flushes.
+             */
+            explicit DeflateSink(Sink& sink, DeflateFormat format = DeflateFormat::Gzip, integer_type level = -1, size_type flush_size = 0);
+            /**
+             * @brief Destroy the DeflateSink object. The stream is finished, if it has not been already.
+             */
+            ~DeflateSink() override;
+
+            void write(std::string_view data) override;
+            /**
+             * @brief Compress everything written so far and push it to the underlying sink, which is flushed too
+             */
+            void flush() override;
+            /**
+             * @brief Write a chunk compressed by deflate_chunk(), without compressing it again. Compression starts over after
+             * the chunk, so data written after it cannot refer back to data before it.
+             * @param chunk The chunk to write
+             */
+            void write_deflated(const DeflatedChunk& chunk);
+            /**
+             * @brief Finish the stream, writing the end of the compressed data and the trailer of the format. Nothing can be written afterwards.
+             */
+            void finish();
+            /**
+             * @brief Get the number of bytes written to the sink, before compression
+             * @return size_type The number of bytes
+             */
+            [[nodiscard]] size_type size() const;
+    };
+} // namespace docpp
+#endif
@@ -0,0 +1,361 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A class to represent a sequence of objects in contiguous memory, like std::pmr::vector, with free space kept at
+     * both ends. Adding to the front is amortized constant time, like adding to the back, and inserting in the middle moves
+     * the objects on the shorter side of the insertion.
+     */
+    template <typename T>
+    class Devector {
+        public:
+            using value_type = T;
+            using allocator_type = std::pmr::polymorphic_allocator<T>;
+            using size_type = docpp::size_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = T&;
+            using const_reference = const T&;
+            using iterator = T*;
+            using const_iterator = const T*;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        private:
+            allocator_type allocator{};
+            T* storage{nullptr};
+            size_type first{0};
+            size_type count{0};
+            size_type allocated{0};
+
+            using traits = std::allocator_traits<allocator_type>;
+
+            /**
+             * @brief Move the objects to new storage
+             * @param capacity The capacity of the new storage
+             * @param offset The index in the new storage to move the first object to
+             */
+            void impl_reallocate(const size_type capacity, const size_type offset) {
+                T* ret{traits::allocate(this->allocator, capacity)};
+                size_type moved{0};
+
+                try {
+                    for (; moved < this->count; ++moved) {
+                        traits::construct(this->allocator, ret + offset + moved, std::move(this->storage[this->first + moved]));
+                    }
+                } catch (...) {
+                    for (size_type i{0}; i < moved; ++i) {
+                        traits::destroy(this->allocator, ret + offset + i);
+                    }
+
+                    traits::deallocate(this->allocator, ret, capacity);
+                    throw;
+                }
+
+                this->impl_release();
+                this->storage = ret;
+                this->first = offset;
+                this->allocated = capacity;
+            }
+            /**
+             * @brief Destroy the objects and free the storage, leaving the size and capacity for the caller to set
+             */
+            void impl_release() {
+                for (size_type i{0}; i < this->count; ++i) {
+                    traits::destroy(this->allocator, this->storage + this->first + i);
+                }
+
+                if (this->storage != nullptr) {
+                    traits::deallocate(this->allocator, this->storage, this->allocated);
+                }
+            }
+            /**
+             * @brief Make room for one more object at the front. Free space at the back is kept, up to half of the new free space.
+             */
+            void impl_grow_front() {
+                const size_type capacity{std::max({size_type{8}, this->count * 2, this->allocated})};
+                const size_type space{capacity - this->count};
+
+                this->impl_reallocate(capacity, space - std::min(this->allocated - this->first - this->count, space / 2));
+            }
+            /**
+             * @brief Make room for one more object at the back. Free space at the front is kept, up to half of the new free space.
+             */
+            void impl_grow_back() {
+                const size_type capacity{std::max({size_type{8}, this->count * 2, this->allocated})};
+
+                this->impl_reallocate(capacity, std::min(this->first, (capacity - this->count) / 2));
+            }
+        public:
+            /**
+             * @brief Construct a new, empty Devector object
+             */
+            Devector() = default;
+            /**
+             * @brief Construct a new, empty Devector object
+             * @param allocator The allocator to allocate the objects with
+             */
+            explicit Devector(const allocator_type& allocator) : allocator(allocator) {};
+            /**
+             * @brief Construct a new Devector object. Like std::pmr::vector, the copy allocates with the default allocator.
+             * @param d The devector to copy
+             */
+            Devector(const Devector& d) : Devector(d, allocator_type{}) {};
+            /**
+             * @brief Construct a new Devector object
+             * @param d The devector to copy
+             * @param allocator The allocator to allocate the objects with
+             */
+            Devector(const Devector& d, const allocator_type& allocator) : allocator(allocator) {
+                this->reserve(d.count);
+
+                for (const T& it : d) {
+                    this->emplace_back(it);
+                }
+            }
+            /**
+             * @brief Construct a new Devector object
+             * @param d The devector to move from
+             */
+            Devector(Devector&& d) noexcept : allocator(d.allocator), storage(std::exchange(d.storage, nullptr)), first(std::exchange(d.first, 0)),
+                count(std::exchange(d.count, 0)), allocated(std::exchange(d.allocated, 0)) {};
+            /**
+             * @brief Destroy the Devector object
+             */
+            ~Devector() {
+                this->impl_release();
+            }
+
+            Devector& operator=(const Devector& d) {
+                if (this == &d) {
+                    return *this;
+                }
+
+                this->clear();
+                this->reserve(d.count);
+
+                for (const T& it : d) {
+                    this->emplace_back(it);
+                }
+
+                return *this;
+            }
+            /**
+             * @brief Move the objects of another devector. The storage is taken over if both use the same allocator, otherwise
+             * the objects are moved one by one, as with std::pmr::vector.
+             */
+            Devector& operator=(Devector&& d) {
+                if (this == &d) {
+                    return *this;
+                }
+
+                if (this->allocator == d.allocator) {
+                    this->impl_release();
+                    this->storage = std::exchange(d.storage, nullptr);
+                    this->first = std::exchange(d.first, 0);
+                    this->count = std::exchange(d.count, 0);
+                    this->allocated = std::exchange(d.allocated, 0);
+                    return *this;
+                }
+
+                this->clear();
+                this->reserve(d.count);
+
+                for (T& it : d) {
+                    this->emplace_back(std::move(it));
+                }
+
+                d.clear();
+
+                return *this;
+            }
+
+            [[nodiscard]] iterator begin() { return this->storage + this->first; }
+            [[nodiscard]] iterator end() { return this->storage + this->first + this->count; }
+            [[nodiscard]] const_iterator begin() const { return this->storage + this->first; }
+            [[nodiscard]] const_iterator end() const { return this->storage + this->first + this->count; }
+            [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+            [[nodiscard]] const_iterator cend() const { return this->end(); }
+            [[nodiscard]] reverse_iterator rbegin() { return reverse_iterator(this->end()); }
+            [[nodiscard]] reverse_iterator rend() { return reverse_iterator(this->begin()); }
+            [[nodiscard]] const_reverse_iterator rbegin() const { return const_reverse_iterator(this->end()); }
+            [[nodiscard]] const_reverse_iterator rend() const { return const_reverse_iterator(this->begin()); }
+            [[nodiscard]] const_reverse_iterator crbegin() const { return this->rbegin(); }
+            [[nodiscard]] const_reverse_iterator crend() const { return this->rend(); }
+
+            [[nodiscard]] T& operator[](const size_type index) { return this->storage[this->first + index]; }
+            [[nodiscard]] const T& operator[](const size_type index) const { return this->storage[this->first + index]; }
+            [[nodiscard]] T& front() { return this->storage[this->first]; }
+            [[nodiscard]] const T& front() const { return this->storage[this->first]; }
+            [[nodiscard]] T& back() { return this->storage[this->first + this->count - 1]; }
+            [[nodiscard]] const T& back() const { return this->storage[this->first + this->count - 1]; }
+
+            /**
+             * @brief Get the number of objects
+             * @return size_type The number of objects
+             */
+            [[nodiscard]] size_type size() const { return this->count; }
+            /**
+             * @brief Check if the devector is empty
+             * @return bool True if there are no objects
+             */
+            [[nodiscard]] bool empty() const { return this->count == 0; }
+            /**
+             * @brief Get the allocator the objects are allocated with
+             * @return allocator_type The allocator
+             */
+            [[nodiscard]] allocator_type get_allocator() const { return this->allocator; }
+
+            /**
+             * @brief Make room for a number of objects, counting the ones already stored, to be added to the back without allocating
+             * @param size The number of objects
+             */
+            void reserve(const size_type size) {
+                if (size > this->allocated - this->first) {
+                    this->impl_reallocate(this->first + size, this->first);
+                }
+            }
+            /**
+             * @brief Destroy objects at the back, or add value-initialized objects to the back, until there are a number of objects
+             * @param size The number of objects
+             */
+            void resize(const size_type size) {
+                while (this->count > size) {
+                    this->pop_back();
+                }
+
+                this->reserve(size);
+
+                while (this->count < size) {
+                    this->emplace_back();
+                }
+            }
+            /**
+             * @brief Destroy every object. The storage is kept.
+             */
+            void clear() {
+                for (size_type i{0}; i < this->count; ++i) {
+                    traits::destroy(this->allocator, this->storage + this->first + i);
+                }
+
+                this->first = 0;
+                this->count = 0;
+            }
+            /**
+             * @brief Destroy the last object
+             */
+            void pop_back() {
+                traits::destroy(this->allocator, this->storage + this->first + --this->count);
+            }
+
+            /**
+             * @brief Construct an object at the back
+             * @param args The arguments to construct the object with
+             * @return T& The object
+             */
+            template <typename... Args> T& emplace_back(Args&&... args) {
+                if (this->first + this->count == this->allocated) {
+                    // constructed before growing, as the arguments may refer to objects in the devector
+                    T value(std::forward<Args>(args)...);
+
+                    this->impl_grow_back();
+                    traits::construct(this->allocator, this->end(), std::move(value));
+                } else {
+                    traits::construct(this->allocator, this->end(), std::forward<Args>(args)...);
+                }
+
+                ++this->count;
+                return this->back();
+            }
+            /**
+             * @brief Construct an object at the front
+             * @param args The arguments to construct the object with
+             * @return T& The object
+             */
+            template <typename... Args> T& emplace_front(Args&&... args) {
+                if (this->first == 0) {
+                    T value(std::forward<Args>(args)...);
+
+                    this->impl_grow_front();
+                    traits::construct(this->allocator, this->begin() - 1, std::move(value));
+                } else {
+                    traits::construct(this->allocator, this->begin() - 1, std::forward<Args>(args)...);
+                }
+
+                --this->first;
+                ++this->count;
+                return this->front();
+            }
+            /**
+             * @brief Construct an object before another, moving the objects before or after it, whichever are fewer
+             * @param pos The position to insert the object at
+             * @param args The arguments to construct the object with
+             * @return iterator An iterator to the object
+             */
+            template <typename... Args> iterator emplace(const_iterator pos, Args&&... args) {
+                const size_type index{static_cast<size_type>(pos - this->begin())};
+
+                if (index == this->count) {
+                    this->emplace_back(std::forward<Args>(args)...);
+                    return this->begin() + index;
+                }
+
+                if (index == 0) {
+                    this->emplace_front(std::forward<Args>(args)...);
+                    return this->begin();
+                }
+
+                T value(std::forward<Args>(args)...);
+
+                if (index < this->count - index) {
+                    if (this->first == 0) {
+                        this->impl_grow_front();
+                    }
+
+                    T* c_first{this->begin()};
+                    traits::construct(this->allocator, c_first - 1, std::move(*c_first));
+                    std::move(c_first + 1, c_first + index, c_first);
+
+                    --this->first;
+                } else {
+                    if (this->first + this->count == this->allocated) {
+                        this->impl_grow_back();
+                    }
+
+                    T* c_last{this->end()};
+                    traits::construct(this->allocator, c_last, std::move(*(c_last - 1)));
+                    std::move_backward(this->begin() + index, c_last - 1, c_last);
+                }
+
+                ++this->count;
+                this->begin()[index] = std::move(value);
+                return this->begin() + index;
+            }
+            void push_back(const T& value) { this->emplace_back(value); }
+            void push_back(T&& value) { this->emplace_back(std::move(value)); }
+            void push_front(const T& value) { this->emplace_front(value); }
+            void push_front(T&& value) { this->emplace_front(std::move(value)); }
+
+            bool operator==(const Devector& d) const {
+                return this->count == d.count && std::equal(this->begin(), this->end(), d.begin());
+            }
+            bool operator!=(const Devector& d) const {
+                return !(*this == d);
+            }
+    };
+} // namespace docpp
@@ -7,7 +7,19 @@
 #pragma once
 
 #include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+#include <docpp/deflate.hpp>
+#include <docpp/devector.hpp>
+#include <docpp/small_vector.hpp>
+#include <docpp/escape.hpp>
 #include <docpp/except.hpp>
+#include <docpp/hash.hpp>
+#include <docpp/intern.hpp>
+#include <docpp/mapped_file.hpp>
+#include <docpp/sink.hpp>
+#include <docpp/stats.hpp>
+#include <docpp/thread_pool.hpp>
 #include <docpp/version.hpp>
+#include <docpp/view.hpp>
 #include <docpp/HTML/HTML.hpp>
 #include <docpp/CSS/CSS.hpp>
\ No newline at end of file
@@ -0,0 +1,36 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief Find the first character in a string that must be escaped in HTML text or attribute values (& < > " ').
+     * Uses AVX2 or SSE2 when the library is compiled with support for it, and a scalar scan otherwise.
+     * @param str The string to search
+     * @return size_type The index of the character, or npos if there is none
+     */
+    [[nodiscard]] size_type impl_find_escape(std::string_view str);
+    /**
+     * @brief Get the entity a character is escaped as
+     * @param c The character, which must be one of & < > " '
+     * @return std::string_view The entity
+     */
+    [[nodiscard]] std::string_view impl_escape_entity(char c);
+    /**
+     * @brief Escape a string for use in HTML text or attribute values, replacing & < > " ' with their entities
+     * @param str The string to escape
+     * @return string_type The escaped string
+     */
+    [[nodiscard]] string_type escape(std::string_view str);
+} // namespace docpp
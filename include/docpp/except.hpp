@@ -39,4 +39,18 @@ namespace docpp {
             invalid_argument() = default;
             explicit invalid_argument(const char* message) : message(message) {};
     };
+
+    /**
+     * @brief A class to represent an exception when writing output fails
+     */
+    class io_error : public exception_type {
+        private:
+            const char* message{"I/O error"};
+        public:
+            [[nodiscard]] const char* what() const noexcept override {
+                return message;
+            }
+            io_error() = default;
+            explicit io_error(const char* message) : message(message) {};
+    };
 } // namespace docpp
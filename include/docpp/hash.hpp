@@ -0,0 +1,79 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief The initial value of a structural hash
+     */
+    constexpr std::uint64_t impl_hash_basis{14695981039346656037ULL};
+    /**
+     * @brief The multiplier used to mix a value into a structural hash
+     */
+    constexpr std::uint64_t impl_hash_multiplier{0x9e3779b97f4a7c15ULL};
+
+    /**
+     * @brief Mix a value into a structural hash
+     * @param hash The hash to mix the value into
+     * @param value The value
+     */
+    inline void impl_hash_value(std::uint64_t& hash, const std::uint64_t value) {
+        hash = (hash ^ value) * impl_hash_multiplier;
+        hash ^= hash >> 32;
+    }
+    /**
+     * @brief Mix a string into a structural hash, a word at a time. The size is mixed in first, so that adjacent strings
+     * cannot be mistaken for each other.
+     * @param hash The hash to mix the string into
+     * @param str The string
+     */
+    inline void impl_hash_string(std::uint64_t& hash, const std::string_view str) {
+        impl_hash_value(hash, str.size());
+
+        size_type i{0};
+        for (; i + 8 <= str.size(); i += 8) {
+            std::uint64_t word{0};
+            std::memcpy(&word, str.data() + i, 8);
+            impl_hash_value(hash, word);
+        }
+
+        if (i < str.size()) {
+            std::uint64_t word{0};
+            std::memcpy(&word, str.data() + i, str.size() - i);
+            impl_hash_value(hash, word);
+        }
+    }
+    /**
+     * @brief Mix a list of properties into a structural hash
+     * @param hash The hash to mix the properties into
+     * @param properties The properties, each with key_view() and value_view()
+     */
+    template <typename T> void impl_hash_properties(std::uint64_t& hash, const T& properties) {
+        impl_hash_value(hash, properties.size());
+
+        for (const auto& it : properties) {
+            impl_hash_string(hash, it.key_view());
+            impl_hash_string(hash, it.value_view());
+        }
+    }
+    /**
+     * @brief Finish a structural hash. 0 is reserved to mean that a cached hash has not been computed.
+     * @param hash The hash
+     * @return std::uint64_t The hash, never 0
+     */
+    constexpr std::uint64_t impl_hash_finish(const std::uint64_t hash) {
+        return hash == 0 ? 1 : hash;
+    }
+} // namespace docpp
@@ -0,0 +1,185 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <docpp/types.hpp>
+#include <docpp/arena.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    class InternPool;
+
+    /**
+     * @brief A handle to a name, used for tag names and property keys. Names held by the intern pool are stored once, so comparing
+     * two handles to them compares two pointers, and copying one copies a pointer. Any other name is not added to the pool; the
+     * handle holds a reference-counted copy of it instead, which is compared by its content. The copy is allocated with the allocator
+     * the handle is made with, and is shared by copies of the handle made with an equal allocator.
+     * The empty string is not stored; it is the default-constructed handle.
+     */
+    class InternedString {
+        private:
+            const std::string_view* entry{nullptr};
+            bool owned{false};
+
+            explicit InternedString(const std::string_view* entry) : entry(entry) {};
+
+            void impl_retain() const;
+            void impl_release();
+            void impl_copy(std::string_view str, std::pmr::memory_resource* resource);
+
+            friend class InternPool;
+        public:
+            /**
+             * @brief Construct a new InternedString object, holding the empty string
+             */
+            InternedString() = default;
+            /**
+             * @brief Construct a new InternedString object, referring to the string in the intern pool if it is there,
+             * and holding a copy of it otherwise
+             * @param str The string
+             */
+            explicit InternedString(std::string_view str);
+            /**
+             * @brief Construct a new InternedString object, referring to the string in the intern pool if it is there,
+             * and holding a copy of it, allocated with an allocator, otherwise
+             * @param str The string
+             * @param allocator The allocator to use
+             */
+            InternedString(std::string_view str, const allocator_type& allocator);
+            /**
+             * @brief Construct a new InternedString object. A copy held by the handle is shared if it was allocated with an equal
+             * allocator, and copied with the allocator otherwise.
+             * @param str The handle to copy
+             * @param allocator The allocator to use
+             */
+            InternedString(const InternedString& str, const allocator_type& allocator);
+            /**
+             * @brief Construct a new InternedString object. A copy held by the handle is taken over if it was allocated with an equal
+             * allocator, and copied with the allocator otherwise.
+             * @param str The handle to move from
+             * @param allocator The allocator to use
+             */
+            InternedString(InternedString&& str, const allocator_type& allocator);
+            /**
+             * @brief Construct a new InternedString object
+             * @param str The handle to copy
+             */
+            InternedString(const InternedString& str) noexcept : entry(str.entry), owned(str.owned) {
+                if (this->owned) {
+                    this->impl_retain();
+                }
+            }
+            /**
+             * @brief Construct a new InternedString object
+             * @param str The handle to move from
+             */
+            InternedString(InternedString&& str) noexcept : entry(str.entry), owned(str.owned) {
+                str.entry = nullptr;
+                str.owned = false;
+            }
+            /**
+             * @brief Destroy the InternedString object
+             */
+            ~InternedString() {
+                if (this->owned) {
+                    this->impl_release();
+                }
+            }
+
+            /**
+             * @brief Get a view of the string
+             * @return std::string_view The string, valid until the program exits if it is interned, and as long as a handle to it exists
+             * and the memory of its allocator is not released otherwise
+             */
+            [[nodiscard]] std::string_view view() const { return this->entry != nullptr ? *this->entry : std::string_view{}; }
+            /**
+             * @brief Get the size of the string
+             * @return size_type The size of the string
+             */
+            [[nodiscard]] size_type size() const { return this->view().size(); }
+            /**
+             * @brief Check if the string is empty
+             * @return bool True if the string is empty
+             */
+            [[nodiscard]] bool empty() const { return this->entry == nullptr; }
+            /**
+             * @brief Check if the string is held by the intern pool, rather than by the handle
+             * @return bool True if the string is interned
+             */
+            [[nodiscard]] bool is_interned() const { return !this->owned; }
+
+            InternedString& operator=(const InternedString& str) noexcept {
+                InternedString copy{str};
+                std::swap(this->entry, copy.entry);
+                std::swap(this->owned, copy.owned);
+                return *this;
+            }
+            InternedString& operator=(InternedString&& str) noexcept {
+                std::swap(this->entry, str.entry);
+                std::swap(this->owned, str.owned);
+                return *this;
+            }
+
+            bool operator==(const InternedString& str) const {
+                return this->entry == str.entry || ((this->owned || str.owned) && this->view() == str.view());
+            }
+            bool operator!=(const InternedString& str) const { return !(*this == str); }
+    };
+
+    /**
+     * @brief A class to represent the intern pool, a thread-safe table holding one copy of every interned string.
+     *
+     * There is one pool per process, rather than one per arena, so that handles from any two trees compare by address.
+     * Strings are never removed, so the pool only grows through intern(): it starts out with the names of the tag table and of
+     * common HTML attributes and CSS properties, and InternedString never adds to it, so parsing markup with arbitrary names
+     * does not grow it.
+     */
+    class InternPool {
+        private:
+            struct impl_shard;
+
+            std::unique_ptr<impl_shard[]> shards;
+
+            InternPool();
+        public:
+            InternPool(const InternPool& pool) = delete;
+            InternPool& operator=(const InternPool& pool) = delete;
+            ~InternPool();
+
+            /**
+             * @brief Get the intern pool
+             * @return InternPool& The intern pool
+             */
+            [[nodiscard]] static InternPool& get();
+
+            /**
+             * @brief Get the handle to a string, adding the string to the pool if it is not there already. The string is kept until
+             * the program exits, so this is meant for names that are used over and over.
+             * @param str The string
+             * @return InternedString The handle
+             */
+            [[nodiscard]] InternedString intern(std::string_view str);
+            /**
+             * @brief Get the handle to a string, without adding the string to the pool. A string that is not in the pool
+             * is only held by handles that hold a copy of it.
+             * @param str The string
+             * @return std::optional<InternedString> The handle, or std::nullopt if the string is not in the pool
+             */
+            [[nodiscard]] std::optional<InternedString> find(std::string_view str) const;
+            /**
+             * @brief Get the number of strings in the pool
+             * @return size_type The number of strings
+             */
+            [[nodiscard]] size_type size() const;
+    };
+} // namespace docpp
@@ -0,0 +1,53 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A class to represent a read-only file mapped into memory. On platforms without mmap(), the file is read into a buffer instead.
+     */
+    class MappedFile {
+        private:
+            const char* data{nullptr};
+            size_type length{0};
+            string_type buffer{};
+        public:
+            /**
+             * @brief Map a file into memory
+             * @param path The path to the file
+             */
+            explicit MappedFile(const string_type& path);
+            MappedFile(const MappedFile& file) = delete;
+            MappedFile& operator=(const MappedFile& file) = delete;
+            /**
+             * @brief Destroy the MappedFile object, unmapping the file
+             */
+            ~MappedFile();
+
+            /**
+             * @brief Get the contents of the file. The view is invalidated when the MappedFile is destroyed.
+             * @return std::string_view The contents of the file
+             */
+            [[nodiscard]] std::string_view view() const {
+                return {this->data, this->length};
+            }
+            /**
+             * @brief Get the size of the file
+             * @return size_type The size of the file in bytes
+             */
+            [[nodiscard]] size_type size() const {
+                return this->length;
+            }
+    };
+} // namespace docpp
@@ -0,0 +1,198 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A class to represent an output sink that serialized documents are written to, chunk by chunk.
+     */
+    class Sink {
+        private:
+            bool escaping{false};
+        public:
+            /**
+             * @brief Construct a new Sink object
+             */
+            Sink() = default;
+            Sink(const Sink& sink) = delete;
+            Sink& operator=(const Sink& sink) = delete;
+            /**
+             * @brief Destroy the Sink object
+             */
+            virtual ~Sink() = default;
+
+            /**
+             * @brief Write a chunk of data to the sink
+             * @param data The data to write
+             */
+            virtual void write(std::string_view data) = 0;
+            /**
+             * @brief Push any buffered data to the underlying destination
+             */
+            virtual void flush() {}
+            /**
+             * @brief Write a slot, an element of Type::Slot. Sinks other than the one a Template is built with write nothing.
+             * @param name The name of the slot
+             * @param escape Whether the value of the slot is to be escaped
+             */
+            virtual void write_slot(std::string_view name, bool escape) { static_cast<void>(name); static_cast<void>(escape); }
+            /**
+             * @brief Check whether the sink collects slots, in which case sections are rendered rather than copied from the cached output
+             * of frozen and incremental sections, as that does not hold the slots
+             * @return bool True if the sink collects slots
+             */
+            [[nodiscard]] virtual bool collects_slots() const { return false; }
+            /**
+             * @brief Hint that a number of bytes is about to be written, so that a sink that buffers its output can make room for them
+             * @param size The number of bytes
+             */
+            virtual void reserve(size_type size) { static_cast<void>(size); }
+            /**
+             * @brief Write a number of tab characters to the sink
+             * @param count The number of tab characters
+             */
+            void indent(integer_type count);
+            /**
+             * @brief Write a chunk of data to the sink, escaping & < > " ' as HTML entities. Runs without such characters are written in bulk.
+             * @param data The data to write
+             */
+            void write_escaped(std::string_view data);
+            /**
+             * @brief Set whether text and attribute values of HTML elements written to the sink are escaped
+             * @param escaping True to escape
+             */
+            void set_escaping(bool escaping);
+            /**
+             * @brief Check whether text and attribute values of HTML elements written to the sink are escaped
+             * @return bool True if they are escaped
+             */
+            [[nodiscard]] bool is_escaping() const;
+    };
+
+    /**
+     * @brief A sink that appends to a string
+     */
+    class StringSink : public Sink {
+        private:
+            string_type& str;
+        public:
+            /**
+             * @brief Construct a new StringSink object
+             * @param str The string to append to
+             */
+            explicit StringSink(string_type& str) : str(str) {};
+            /**
+             * @brief Destroy the StringSink object
+             */
+            ~StringSink() override = default;
+
+            void write(std::string_view data) override;
+            void reserve(size_type size) override;
+    };
+
+    /**
+     * @brief A sink that discards data, only counting the number of bytes written to it
+     */
+    class CountingSink : public Sink {
+        private:
+            size_type count{0};
+        public:
+            /**
+             * @brief Construct a new CountingSink object
+             */
+            CountingSink() = default;
+            /**
+             * @brief Destroy the CountingSink object
+             */
+            ~CountingSink() override = default;
+
+            void write(std::string_view data) override;
+            /**
+             * @brief Get the number of bytes written to the sink
+             * @return size_type The number of bytes
+             */
+            [[nodiscard]] size_type size() const;
+    };
+
+    /**
+     * @brief A sink that writes to an std::ostream
+     */
+    class StreamSink : public Sink {
+        private:
+            std::ostream& stream;
+        public:
+            /**
+             * @brief Construct a new StreamSink object
+             * @param stream The stream to write to
+             */
+            explicit StreamSink(std::ostream& stream) : stream(stream) {};
+            /**
+             * @brief Destroy the StreamSink object
+             */
+            ~StreamSink() override = default;
+
+            void write(std::string_view data) override;
+            void flush() override;
+    };
+
+    /**
+     * @brief A sink that collects data into fixed-size chunks and hands each chunk to a user callback
+     */
+    class CallbackSink : public Sink {
+        private:
+            std::function<void(std::string_view)> callback{};
+            string_type buffer{};
+            size_type chunk_size{4096};
+        public:
+            /**
+             * @brief Construct a new CallbackSink object
+             * @param callback The function to call with each chunk
+             * @param chunk_size The size of the chunks. If 0, every write is passed through as-is.
+             */
+            explicit CallbackSink(std::function<void(std::string_view)> callback, size_type chunk_size = 4096);
+            /**
+             * @brief Destroy the CallbackSink object. Remaining data is flushed.
+             */
+            ~CallbackSink() override;
+
+            void write(std::string_view data) override;
+            void flush() override;
+    };
+
+    /**
+     * @brief A sink that writes to a POSIX file descriptor, in chunks
+     */
+    class FileDescriptorSink : public Sink {
+        private:
+            int fd{-1};
+            string_type buffer{};
+            size_type chunk_size{65536};
+        public:
+            /**
+             * @brief Construct a new FileDescriptorSink object. The file descriptor is not closed by the sink.
+             * @param fd The file descriptor to write to
+             * @param chunk_size The size of the chunks. If 0, every write is passed through as-is.
+             */
+            explicit FileDescriptorSink(int fd, size_type chunk_size = 65536);
+            /**
+             * @brief Destroy the FileDescriptorSink object. Remaining data is flushed.
+             */
+            ~FileDescriptorSink() override;
+
+            void write(std::string_view data) override;
+            void flush() override;
+    };
+} // namespace docpp
\ No newline at end of file
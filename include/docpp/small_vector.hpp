@@ -0,0 +1,353 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A class to represent a sequence of objects in contiguous memory, like std::pmr::vector, that stores up to N objects
+     * inside the object itself, and only allocates when there are more.
+     */
+    template <typename T, size_type N>
+    class SmallVector {
+        static_assert(N > 0, "A SmallVector must have room for at least one object");
+        public:
+            using value_type = T;
+            using allocator_type = std::pmr::polymorphic_allocator<T>;
+            using size_type = docpp::size_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = T&;
+            using const_reference = const T&;
+            using iterator = T*;
+            using const_iterator = const T*;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        private:
+            allocator_type allocator{};
+            T* heap{nullptr};
+            size_type count{0};
+            size_type allocated{N};
+            alignas(T) unsigned char buffer[N * sizeof(T)];
+
+            using traits = std::allocator_traits<allocator_type>;
+
+            [[nodiscard]] T* impl_data() { return this->heap != nullptr ? this->heap : std::launder(reinterpret_cast<T*>(this->buffer)); }
+            [[nodiscard]] const T* impl_data() const { return this->heap != nullptr ? this->heap : std::launder(reinterpret_cast<const T*>(this->buffer)); }
+
+            /**
+             * @brief Move the objects to new storage on the heap. The objects keep their allocator, as it is the same.
+             * @param capacity The capacity of the new storage
+             */
+            void impl_reallocate(const size_type capacity) {
+                T* ret{traits::allocate(this->allocator, capacity)};
+                T* data{this->impl_data()};
+                size_type moved{0};
+
+                try {
+                    for (; moved < this->count; ++moved) {
+                        ::new (static_cast<void*>(ret + moved)) T(std::move_if_noexcept(data[moved]));
+                    }
+                } catch (...) {
+                    for (size_type i{0}; i < moved; ++i) {
+                        ret[i].~T();
+                    }
+
+                    traits::deallocate(this->allocator, ret, capacity);
+                    throw;
+                }
+
+                const size_type c_count{this->count};
+                this->impl_release();
+                this->heap = ret;
+                this->count = c_count;
+                this->allocated = capacity;
+            }
+            /**
+             * @brief Destroy the objects and free the storage, if it is on the heap
+             */
+            void impl_release() {
+                this->clear();
+
+                if (this->heap != nullptr) {
+                    traits::deallocate(this->allocator, this->heap, this->allocated);
+                    this->heap = nullptr;
+                    this->allocated = N;
+                }
+            }
+            /**
+             * @brief Take over the objects of another small vector, which uses the same allocator
+             * @param v The small vector to move from
+             */
+            void impl_steal(SmallVector& v) noexcept {
+                if (v.heap != nullptr) {
+                    this->heap = std::exchange(v.heap, nullptr);
+                    this->count = std::exchange(v.count, 0);
+                    this->allocated = std::exchange(v.allocated, N);
+                    return;
+                }
+
+                T* data{v.impl_data()};
+
+                for (size_type i{0}; i < v.count; ++i) {
+                    ::new (static_cast<void*>(this->impl_data() + i)) T(std::move(data[i]));
+                }
+
+                this->count = v.count;
+                v.clear();
+            }
+        public:
+            /**
+             * @brief Construct a new, empty SmallVector object
+             */
+            SmallVector() = default;
+            /**
+             * @brief Construct a new, empty SmallVector object
+             * @param allocator The allocator to allocate the objects with, once there are more than N
+             */
+            explicit SmallVector(const allocator_type& allocator) : allocator(allocator) {};
+            /**
+             * @brief Construct a new SmallVector object. Like std::pmr::vector, the copy allocates with the default allocator.
+             * @param v The small vector to copy
+             */
+            SmallVector(const SmallVector& v) : SmallVector(v, allocator_type{}) {};
+            /**
+             * @brief Construct a new SmallVector object
+             * @param v The small vector to copy
+             * @param allocator The allocator to allocate the objects with
+             */
+            SmallVector(const SmallVector& v, const allocator_type& allocator) : allocator(allocator) {
+                this->assign(v.begin(), v.end());
+            }
+            /**
+             * @brief Construct a new SmallVector object. The objects keep their allocator.
+             * @param v The small vector to move from
+             */
+            SmallVector(SmallVector&& v) noexcept : allocator(v.allocator) {
+                this->impl_steal(v);
+            }
+            /**
+             * @brief Construct a new SmallVector object. The objects are moved if both use the same allocator, and moved
+             * one by one with the new allocator otherwise.
+             * @param v The small vector to move from
+             * @param allocator The allocator to allocate the objects with
+             */
+            SmallVector(SmallVector&& v, const allocator_type& allocator) : allocator(allocator) {
+                if (this->allocator == v.allocator) {
+                    this->impl_steal(v);
+                    return;
+                }
+
+                this->reserve(v.count);
+
+                for (T& it : v) {
+                    this->emplace_back(std::move(it));
+                }
+
+                v.clear();
+            }
+            /**
+             * @brief Destroy the SmallVector object
+             */
+            ~SmallVector() {
+                this->impl_release();
+            }
+
+            SmallVector& operator=(const SmallVector& v) {
+                if (this != &v) {
+                    this->assign(v.begin(), v.end());
+                }
+
+                return *this;
+            }
+            SmallVector& operator=(SmallVector&& v) {
+                if (this == &v) {
+                    return *this;
+                }
+
+                if (this->allocator == v.allocator) {
+                    this->impl_release();
+                    this->impl_steal(v);
+                    return *this;
+                }
+
+                this->clear();
+                this->reserve(v.count);
+
+                for (T& it : v) {
+                    this->emplace_back(std::move(it));
+                }
+
+                v.clear();
+
+                return *this;
+            }
+
+            [[nodiscard]] iterator begin() { return this->impl_data(); }
+            [[nodiscard]] iterator end() { return this->impl_data() + this->count; }
+            [[nodiscard]] const_iterator begin() const { return this->impl_data(); }
+            [[nodiscard]] const_iterator end() const { return this->impl_data() + this->count; }
+            [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+            [[nodiscard]] const_iterator cend() const { return this->end(); }
+            [[nodiscard]] reverse_iterator rbegin() { return reverse_iterator(this->end()); }
+            [[nodiscard]] reverse_iterator rend() { return reverse_iterator(this->begin()); }
+            [[nodiscard]] const_reverse_iterator rbegin() const { return const_reverse_iterator(this->end()); }
+            [[nodiscard]] const_reverse_iterator rend() const { return const_reverse_iterator(this->begin()); }
+            [[nodiscard]] const_reverse_iterator crbegin() const { return this->rbegin(); }
+            [[nodiscard]] const_reverse_iterator crend() const { return this->rend(); }
+
+            [[nodiscard]] T& operator[](const size_type index) { return this->impl_data()[index]; }
+            [[nodiscard]] const T& operator[](const size_type index) const { return this->impl_data()[index]; }
+            [[nodiscard]] T& front() { return this->impl_data()[0]; }
+            [[nodiscard]] const T& front() const { return this->impl_data()[0]; }
+            [[nodiscard]] T& back() { return this->impl_data()[this->count - 1]; }
+            [[nodiscard]] const T& back() const { return this->impl_data()[this->count - 1]; }
+
+            /**
+             * @brief Get the number of objects
+             * @return size_type The number of objects
+             */
+            [[nodiscard]] size_type size() const { return this->count; }
+            /**
+             * @brief Check if the small vector is empty
+             * @return bool True if there are no objects
+             */
+            [[nodiscard]] bool empty() const { return this->count == 0; }
+            /**
+             * @brief Check if the objects are stored on the heap, rather than inside the small vector
+             * @return bool True if the objects are on the heap
+             */
+            [[nodiscard]] bool is_allocated() const { return this->heap != nullptr; }
+            /**
+             * @brief Get the allocator the objects are allocated with
+             * @return allocator_type The allocator
+             */
+            [[nodiscard]] allocator_type get_allocator() const { return this->allocator; }
+
+            /**
+             * @brief Make room for a number of objects, counting the ones already stored
+             * @param size The number of objects
+             */
+            void reserve(const size_type size) {
+                if (size > this->allocated) {
+                    this->impl_reallocate(size);
+                }
+            }
+            /**
+             * @brief Destroy every object. The storage is kept.
+             */
+            void clear() {
+                T* data{this->impl_data()};
+
+                for (size_type i{0}; i < this->count; ++i) {
+                    traits::destroy(this->allocator, data + i);
+                }
+
+                this->count = 0;
+            }
+            /**
+             * @brief Replace the objects with copies of a range of objects
+             * @param first An iterator to the first object
+             * @param last An iterator past the last object
+             */
+            template <typename I> void assign(I first, I last) {
+                this->clear();
+
+                if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<I>::iterator_category>) {
+                    this->reserve(static_cast<size_type>(std::distance(first, last)));
+                }
+
+                for (; first != last; ++first) {
+                    this->emplace_back(*first);
+                }
+            }
+
+            /**
+             * @brief Construct an object at the back
+             * @param args The arguments to construct the object with
+             * @return T& The object
+             */
+            template <typename... Args> T& emplace_back(Args&&... args) {
+                if (this->count == this->allocated) {
+                    // constructed before growing, as the arguments may refer to objects in the small vector
+                    T value(std::forward<Args>(args)...);
+
+                    this->impl_reallocate(this->allocated * 2);
+                    traits::construct(this->allocator, this->end(), std::move(value));
+                } else {
+                    traits::construct(this->allocator, this->end(), std::forward<Args>(args)...);
+                }
+
+                ++this->count;
+                return this->back();
+            }
+            /**
+             * @brief Construct an object before another
+             * @param pos The position to insert the object at
+             * @param args The arguments to construct the object with
+             * @return iterator An iterator to the object
+             */
+            template <typename... Args> iterator emplace(const_iterator pos, Args&&... args) {
+                const size_type index{static_cast<size_type>(pos - this->begin())};
+
+                if (index == this->count) {
+                    this->emplace_back(std::forward<Args>(args)...);
+                    return this->begin() + index;
+                }
+
+                T value(std::forward<Args>(args)...);
+
+                if (this->count == this->allocated) {
+                    this->impl_reallocate(this->allocated * 2);
+                }
+
+                T* c_last{this->end()};
+                traits::construct(this->allocator, c_last, std::move(*(c_last - 1)));
+                std::move_backward(this->begin() + index, c_last - 1, c_last);
+
+                ++this->count;
+                this->begin()[index] = std::move(value);
+                return this->begin() + index;
+            }
+            iterator insert(const_iterator pos, const T& value) { return this->emplace(pos, value); }
+            iterator insert(const_iterator pos, T&& value) { return this->emplace(pos, std::move(value)); }
+            void push_back(const T& value) { this->emplace_back(value); }
+            void push_back(T&& value) { this->emplace_back(std::move(value)); }
+            /**
+             * @brief Destroy an object, moving the objects after it
+             * @param pos The position of the object
+             * @return iterator An iterator to the object after the destroyed one
+             */
+            iterator erase(const_iterator pos) {
+                const size_type index{static_cast<size_type>(pos - this->begin())};
+
+                std::move(this->begin() + index + 1, this->end(), this->begin() + index);
+                traits::destroy(this->allocator, this->end() - 1);
+                --this->count;
+
+                return this->begin() + index;
+            }
+
+            bool operator==(const SmallVector& v) const {
+                return this->count == v.count && std::equal(this->begin(), this->end(), v.begin());
+            }
+            bool operator!=(const SmallVector& v) const {
+                return !(*this == v);
+            }
+    };
+} // namespace docpp
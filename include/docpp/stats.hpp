@@ -0,0 +1,175 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <docpp/types.hpp>
+#include <docpp/sink.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A struct to represent a snapshot of the rendering statistics. Statistics are only collected when docpp is built with
+     * DOCPP_ENABLE_STATS defined (the DOCPP_ENABLE_STATS CMake option), otherwise every counter stays 0.
+     */
+    struct Stats {
+        /**
+         * @brief The number of top-level get() and write() calls. Calls made by another get() or write() are part of the outer call.
+         */
+        size_type renders{0};
+        /**
+         * @brief The number of elements, sections and rules written. get() visits every node twice, once to size the output and once to write it.
+         */
+        size_type nodes_visited{0};
+        /**
+         * @brief The number of bytes written by top-level get() and write() calls
+         */
+        size_type bytes_emitted{0};
+        /**
+         * @brief The number of strings allocated when storing strings in, and returning them from, the object model,
+         * not counting strings short enough to be stored inline, and the strings returned by get()
+         */
+        size_type string_allocations{0};
+        /**
+         * @brief The number of resolve_tag() calls
+         */
+        size_type tag_resolutions{0};
+        /**
+         * @brief The wall time spent in top-level get() and write() calls
+         */
+        std::chrono::nanoseconds render_time{0};
+    };
+
+    /**
+     * @brief The type of the function called after every top-level get() and write() call
+     */
+    using stats_callback_type = std::function<void(const Stats&)>;
+
+    /**
+     * @brief Check whether docpp was built with statistics enabled
+     * @return bool True if statistics are collected
+     */
+    constexpr bool stats_enabled() {
+#ifdef DOCPP_ENABLE_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+    /**
+     * @brief Get the statistics collected by every thread since the start of the program, or since the last reset_stats() call
+     * @return Stats The statistics
+     */
+    [[nodiscard]] Stats get_stats();
+    /**
+     * @brief Reset the statistics to 0
+     */
+    void reset_stats();
+    /**
+     * @brief Set the function to call after every top-level get() and write() call, with the statistics of that call only.
+     * The function is called on the thread that rendered, and must be safe to call from several threads at once.
+     * @param callback The function to call, or an empty function to call nothing
+     */
+    void set_stats_callback(stats_callback_type callback);
+
+    /**
+     * @brief The counters of the current thread, during a top-level get() or write() call
+     */
+    struct impl_stats_counters {
+        size_type depth{0};
+        size_type nodes_visited{0};
+        size_type bytes_emitted{0};
+        size_type string_allocations{0};
+        size_type tag_resolutions{0};
+    };
+
+#ifdef DOCPP_ENABLE_STATS
+    impl_stats_counters& impl_stats_local();
+    void impl_stats_add_string_allocation();
+    void impl_stats_add_tag_resolution();
+#endif
+
+    /**
+     * @brief Count a node visited by the renderer
+     */
+    inline void impl_stats_add_node() {
+#ifdef DOCPP_ENABLE_STATS
+        ++impl_stats_local().nodes_visited;
+#endif
+    }
+    /**
+     * @brief Count a string allocated by the object model, if it is too long to be stored inline
+     * @param size The size of the string
+     */
+    inline void impl_stats_add_string(const size_type size) {
+#ifdef DOCPP_ENABLE_STATS
+        static const size_type inline_capacity{std::string{}.capacity()};
+
+        if (size > inline_capacity) {
+            impl_stats_add_string_allocation();
+        }
+#else
+        static_cast<void>(size);
+#endif
+    }
+    /**
+     * @brief Count a resolve_tag() call
+     */
+    inline void impl_stats_add_tag() {
+#ifdef DOCPP_ENABLE_STATS
+        impl_stats_add_tag_resolution();
+#endif
+    }
+
+    /**
+     * @brief A class to represent a get() or write() call. The outermost scope on a thread measures the call,
+     * and adds its statistics to the totals when it is destroyed.
+     */
+    class impl_stats_scope {
+#ifdef DOCPP_ENABLE_STATS
+        private:
+            impl_stats_counters& counters;
+            std::chrono::steady_clock::time_point start{};
+        public:
+            impl_stats_scope();
+            ~impl_stats_scope();
+            impl_stats_scope(const impl_stats_scope& scope) = delete;
+            impl_stats_scope& operator=(const impl_stats_scope& scope) = delete;
+
+            [[nodiscard]] bool top_level() const { return this->counters.depth == 1; }
+            void add_bytes(const size_type count) { this->counters.bytes_emitted += count; }
+#else
+        public:
+            [[nodiscard]] constexpr bool top_level() const { return false; }
+            void add_bytes(const size_type) {}
+#endif
+    };
+
+    /**
+     * @brief A sink that counts the bytes a top-level write() call writes to another sink
+     */
+    class impl_stats_sink : public Sink {
+        private:
+            Sink& sink;
+            size_type count{0};
+        public:
+            explicit impl_stats_sink(Sink& sink) : sink(sink) { this->set_escaping(sink.is_escaping()); };
+            ~impl_stats_sink() override = default;
+
+            void write(std::string_view data) override { this->count += data.size(); this->sink.write(data); }
+            void flush() override { this->sink.flush(); }
+            void write_slot(std::string_view name, bool escape) override { this->sink.write_slot(name, escape); }
+            [[nodiscard]] bool collects_slots() const override { return this->sink.collects_slots(); }
+            void reserve(size_type size) override { this->sink.reserve(size); }
+            [[nodiscard]] size_type size() const { return this->count; }
+    };
+} // namespace docpp
@@ -0,0 +1,88 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A class to represent a pool of worker threads. Every worker has its own queue of tasks, and workers without
+     * tasks of their own steal tasks from the other queues.
+     */
+    class ThreadPool {
+        private:
+            struct impl_queue {
+                std::mutex mutex{};
+                std::deque<std::function<void()>> tasks{};
+            };
+
+            std::vector<std::unique_ptr<impl_queue>> queues{};
+            std::vector<std::thread> threads{};
+            std::mutex mutex{};
+            std::condition_variable condition{};
+            std::atomic<size_type> pending{0};
+            std::atomic<size_type> next{0};
+            bool stop{false};
+
+            /**
+             * @brief Take a task, from the back of a worker's own queue if it has one, or from the front of another queue
+             * @param index The index of the worker, or npos if the caller is not a worker of the pool
+             * @param task The task taken
+             * @return bool True if a task was taken
+             */
+            bool impl_pop(size_type index, std::function<void()>& task);
+            /**
+             * @brief Run tasks until the pool is destroyed
+             * @param index The index of the worker
+             */
+            void impl_work(size_type index);
+        public:
+            /**
+             * @brief The npos value
+             */
+            static constexpr size_type npos = -1;
+
+            /**
+             * @brief Construct a new ThreadPool object
+             * @param threads The number of worker threads. If 0, one per hardware thread.
+             */
+            explicit ThreadPool(size_type threads = 0);
+            ThreadPool(const ThreadPool& pool) = delete;
+            ThreadPool& operator=(const ThreadPool& pool) = delete;
+            /**
+             * @brief Destroy the ThreadPool object, after running the tasks that are still queued
+             */
+            ~ThreadPool();
+
+            /**
+             * @brief Queue a task. Tasks queued by a worker are added to its own queue, other tasks are spread over the queues.
+             * @param task The task to run. It must not throw.
+             */
+            void push(std::function<void()> task);
+            /**
+             * @brief Run one queued task on the calling thread, so that a thread waiting for tasks can help running them
+             * @return bool True if a task was run, false if no task was queued
+             */
+            bool run_one();
+            /**
+             * @brief Get the number of worker threads
+             * @return size_type The number of worker threads
+             */
+            [[nodiscard]] size_type size() const;
+    };
+} // namespace docpp
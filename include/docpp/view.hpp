@@ -0,0 +1,61 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+#pragma once
+
+#include <iterator>
+#include <docpp/types.hpp>
+
+/**
+ * @brief A namespace to represent HTML elements and documents
+ */
+namespace docpp {
+    /**
+     * @brief A class to represent a non-owning view over a range of objects, similar to std::span.
+     * The view is invalidated when the object it was taken from is modified or destroyed.
+     */
+    template <typename I>
+    class View {
+        private:
+            I first{};
+            I last{};
+        public:
+            using iterator = I;
+            using const_iterator = I;
+
+            /**
+             * @brief Construct a new View object
+             * @param first An iterator to the first object
+             * @param last An iterator past the last object
+             */
+            View(I first, I last) : first(first), last(last) {};
+            /**
+             * @brief Construct a new View object
+             */
+            View() = default;
+
+            /**
+             * @brief Return an iterator to the beginning.
+             * @return iterator The iterator to the beginning.
+             */
+            [[nodiscard]] iterator begin() const { return first; }
+            /**
+             * @brief Return an iterator to the end.
+             * @return iterator The iterator to the end.
+             */
+            [[nodiscard]] iterator end() const { return last; }
+            /**
+             * @brief Check if the view is empty
+             * @return bool True if the view is empty, false otherwise
+             */
+            [[nodiscard]] bool empty() const { return first == last; }
+            /**
+             * @brief Get the number of objects in the view. Linear in the size of the view, unless the iterators are random access.
+             * @return size_type The number of objects
+             */
+            [[nodiscard]] size_type size() const { return static_cast<size_type>(std::distance(first, last)); }
+    };
+} // namespace docpp
\ No newline at end of file
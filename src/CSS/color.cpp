@@ -19,6 +19,8 @@ docpp::string_type docpp::CSS::ColorFormatter::get(const docpp::CSS::ColorFormat
             return docpp::impl_color_to_string(color);
         } case docpp::CSS::ColorFormatting::Hex_A: {
             return docpp::impl_color_to_string_a(color);
+        } case docpp::CSS::ColorFormatting::Hex_Short: {
+            return docpp::impl_color_to_string_short(color);
         } case docpp::CSS::ColorFormatting::Rgb: {
             std::tuple<int, int, int> tuple = docpp::impl_color_to_int(color);
             std::stringstream ss{};
@@ -6,10 +6,22 @@
  */
 
 #include <docpp/except.hpp>
+#include <docpp/hash.hpp>
 #include <docpp/CSS/element.hpp>
+#include <docpp/stats.hpp>
 
 docpp::CSS::Element& docpp::CSS::Element::operator=(const docpp::CSS::Element& element) {
-    this->set(element.get_tag(), element.get_properties());
+    this->element = element.element;
+    this->rules = element.rules;
+    this->cached_hash.store(element.cached_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+docpp::CSS::Element& docpp::CSS::Element::operator=(docpp::CSS::Element&& element) noexcept {
+    this->element = std::move(element.element);
+    this->rules = std::move(element.rules);
+    this->cached_hash.store(element.cached_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->exposed = this->exposed || element.exposed;
     return *this;
 }
 
@@ -18,44 +30,75 @@ docpp::CSS::Element& docpp::CSS::Element::operator+=(const Property& property) {
     return *this;
 }
 
+docpp::CSS::Element& docpp::CSS::Element::operator+=(Property&& property) {
+    this->push_back(std::move(property));
+    return *this;
+}
+
 docpp::CSS::Property docpp::CSS::Element::operator[](const size_type& index) const {
     return this->at(index);
 }
 
 bool docpp::CSS::Element::operator==(const docpp::CSS::Element& element) const {
-    return this->get() == element.get();
+    if (this->hash() != element.hash()) {
+        return false;
+    }
+
+    return this->element == element.element && this->rules == element.rules;
 }
 
 bool docpp::CSS::Element::operator!=(const docpp::CSS::Element& element) const {
-    return this->get() != element.get();
+    return !(*this == element);
 }
 
-void docpp::CSS::Element::set(const docpp::string_type& tag, const std::vector<Property>& properties) {
-    this->element.first = tag;
-    this->element.second = properties;
+void docpp::CSS::Element::set(docpp::string_type tag, std::vector<Property> properties) {
+    this->impl_modified();
+    this->element.first = std::move(tag);
+    this->element.second = std::move(properties);
 }
 
 void docpp::CSS::Element::set_tag(const docpp::string_type& tag) {
+    this->impl_modified();
     this->element.first = tag;
 }
 
 void docpp::CSS::Element::set_tag(const HTML::Tag tag) {
-    this->element.first = resolve_tag(tag).first;
+    this->impl_modified();
+    this->element.first = HTML::get_tag_name(tag);
 }
 
 void docpp::CSS::Element::set_properties(const std::vector<Property>& properties) {
+    this->impl_modified();
     this->element.second = properties;
 }
 
+void docpp::CSS::Element::set_properties(std::vector<Property>&& properties) {
+    this->impl_modified();
+    this->element.second = std::move(properties);
+}
+
 void docpp::CSS::Element::push_front(const Property& property) {
+    this->impl_modified();
     this->element.second.insert(this->element.second.begin(), property);
 }
 
+void docpp::CSS::Element::push_front(Property&& property) {
+    this->impl_modified();
+    this->element.second.insert(this->element.second.begin(), std::move(property));
+}
+
 void docpp::CSS::Element::push_back(const Property& property) {
+    this->impl_modified();
     this->element.second.push_back(property);
 }
 
+void docpp::CSS::Element::push_back(Property&& property) {
+    this->impl_modified();
+    this->element.second.push_back(std::move(property));
+}
+
 void docpp::CSS::Element::insert(const size_type index, const Property& property) {
+    this->impl_modified();
     if (index >= this->element.second.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -63,7 +106,17 @@ void docpp::CSS::Element::insert(const size_type index, const Property& property
     this->element.second.insert(this->element.second.begin() + static_cast<long>(index), property);
 }
 
+void docpp::CSS::Element::insert(const size_type index, Property&& property) {
+    this->impl_modified();
+    if (index >= this->element.second.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->element.second.insert(this->element.second.begin() + static_cast<long>(index), std::move(property));
+}
+
 void docpp::CSS::Element::erase(const size_type index) {
+    this->impl_modified();
     if (index >= this->element.second.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -80,6 +133,7 @@ docpp::CSS::Property docpp::CSS::Element::at(const size_type index) const {
 }
 
 docpp::CSS::Property& docpp::CSS::Element::at(const size_type index) {
+    this->impl_exposed();
     if (index >= this->element.second.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -89,7 +143,7 @@ docpp::CSS::Property& docpp::CSS::Element::at(const size_type index) {
 
 docpp::size_type docpp::CSS::Element::find(const Property& property) const {
     for (size_type i{0}; i < this->element.second.size(); i++) {
-        if (this->element.second.at(i).get() == property.get()) {
+        if (this->element.second[i] == property) {
             return i;
         }
     }
@@ -99,7 +153,7 @@ docpp::size_type docpp::CSS::Element::find(const Property& property) const {
 
 docpp::size_type docpp::CSS::Element::find(const docpp::string_type& str) const {
     for (size_type i{0}; i < this->element.second.size(); i++) {
-        if (this->element.second.at(i).get_key() == str || this->element.second.at(i).get_value() == str) {
+        if (this->element.second[i].key_view() == str || this->element.second[i].value_view() == str) {
             return i;
         }
     }
@@ -116,10 +170,12 @@ docpp::CSS::Property docpp::CSS::Element::back() const {
 }
 
 docpp::CSS::Property& docpp::CSS::Element::front() {
+    this->impl_exposed();
     return this->element.second.front();
 }
 
 docpp::CSS::Property& docpp::CSS::Element::back() {
+    this->impl_exposed();
     return this->element.second.back();
 }
 
@@ -128,15 +184,18 @@ docpp::size_type docpp::CSS::Element::size() const {
 }
 
 bool docpp::CSS::Element::empty() const {
-    return this->element.second.empty();
+    return this->element.second.empty() && this->rules.empty();
 }
 
 void docpp::CSS::Element::clear() {
+    this->impl_modified();
     this->element.first.clear();
     this->element.second.clear();
+    this->rules.clear();
 }
 
 void docpp::CSS::Element::swap(const size_type index1, const size_type index2) {
+    this->impl_modified();
     if (index1 >= this->element.second.size() || index2 >= this->element.second.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -148,53 +207,144 @@ void docpp::CSS::Element::swap(const Property& property1, const Property& proper
     this->swap(this->find(property1), this->find(property2));
 }
 
-docpp::string_type docpp::CSS::Element::get(const Formatting formatting, const docpp::integer_type tabc) const {
-    docpp::string_type ret{};
+void docpp::CSS::Element::write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    if (scope.top_level()) {
+        impl_stats_sink counting{sink};
+        this->write(counting, formatting, tabc);
+        scope.add_bytes(counting.size());
+        return;
+    }
 
-    if (!this->element.first.empty()) {
-        if (formatting == docpp::CSS::Formatting::Pretty) {
-            for (size_type i{0}; i < tabc; i++) {
-                ret += "\t";
-            }
-        }
+    if (this->element.first.empty()) {
+        return;
+    }
+
+    impl_stats_add_node();
+
+    const bool newline{formatting == docpp::CSS::Formatting::Pretty || formatting == docpp::CSS::Formatting::Newline};
 
-        ret += this->element.first + " {";
+    if (formatting == docpp::CSS::Formatting::Pretty) {
+        sink.indent(tabc);
+    }
+
+    sink.write(this->element.first);
+
+    if (this->element.first.front() == '@' && this->element.second.empty() && this->rules.empty()) {
+        sink.write(";");
 
-        if (formatting == docpp::CSS::Formatting::Pretty || formatting == docpp::CSS::Formatting::Newline) {
-            ret += "\n";
+        if (newline) {
+            sink.write("\n");
         }
 
-        for (const Property& it : this->element.second) {
-            if (it.get_key().empty() || it.get_value().empty()) {
-                continue;
-            }
+        return;
+    }
 
-            if (formatting == docpp::CSS::Formatting::Pretty) {
-                for (size_type i{0}; i < tabc + 1; i++) {
-                    ret += "\t";
-                }
-            }
+    const bool minified{formatting == docpp::CSS::Formatting::Minified};
 
-            ret += it.get_key() + ": " + it.get_value() + ";";
+    sink.write(minified ? "{" : " {");
 
-            if (formatting == docpp::CSS::Formatting::Pretty || formatting == docpp::CSS::Formatting::Newline) {
-                ret += "\n";
-            }
+    if (newline) {
+        sink.write("\n");
+    }
+
+    // minified, the semicolon only separates declarations, and is left out after the last one unless a nested rule follows
+    bool separate{false};
+
+    for (const Property& it : this->element.second) {
+        if (it.key_view().empty() || it.value_view().empty()) {
+            continue;
         }
 
         if (formatting == docpp::CSS::Formatting::Pretty) {
-            for (size_type i{0}; i < tabc; i++) {
-                ret += "\t";
+            sink.indent(tabc + 1);
+        }
+
+        if (minified) {
+            if (separate) {
+                sink.write(";");
             }
+
+            sink.write(it.key_view());
+            sink.write(":");
+            sink.write(it.value_view());
+
+            separate = true;
+            continue;
         }
 
-        ret += "}";
+        sink.write(it.key_view());
+        sink.write(": ");
+        sink.write(it.value_view());
+        sink.write(";");
 
-        if (formatting == docpp::CSS::Formatting::Pretty || formatting == docpp::CSS::Formatting::Newline) {
-            ret += "\n";
+        if (newline) {
+            sink.write("\n");
         }
     }
 
+    if (separate && !this->rules.empty()) {
+        sink.write(";");
+    }
+
+    for (const Element& it : this->rules) {
+        it.write(sink, formatting, tabc + 1);
+    }
+
+    if (formatting == docpp::CSS::Formatting::Pretty) {
+        sink.indent(tabc);
+    }
+
+    sink.write("}");
+
+    if (newline) {
+        sink.write("\n");
+    }
+}
+
+std::uint64_t docpp::CSS::Element::hash() const {
+    if (const std::uint64_t hash{this->cached_hash.load(std::memory_order_acquire)}; hash != 0 && !this->exposed) {
+        return hash;
+    }
+
+    std::uint64_t hash{impl_hash_basis};
+    impl_hash_string(hash, this->element.first);
+    impl_hash_properties(hash, this->element.second);
+    impl_hash_value(hash, this->rules.size());
+
+    for (const Element& it : this->rules) {
+        impl_hash_value(hash, it.hash());
+    }
+
+    hash = impl_hash_finish(hash);
+
+    // a property may still be written through a reference that was handed out, so the hash is not kept
+    if (!this->exposed) {
+        this->cached_hash.store(hash, std::memory_order_release);
+    }
+
+    return hash;
+}
+
+docpp::size_type docpp::CSS::Element::rendered_size(const Formatting formatting, const docpp::integer_type tabc) const {
+    CountingSink sink{};
+
+    this->write(sink, formatting, tabc);
+
+    return sink.size();
+}
+
+docpp::string_type docpp::CSS::Element::get(const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    docpp::string_type ret{};
+    // the string grows as it is written rather than being sized up front, which would write the element twice
+    StringSink sink{ret};
+
+    this->write(sink, formatting, tabc);
+
+    scope.add_bytes(ret.size());
+    impl_stats_add_string(ret.size());
+
     return ret;
 }
 
@@ -204,4 +354,23 @@ docpp::string_type docpp::CSS::Element::get_tag() const {
 
 std::vector<docpp::CSS::Property> docpp::CSS::Element::get_properties() const {
     return this->element.second;
+}
+
+void docpp::CSS::Element::push_back_rule(const Element& rule) {
+    this->impl_modified();
+    this->rules.push_back(rule);
+}
+
+void docpp::CSS::Element::push_back_rule(Element&& rule) {
+    this->impl_modified();
+    this->rules.push_back(std::move(rule));
+}
+
+void docpp::CSS::Element::set_rules(std::vector<Element> rules) {
+    this->impl_modified();
+    this->rules = std::move(rules);
+}
+
+std::vector<docpp::CSS::Element> docpp::CSS::Element::get_rules() const {
+    return this->rules;
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
  * Copyright (c) 2024 speedie <speedie@speedie.site>
  */
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <sstream>
 #include <iomanip>
 #include <tuple>
@@ -31,6 +34,30 @@ docpp::string_type docpp::impl_color_to_string_a(const docpp::CSS::ColorStruct&
  return ss.str();
 }
 
+docpp::string_type docpp::impl_color_to_string_short(const docpp::CSS::ColorStruct& color) {
+    static constexpr char digits[]{"0123456789abcdef"};
+
+    // rounded rather than truncated, so that a color read with from_hex() is written back unchanged
+    const auto channel = [](const double c) {
+        return std::clamp(static_cast<int>(std::lround(c * 255)), 0, 255);
+    };
+    const int channels[]{channel(color.r), channel(color.g), channel(color.b)};
+    const bool short_form{std::all_of(std::begin(channels), std::end(channels), [](const int c) { return c % 17 == 0; })};
+
+    docpp::string_type ret{"#"};
+
+    for (const int c : channels) {
+        if (short_form) {
+            ret += digits[c / 17];
+        } else {
+            ret += digits[c / 16];
+            ret += digits[c % 16];
+        }
+    }
+
+    return ret;
+}
+
 std::tuple<int, int, int> docpp::impl_color_to_int(const docpp::CSS::ColorStruct& color) {
     return std::make_tuple(static_cast<int>(color.r * 255), static_cast<int>(color.g * 255), static_cast<int>(color.b * 255));
 }
@@ -0,0 +1,527 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <docpp/hash.hpp>
+#include <docpp/CSS/color.hpp>
+#include <docpp/CSS/element.hpp>
+#include <docpp/CSS/stylesheet.hpp>
+
+namespace {
+    // the length units whose zero is the same as a unitless zero; times, angles and percentages need their unit
+    constexpr std::array<std::string_view, 15> impl_css_optimize_units{
+        "px", "em", "rem", "ex", "ch", "vw", "vh", "vmin", "vmax", "cm", "mm", "in", "pt", "pc", "q",
+    };
+
+    // the pseudo-classes and pseudo-elements every browser knows, which a selector can use and still be grouped with others
+    constexpr std::array<std::string_view, 27> impl_css_optimize_pseudos{
+        "active", "after", "before", "checked", "disabled", "empty", "enabled", "first-child", "first-letter", "first-line",
+        "first-of-type", "focus", "hover", "lang", "last-child", "last-of-type", "link", "not", "nth-child", "nth-last-child",
+        "nth-last-of-type", "nth-of-type", "only-child", "only-of-type", "root", "target", "visited",
+    };
+
+    constexpr docpp::size_type impl_css_optimize_npos{static_cast<docpp::size_type>(-1)};
+
+    bool impl_css_optimize_is_space(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    bool impl_css_optimize_is_hex(const char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    bool impl_css_optimize_equals(const std::string_view str, const std::string_view lower) {
+        return str.size() == lower.size() && std::equal(str.begin(), str.end(), lower.begin(), [](const char a, const char b) {
+            return (a >= 'A' && a <= 'Z' ? static_cast<char>(a - 'A' + 'a') : a) == b;
+        });
+    }
+
+    bool impl_css_optimize_is_important(const std::string_view value) {
+        constexpr std::string_view important{"!important"};
+        return value.size() >= important.size() && impl_css_optimize_equals(value.substr(value.size() - important.size()), important);
+    }
+
+    // a zero length, such as 0px or -0.0em
+    bool impl_css_optimize_is_zero(const std::string_view word) {
+        docpp::size_type i{word.front() == '+' || word.front() == '-' ? 1U : 0U};
+        bool zero{false};
+
+        for (; i < word.size() && (word[i] == '0' || word[i] == '.'); ++i) {
+            zero = zero || word[i] == '0';
+        }
+
+        return zero && std::find(impl_css_optimize_units.begin(), impl_css_optimize_units.end(), word.substr(i)) != impl_css_optimize_units.end();
+    }
+
+    docpp::string_type impl_css_optimize_color(const docpp::CSS::ColorStruct& color) {
+        return docpp::CSS::ColorFormatter{color}.get(docpp::CSS::ColorFormatting::Hex_Short);
+    }
+
+    // #rrggbb, and #rrggbbaa when it is opaque
+    std::optional<docpp::string_type> impl_css_optimize_hex(const std::string_view word) {
+        if ((word.size() != 7 && word.size() != 9) || !std::all_of(word.begin() + 1, word.end(), impl_css_optimize_is_hex)) {
+            return std::nullopt;
+        }
+
+        if (word.size() == 9 && !impl_css_optimize_equals(word.substr(7), "ff")) {
+            return std::nullopt;
+        }
+
+        return impl_css_optimize_color(docpp::CSS::from_hex(docpp::string_type(word.substr(0, 7))));
+    }
+
+    // the arguments of rgb(), when they are three integers
+    std::optional<docpp::string_type> impl_css_optimize_rgb(const std::string_view arguments) {
+        std::array<int, 3> channels{};
+        docpp::size_type count{0};
+        docpp::size_type i{0};
+
+        while (i < arguments.size()) {
+            if (impl_css_optimize_is_space(arguments[i]) || arguments[i] == ',') {
+                ++i;
+                continue;
+            }
+
+            int channel{0};
+            docpp::size_type digits{0};
+            for (; i < arguments.size() && arguments[i] >= '0' && arguments[i] <= '9' && digits < 4; ++i, ++digits) {
+                channel = channel * 10 + (arguments[i] - '0');
+            }
+
+            const bool separated{i == arguments.size() || impl_css_optimize_is_space(arguments[i]) || arguments[i] == ','};
+            if (digits == 0 || !separated || channel > 255 || count == channels.size()) {
+                return std::nullopt;
+            }
+
+            channels[count++] = channel;
+        }
+
+        if (count != channels.size()) {
+            return std::nullopt;
+        }
+
+        return impl_css_optimize_color(docpp::CSS::from_rgba(channels[0], channels[1], channels[2], 255));
+    }
+
+    // custom properties are kept as they are, since their value means nothing until it is substituted
+    bool impl_css_optimize_is_custom(const std::string_view key) {
+        return key.size() > 2 && key[0] == '-' && key[1] == '-';
+    }
+
+    // the flex shorthand reads a unitless zero as a flex factor, so flex:1 0px and flex:1 0 are not the same
+    bool impl_css_optimize_keeps_units(std::string_view key) {
+        if (!key.empty() && key.front() == '-') {
+            const docpp::size_type dash{key.find('-', 1)};
+            key = dash == impl_css_optimize_npos ? key : key.substr(dash + 1);
+        }
+
+        return impl_css_optimize_equals(key, "flex");
+    }
+
+    docpp::string_type impl_css_optimize_value(const std::string_view value, const bool units) {
+        docpp::string_type ret{};
+        ret.reserve(value.size());
+
+        docpp::size_type depth{0};
+        bool space{false};
+
+        // whitespace is only kept between two words, not next to parentheses, commas and !important
+        const auto emit = [&ret, &space](const std::string_view token) {
+            if (space && !ret.empty()) {
+                const char last{ret.back()};
+                const char next{token.front()};
+
+                if (last != '(' && last != ',' && last != '!' && next != ')' && next != ',' && next != '!') {
+                    ret += ' ';
+                }
+            }
+
+            space = false;
+            ret.append(token.data(), token.size());
+        };
+
+        docpp::size_type i{0};
+        while (i < value.size()) {
+            const char c{value[i]};
+
+            if (impl_css_optimize_is_space(c)) {
+                space = true;
+                ++i;
+                continue;
+            }
+
+            // strings are kept as they are
+            if (c == '"' || c == '\'') {
+                docpp::size_type end{i + 1};
+                while (end < value.size() && value[end] != c) {
+                    end += value[end] == '\\' ? 2 : 1;
+                }
+
+                end = std::min(end + 1, value.size());
+                emit(value.substr(i, end - i));
+                i = end;
+                continue;
+            }
+
+            if (c == '(' || c == ')' || c == ',') {
+                depth = c == '(' ? depth + 1 : c == ')' && depth != 0 ? depth - 1 : depth;
+                emit(value.substr(i, 1));
+                ++i;
+                continue;
+            }
+
+            docpp::size_type end{i};
+            while (end < value.size() && !impl_css_optimize_is_space(value[end]) && value[end] != '"' && value[end] != '\'' &&
+                   value[end] != '(' && value[end] != ')' && value[end] != ',') {
+                ++end;
+            }
+
+            const std::string_view word{value.substr(i, end - i)};
+
+            if (end < value.size() && value[end] == '(') {
+                const docpp::size_type close{value.find(')', end)};
+
+                // an unquoted url() is kept as it is, and rgb() of three integers is written as a hex color
+                if (close != impl_css_optimize_npos && impl_css_optimize_equals(word, "url") && value[end + 1] != '"' && value[end + 1] != '\'') {
+                    emit(value.substr(i, close + 1 - i));
+                    i = close + 1;
+                    continue;
+                }
+
+                if (close != impl_css_optimize_npos && impl_css_optimize_equals(word, "rgb")) {
+                    if (const std::optional<docpp::string_type> color{impl_css_optimize_rgb(value.substr(end + 1, close - end - 1))}) {
+                        emit(*color);
+                        i = close + 1;
+                        continue;
+                    }
+                }
+
+                emit(word);
+                i = end;
+                continue;
+            }
+
+            // lengths in functions such as calc() need their unit
+            if (depth == 0 && !units && impl_css_optimize_is_zero(word)) {
+                emit("0");
+            } else if (const std::optional<docpp::string_type> color{word.front() == '#' ? impl_css_optimize_hex(word) : std::nullopt}) {
+                emit(*color);
+            } else {
+                emit(word);
+            }
+
+            i = end;
+        }
+
+        return ret;
+    }
+
+    // keep the declaration of every property that takes effect: the last one, unless an earlier one is !important and it is not
+    std::vector<docpp::CSS::Property> impl_css_optimize_declarations(std::vector<docpp::CSS::Property>&& properties) {
+        std::vector<bool> keep(properties.size(), false);
+        std::unordered_map<std::string_view, docpp::size_type> kept{};
+
+        for (docpp::size_type i{properties.size()}; i-- > 0;) {
+            const docpp::CSS::Property& it{properties[i]};
+
+            if (it.key_view().empty() || it.value_view().empty()) {
+                continue;
+            }
+
+            const auto [found, inserted] = kept.try_emplace(it.key_view(), i);
+
+            if (inserted) {
+                keep[i] = true;
+            } else if (impl_css_optimize_is_important(it.value_view()) && !impl_css_optimize_is_important(properties[found->second].value_view())) {
+                keep[found->second] = false;
+                keep[i] = true;
+                found->second = i;
+            }
+        }
+
+        std::vector<docpp::CSS::Property> ret{};
+        ret.reserve(kept.size());
+
+        for (docpp::size_type i{0}; i < properties.size(); ++i) {
+            if (keep[i]) {
+                ret.push_back(std::move(properties[i]));
+            }
+        }
+
+        return ret;
+    }
+
+    /*
+     * Shorthands and the longhands they set that do not share the name of the shorthand up to the first dash, as property and the
+     * family it belongs to. Longhands that share it (margin and margin-top, font and font-weight) need no entry.
+     */
+    constexpr std::array<std::pair<std::string_view, std::string_view>, 27> impl_css_optimize_shorthands{{
+        {"line-height", "font"},
+        {"columns", "column"},
+        {"gap", "grid"}, // gap and its longhands were grid-gap, grid-row-gap and grid-column-gap
+        {"row-gap", "grid"},
+        {"column-gap", "grid"},
+        {"top", "inset"},
+        {"right", "inset"},
+        {"bottom", "inset"},
+        {"left", "inset"},
+        {"align-content", "place"},
+        {"align-items", "place"},
+        {"align-self", "place"},
+        {"justify-content", "place"},
+        {"justify-items", "place"},
+        {"justify-self", "place"},
+        {"white-space", "text"},
+        {"white-space-collapse", "text"},
+        {"word-wrap", "overflow"},
+        {"page-break-after", "break"},
+        {"page-break-before", "break"},
+        {"page-break-inside", "break"},
+        {"alignment-baseline", "vertical"},
+        {"baseline-shift", "vertical"},
+        {"baseline-source", "vertical"},
+        {"max-lines", "line"},
+        {"block-ellipsis", "line"},
+        {"continue", "line"},
+    }};
+
+    /*
+     * The properties a declaration can override or be overridden by, as a hash. A property listed in impl_css_optimize_shorthands
+     * belongs to the family given there, and any other to the family named by its name up to the first dash, so that a property
+     * the table does not know is taken to conflict with everything sharing that name. Families are coarse on purpose: taking two
+     * properties to conflict keeps a rule from being moved, but never moves one wrongly.
+     */
+    std::uint64_t impl_css_optimize_family(std::string_view key) {
+        std::uint64_t hash{docpp::impl_hash_basis};
+
+        if (impl_css_optimize_is_custom(key)) {
+            docpp::impl_hash_string(hash, key);
+            return hash;
+        }
+
+        // vendor prefixes, such as -webkit-
+        if (!key.empty() && key.front() == '-') {
+            const docpp::size_type dash{key.find('-', 1)};
+            key = dash == impl_css_optimize_npos ? key : key.substr(dash + 1);
+        }
+
+        std::string_view family{key.substr(0, key.find('-'))};
+
+        const auto it = std::find_if(impl_css_optimize_shorthands.begin(), impl_css_optimize_shorthands.end(), [key](const auto& entry) {
+            return entry.first == key;
+        });
+
+        if (it != impl_css_optimize_shorthands.end()) {
+            family = it->second;
+        }
+
+        docpp::impl_hash_string(hash, family);
+        return hash;
+    }
+
+    /*
+     * A selector list is dropped as a whole by a browser that does not know one of its selectors, so only selectors that use no
+     * pseudo-classes or pseudo-elements other than those in impl_css_optimize_pseudos are grouped, and not selector lists passed
+     * to them, as in :not(.a, .b). Attribute selectors and escaped characters are skipped, so [href=":x"] and .a\:b do not count.
+     */
+    bool impl_css_optimize_is_groupable(const std::string_view selector) {
+        docpp::size_type depth{0};
+        docpp::size_type i{0};
+
+        while (i < selector.size()) {
+            const char c{selector[i]};
+
+            if (c == '\\') {
+                i += 2;
+            } else if (c == '[') {
+                char quote{0};
+                for (++i; i < selector.size() && (quote != 0 || selector[i] != ']'); ++i) {
+                    if (selector[i] == '\\') {
+                        ++i;
+                    } else if (quote == 0 && (selector[i] == '"' || selector[i] == '\'')) {
+                        quote = selector[i];
+                    } else if (selector[i] == quote) {
+                        quote = 0;
+                    }
+                }
+
+                ++i;
+            } else if (c == ':') {
+                i += i + 1 < selector.size() && selector[i + 1] == ':' ? 2 : 1;
+
+                const docpp::size_type start{i};
+                while (i < selector.size() && (std::isalnum(static_cast<unsigned char>(selector[i])) || selector[i] == '-' || selector[i] == '_')) {
+                    ++i;
+                }
+
+                const std::string_view name{selector.substr(start, i - start)};
+                if (std::none_of(impl_css_optimize_pseudos.begin(), impl_css_optimize_pseudos.end(), [name](const std::string_view it) {
+                    return impl_css_optimize_equals(name, it);
+                })) {
+                    return false;
+                }
+            } else {
+                if (c == ',' && depth != 0) {
+                    return false;
+                }
+
+                depth = c == '(' ? depth + 1 : c == ')' && depth != 0 ? depth - 1 : depth;
+                ++i;
+            }
+        }
+
+        return true;
+    }
+
+    // rules that only hold declarations can be merged and grouped; at-rules and rules with nested rules stay where they are
+    bool impl_css_optimize_is_plain(const docpp::CSS::Element& rule) {
+        return !rule.tag_view().empty() && rule.tag_view().front() != '@' && rule.rules_view().empty();
+    }
+
+    /*
+     * Merge every plain rule into an earlier one with the same key, unless a rule between them sets a property of the same family,
+     * which the rule would then no longer override. merge() moves the declarations or selector of a rule into the earlier rule.
+     */
+    template <typename K, typename M> void impl_css_optimize_merge(std::vector<docpp::CSS::Element>& rules, const K& key, const M& merge) {
+        // the last position at which each family of properties is set
+        std::unordered_map<docpp::string_type, docpp::size_type> targets{};
+        std::unordered_map<std::uint64_t, docpp::size_type> last{};
+        std::vector<bool> merged(rules.size(), false);
+        std::vector<std::uint64_t> families{};
+        const std::uint64_t all_family{impl_css_optimize_family("all")};
+        docpp::size_type barrier{0};
+        bool any{false};
+
+        for (docpp::size_type j{0}; j < rules.size(); ++j) {
+            docpp::CSS::Element& rule{rules[j]};
+
+            if (!impl_css_optimize_is_plain(rule)) {
+                barrier = j + 1;
+                continue;
+            }
+
+            families.clear();
+            for (const docpp::CSS::Property& it : rule.properties_view()) {
+                families.push_back(impl_css_optimize_family(it.key_view()));
+            }
+
+            // the all property overrides every other property
+            const bool all{std::find(families.begin(), families.end(), all_family) != families.end()};
+
+            const std::optional<docpp::string_type> c_key{key(rule)};
+            const auto target = c_key ? targets.find(*c_key) : targets.end();
+
+            const auto movable = [&](const docpp::size_type i) {
+                if (i < barrier || all) {
+                    return false;
+                }
+
+                if (const auto it = last.find(all_family); it != last.end() && it->second > i) {
+                    return false;
+                }
+
+                return std::none_of(families.begin(), families.end(), [&](const std::uint64_t family) {
+                    const auto it = last.find(family);
+                    return it != last.end() && it->second > i;
+                });
+            };
+
+            docpp::size_type position{j};
+            if (target != targets.end() && movable(target->second)) {
+                position = target->second;
+                merge(rules[position], rule);
+                merged[j] = true;
+                any = true;
+            } else if (c_key) {
+                targets[*c_key] = j;
+            }
+
+            // the declarations of the rule now live at position
+            for (const std::uint64_t family : families) {
+                docpp::size_type& at{last[family]};
+                at = std::max(at, position);
+            }
+        }
+
+        if (!any) {
+            return;
+        }
+
+        std::vector<docpp::CSS::Element> ret{};
+        ret.reserve(rules.size());
+
+        for (docpp::size_type i{0}; i < rules.size(); ++i) {
+            if (!merged[i]) {
+                ret.push_back(std::move(rules[i]));
+            }
+        }
+
+        rules = std::move(ret);
+    }
+
+    void impl_css_optimize_rules(std::vector<docpp::CSS::Element>& rules) {
+        for (docpp::CSS::Element& it : rules) {
+            it.optimize();
+        }
+
+        // empty rules style nothing; at-rules without a block, such as @import, are kept
+        rules.erase(std::remove_if(rules.begin(), rules.end(), [](const docpp::CSS::Element& it) {
+            return it.tag_view().empty() || (it.tag_view().front() != '@' && it.empty());
+        }), rules.end());
+
+        impl_css_optimize_merge(rules, [](const docpp::CSS::Element& rule) {
+            return std::optional<docpp::string_type>{rule.tag_view()};
+        }, [](docpp::CSS::Element& target, const docpp::CSS::Element& rule) {
+            std::vector<docpp::CSS::Property> properties{target.get_properties()};
+            properties.insert(properties.end(), rule.properties_view().begin(), rule.properties_view().end());
+            target.set_properties(impl_css_optimize_declarations(std::move(properties)));
+        });
+
+        impl_css_optimize_merge(rules, [](const docpp::CSS::Element& rule) -> std::optional<docpp::string_type> {
+            if (!impl_css_optimize_is_groupable(rule.tag_view())) {
+                return std::nullopt;
+            }
+
+            docpp::string_type ret{};
+            for (const docpp::CSS::Property& it : rule.properties_view()) {
+                ret.append(it.key_view()).append(1, ':').append(it.value_view()).append(1, ';');
+            }
+
+            return ret;
+        }, [](docpp::CSS::Element& target, const docpp::CSS::Element& rule) {
+            target.set_tag(target.get_tag() + "," + rule.get_tag());
+        });
+    }
+} // namespace
+
+void docpp::CSS::Element::optimize() {
+    this->impl_modified();
+
+    for (Property& it : this->element.second) {
+        if (!it.key_view().empty() && !it.value_view().empty() && !impl_css_optimize_is_custom(it.key_view())) {
+            it.set_value(impl_css_optimize_value(it.value_view(), impl_css_optimize_keeps_units(it.key_view())));
+        }
+    }
+
+    this->element.second = impl_css_optimize_declarations(std::move(this->element.second));
+
+    impl_css_optimize_rules(this->rules);
+}
+
+void docpp::CSS::Stylesheet::optimize() {
+    this->impl_modified();
+
+    impl_css_optimize_rules(this->elements);
+}
\ No newline at end of file
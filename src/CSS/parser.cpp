@@ -0,0 +1,252 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include <docpp/except.hpp>
+#include <docpp/intern.hpp>
+#include <docpp/mapped_file.hpp>
+#include <docpp/CSS/parser.hpp>
+
+namespace {
+    constexpr bool impl_css_is_space(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    /* characters the tokenizer has to look at; everything else is skipped over */
+    constexpr std::array<bool, 256> impl_css_make_special_table() {
+        std::array<bool, 256> ret{};
+
+        for (const char c : std::string_view{"{};/\"'\\()[]"}) {
+            ret[static_cast<unsigned char>(c)] = true;
+        }
+
+        return ret;
+    }
+
+    constexpr std::array<bool, 256> impl_css_special_table{impl_css_make_special_table()};
+
+    std::string_view impl_css_trim(std::string_view str) {
+        while (!str.empty() && impl_css_is_space(str.front())) {
+            str.remove_prefix(1);
+        }
+
+        while (!str.empty() && impl_css_is_space(str.back())) {
+            str.remove_suffix(1);
+        }
+
+        return str;
+    }
+
+    /* returns the position after the string starting at pos, which must be a quote */
+    docpp::size_type impl_css_skip_string(const std::string_view input, docpp::size_type pos) {
+        const char quote{input[pos++]};
+
+        while (pos < input.size()) {
+            if (input[pos] == '\\') {
+                pos += 2;
+            } else if (input[pos] == quote) {
+                return pos + 1;
+            } else {
+                ++pos;
+            }
+        }
+
+        throw docpp::invalid_argument{"Unterminated string"};
+    }
+
+    /* returns the position after the comment starting at pos */
+    docpp::size_type impl_css_skip_comment(const std::string_view input, const docpp::size_type pos) {
+        const docpp::size_type end{input.find("*/", pos + 2)};
+
+        if (end == std::string_view::npos) {
+            throw docpp::invalid_argument{"Unterminated comment"};
+        }
+
+        return end + 2;
+    }
+
+    /**
+     * @brief Streaming tokenizer and parser. The input is split into preludes and declarations, which are views into the input
+     * unless they contain comments. Open blocks are kept on an explicit stack and moved into their parent when they are closed.
+     */
+    class impl_css_parser {
+        private:
+            std::string_view input{};
+            docpp::size_type pos{0};
+            std::vector<docpp::CSS::Element> stack{};
+            docpp::CSS::Stylesheet stylesheet{};
+            /* holds a segment with its comments removed */
+            docpp::string_type scratch{};
+            /* property names that are not in the intern pool, copied once per parse and shared by every declaration using them */
+            std::unordered_map<std::string_view, docpp::InternedString> names{};
+
+            [[nodiscard]] docpp::InternedString shared_name(const std::string_view str) {
+                if (std::optional<docpp::InternedString> interned{docpp::InternPool::get().find(str)}) {
+                    return std::move(*interned);
+                }
+
+                const auto it = this->names.find(str);
+
+                if (it != this->names.end()) {
+                    return it->second;
+                }
+
+                docpp::InternedString name{str};
+                const std::string_view view{name.view()};
+
+                return this->names.emplace(view, std::move(name)).first->second;
+            }
+
+            /* scans up to the next '{', '}' or ';' outside of strings, comments and parentheses, returning it, or '\0' at the end of the input */
+            char scan(std::string_view& segment) {
+                const docpp::size_type start{this->pos};
+                docpp::size_type i{this->pos};
+                docpp::size_type depth{0};
+                bool comments{false};
+                char ret{'\0'};
+
+                while (i < this->input.size()) {
+                    const char c{this->input[i]};
+
+                    if (!impl_css_special_table[static_cast<unsigned char>(c)]) {
+                        ++i;
+                        continue;
+                    }
+
+                    if (c == '/' && i + 1 < this->input.size() && this->input[i + 1] == '*') {
+                        i = impl_css_skip_comment(this->input, i);
+                        comments = true;
+                    } else if (c == '"' || c == '\'') {
+                        i = impl_css_skip_string(this->input, i);
+                    } else if (c == '\\') {
+                        i += 2;
+                    } else if (c == '(' || c == '[') {
+                        ++depth;
+                        ++i;
+                    } else if (c == ')' || c == ']') {
+                        depth -= depth > 0 ? 1 : 0;
+                        ++i;
+                    } else if (depth == 0 && (c == '{' || c == '}' || c == ';')) {
+                        ret = c;
+                        break;
+                    } else {
+                        ++i;
+                    }
+                }
+
+                const docpp::size_type end{std::min(i, this->input.size())};
+                this->pos = ret == '\0' ? this->input.size() : end + 1;
+                segment = this->input.substr(start, end - start);
+
+                if (comments) {
+                    segment = this->strip_comments(segment);
+                }
+
+                segment = impl_css_trim(segment);
+
+                return ret;
+            }
+
+            std::string_view strip_comments(const std::string_view segment) {
+                this->scratch.clear();
+
+                docpp::size_type i{0};
+                docpp::size_type run{0};
+
+                while (i < segment.size()) {
+                    if (segment[i] == '"' || segment[i] == '\'') {
+                        i = impl_css_skip_string(segment, i);
+                    } else if (segment[i] == '\\') {
+                        i += 2;
+                    } else if (segment[i] == '/' && i + 1 < segment.size() && segment[i + 1] == '*') {
+                        this->scratch.append(segment.data() + run, i - run);
+                        i = impl_css_skip_comment(segment, i);
+                        run = i;
+                    } else {
+                        ++i;
+                    }
+                }
+
+                this->scratch.append(segment.data() + run, std::min(i, segment.size()) - run);
+
+                return this->scratch;
+            }
+
+            void declaration(const std::string_view text) {
+                const docpp::size_type colon{text.find(':')};
+
+                if (colon == std::string_view::npos) {
+                    return;
+                }
+
+                const std::string_view key{impl_css_trim(text.substr(0, colon))};
+                const std::string_view value{impl_css_trim(text.substr(colon + 1))};
+
+                if (key.empty() || value.empty()) {
+                    return;
+                }
+
+                this->stack.back().emplace_back(this->shared_name(key), docpp::string_type(value));
+            }
+
+            void close() {
+                docpp::CSS::Element element{std::move(this->stack.back())};
+                this->stack.pop_back();
+
+                if (this->stack.empty()) {
+                    this->stylesheet.push_back(std::move(element));
+                } else {
+                    this->stack.back().push_back_rule(std::move(element));
+                }
+            }
+        public:
+            explicit impl_css_parser(const std::string_view input) : input(input) {}
+
+            docpp::CSS::Stylesheet parse() {
+                while (this->pos < this->input.size()) {
+                    std::string_view segment{};
+                    const char c{this->scan(segment)};
+
+                    if (c == '{') {
+                        this->stack.emplace_back(docpp::string_type(segment), std::vector<docpp::CSS::Property>{});
+                    } else if (this->stack.empty()) {
+                        // only at-rules can end with a semicolon at the top level; anything else is not valid CSS and is ignored
+                        if (!segment.empty() && segment.front() == '@') {
+                            this->stylesheet.emplace_back(docpp::string_type(segment), std::vector<docpp::CSS::Property>{});
+                        }
+                    } else {
+                        if (!segment.empty()) {
+                            this->declaration(segment);
+                        }
+
+                        if (c == '}') {
+                            this->close();
+                        }
+                    }
+                }
+
+                while (!this->stack.empty()) {
+                    this->close();
+                }
+
+                return std::move(this->stylesheet);
+            }
+    };
+} // namespace
+
+docpp::CSS::Stylesheet docpp::CSS::parse(const std::string_view input) {
+    return impl_css_parser{input}.parse();
+}
+
+docpp::CSS::Stylesheet docpp::CSS::parse_file(const docpp::string_type& path) {
+    const MappedFile file{path};
+
+    return parse(file.view());
+}
\ No newline at end of file
@@ -8,38 +8,40 @@
 #include <docpp/CSS/property.hpp>
 
 docpp::string_type docpp::CSS::Property::get_key() const {
-    return this->property.first;
+    return docpp::string_type(this->key.view());
 }
 
 docpp::string_type docpp::CSS::Property::get_value() const {
-    return this->property.second;
+    return this->value;
 }
 
 std::pair<docpp::string_type, docpp::string_type> docpp::CSS::Property::get() const {
-    return this->property;
+    return std::make_pair(this->get_key(), this->value);
 }
 
 void docpp::CSS::Property::set_key(const docpp::string_type& key) {
-    this->property.first = key;
+    this->key = InternedString{key};
 }
 
 void docpp::CSS::Property::set_value(const docpp::string_type& value) {
-    this->property.second = value;
+    this->value = value;
 }
 
-void docpp::CSS::Property::set(const docpp::string_type& key, const docpp::string_type& value) {
-    this->property = std::make_pair(key, value);
+void docpp::CSS::Property::set(const docpp::string_type& key, docpp::string_type value) {
+    this->key = InternedString{key};
+    this->value = std::move(value);
 }
 
 docpp::CSS::Property& docpp::CSS::Property::operator=(const docpp::CSS::Property& property) {
-    this->set(property.get().first, property.get().second);
+    this->key = property.key;
+    this->value = property.value;
     return *this;
 }
 
 bool docpp::CSS::Property::operator==(const docpp::CSS::Property& property) const {
-    return this->get() == property.get();
+    return this->key == property.key && this->value == property.value;
 }
 
 bool docpp::CSS::Property::operator!=(const docpp::CSS::Property& property) const {
-    return this->get() != property.get();
+    return !(*this == property);
 }
\ No newline at end of file
@@ -6,21 +6,42 @@
  */
 
 #include <docpp/except.hpp>
+#include <docpp/hash.hpp>
 #include <docpp/CSS/stylesheet.hpp>
+#include <docpp/stats.hpp>
 
 void docpp::CSS::Stylesheet::set(const std::vector<Element>& elements) {
+    this->impl_modified();
     this->elements = elements;
 }
 
+void docpp::CSS::Stylesheet::set(std::vector<Element>&& elements) {
+    this->impl_modified();
+    this->elements = std::move(elements);
+}
+
 void docpp::CSS::Stylesheet::push_front(const Element& element) {
+    this->impl_modified();
     this->elements.insert(this->elements.begin(), element);
 }
 
+void docpp::CSS::Stylesheet::push_front(Element&& element) {
+    this->impl_modified();
+    this->elements.insert(this->elements.begin(), std::move(element));
+}
+
 void docpp::CSS::Stylesheet::push_back(const Element& element) {
+    this->impl_modified();
     this->elements.push_back(element);
 }
 
+void docpp::CSS::Stylesheet::push_back(Element&& element) {
+    this->impl_modified();
+    this->elements.push_back(std::move(element));
+}
+
 void docpp::CSS::Stylesheet::insert(const size_type index, const Element& element) {
+    this->impl_modified();
     if (index >= this->elements.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -28,7 +49,17 @@ void docpp::CSS::Stylesheet::insert(const size_type index, const Element& elemen
     this->elements.insert(this->elements.begin() + static_cast<long>(index), element);
 }
 
+void docpp::CSS::Stylesheet::insert(const size_type index, Element&& element) {
+    this->impl_modified();
+    if (index >= this->elements.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->elements.insert(this->elements.begin() + static_cast<long>(index), std::move(element));
+}
+
 void docpp::CSS::Stylesheet::erase(const size_type index) {
+    this->impl_modified();
     if (index >= this->elements.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -37,7 +68,15 @@ void docpp::CSS::Stylesheet::erase(const size_type index) {
 }
 
 docpp::CSS::Stylesheet& docpp::CSS::Stylesheet::operator=(const docpp::CSS::Stylesheet& stylesheet) {
-    this->set(stylesheet.get_elements());
+    this->elements = stylesheet.elements;
+    this->cached_hash.store(stylesheet.cached_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+docpp::CSS::Stylesheet& docpp::CSS::Stylesheet::operator=(docpp::CSS::Stylesheet&& stylesheet) noexcept {
+    this->elements = std::move(stylesheet.elements);
+    this->cached_hash.store(stylesheet.cached_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->exposed = this->exposed || stylesheet.exposed;
     return *this;
 }
 
@@ -46,16 +85,25 @@ docpp::CSS::Stylesheet& docpp::CSS::Stylesheet::operator+=(const Element& elemen
     return *this;
 }
 
+docpp::CSS::Stylesheet& docpp::CSS::Stylesheet::operator+=(Element&& element) {
+    this->push_back(std::move(element));
+    return *this;
+}
+
 docpp::CSS::Element docpp::CSS::Stylesheet::operator[](const docpp::integer_type& index) const {
     return this->at(index);
 }
 
 bool docpp::CSS::Stylesheet::operator==(const docpp::CSS::Stylesheet& stylesheet) const {
-    return this->get_elements() == stylesheet.get_elements();
+    if (this->hash() != stylesheet.hash()) {
+        return false;
+    }
+
+    return this->elements == stylesheet.elements;
 }
 
 bool docpp::CSS::Stylesheet::operator!=(const docpp::CSS::Stylesheet& stylesheet) const {
-    return this->get_elements() != stylesheet.get_elements();
+    return !(*this == stylesheet);
 }
 
 docpp::CSS::Element docpp::CSS::Stylesheet::at(const size_type index) const {
@@ -67,8 +115,10 @@ docpp::CSS::Element docpp::CSS::Stylesheet::at(const size_type index) const {
 }
 
 docpp::size_type docpp::CSS::Stylesheet::find(const Element& element) const {
+    const std::uint64_t hash{element.hash()};
+
     for (size_type i{0}; i < this->elements.size(); i++) {
-        if (this->elements.at(i).get() == element.get()) {
+        if (this->elements[i].hash() == hash && this->elements[i] == element) {
             return i;
         }
     }
@@ -78,7 +128,7 @@ docpp::size_type docpp::CSS::Stylesheet::find(const Element& element) const {
 
 docpp::size_type docpp::CSS::Stylesheet::find(const docpp::string_type& str) const {
     for (size_type i{0}; i < this->elements.size(); i++) {
-        if (this->elements.at(i).get() == str || this->elements.at(i).get_tag() == str) {
+        if (this->elements[i].tag_view() == str || this->elements[i].get() == str) {
             return i;
         }
     }
@@ -95,6 +145,7 @@ bool docpp::CSS::Stylesheet::empty() const {
 }
 
 void docpp::CSS::Stylesheet::clear() {
+    this->impl_modified();
     this->elements.clear();
 }
 
@@ -107,6 +158,7 @@ docpp::CSS::Element docpp::CSS::Stylesheet::back() const {
 }
 
 void docpp::CSS::Stylesheet::swap(const size_type index1, const size_type index2) {
+    this->impl_modified();
     if (index1 >= this->elements.size() || index2 >= this->elements.size()) {
         throw docpp::out_of_range("Index out of range");
     }
@@ -118,16 +170,64 @@ void docpp::CSS::Stylesheet::swap(const Element& element1, const Element& elemen
     this->swap(this->find(element1), this->find(element2));
 }
 
+std::uint64_t docpp::CSS::Stylesheet::hash() const {
+    if (const std::uint64_t hash{this->cached_hash.load(std::memory_order_acquire)}; hash != 0 && !this->exposed) {
+        return hash;
+    }
+
+    std::uint64_t hash{impl_hash_basis};
+    impl_hash_value(hash, this->elements.size());
+
+    for (const Element& it : this->elements) {
+        impl_hash_value(hash, it.hash());
+    }
+
+    hash = impl_hash_finish(hash);
+
+    // an element may still be modified through a reference that was handed out, so the hash is not kept
+    if (!this->exposed) {
+        this->cached_hash.store(hash, std::memory_order_release);
+    }
+
+    return hash;
+}
+
 std::vector<docpp::CSS::Element> docpp::CSS::Stylesheet::get_elements() const {
     return this->elements;
 }
 
-docpp::string_type docpp::CSS::Stylesheet::get(const Formatting formatting, const docpp::integer_type tabc) const {
-    docpp::string_type ret{};
+void docpp::CSS::Stylesheet::write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    if (scope.top_level()) {
+        impl_stats_sink counting{sink};
+        this->write(counting, formatting, tabc);
+        scope.add_bytes(counting.size());
+        return;
+    }
 
     for (const Element& it : this->elements) {
-        ret += it.get(formatting, tabc);
+        it.write(sink, formatting, tabc);
     }
+}
+
+docpp::size_type docpp::CSS::Stylesheet::rendered_size(const Formatting formatting, const docpp::integer_type tabc) const {
+    CountingSink sink{};
+
+    this->write(sink, formatting, tabc);
+
+    return sink.size();
+}
+
+docpp::string_type docpp::CSS::Stylesheet::get(const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    docpp::string_type ret{};
+    // the string grows as it is written rather than being sized up front, which would write the stylesheet twice
+    StringSink sink{ret};
+
+    this->write(sink, formatting, tabc);
+
+    scope.add_bytes(ret.size());
+    impl_stats_add_string(ret.size());
 
     return ret;
 }
\ No newline at end of file
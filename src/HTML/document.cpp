@@ -5,11 +5,62 @@
  * Copyright (c) 2024 speedie <speedie@speedie.site>
  */
 
+#include <docpp/hash.hpp>
 #include <docpp/HTML/section.hpp>
 #include <docpp/HTML/document.hpp>
+#include <docpp/stats.hpp>
+
+void docpp::HTML::Document::write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    if (scope.top_level()) {
+        impl_stats_sink counting{sink};
+        this->write(counting, formatting, tabc);
+        scope.add_bytes(counting.size());
+        return;
+    }
+
+    const bool escaping{sink.is_escaping()};
+
+    sink.write(this->doctype);
+
+    if (formatting == Formatting::Pretty || formatting == Formatting::Newline) {
+        sink.write("\n");
+    }
+
+    sink.set_escaping(escaping || this->escape);
+
+    try {
+        this->document.write(sink, formatting, tabc);
+    } catch (...) {
+        sink.set_escaping(escaping);
+        throw;
+    }
+
+    sink.set_escaping(escaping);
+}
+
+docpp::size_type docpp::HTML::Document::rendered_size(const Formatting formatting, const docpp::integer_type tabc) const {
+    CountingSink sink{};
+
+    this->write(sink, formatting, tabc);
+
+    return sink.size();
+}
 
 docpp::string_type docpp::HTML::Document::get(const Formatting formatting, const docpp::integer_type tabc) const {
-    return this->doctype + (formatting == Formatting::Pretty ? "\n" : formatting == Formatting::Newline ? "\n" : "") + this->document.get(formatting, tabc);
+    impl_stats_scope scope{};
+    docpp::string_type ret{};
+
+    // the string grows as it is written rather than being sized up front, which would write the document twice;
+    // an incremental section reserves the space it needs once it knows its size
+    StringSink sink{ret};
+
+    this->write(sink, formatting, tabc);
+
+    scope.add_bytes(ret.size());
+    impl_stats_add_string(ret.size());
+
+    return ret;
 }
 
 docpp::HTML::Section docpp::HTML::Document::get_section() const {
@@ -24,12 +75,41 @@ void docpp::HTML::Document::set(const docpp::HTML::Section& document) {
     this->document = document;
 }
 
+void docpp::HTML::Document::set(docpp::HTML::Section&& document) {
+    this->document = std::move(document);
+}
+
 docpp::size_type docpp::HTML::Document::size() const {
     return this->document.size();
 }
 
 void docpp::HTML::Document::set_doctype(const docpp::string_type& doctype) {
-    this->doctype = doctype;
+    this->doctype.assign(doctype.data(), doctype.size());
+}
+
+void docpp::HTML::Document::set_escaping(const bool escape) {
+    this->escape = escape;
+}
+
+bool docpp::HTML::Document::is_escaping() const {
+    return this->escape;
+}
+
+void docpp::HTML::Document::set_incremental(const bool incremental) {
+    this->document.set_incremental(incremental);
+}
+
+bool docpp::HTML::Document::is_incremental() const {
+    return this->document.is_incremental();
+}
+
+std::uint64_t docpp::HTML::Document::hash() const {
+    std::uint64_t hash{impl_hash_basis};
+    impl_hash_string(hash, this->doctype);
+    impl_hash_value(hash, this->escape);
+    impl_hash_value(hash, this->document.hash());
+
+    return impl_hash_finish(hash);
 }
 
 void docpp::HTML::Document::clear() {
@@ -42,8 +122,9 @@ bool docpp::HTML::Document::empty() const {
 }
 
 docpp::HTML::Document& docpp::HTML::Document::operator=(const docpp::HTML::Document& document) {
-    this->set(document.get_section());
-    this->set_doctype(document.get_doctype());
+    this->document = document.document;
+    this->doctype = document.doctype;
+    this->escape = document.escape;
     return *this;
 }
 
@@ -52,8 +133,13 @@ docpp::HTML::Document& docpp::HTML::Document::operator=(const docpp::HTML::Secti
     return *this;
 }
 
+docpp::HTML::Document& docpp::HTML::Document::operator=(docpp::HTML::Section&& section) {
+    this->set(std::move(section));
+    return *this;
+}
+
 bool docpp::HTML::Document::operator==(const docpp::HTML::Document& document) const {
-    return this->get() == document.get();
+    return this->doctype == document.doctype && this->escape == document.escape && this->document == document.document;
 }
 
 bool docpp::HTML::Document::operator==(const docpp::HTML::Section& section) const {
@@ -61,7 +147,7 @@ bool docpp::HTML::Document::operator==(const docpp::HTML::Section& section) cons
 }
 
 bool docpp::HTML::Document::operator!=(const docpp::HTML::Document& document) const {
-    return this->doctype != document.get_doctype() || this->document != document.document;
+    return !(*this == document);
 }
 
 bool docpp::HTML::Document::operator!=(const docpp::HTML::Section& section) const {
@@ -69,5 +155,9 @@ bool docpp::HTML::Document::operator!=(const docpp::HTML::Section& section) cons
 }
 
 docpp::string_type docpp::HTML::Document::get_doctype() const {
-    return this->doctype;
+    return docpp::impl_to_string(this->doctype);
+}
+
+docpp::HTML::Document::allocator_type docpp::HTML::Document::get_allocator() const {
+    return this->document.get_allocator();
 }
\ No newline at end of file
@@ -5,24 +5,69 @@
  * Copyright (c) 2024 speedie <speedie@speedie.site>
  */
 
+#include <docpp/hash.hpp>
 #include <docpp/HTML/element.hpp>
+#include <docpp/HTML/section.hpp>
+#include <docpp/HTML/minify.hpp>
+#include <docpp/stats.hpp>
+
+void docpp::HTML::Element::impl_modified() {
+    const std::uint64_t hash{this->cached_hash.exchange(0, std::memory_order_relaxed)};
+
+    // without a hash, the element has already been noted by its parent
+    if (hash != 0 && this->parent != nullptr) {
+        this->parent->impl_modified(this, false, hash, 1);
+    }
+}
 
 docpp::HTML::Element& docpp::HTML::Element::operator=(const docpp::HTML::Element& element) {
-    this->set(element.get_tag(), element.properties, element.get_data(), element.type);
+    const std::uint64_t hash{element.cached_hash.load(std::memory_order_relaxed)};
+
+    // the element keeps its place, so the sections above it have changed
+    this->impl_modified();
+
+    this->tag = InternedString{element.tag, this->get_allocator()};
+    this->properties = element.properties;
+    this->data = element.data;
+    this->type = element.type;
+    this->escape = element.escape;
+    this->cached_hash.store(hash, std::memory_order_relaxed);
+
+    return *this;
+}
+
+docpp::HTML::Element& docpp::HTML::Element::operator=(docpp::HTML::Element&& element) {
+    const std::uint64_t hash{element.cached_hash.load(std::memory_order_relaxed)};
+
+    this->impl_modified();
+
+    this->tag = InternedString{std::move(element.tag), this->get_allocator()};
+    this->properties = std::move(element.properties);
+    this->data = std::move(element.data);
+    this->type = element.type;
+    this->escape = element.escape;
+    element.impl_modified();
+    this->cached_hash.store(hash, std::memory_order_relaxed);
+
     return *this;
 }
 
 docpp::HTML::Element& docpp::HTML::Element::operator+=(const docpp::string_type& data) {
-    this->data += data;
+    this->impl_modified();
+    this->data.append(data.data(), data.size());
     return *this;
 }
 
 bool docpp::HTML::Element::operator==(const docpp::HTML::Element& element) const {
-    return this->tag == element.get_tag() && this->properties == element.properties && this->data == element.get_data() && this->type == element.type;
+    if (this->hash() != element.hash()) {
+        return false;
+    }
+
+    return this->tag == element.tag && this->properties == element.properties && this->data == element.data && this->type == element.type && this->escape == element.escape;
 }
 
 bool docpp::HTML::Element::operator!=(const docpp::HTML::Element& element) const {
-    return this->tag != element.get_tag() || this->properties != element.properties || this->data != element.get_data() || this->type != element.type;
+    return !(*this == element);
 }
 
 void docpp::HTML::Element::set(const docpp::string_type& tag, const Properties& properties, const docpp::string_type& data, const Type type) {
@@ -39,85 +84,201 @@ void docpp::HTML::Element::set(const Tag tag, const Properties& properties, cons
 }
 
 void docpp::HTML::Element::set_tag(const docpp::string_type& tag) {
-    this->tag = tag;
+    this->impl_modified();
+    this->tag = InternedString{tag, this->get_allocator()};
 }
 
 void docpp::HTML::Element::set_tag(const Tag tag) {
-    std::pair<docpp::string_type, docpp::HTML::Type> resolved{resolve_tag(tag)};
-    this->tag = resolved.first;
-    this->type = resolved.second;
+    this->impl_modified();
+    this->tag = get_interned_tag_name(tag);
+    this->type = get_tag_type(tag);
 }
 
 void docpp::HTML::Element::set_data(const docpp::string_type& data) {
-    this->data = data;
+    this->impl_modified();
+    this->data.assign(data.data(), data.size());
 }
 
 void docpp::HTML::Element::set_type(const Type type) {
+    this->impl_modified();
     this->type = type;
 }
 
+void docpp::HTML::Element::set_escaping(const bool escape) {
+    this->impl_modified();
+    this->escape = escape;
+}
+
+std::uint64_t docpp::HTML::Element::hash() const {
+    if (const std::uint64_t hash{this->cached_hash.load(std::memory_order_acquire)}; hash != 0) {
+        return hash;
+    }
+
+    std::uint64_t hash{impl_hash_basis};
+    impl_hash_value(hash, static_cast<std::uint64_t>(this->type));
+    impl_hash_value(hash, this->escape);
+    impl_hash_string(hash, this->tag.view());
+    impl_hash_properties(hash, this->properties);
+    impl_hash_string(hash, this->data);
+
+    hash = impl_hash_finish(hash);
+    this->cached_hash.store(hash, std::memory_order_release);
+
+    return hash;
+}
+
+bool docpp::HTML::Element::is_escaping() const {
+    return this->escape;
+}
+
 void docpp::HTML::Element::set_properties(const Properties& properties) {
+    this->impl_modified();
     this->properties = properties;
 }
 
-docpp::string_type docpp::HTML::Element::get(const Formatting formatting, const docpp::integer_type tabc) const {
-    docpp::string_type ret{};
+void docpp::HTML::Element::set_properties(Properties&& properties) {
+    this->impl_modified();
+    this->properties = std::move(properties);
+}
+
+void docpp::HTML::Element::set_property(const docpp::string_type& key, const docpp::string_type& value) {
+    this->impl_modified();
+    this->properties.set(key, value);
+}
 
-    if (this->type == docpp::HTML::Type::Text_No_Formatting) {
-        return this->data;
+void docpp::HTML::Element::write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    if (scope.top_level()) {
+        impl_stats_sink counting{sink};
+        this->write(counting, formatting, tabc);
+        scope.add_bytes(counting.size());
+        return;
+    }
+
+    this->impl_write(sink, formatting, tabc, false, true);
+}
+
+void docpp::HTML::Element::impl_write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc, const bool preformatted, const bool close) const {
+    impl_stats_add_node();
+
+    const bool escape{this->escape || sink.is_escaping()};
+    const bool minified{formatting == docpp::HTML::Formatting::Minified};
+    const bool collapse{minified && !preformatted && !impl_minify_preformatted(this->tag.view())};
+    const auto write_text = [&sink, escape](const std::string_view text) {
+        if (escape) {
+            sink.write_escaped(text);
+        } else {
+            sink.write(text);
+        }
+    };
+    const auto write_data = [&sink, &write_text, escape, collapse](const std::string_view text) {
+        if (collapse) {
+            impl_minify_write_text(sink, text, escape);
+        } else {
+            write_text(text);
+        }
+    };
+
+    if (this->type == docpp::HTML::Type::Raw) {
+        sink.write(this->data);
+        return;
+    } else if (this->type == docpp::HTML::Type::Slot) {
+        if (formatting == docpp::HTML::Formatting::Pretty) {
+            sink.indent(tabc);
+        }
+
+        sink.write_slot(this->data, escape);
+        return;
+    } else if (this->type == docpp::HTML::Type::Text_No_Formatting) {
+        write_data(this->data);
+        return;
     } else if (this->type == docpp::HTML::Type::Text) {
-        for (size_type i{0}; i < tabc; i++) {
-            ret += "\t";
+        if (!minified) {
+            sink.indent(tabc);
         }
 
-        return ret + this->data;
+        write_data(this->data);
+        return;
     }
 
     if (formatting == docpp::HTML::Formatting::Pretty) {
-        for (size_type i{0}; i < tabc; i++) {
-            ret += "\t";
-        }
+        sink.indent(tabc);
     }
 
-    if (this->type == docpp::HTML::Type::Non_Opened) {
-        ret += "</" + this->tag;
-    } else {
-        ret += "<" + this->tag;
-    }
+    sink.write(this->type == docpp::HTML::Type::Non_Opened ? "</" : "<");
+    sink.write(this->tag.view());
 
-    for (const Property& it : this->properties.get_properties()) {
-        if (it.get_key().empty() || it.get_value().empty()) {
+    for (const Property& it : this->properties) {
+        if (it.key_view().empty() || it.value_view().empty()) {
             continue;
         }
 
-        ret += " " + it.get_key() + "=\"" + it.get_value() + "\"";
+        // an unquoted value directly before /> would take the slash as part of the value
+        const bool quote{!minified || this->type == docpp::HTML::Type::Self_Closing || !impl_minify_unquoted(it.value_view())};
+
+        sink.write(" ");
+        sink.write(it.key_view());
+        sink.write(quote ? "=\"" : "=");
+        write_text(it.value_view());
+
+        if (quote) {
+            sink.write("\"");
+        }
     }
 
     if (this->type != docpp::HTML::Type::Self_Closing && this->type != docpp::HTML::Type::Non_Opened) {
-        ret += ">";
+        sink.write(">");
     }
 
     if (this->type == docpp::HTML::Type::Non_Self_Closing) {
-        ret += this->data + "</" + this->tag + ">";
+        write_data(this->data);
+
+        if (close) {
+            sink.write("</");
+            sink.write(this->tag.view());
+            sink.write(">");
+        }
     } else if (this->type == docpp::HTML::Type::Self_Closing) {
-        ret += this->data + "/>";
+        write_data(this->data);
+        sink.write("/>");
     } else if (this->type == docpp::HTML::Type::Non_Opened) {
-        ret += ">";
+        sink.write(">");
     }
 
     if (formatting == docpp::HTML::Formatting::Pretty || formatting == docpp::HTML::Formatting::Newline) {
-        ret += "\n";
+        sink.write("\n");
     }
+}
+
+docpp::size_type docpp::HTML::Element::rendered_size(const Formatting formatting, const docpp::integer_type tabc) const {
+    CountingSink sink{};
+
+    this->write(sink, formatting, tabc);
+
+    return sink.size();
+}
+
+docpp::string_type docpp::HTML::Element::get(const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    docpp::string_type ret{};
+    // the string grows as it is written rather than being sized up front, which would write the element twice
+    StringSink sink{ret};
+
+    this->write(sink, formatting, tabc);
+
+    scope.add_bytes(ret.size());
+    impl_stats_add_string(ret.size());
 
     return ret;
 }
 
 docpp::string_type docpp::HTML::Element::get_tag() const {
-    return this->tag;
+    impl_stats_add_string(this->tag.size());
+    return docpp::string_type(this->tag.view());
 }
 
 docpp::string_type docpp::HTML::Element::get_data() const {
-    return this->data;
+    return docpp::impl_to_string(this->data);
 }
 
 docpp::HTML::Type docpp::HTML::Element::get_type() const {
@@ -132,8 +293,13 @@ bool docpp::HTML::Element::empty() const {
     return this->tag.empty() && this->data.empty() && this->properties.empty();
 }
 
+docpp::HTML::Element::allocator_type docpp::HTML::Element::get_allocator() const {
+    return this->data.get_allocator();
+}
+
 void docpp::HTML::Element::clear() {
-    this->tag.clear();
+    this->impl_modified();
+    this->tag = InternedString{};
     this->data.clear();
     this->properties.clear();
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <array>
+#include <docpp/HTML/minify.hpp>
+
+namespace {
+    // the elements that close an open p element when they start
+    constexpr std::array<std::string_view, 28> impl_html_minify_p_closers{
+        "address", "article", "aside", "blockquote", "details", "div", "dl", "fieldset", "figcaption", "figure", "footer", "form",
+        "h1", "h2", "h3", "h4", "h5", "h6", "header", "hgroup", "hr", "main", "menu", "nav", "ol", "p", "section", "table",
+    };
+
+    // the parents in which the end tag of a last p element must be kept
+    constexpr std::array<std::string_view, 7> impl_html_minify_p_parents{
+        "a", "audio", "del", "ins", "map", "noscript", "video",
+    };
+
+    // the characters that are whitespace in HTML, and the characters that need an attribute value to be quoted
+    constexpr unsigned char impl_html_minify_space{1};
+    constexpr unsigned char impl_html_minify_quote{2};
+
+    constexpr std::array<unsigned char, 256> impl_html_minify_table{[]() {
+        std::array<unsigned char, 256> ret{};
+
+        for (const char c : {' ', '\t', '\n', '\r', '\f'}) {
+            ret[static_cast<unsigned char>(c)] = impl_html_minify_space | impl_html_minify_quote;
+        }
+
+        for (const char c : {'"', '\'', '=', '<', '>', '`'}) {
+            ret[static_cast<unsigned char>(c)] = impl_html_minify_quote;
+        }
+
+        return ret;
+    }()};
+
+    bool impl_html_minify_is_space(const char c) {
+        return impl_html_minify_table[static_cast<unsigned char>(c)] & impl_html_minify_space;
+    }
+
+    template <typename T> bool impl_html_minify_contains(const T& list, const std::string_view str) {
+        return std::find(list.begin(), list.end(), str) != list.end();
+    }
+} // namespace
+
+bool docpp::HTML::impl_minify_preformatted(const std::string_view tag) {
+    // this is asked for every element that is written, so most tags are ruled out by their size alone
+    switch (tag.size()) {
+        case 3:
+            return tag == "pre";
+        case 5:
+            return tag == "style";
+        case 6:
+            return tag == "script";
+        case 8:
+            return tag == "textarea";
+        default:
+            return false;
+    }
+}
+
+bool docpp::HTML::impl_minify_unquoted(const std::string_view value) {
+    if (value.empty()) {
+        return false;
+    }
+
+    return std::none_of(value.begin(), value.end(), [](const char c) {
+        return impl_html_minify_table[static_cast<unsigned char>(c)] & impl_html_minify_quote;
+    });
+}
+
+bool docpp::HTML::impl_minify_optional_end(const std::string_view tag) {
+    switch (tag.size()) {
+        case 1:
+            return tag[0] == 'p';
+        case 2:
+            // li, dt, dd, td, th and tr
+            switch (tag[0]) {
+                case 'l':
+                    return tag[1] == 'i';
+                case 'd':
+                    return tag[1] == 't' || tag[1] == 'd';
+                case 't':
+                    return tag[1] == 'd' || tag[1] == 'h' || tag[1] == 'r';
+                default:
+                    return false;
+            }
+        case 6:
+            return tag == "option";
+        default:
+            return false;
+    }
+}
+
+bool docpp::HTML::impl_minify_omit_end(const std::string_view tag, const std::string_view next, const bool last, const std::string_view parent) {
+    if (tag == "li") {
+        return last || next == "li";
+    } else if (tag == "dt") {
+        return !last && (next == "dt" || next == "dd");
+    } else if (tag == "dd") {
+        return last || next == "dt" || next == "dd";
+    } else if (tag == "p") {
+        return last ? !impl_html_minify_contains(impl_html_minify_p_parents, parent) : impl_html_minify_contains(impl_html_minify_p_closers, next);
+    } else if (tag == "td" || tag == "th") {
+        return last || next == "td" || next == "th";
+    } else if (tag == "tr") {
+        return last || next == "tr";
+    } else if (tag == "option") {
+        return last || next == "option" || next == "optgroup";
+    }
+
+    return false;
+}
+
+void docpp::HTML::impl_minify_write_text(Sink& sink, const std::string_view text, const bool escape) {
+    const auto write = [&sink, escape](const std::string_view str) {
+        if (escape) {
+            sink.write_escaped(str);
+        } else {
+            sink.write(str);
+        }
+    };
+
+    size_type start{0};
+
+    for (size_type i{0}; i < text.size(); ++i) {
+        if (!impl_html_minify_is_space(text[i])) {
+            continue;
+        }
+
+        // a single space is kept as it is, so that plain text is written in one piece
+        if (text[i] == ' ' && (i + 1 == text.size() || !impl_html_minify_is_space(text[i + 1]))) {
+            continue;
+        }
+
+        size_type end{i + 1};
+        while (end < text.size() && impl_html_minify_is_space(text[end])) {
+            ++end;
+        }
+
+        write(text.substr(start, i - start));
+        sink.write(" ");
+
+        start = end;
+        i = end - 1;
+    }
+
+    write(text.substr(start));
+}
\ No newline at end of file
@@ -0,0 +1,552 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+#include <docpp/except.hpp>
+#include <docpp/intern.hpp>
+#include <docpp/mapped_file.hpp>
+#include <docpp/HTML/tag.hpp>
+#include <docpp/HTML/minify.hpp>
+#include <docpp/HTML/parser.hpp>
+
+namespace {
+    constexpr bool impl_html_is_space(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    constexpr bool impl_html_is_alpha(const char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    constexpr char impl_html_lower(const char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool impl_html_iequals(const std::string_view a, const std::string_view b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+
+        for (docpp::size_type i{0}; i < a.size(); i++) {
+            if (impl_html_lower(a[i]) != impl_html_lower(b[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool impl_html_is_blank(const std::string_view str) {
+        for (const char c : str) {
+            if (!impl_html_is_space(c)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* elements that are laid out on lines of their own, so that whitespace between them only lays out the markup */
+    constexpr std::array<std::string_view, 58> impl_html_blocks{
+        "address", "article", "aside", "base", "blockquote", "body", "caption", "col", "colgroup", "dd", "details", "dialog", "div", "dl",
+        "dt", "fieldset", "figcaption", "figure", "footer", "form", "h1", "h2", "h3", "h4", "h5", "h6", "head", "header", "hgroup", "hr",
+        "html", "li", "link", "main", "menu", "meta", "nav", "noscript", "ol", "optgroup", "option", "p", "pre", "script", "section",
+        "select", "style", "summary", "table", "tbody", "td", "template", "tfoot", "th", "thead", "title", "tr", "ul",
+    };
+
+    /* elements that never hold text of their own, so that whitespace between their children only lays out the markup */
+    constexpr std::array<std::string_view, 15> impl_html_textless{
+        "colgroup", "datalist", "dl", "head", "html", "menu", "ol", "optgroup", "select", "table", "tbody", "tfoot", "thead", "tr", "ul",
+    };
+
+    template <typename T> bool impl_html_contains(const T& list, const std::string_view name) {
+        return std::any_of(list.begin(), list.end(), [&name](const std::string_view it) {
+            return impl_html_iequals(it, name);
+        });
+    }
+
+    /* elements whose content is never parsed as markup */
+    bool impl_html_is_raw_text(const std::string_view name) {
+        return name == "script" || name == "style" || name == "textarea" || name == "title";
+    }
+
+    /* start tags that imply the end tag of an open element, such as li for an open li */
+    bool impl_html_implies_end(const std::string_view name) {
+        return name == "li" || name == "dt" || name == "dd" || name == "td" || name == "th" || name == "tr" || name == "option"
+            || name == "optgroup" || docpp::HTML::impl_minify_omit_end("p", name, false, {});
+    }
+
+    /* whether the open element whose end tag a start tag implies is looked for past another open element */
+    bool impl_html_implies_end_through(const std::string_view open, const std::string_view name) {
+        if (name == "option" || name == "optgroup") {
+            return false;
+        } else if (name == "td" || name == "th" || name == "tr") {
+            return open != "table" && open != "tbody" && open != "thead" && open != "tfoot" && open != "html" && open != "template"
+                && (name == "tr" || open != "tr");
+        } else if (open == "applet" || open == "button" || open == "caption" || open == "html" || open == "marquee" || open == "object"
+            || open == "table" || open == "td" || open == "template" || open == "th") {
+            return false;
+        } else if (name == "li") {
+            return open != "ol" && open != "ul";
+        } else if (name == "dt" || name == "dd") {
+            return open != "dl";
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Single-pass tokenizer and tree builder. Open sections are kept on an explicit stack rather than the call stack,
+     * and are moved into their parent when they are closed.
+     */
+    class impl_html_parser {
+        private:
+            std::string_view input{};
+            docpp::size_type pos{0};
+            docpp::allocator_type allocator{};
+            std::vector<docpp::HTML::Section> stack{};
+            /* names that are not in the intern pool, copied once per parse with the allocator and shared by every node using them */
+            std::pmr::unordered_map<std::string_view, docpp::InternedString> names;
+            docpp::InternedString tag{};
+            /* scratch buffers, so that strings are only allocated when they are stored in a node */
+            docpp::string_type lowered{};
+            docpp::string_type data{};
+            docpp::string_type key{};
+            docpp::string_type value{};
+            /* whether the last node added to the open element is block-level, or its start tag if it has none */
+            bool block{true};
+
+            [[nodiscard]] bool at_end() const {
+                return this->pos >= this->input.size();
+            }
+
+            void skip_space() {
+                while (!this->at_end() && impl_html_is_space(this->input[this->pos])) {
+                    ++this->pos;
+                }
+            }
+
+            [[nodiscard]] std::string_view read_name() {
+                const docpp::size_type start{this->pos};
+
+                while (!this->at_end()) {
+                    const char c{this->input[this->pos]};
+
+                    if (impl_html_is_space(c) || c == '>' || c == '/' || c == '=' || c == '"' || c == '\'') {
+                        break;
+                    }
+
+                    ++this->pos;
+                }
+
+                return this->input.substr(start, this->pos - start);
+            }
+
+            [[nodiscard]] docpp::size_type find(const std::string_view str, const docpp::size_type from) const {
+                const docpp::size_type ret{this->input.find(str, from)};
+                return ret == std::string_view::npos ? this->input.size() : ret;
+            }
+
+            [[nodiscard]] docpp::InternedString shared_name(const std::string_view str) {
+                if (std::optional<docpp::InternedString> interned{docpp::InternPool::get().find(str)}) {
+                    return std::move(*interned);
+                }
+
+                const auto it = this->names.find(str);
+
+                if (it != this->names.end()) {
+                    return it->second;
+                }
+
+                docpp::InternedString name{str, this->allocator};
+                const std::string_view view{name.view()};
+
+                return this->names.emplace(view, std::move(name)).first->second;
+            }
+
+            /* resolve a tag name through the tag table, falling back to the name in lower case for unknown tags */
+            void resolve(const std::string_view name, std::optional<docpp::HTML::Tag>& resolved) {
+                this->lowered.resize(name.size());
+                for (docpp::size_type i{0}; i < name.size(); i++) {
+                    this->lowered[i] = impl_html_lower(name[i]);
+                }
+
+                resolved = docpp::HTML::find_tag(this->lowered);
+
+                if (resolved.has_value()) {
+                    this->tag = docpp::HTML::get_interned_tag_name(resolved.value());
+                } else {
+                    this->tag = this->shared_name(this->lowered);
+                }
+            }
+
+            /* whether the markup at pos, a '<', starts or ends a block-level element; comments and the like are inline */
+            [[nodiscard]] bool block_at(docpp::size_type pos) const {
+                pos += pos + 1 < this->input.size() && this->input[pos + 1] == '/' ? 2 : 1;
+                const docpp::size_type start{pos};
+
+                while (pos < this->input.size() && !impl_html_is_space(this->input[pos]) && this->input[pos] != '>' && this->input[pos] != '/') {
+                    ++pos;
+                }
+
+                return impl_html_contains(impl_html_blocks, this->input.substr(start, pos - start));
+            }
+
+            /* whitespace only lays out the markup between block-level elements and between the children of elements that hold no text,
+               and is left out there; elsewhere, and anywhere inside pre and textarea, it separates words and is kept */
+            void push_text(const std::string_view text, const bool block_after) {
+                if (text.empty()) {
+                    return;
+                }
+
+                if (impl_html_is_blank(text) && this->is_layout(block_after)) {
+                    return;
+                }
+
+                this->data.assign(text.data(), text.size());
+                this->stack.back().emplace_back<docpp::HTML::Element>(docpp::HTML::Tag::Empty_No_Formatting, docpp::HTML::Properties{}, this->data);
+                this->block = false;
+            }
+
+            [[nodiscard]] bool is_layout(const bool block_after) const {
+                for (const docpp::HTML::Section& it : this->stack) {
+                    if (docpp::HTML::impl_minify_preformatted(it.tag_view())) {
+                        return false;
+                    }
+                }
+
+                return impl_html_contains(impl_html_textless, this->stack.back().tag_view()) || (this->block && block_after);
+            }
+
+            void push_element(docpp::HTML::Properties&& properties, const std::string_view text, const docpp::HTML::Type type) {
+                this->data.assign(text.data(), text.size());
+                this->stack.back().emplace_back<docpp::HTML::Element>(this->tag, std::move(properties), this->data, type);
+                this->block = impl_html_contains(impl_html_blocks, this->tag.view());
+            }
+
+            void close_top() {
+                docpp::HTML::Section section{std::move(this->stack.back())};
+                this->stack.pop_back();
+                this->block = impl_html_contains(impl_html_blocks, section.tag_view());
+                this->stack.back().push_back(std::move(section));
+            }
+
+            /* close the open elements whose end tag is implied by a start tag, which Formatting::Minified leaves out */
+            void close_implied(const std::string_view name) {
+                if (!impl_html_implies_end(name)) {
+                    return;
+                }
+
+                for (docpp::size_type i{this->stack.size() - 1}; i > 0; i--) {
+                    const std::string_view open{this->stack[i].tag_view()};
+
+                    if (docpp::HTML::impl_minify_omit_end(open, name, false, {})) {
+                        while (this->stack.size() > i) {
+                            this->close_top();
+                        }
+
+                        return;
+                    } else if (!impl_html_implies_end_through(open, name)) {
+                        return;
+                    }
+                }
+            }
+
+            /* parses the attributes of a start tag, returning true if the tag is self-closing (<tag/>) */
+            bool parse_attributes(docpp::HTML::Properties& properties) {
+                while (true) {
+                    this->skip_space();
+
+                    if (this->at_end()) {
+                        throw docpp::invalid_argument{"Unterminated tag"};
+                    }
+
+                    const char c{this->input[this->pos]};
+
+                    if (c == '>') {
+                        ++this->pos;
+                        return false;
+                    } else if (c == '/') {
+                        ++this->pos;
+
+                        if (!this->at_end() && this->input[this->pos] == '>') {
+                            ++this->pos;
+                            return true;
+                        }
+
+                        continue;
+                    }
+
+                    std::string_view name{this->read_name()};
+
+                    if (name.empty()) { // stray quote or equals sign
+                        name = this->input.substr(this->pos++, 1);
+                    }
+
+                    this->key.resize(name.size());
+                    for (docpp::size_type i{0}; i < name.size(); i++) {
+                        this->key[i] = impl_html_lower(name[i]);
+                    }
+                    this->skip_space();
+
+                    if (this->at_end() || this->input[this->pos] != '=') {
+                        properties.emplace_back(this->shared_name(this->key), this->key);
+                        continue;
+                    }
+
+                    ++this->pos;
+                    this->skip_space();
+
+                    if (this->at_end()) {
+                        throw docpp::invalid_argument{"Unterminated tag"};
+                    }
+
+                    const char quote{this->input[this->pos]};
+
+                    if (quote == '"' || quote == '\'') {
+                        const docpp::size_type end{this->input.find(quote, this->pos + 1)};
+
+                        if (end == std::string_view::npos) {
+                            throw docpp::invalid_argument{"Unterminated attribute value"};
+                        }
+
+                        this->value.assign(this->input.data() + this->pos + 1, end - this->pos - 1);
+                        this->pos = end + 1;
+
+                        // values are written back in double quotes, so a double quote inside single quotes is encoded
+                        if (quote == '\'') {
+                            for (docpp::size_type i{this->value.find('"')}; i != docpp::string_type::npos; i = this->value.find('"', i + 6)) {
+                                this->value.replace(i, 1, "&quot;");
+                            }
+                        }
+                    } else {
+                        const docpp::size_type start{this->pos};
+
+                        while (!this->at_end() && !impl_html_is_space(this->input[this->pos]) && this->input[this->pos] != '>') {
+                            ++this->pos;
+                        }
+
+                        this->value.assign(this->input.data() + start, this->pos - start);
+                    }
+
+                    properties.emplace_back(this->shared_name(this->key), this->value);
+                }
+            }
+
+            /* returns the position after the end tag </name> if it starts at pos, or npos */
+            [[nodiscard]] docpp::size_type match_end_tag(docpp::size_type pos, const std::string_view name) const {
+                if (this->input.compare(pos, 2, "</") != 0) {
+                    return std::string_view::npos;
+                }
+
+                pos += 2;
+
+                if (!impl_html_iequals(this->input.substr(pos, name.size()), name)) {
+                    return std::string_view::npos;
+                }
+
+                pos += name.size();
+
+                while (pos < this->input.size() && impl_html_is_space(this->input[pos])) {
+                    ++pos;
+                }
+
+                return pos < this->input.size() && this->input[pos] == '>' ? pos + 1 : std::string_view::npos;
+            }
+
+            void parse_start_tag() {
+                const std::string_view name{this->read_name()};
+                std::optional<docpp::HTML::Tag> resolved{};
+                this->resolve(name, resolved);
+
+                docpp::HTML::Properties properties{this->allocator};
+                const bool self_closing{this->parse_attributes(properties)};
+
+                this->close_implied(this->lowered);
+
+                if (self_closing) {
+                    this->push_element(std::move(properties), {}, docpp::HTML::Type::Self_Closing);
+                    return;
+                }
+
+                if (resolved.has_value()) {
+                    const docpp::HTML::Type type{docpp::HTML::get_tag_type(resolved.value())};
+
+                    if (type == docpp::HTML::Type::Self_Closing || type == docpp::HTML::Type::Non_Closed) {
+                        this->push_element(std::move(properties), {}, docpp::HTML::Type::Non_Closed);
+                        return;
+                    }
+                }
+
+                if (impl_html_is_raw_text(this->lowered)) {
+                    docpp::size_type end{this->pos};
+
+                    while ((end = this->find("</", end)) < this->input.size()) {
+                        const docpp::size_type after{this->match_end_tag(end, name)};
+
+                        if (after != std::string_view::npos) {
+                            this->push_element(std::move(properties), this->input.substr(this->pos, end - this->pos), docpp::HTML::Type::Non_Self_Closing);
+                            this->pos = after;
+                            return;
+                        }
+
+                        end += 2;
+                    }
+
+                    this->push_element(std::move(properties), this->input.substr(this->pos), docpp::HTML::Type::Non_Self_Closing);
+                    this->pos = this->input.size();
+                    return;
+                }
+
+                // an element that holds nothing but text is an Element, anything else is a Section
+                const docpp::size_type next{this->find("<", this->pos)};
+                const docpp::size_type after{next < this->input.size() ? this->match_end_tag(next, name) : std::string_view::npos};
+
+                if (after != std::string_view::npos) {
+                    this->push_element(std::move(properties), this->input.substr(this->pos, next - this->pos), docpp::HTML::Type::Non_Self_Closing);
+                    this->pos = after;
+                    return;
+                }
+
+                this->stack.emplace_back(this->tag, std::move(properties), this->allocator);
+                this->block = impl_html_contains(impl_html_blocks, this->tag.view());
+            }
+
+            void parse_end_tag() {
+                const std::string_view name{this->read_name()};
+                const docpp::size_type end{this->input.find('>', this->pos)};
+
+                if (end == std::string_view::npos) {
+                    throw docpp::invalid_argument{"Unterminated tag"};
+                }
+
+                this->pos = end + 1;
+
+                std::optional<docpp::HTML::Tag> resolved{};
+                this->resolve(name, resolved);
+
+                // close the innermost matching section, and any section left open inside it
+                for (docpp::size_type i{this->stack.size() - 1}; i > 0; i--) {
+                    if (impl_html_iequals(this->stack[i].tag_view(), this->tag.view())) {
+                        while (this->stack.size() > i) {
+                            this->close_top();
+                        }
+
+                        return;
+                    }
+                }
+
+                this->push_element(docpp::HTML::Properties{this->allocator}, {}, docpp::HTML::Type::Non_Opened);
+            }
+        public:
+            impl_html_parser(const std::string_view input, const docpp::allocator_type& allocator) : input(input), allocator(allocator), names(allocator.resource()) {
+                this->stack.emplace_back(allocator);
+            }
+
+            docpp::HTML::Section parse() {
+                docpp::size_type text{this->pos};
+
+                while (!this->at_end()) {
+                    const char* lt{static_cast<const char*>(std::memchr(this->input.data() + this->pos, '<', this->input.size() - this->pos))};
+
+                    if (lt == nullptr) {
+                        break;
+                    }
+
+                    const docpp::size_type start{static_cast<docpp::size_type>(lt - this->input.data())};
+                    const char c{start + 1 < this->input.size() ? this->input[start + 1] : '\0'};
+                    const bool end_tag{c == '/' && start + 2 < this->input.size() && impl_html_is_alpha(this->input[start + 2])};
+
+                    if (!impl_html_is_alpha(c) && !end_tag && c != '!' && c != '?') { // not markup, e.g. "a < b"
+                        this->pos = start + 1;
+                        continue;
+                    }
+
+                    this->push_text(this->input.substr(text, start - text), this->block_at(start));
+
+                    if (end_tag) {
+                        this->pos = start + 2;
+                        this->parse_end_tag();
+                    } else if (impl_html_is_alpha(c)) {
+                        this->pos = start + 1;
+                        this->parse_start_tag();
+                    } else { // comments, doctype declarations and processing instructions are kept as they are
+                        const bool comment{this->input.compare(start, 4, "<!--") == 0};
+                        const docpp::size_type end{comment ? this->input.find("-->", start + 4) : this->input.find('>', start)};
+
+                        if (end == std::string_view::npos) {
+                            throw docpp::invalid_argument{comment ? "Unterminated comment" : "Unterminated tag"};
+                        }
+
+                        this->pos = end + (comment ? 3 : 1);
+                        this->data.assign(this->input.data() + start, this->pos - start);
+                        this->stack.back().emplace_back<docpp::HTML::Element>(docpp::HTML::Tag::Raw, docpp::HTML::Properties{}, this->data);
+                        this->block = false;
+                    }
+
+                    text = this->pos;
+                }
+
+                this->push_text(this->input.substr(text), true);
+
+                while (this->stack.size() > 1) {
+                    this->close_top();
+                }
+
+                return std::move(this->stack.front());
+            }
+    };
+} // namespace
+
+docpp::HTML::Section docpp::HTML::parse(const std::string_view input, const allocator_type& allocator) {
+    return impl_html_parser{input, allocator}.parse();
+}
+
+docpp::HTML::Document docpp::HTML::parse_document(std::string_view input, const allocator_type& allocator) {
+    docpp::size_type start{0};
+
+    if (input.compare(0, 3, "\xEF\xBB\xBF") == 0) { // UTF-8 byte order mark
+        start = 3;
+    }
+
+    while (start < input.size() && impl_html_is_space(input[start])) {
+        ++start;
+    }
+
+    std::string_view doctype{};
+
+    if (impl_html_iequals(input.substr(start, 9), "<!doctype")) {
+        const docpp::size_type end{input.find('>', start)};
+
+        if (end == std::string_view::npos) {
+            throw docpp::invalid_argument{"Unterminated doctype"};
+        }
+
+        doctype = input.substr(start, end + 1 - start);
+        start = end + 1;
+    }
+
+    Section section{parse(input.substr(start), allocator)};
+
+    if (section.size() == 1 && section.sections_view().size() == 1) {
+        Section root{std::move(section.front_section())};
+        return Document{std::move(root), docpp::string_type(doctype), allocator};
+    }
+
+    return Document{std::move(section), docpp::string_type(doctype), allocator};
+}
+
+docpp::HTML::Document docpp::HTML::parse_file(const docpp::string_type& path, const allocator_type& allocator) {
+    const MappedFile file{path};
+
+    return parse_document(file.view(), allocator);
+}
\ No newline at end of file
@@ -0,0 +1,562 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <stack>
+#include <unordered_map>
+#include <utility>
+#include <docpp/except.hpp>
+#include <docpp/hash.hpp>
+#include <docpp/HTML/patch.hpp>
+
+namespace {
+    const docpp::HTML::Property& impl_html_patch_at(const docpp::HTML::Properties& properties, const docpp::size_type index) {
+        return *(properties.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+
+    docpp::size_type impl_html_patch_find(const docpp::HTML::Properties& properties, const docpp::InternedString key) {
+        for (docpp::size_type i{0}; i < properties.size(); i++) {
+            if (impl_html_patch_at(properties, i).interned_key() == key) {
+                return i;
+            }
+        }
+
+        return docpp::HTML::Properties::npos;
+    }
+
+    /* the attribute changes that turn one list of properties into another, which is not possible if attributes have to be
+     * reordered, or are empty or repeated, as setting an attribute changes it in place or appends it, and an empty value removes it */
+    bool impl_html_patch_properties(const docpp::HTML::Properties& from, const docpp::HTML::Properties& to, std::vector<std::pair<docpp::string_type, docpp::string_type>>& changes) {
+        if (from == to) {
+            return true;
+        }
+
+        for (docpp::size_type i{0}; i < to.size(); i++) {
+            const docpp::HTML::Property& property{impl_html_patch_at(to, i)};
+
+            if (property.key_view().empty() || property.value_view().empty() || impl_html_patch_find(to, property.interned_key()) != i) {
+                return false;
+            }
+        }
+
+        // the attributes that are kept stay in place, and new ones are appended after them
+        docpp::size_type kept{0};
+        for (docpp::size_type i{0}; i < from.size(); i++) {
+            const docpp::InternedString key{impl_html_patch_at(from, i).interned_key()};
+
+            if (impl_html_patch_find(from, key) != i) {
+                return false;
+            }
+
+            if (impl_html_patch_find(to, key) == docpp::HTML::Properties::npos) {
+                changes.emplace_back(key.view(), "");
+            } else if (impl_html_patch_at(to, kept++).interned_key() != key) {
+                return false;
+            }
+        }
+
+        for (docpp::size_type i{0}; i < to.size(); i++) {
+            const docpp::HTML::Property& property{impl_html_patch_at(to, i)};
+            const docpp::size_type index{impl_html_patch_find(from, property.interned_key())};
+
+            if (index == docpp::HTML::Properties::npos || impl_html_patch_at(from, index).value_view() != property.value_view()) {
+                changes.emplace_back(property.key_view(), property.value_view());
+            }
+        }
+
+        return true;
+    }
+
+    void impl_html_patch_set_property(docpp::HTML::Properties& properties, const docpp::string_type& key, const docpp::string_type& value) {
+        const docpp::InternedString c_key{key};
+        const docpp::size_type index{impl_html_patch_find(properties, c_key)};
+
+        if (index == docpp::HTML::Properties::npos) {
+            if (!value.empty()) {
+                properties.push_back(docpp::HTML::Property{c_key, value});
+            }
+        } else if (value.empty()) {
+            properties.erase(index);
+        } else {
+            (properties.begin() + static_cast<std::ptrdiff_t>(index))->set_value(value);
+        }
+    }
+
+    /* the hash a child is matched by, which tells elements and sections apart */
+    std::uint64_t impl_html_patch_key(const std::uint64_t kind, const std::uint64_t hash) {
+        std::uint64_t ret{docpp::impl_hash_basis};
+        docpp::impl_hash_value(ret, kind);
+        docpp::impl_hash_value(ret, hash);
+        return docpp::impl_hash_finish(ret);
+    }
+
+    /* the slot of the child at an index of a patch, which does not count erased children, or the size of the section for the index past the last child */
+    docpp::size_type impl_html_patch_slot(const docpp::HTML::Section& section, const docpp::size_type index) {
+        docpp::size_type count{0};
+
+        for (docpp::size_type i{0}; i < section.size(); i++) {
+            if (std::holds_alternative<std::monostate>(section.children_ref()[i])) {
+                continue;
+            }
+
+            if (count++ == index) {
+                return i;
+            }
+        }
+
+        if (count == index) {
+            return section.size();
+        }
+
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    void impl_html_patch_write_string(docpp::Sink& sink, const std::string_view str) {
+        docpp::size_type start{0};
+
+        sink.write("\"");
+
+        for (docpp::size_type i{0}; i < str.size(); i++) {
+            const unsigned char c{static_cast<unsigned char>(str[i])};
+
+            if (c != '"' && c != '\\' && c >= 0x20) {
+                continue;
+            }
+
+            sink.write(str.substr(start, i - start));
+            start = i + 1;
+
+            if (c == '"') {
+                sink.write("\\\"");
+            } else if (c == '\\') {
+                sink.write("\\\\");
+            } else if (c == '\n') {
+                sink.write("\\n");
+            } else if (c == '\t') {
+                sink.write("\\t");
+            } else {
+                char buf[7]{};
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                sink.write(buf);
+            }
+        }
+
+        sink.write(str.substr(start));
+        sink.write("\"");
+    }
+} // namespace
+
+docpp::HTML::Change::Change(const Operation operation, std::vector<size_type> path, const size_type index)
+    : operation(operation), path(std::move(path)), index(index) {}
+
+docpp::HTML::Change::Change(const Operation operation, std::vector<size_type> path, const size_type index, Section::node_type node)
+    : operation(operation), path(std::move(path)), index(index), node(std::move(node)) {}
+
+docpp::HTML::Change::Change(const Operation operation, std::vector<size_type> path, const size_type index, const docpp::string_type& key, const docpp::string_type& value)
+    : operation(operation), path(std::move(path)), index(index), key(key), value(value) {}
+
+docpp::HTML::Operation docpp::HTML::Change::get_operation() const {
+    return this->operation;
+}
+
+const std::vector<docpp::size_type>& docpp::HTML::Change::get_path() const {
+    return this->path;
+}
+
+docpp::size_type docpp::HTML::Change::get_index() const {
+    return this->index;
+}
+
+const docpp::HTML::Section::node_type& docpp::HTML::Change::get_node() const {
+    return this->node;
+}
+
+docpp::string_type docpp::HTML::Change::get_key() const {
+    return this->key;
+}
+
+docpp::string_type docpp::HTML::Change::get_value() const {
+    return this->value;
+}
+
+void docpp::HTML::Patch::push_back(const Change& change) {
+    this->changes.push_back(change);
+}
+
+void docpp::HTML::Patch::push_back(Change&& change) {
+    this->changes.push_back(std::move(change));
+}
+
+const docpp::HTML::Change& docpp::HTML::Patch::at(const size_type index) const {
+    if (index >= this->changes.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    return this->changes[index];
+}
+
+docpp::size_type docpp::HTML::Patch::size() const {
+    return this->changes.size();
+}
+
+bool docpp::HTML::Patch::empty() const {
+    return this->changes.empty();
+}
+
+void docpp::HTML::Patch::clear() {
+    this->changes.clear();
+}
+
+void docpp::HTML::Patch::write(Sink& sink) const {
+    static constexpr std::string_view names[]{"insert", "remove", "replace", "set-attribute", "set-text"};
+
+    sink.write("[");
+
+    for (size_type i{0}; i < this->changes.size(); i++) {
+        const Change& it{this->changes[i]};
+
+        sink.write(i == 0 ? "{\"op\":\"" : ",{\"op\":\"");
+        sink.write(names[static_cast<size_type>(it.get_operation())]);
+        sink.write("\",\"path\":[");
+
+        for (size_type j{0}; j < it.get_path().size(); j++) {
+            if (j != 0) {
+                sink.write(",");
+            }
+
+            sink.write(std::to_string(it.get_path()[j]));
+        }
+
+        sink.write("]");
+
+        if (it.get_index() != Change::npos) {
+            sink.write(",\"index\":");
+            sink.write(std::to_string(it.get_index()));
+        }
+
+        if (it.get_operation() == Operation::Insert || it.get_operation() == Operation::Replace) {
+            docpp::string_type html{};
+            StringSink html_sink{html};
+            html_sink.set_escaping(sink.is_escaping());
+
+            if (const Element* element = std::get_if<Element>(&it.get_node())) {
+                element->write(html_sink);
+            } else if (const Section* section = std::get_if<Section>(&it.get_node())) {
+                section->write(html_sink);
+            }
+
+            sink.write(",\"html\":");
+            impl_html_patch_write_string(sink, html);
+        } else if (it.get_operation() == Operation::Set_Attribute) {
+            sink.write(",\"key\":");
+            impl_html_patch_write_string(sink, it.get_key());
+            sink.write(",\"value\":");
+            impl_html_patch_write_string(sink, it.get_value());
+        } else if (it.get_operation() == Operation::Set_Text) {
+            sink.write(",\"value\":");
+            impl_html_patch_write_string(sink, it.get_value());
+        }
+
+        sink.write("}");
+    }
+
+    sink.write("]");
+}
+
+docpp::string_type docpp::HTML::Patch::get() const {
+    docpp::string_type ret{};
+    StringSink sink{ret};
+
+    this->write(sink);
+
+    return ret;
+}
+
+docpp::HTML::Patch docpp::HTML::diff(const Section& old_section, const Section& new_section) {
+    struct Entry {
+        const Section* old_section{nullptr};
+        const Section* new_section{nullptr};
+        std::vector<size_type> path{};
+    };
+
+    Patch ret{};
+    std::vector<std::pair<docpp::string_type, docpp::string_type>> properties{};
+    std::vector<const Section::node_type*> old_children{};
+    std::vector<const Section::node_type*> new_children{};
+    std::vector<std::uint64_t> old_keys{};
+    std::vector<std::uint64_t> new_keys{};
+    std::vector<std::pair<std::uint64_t, size_type>> sorted{};
+    std::unordered_map<std::uint64_t, size_type> taken{};
+    std::vector<std::pair<size_type, size_type>> candidates{};
+    std::vector<size_type> tails{};
+    std::vector<size_type> previous{};
+    std::vector<std::pair<size_type, size_type>> anchors{};
+
+    // the attribute changes of a node, or false if it has to be replaced
+    const auto set_properties = [&ret, &properties](const Properties& from, const Properties& to, const std::vector<size_type>& path, const size_type index) {
+        properties.clear();
+
+        if (!impl_html_patch_properties(from, to, properties)) {
+            return false;
+        }
+
+        for (std::pair<docpp::string_type, docpp::string_type>& it : properties) {
+            ret.push_back(Change{Operation::Set_Attribute, path, index, it.first, it.second});
+        }
+
+        return true;
+    };
+
+    // the children of a section that have not been erased, and the hashes they are matched by
+    const auto collect = [](const Section& section, std::vector<const Section::node_type*>& children, std::vector<std::uint64_t>& keys) {
+        children.clear();
+        keys.clear();
+
+        for (const Section::node_type& it : section.children_ref()) {
+            if (const Element* element = std::get_if<Element>(&it)) {
+                children.push_back(&it);
+                keys.push_back(impl_html_patch_key(1, element->hash()));
+            } else if (const Section* section = std::get_if<Section>(&it)) {
+                children.push_back(&it);
+                keys.push_back(impl_html_patch_key(2, section->hash()));
+            }
+        }
+    };
+
+    if (old_section.hash() == new_section.hash()) {
+        return ret;
+    }
+
+    if (old_section.tag_view() != new_section.tag_view() || !set_properties(old_section.properties_ref(), new_section.properties_ref(), {}, Change::npos)) {
+        ret.push_back(Change{Operation::Replace, {}, Change::npos, Section::node_type{new_section}});
+        return ret;
+    }
+
+    std::stack<Entry> s_stack{};
+    s_stack.push({&old_section, &new_section, {}});
+
+    while (!s_stack.empty()) {
+        const Entry c_entry{std::move(s_stack.top())};
+        s_stack.pop();
+
+        collect(*c_entry.old_section, old_children, old_keys);
+        collect(*c_entry.new_section, new_children, new_keys);
+
+        // the children before and after the changed ones are usually the same
+        size_type prefix{0};
+        while (prefix < old_keys.size() && prefix < new_keys.size() && old_keys[prefix] == new_keys[prefix]) {
+            ++prefix;
+        }
+
+        size_type suffix{0};
+        while (suffix < old_keys.size() - prefix && suffix < new_keys.size() - prefix
+            && old_keys[old_keys.size() - 1 - suffix] == new_keys[new_keys.size() - 1 - suffix]) {
+            ++suffix;
+        }
+
+        const size_type old_end{old_keys.size() - suffix};
+        const size_type new_end{new_keys.size() - suffix};
+
+        // the children in between that are kept are the longest run of unchanged children that are in the same order in both,
+        // where the nth occurrence of a child in the new section is matched with its nth occurrence in the old section
+        anchors.clear();
+
+        if (prefix < old_end && prefix < new_end) {
+            sorted.clear();
+            taken.clear();
+            candidates.clear();
+
+            for (size_type i{prefix}; i < old_end; i++) {
+                sorted.emplace_back(old_keys[i], i);
+            }
+
+            std::sort(sorted.begin(), sorted.end());
+
+            for (size_type j{prefix}; j < new_end; j++) {
+                const auto it{std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(new_keys[j], size_type{0}))};
+                const size_type k{static_cast<size_type>(it - sorted.begin()) + taken[new_keys[j]]};
+
+                if (k < sorted.size() && sorted[k].first == new_keys[j]) {
+                    ++taken[new_keys[j]];
+                    candidates.emplace_back(sorted[k].second, j);
+                }
+            }
+
+            // longest increasing run of old indices, by patience sorting
+            tails.clear();
+            previous.assign(candidates.size(), Patch::npos);
+
+            for (size_type i{0}; i < candidates.size(); i++) {
+                const auto it{std::lower_bound(tails.begin(), tails.end(), candidates[i].first, [&candidates](const size_type tail, const size_type index) {
+                    return candidates[tail].first < index;
+                })};
+
+                if (it != tails.begin()) {
+                    previous[i] = *(it - 1);
+                }
+
+                if (it == tails.end()) {
+                    tails.push_back(i);
+                } else {
+                    *it = i;
+                }
+            }
+
+            for (size_type i{tails.empty() ? Patch::npos : tails.back()}; i != Patch::npos; i = previous[i]) {
+                anchors.push_back(candidates[i]);
+            }
+
+            std::reverse(anchors.begin(), anchors.end());
+        }
+
+        anchors.emplace_back(old_end, new_end);
+
+        // the children between two kept ones are changed in place pairwise, and the rest are removed or inserted. Changes are
+        // applied in order, so the index of a change is the index of the next child of the new section that is not in place yet.
+        size_type old_index{prefix};
+        size_type new_index{prefix};
+
+        for (const std::pair<size_type, size_type>& anchor : anchors) {
+            for (; old_index < anchor.first && new_index < anchor.second; old_index++, new_index++) {
+                if (old_keys[old_index] == new_keys[new_index]) {
+                    continue;
+                }
+
+                const Section::node_type& old_child{*old_children[old_index]};
+                const Section::node_type& new_child{*new_children[new_index]};
+                const Element* old_element{std::get_if<Element>(&old_child)};
+                const Element* new_element{std::get_if<Element>(&new_child)};
+
+                if (old_element && new_element) {
+                    if (old_element->tag_view() == new_element->tag_view() && old_element->get_type() == new_element->get_type()
+                        && old_element->is_escaping() == new_element->is_escaping()
+                        && set_properties(old_element->properties_ref(), new_element->properties_ref(), c_entry.path, new_index)) {
+                        if (old_element->data_view() != new_element->data_view()) {
+                            ret.push_back(Change{Operation::Set_Text, c_entry.path, new_index, {}, new_element->get_data()});
+                        }
+
+                        continue;
+                    }
+
+                    ret.push_back(Change{Operation::Replace, c_entry.path, new_index, new_child});
+                    continue;
+                }
+
+                const Section* old_child_section{std::get_if<Section>(&old_child)};
+                const Section* new_child_section{std::get_if<Section>(&new_child)};
+
+                if (old_child_section && new_child_section) {
+                    std::vector<size_type> path{c_entry.path};
+                    path.push_back(new_index);
+
+                    // the children of the pair are changed after every change to this section, by which time it is at its new index
+                    if (old_child_section->tag_view() == new_child_section->tag_view()
+                        && set_properties(old_child_section->properties_ref(), new_child_section->properties_ref(), path, Change::npos)) {
+                        s_stack.push({old_child_section, new_child_section, std::move(path)});
+                        continue;
+                    }
+                }
+
+                ret.push_back(Change{Operation::Replace, c_entry.path, new_index, new_child});
+            }
+
+            for (; old_index < anchor.first; old_index++) {
+                ret.push_back(Change{Operation::Remove, c_entry.path, new_index});
+            }
+
+            for (; new_index < anchor.second; new_index++) {
+                ret.push_back(Change{Operation::Insert, c_entry.path, new_index, *new_children[new_index]});
+            }
+
+            // the kept child itself
+            ++old_index;
+            ++new_index;
+        }
+    }
+
+    return ret;
+}
+
+void docpp::HTML::apply(Section& section, const Patch& patch) {
+    for (const Change& it : patch) {
+        Section* target{&section};
+
+        for (const size_type index : it.get_path()) {
+            target = &target->at_section(impl_html_patch_slot(*target, index));
+        }
+
+        const Section::node_type& node{it.get_node()};
+
+        if (it.get_index() == Change::npos) {
+            if (it.get_operation() == Operation::Replace && std::holds_alternative<Section>(node)) {
+                *target = std::get<Section>(node);
+            } else if (it.get_operation() == Operation::Set_Attribute) {
+                Properties properties{target->properties_ref()};
+                impl_html_patch_set_property(properties, it.get_key(), it.get_value());
+                target->set_properties(std::move(properties));
+            } else {
+                throw docpp::invalid_argument("Invalid change to a section");
+            }
+
+            continue;
+        }
+
+        const size_type index{impl_html_patch_slot(*target, it.get_index())};
+
+        switch (it.get_operation()) {
+            case Operation::Replace:
+                if (std::holds_alternative<std::monostate>(node)) {
+                    throw docpp::invalid_argument("Expected a node to replace with");
+                }
+
+                target->erase(index);
+
+                if (const Element* element = std::get_if<Element>(&node)) {
+                    target->insert(index, *element);
+                } else {
+                    target->insert(index, std::get<Section>(node));
+                }
+
+                break;
+            case Operation::Insert:
+                if (const Element* element = std::get_if<Element>(&node)) {
+                    target->insert_before(index, *element);
+                } else if (const Section* child = std::get_if<Section>(&node)) {
+                    target->insert_before(index, *child);
+                } else {
+                    throw docpp::invalid_argument("Expected a node to insert");
+                }
+
+                break;
+            case Operation::Remove:
+                if (index == target->size()) {
+                    throw docpp::out_of_range("Index out of range");
+                }
+
+                target->erase(index);
+                break;
+            case Operation::Set_Attribute:
+                if (index < target->size() && std::holds_alternative<Section>(target->children_ref()[index])) {
+                    Section& child{target->at_section(index)};
+                    Properties properties{child.properties_ref()};
+                    impl_html_patch_set_property(properties, it.get_key(), it.get_value());
+                    child.set_properties(std::move(properties));
+                } else {
+                    Element& element{target->at(index)};
+                    Properties properties{element.properties_ref()};
+                    impl_html_patch_set_property(properties, it.get_key(), it.get_value());
+                    element.set_properties(std::move(properties));
+                }
+
+                break;
+            case Operation::Set_Text:
+                target->at(index).set_data(it.get_value());
+                break;
+        }
+    }
+}
@@ -10,12 +10,13 @@
 #include <docpp/HTML/properties.hpp>
 
 docpp::HTML::Properties& docpp::HTML::Properties::operator=(const docpp::HTML::Property& property) {
-    this->properties = {property};
+    this->properties.clear();
+    this->properties.push_back(property);
     return *this;
 }
 
 docpp::HTML::Properties& docpp::HTML::Properties::operator=(const docpp::HTML::Properties& properties) {
-    this->set(properties.get_properties());
+    this->properties = properties.properties;
     return *this;
 }
 
@@ -29,23 +30,23 @@ docpp::HTML::Property docpp::HTML::Properties::operator[](const size_type& index
 }
 
 bool docpp::HTML::Properties::operator==(const docpp::HTML::Properties& properties) const {
-    return this->properties == properties.get_properties();
+    return this->properties == properties.properties;
 }
 
 bool docpp::HTML::Properties::operator==(const docpp::HTML::Property& property) const {
     return std::any_of(this->properties.begin(), this->properties.end(),
                    [&property](const docpp::HTML::Property& it) {
-                       return it.get() == property.get();
+                       return it == property;
                    });
 }
 
 bool docpp::HTML::Properties::operator!=(const docpp::HTML::Properties& properties) const {
-    return this->properties != properties.get_properties();
+    return this->properties != properties.properties;
 }
 
 bool docpp::HTML::Properties::operator!=(const docpp::HTML::Property& property) const {
     return std::all_of(this->properties.begin(), this->properties.end(), [&property](const docpp::HTML::Property& it) {
-        return it.get() == property.get();
+        return it == property;
         });
 }
 
@@ -54,6 +55,11 @@ docpp::HTML::Properties& docpp::HTML::Properties::operator+=(const docpp::HTML::
     return *this;
 }
 
+docpp::HTML::Properties& docpp::HTML::Properties::operator+=(docpp::HTML::Property&& property) {
+    this->push_back(std::move(property));
+    return *this;
+}
+
 docpp::HTML::Properties& docpp::HTML::Properties::operator+=(const docpp::HTML::Properties& properties) {
     for (const docpp::HTML::Property& it : properties) {
         this->push_back(it);
@@ -63,7 +69,7 @@ docpp::HTML::Properties& docpp::HTML::Properties::operator+=(const docpp::HTML::
 }
 
 std::vector<docpp::HTML::Property> docpp::HTML::Properties::get_properties() const {
-    return this->properties;
+    return {this->properties.begin(), this->properties.end()};
 }
 
 docpp::HTML::Property docpp::HTML::Properties::at(const size_type index) const {
@@ -71,11 +77,37 @@ docpp::HTML::Property docpp::HTML::Properties::at(const size_type index) const {
         throw docpp::out_of_range("Index out of range");
     }
 
-    return this->properties.at(index);
+    return this->properties[index];
 }
 
 void docpp::HTML::Properties::set(const std::vector<docpp::HTML::Property>& properties) {
-    this->properties = properties;
+    this->properties.assign(properties.begin(), properties.end());
+}
+
+void docpp::HTML::Properties::set(const docpp::string_type& key, const docpp::string_type& value) {
+    const InternedString c_key{key, this->get_allocator()};
+
+    for (docpp::HTML::Property& it : this->properties) {
+        if (it.interned_key() == c_key) {
+            it.set_value(value);
+            return;
+        }
+    }
+
+    this->properties.emplace_back(c_key, value);
+}
+
+std::optional<std::string_view> docpp::HTML::Properties::get(const std::string_view key) const {
+    // an interned key is compared by address, and a key that is not interned can only be held as a copy, compared by content
+    const std::optional<InternedString> c_key{InternPool::get().find(key)};
+
+    for (const docpp::HTML::Property& it : this->properties) {
+        if (c_key.has_value() ? it.interned_key() == *c_key : it.key_view() == key) {
+            return it.value_view();
+        }
+    }
+
+    return std::nullopt;
 }
 
 void docpp::HTML::Properties::insert(const size_type index, const docpp::HTML::Property& property) {
@@ -86,6 +118,14 @@ void docpp::HTML::Properties::insert(const size_type index, const docpp::HTML::P
     this->properties.insert(this->properties.begin() + static_cast<long>(index), property);
 }
 
+void docpp::HTML::Properties::insert(const size_type index, docpp::HTML::Property&& property) {
+    if (index >= this->properties.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->properties.insert(this->properties.begin() + static_cast<long>(index), std::move(property));
+}
+
 void docpp::HTML::Properties::erase(const size_type index) {
     if (index >= this->properties.size()) {
         throw docpp::out_of_range("Index out of range");
@@ -98,14 +138,22 @@ void docpp::HTML::Properties::push_front(const docpp::HTML::Property& property)
     this->properties.insert(this->properties.begin(), property);
 }
 
+void docpp::HTML::Properties::push_front(docpp::HTML::Property&& property) {
+    this->properties.insert(this->properties.begin(), std::move(property));
+}
+
 void docpp::HTML::Properties::push_back(const docpp::HTML::Property& property) {
     this->properties.push_back(property);
 }
 
+void docpp::HTML::Properties::push_back(docpp::HTML::Property&& property) {
+    this->properties.push_back(std::move(property));
+}
+
 docpp::size_type docpp::HTML::Properties::find(const docpp::HTML::Property& property) const {
     for (size_type i{0}; i < this->properties.size(); i++) {
-        if (this->properties.at(i).get_value().find(property.get_value()) != docpp::string_type::npos
-            || this->properties.at(i).get_key().find(property.get_key()) != docpp::string_type::npos) {
+        if (this->properties[i].value_view().find(property.value_view()) != std::string_view::npos
+            || this->properties[i].key_view().find(property.key_view()) != std::string_view::npos) {
             return i;
         }
     }
@@ -115,8 +163,8 @@ docpp::size_type docpp::HTML::Properties::find(const docpp::HTML::Property& prop
 
 docpp::size_type docpp::HTML::Properties::find(const docpp::string_type& str) const {
     for (size_type i{0}; i < this->properties.size(); i++) {
-        if (this->properties.at(i).get_key().find(str) != docpp::string_type::npos ||
-            this->properties.at(i).get_value().find(str) != docpp::string_type::npos) {
+        if (this->properties[i].key_view().find(str) != std::string_view::npos ||
+            this->properties[i].value_view().find(str) != std::string_view::npos) {
             return i;
         }
     }
@@ -144,6 +192,10 @@ bool docpp::HTML::Properties::empty() const {
     return this->properties.empty();
 }
 
+docpp::HTML::Properties::allocator_type docpp::HTML::Properties::get_allocator() const {
+    return this->properties.get_allocator();
+}
+
 void docpp::HTML::Properties::swap(const size_type index1, const size_type index2) {
     if (index1 >= this->properties.size() || index2 >= this->properties.size()) {
         throw docpp::out_of_range("Index out of range");
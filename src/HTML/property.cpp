@@ -8,46 +8,54 @@
 #include <docpp/HTML/property.hpp>
 
 docpp::string_type docpp::HTML::Property::get_key() const {
-    return this->property.first;
+    docpp::impl_stats_add_string(this->key.size());
+    return docpp::string_type(this->key.view());
 }
 
 docpp::string_type docpp::HTML::Property::get_value() const {
-    return this->property.second;
+    return docpp::impl_to_string(this->value);
 }
 
 std::pair<docpp::string_type, docpp::string_type> docpp::HTML::Property::get() const {
-    return this->property;
+    return std::make_pair(this->get_key(), this->get_value());
 }
 
 void docpp::HTML::Property::set_key(const docpp::string_type& key) {
-    this->property.first = key;
+    this->key = InternedString{key, this->get_allocator()};
 }
 
 void docpp::HTML::Property::set_value(const docpp::string_type& value) {
-    this->property.second = value;
+    this->value.assign(value.data(), value.size());
 }
 
 void docpp::HTML::Property::set(const std::pair<docpp::string_type, docpp::string_type>& property) {
-    this->property = property;
+    this->set_key(property.first);
+    this->set_value(property.second);
 }
 
 docpp::HTML::Property& docpp::HTML::Property::operator=(const docpp::HTML::Property& property) {
-    this->set(property.get());
+    this->key = InternedString{property.key, this->get_allocator()};
+    this->value = property.value;
     return *this;
 }
 
 bool docpp::HTML::Property::operator==(const docpp::HTML::Property& property) const {
-    return this->property == property.get();
+    return this->key == property.key && this->value == property.value;
 }
 
 bool docpp::HTML::Property::operator!=(const docpp::HTML::Property& property) const {
-    return this->property != property.get();
+    return !(*this == property);
 }
 
 void docpp::HTML::Property::clear() {
-    this->property = {};
+    this->key = InternedString{};
+    this->value.clear();
 }
 
 bool docpp::HTML::Property::empty() const {
-    return this->property.first.empty() && this->property.second.empty();
+    return this->key.empty() && this->value.empty();
+}
+
+docpp::HTML::Property::allocator_type docpp::HTML::Property::get_allocator() const {
+    return this->value.get_allocator();
 }
\ No newline at end of file
@@ -0,0 +1,609 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <docpp/except.hpp>
+#include <docpp/HTML/query.hpp>
+
+namespace {
+    bool impl_query_is_name(const char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    bool impl_query_is_space(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    char impl_query_lower(const char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // calls the callback with each whitespace separated word of an attribute value, as class and [key~=value] see them, until it returns true
+    template <typename T> bool impl_query_words(std::string_view str, T&& callback) {
+        while (!str.empty()) {
+            docpp::size_type start{0};
+            while (start < str.size() && impl_query_is_space(str[start])) {
+                ++start;
+            }
+
+            docpp::size_type end{start};
+            while (end < str.size() && !impl_query_is_space(str[end])) {
+                ++end;
+            }
+
+            if (end > start && callback(str.substr(start, end - start))) {
+                return true;
+            }
+
+            str.remove_prefix(end);
+        }
+
+        return false;
+    }
+
+    // the value of the first property with a key, which is only written, and so only matched, if it is not empty
+    std::string_view impl_query_attribute(const docpp::HTML::Properties& properties, const docpp::InternedString key) {
+        for (const docpp::HTML::Property& it : properties) {
+            if (it.interned_key() == key) {
+                return it.value_view();
+            }
+        }
+
+        return {};
+    }
+
+    // the tokens of a selector; the grammar itself is in the Selector constructor
+    class impl_query_lexer {
+        private:
+            std::string_view input{};
+            docpp::size_type pos{0};
+        public:
+            explicit impl_query_lexer(const std::string_view input) : input(input) {}
+
+            [[noreturn]] static void fail() {
+                throw docpp::invalid_argument{"Invalid selector"};
+            }
+
+            [[nodiscard]] bool done() const {
+                return this->pos == this->input.size();
+            }
+
+            [[nodiscard]] bool at(const char c) const {
+                return this->pos < this->input.size() && this->input[this->pos] == c;
+            }
+
+            [[nodiscard]] bool at_name() const {
+                return this->pos < this->input.size() && impl_query_is_name(this->input[this->pos]);
+            }
+
+            bool skip(const char c) {
+                if (!this->at(c)) {
+                    return false;
+                }
+
+                ++this->pos;
+                return true;
+            }
+
+            bool skip_space() {
+                const docpp::size_type start{this->pos};
+
+                while (this->pos < this->input.size() && impl_query_is_space(this->input[this->pos])) {
+                    ++this->pos;
+                }
+
+                return this->pos != start;
+            }
+
+            void expect(const char c) {
+                if (!this->skip(c)) {
+                    fail();
+                }
+            }
+
+            std::string_view read_name() {
+                const docpp::size_type start{this->pos};
+
+                while (this->at_name()) {
+                    ++this->pos;
+                }
+
+                if (this->pos == start) {
+                    fail();
+                }
+
+                return this->input.substr(start, this->pos - start);
+            }
+
+            /* the name is looked up rather than interned, so that selectors do not grow the intern pool */
+            docpp::InternedString read_lower_name() {
+                const std::string_view name{this->read_name()};
+                docpp::string_type ret(name.size(), '\0');
+
+                std::transform(name.begin(), name.end(), ret.begin(), impl_query_lower);
+
+                // a name that is not interned is only held by copies, which compare by content
+                if (const std::optional<docpp::InternedString> interned{docpp::InternPool::get().find(ret)}) {
+                    return *interned;
+                }
+
+                return docpp::InternedString{ret};
+            }
+
+            docpp::string_type read_value() {
+                if (!this->at('"') && !this->at('\'')) {
+                    return docpp::string_type(this->read_name());
+                }
+
+                const char quote{this->input[this->pos++]};
+                const docpp::size_type end{this->input.find(quote, this->pos)};
+
+                if (end == std::string_view::npos) {
+                    fail();
+                }
+
+                const std::string_view ret{this->input.substr(this->pos, end - this->pos)};
+                this->pos = end + 1;
+
+                return docpp::string_type(ret);
+            }
+    };
+
+    // a node of a tree with its tag and properties, whether it is an element or a section
+    struct impl_query_node {
+        docpp::InternedString tag{};
+        const docpp::HTML::Properties* properties{nullptr};
+    };
+
+    impl_query_node impl_query_get_node(const docpp::HTML::Section::node_type& node) {
+        if (const docpp::HTML::Element* element = std::get_if<docpp::HTML::Element>(&node)) {
+            return {element->interned_tag(), &element->properties_ref()};
+        } else if (const docpp::HTML::Section* section = std::get_if<docpp::HTML::Section>(&node)) {
+            return {section->interned_tag(), &section->properties_ref()};
+        }
+
+        return {};
+    }
+} // namespace
+
+docpp::HTML::Selector::Selector(const std::string_view selector) {
+    impl_query_lexer lexer{selector};
+    const InternedString id{"id"};
+    const InternedString cls{"class"};
+    bool child{false};
+
+    lexer.skip_space();
+    this->selectors.emplace_back();
+
+    while (true) {
+        impl_compound compound{};
+        compound.child = child;
+
+        const bool any{lexer.skip('*')};
+        if (!any && lexer.at_name()) {
+            compound.tag = lexer.read_lower_name();
+        }
+
+        while (true) {
+            if (lexer.skip('#')) {
+                compound.attributes.push_back({id, string_type(lexer.read_name()), impl_operator::Equals});
+            } else if (lexer.skip('.')) {
+                compound.attributes.push_back({cls, string_type(lexer.read_name()), impl_operator::Includes});
+            } else if (lexer.skip('[')) {
+                lexer.skip_space();
+                impl_attribute attribute{lexer.read_lower_name(), {}, impl_operator::Exists};
+                lexer.skip_space();
+
+                if (!lexer.skip(']')) {
+                    static constexpr std::pair<char, impl_operator> operators[]{
+                        {'~', impl_operator::Includes}, {'|', impl_operator::Dash}, {'^', impl_operator::Prefix}, {'$', impl_operator::Suffix}, {'*', impl_operator::Substring},
+                    };
+
+                    attribute.op = impl_operator::Equals;
+                    for (const auto& [c, op] : operators) {
+                        if (lexer.skip(c)) {
+                            attribute.op = op;
+                            break;
+                        }
+                    }
+
+                    lexer.expect('=');
+                    lexer.skip_space();
+                    attribute.value = lexer.read_value();
+                    lexer.skip_space();
+                    lexer.expect(']');
+                }
+
+                compound.attributes.push_back(std::move(attribute));
+            } else {
+                break;
+            }
+        }
+
+        if (!any && compound.tag.empty() && compound.attributes.empty()) {
+            impl_query_lexer::fail();
+        }
+
+        this->selectors.back().push_back(std::move(compound));
+
+        const bool space{lexer.skip_space()};
+
+        if (lexer.done()) {
+            return;
+        }
+
+        if (lexer.skip(',')) {
+            lexer.skip_space();
+            this->selectors.emplace_back();
+            child = false;
+            continue;
+        }
+
+        // the next compound is joined to this one by the child combinator, or by the descendant combinator if only whitespace is between them
+        child = lexer.skip('>');
+
+        if (child) {
+            lexer.skip_space();
+        } else if (!space) {
+            impl_query_lexer::fail(); // pseudo-classes, sibling combinators, and anything else that is not supported
+        }
+
+        if (lexer.done()) {
+            impl_query_lexer::fail();
+        }
+    }
+}
+
+bool docpp::HTML::Selector::impl_match(const std::vector<impl_compound>& compounds, const Section::node_type& node, const std::vector<const Section*>& ancestors) {
+    const auto matches = [](const impl_compound& compound, const impl_query_node& n) {
+        if (n.tag.empty() || (!compound.tag.empty() && compound.tag != n.tag)) {
+            return false;
+        }
+
+        for (const impl_attribute& it : compound.attributes) {
+            const std::string_view value{impl_query_attribute(*n.properties, it.key)};
+            const std::string_view expected{it.value};
+
+            if (value.empty()) {
+                return false;
+            }
+
+            switch (it.op) {
+                case impl_operator::Exists:
+                    break;
+                case impl_operator::Equals:
+                    if (value != expected) {
+                        return false;
+                    }
+                    break;
+                case impl_operator::Includes:
+                    if (!impl_query_words(value, [expected](const std::string_view word) { return word == expected; })) {
+                        return false;
+                    }
+                    break;
+                case impl_operator::Dash:
+                    if (value != expected && (value.size() <= expected.size() || value.compare(0, expected.size(), expected) != 0 || value[expected.size()] != '-')) {
+                        return false;
+                    }
+                    break;
+                case impl_operator::Prefix:
+                    if (expected.empty() || value.compare(0, expected.size(), expected) != 0) {
+                        return false;
+                    }
+                    break;
+                case impl_operator::Suffix:
+                    if (expected.empty() || value.size() < expected.size() || value.compare(value.size() - expected.size(), expected.size(), expected) != 0) {
+                        return false;
+                    }
+                    break;
+                case impl_operator::Substring:
+                    if (expected.empty() || value.find(expected) == std::string_view::npos) {
+                        return false;
+                    }
+                    break;
+            }
+        }
+
+        return true;
+    };
+
+    if (!matches(compounds.back(), impl_query_get_node(node))) {
+        return false;
+    }
+
+    /* the compounds before the last are matched against the ancestors, right to left. A compound joined by the descendant
+     * combinator may match any ancestor further out, so when the compounds to its left fail, the next ancestor out is tried,
+     * without recursion: each choice is kept on a stack, and the most recent one is revisited. */
+    struct Choice {
+        size_type compound{0}; // the compound that was matched
+        size_type next{0}; // the ancestors before this index are left to try for the compound to its left
+    };
+
+    std::vector<Choice> s_stack{};
+    size_type compound{compounds.size() - 1};
+    size_type next{ancestors.size()};
+
+    while (compound != 0) {
+        const bool child{compounds[compound].child};
+        size_type found{npos};
+
+        while (next > 0) {
+            --next;
+
+            if (matches(compounds[compound - 1], impl_query_node{ancestors[next]->interned_tag(), &ancestors[next]->properties_ref()})) {
+                found = next;
+                break;
+            }
+
+            if (child) {
+                break;
+            }
+        }
+
+        if (found != npos) {
+            s_stack.push_back({compound, child ? 0 : found});
+            --compound;
+            next = found;
+            continue;
+        }
+
+        // go back to the most recent choice that has ancestors left to try
+        while (!s_stack.empty() && s_stack.back().next == 0) {
+            s_stack.pop_back();
+        }
+
+        if (s_stack.empty()) {
+            return false;
+        }
+
+        compound = s_stack.back().compound;
+        next = s_stack.back().next;
+        s_stack.pop_back();
+    }
+
+    return true;
+}
+
+bool docpp::HTML::Selector::impl_match(const Section::node_type& node, const std::vector<const Section*>& ancestors) const {
+    return std::any_of(this->selectors.begin(), this->selectors.end(), [&node, &ancestors](const std::vector<impl_compound>& it) {
+        return impl_match(it, node, ancestors);
+    });
+}
+
+bool docpp::HTML::Selector::matches(const Section::node_type& node, const std::vector<const Section*>& ancestors) const {
+    return this->impl_match(node, ancestors);
+}
+
+std::vector<const docpp::HTML::Section::node_type*> docpp::HTML::Selector::impl_query(const Section& section, const bool first) const {
+    struct Entry {
+        const Section* section{nullptr};
+        size_type next{0};
+    };
+
+    std::vector<const Section::node_type*> ret{};
+    std::vector<const Section*> ancestors{};
+    std::vector<Entry> s_stack{};
+
+    // the root is not matched, but the nodes in it are matched against it
+    if (!section.tag_view().empty()) {
+        ancestors.push_back(&section);
+    }
+
+    s_stack.push_back({&section, 0});
+
+    while (!s_stack.empty()) {
+        Entry& c_entry{s_stack.back()};
+        const Section* c_sect{c_entry.section};
+
+        if (c_entry.next == c_sect->children_ref().size()) {
+            if (!c_sect->tag_view().empty()) {
+                ancestors.pop_back();
+            }
+
+            s_stack.pop_back();
+            continue;
+        }
+
+        const Section::node_type& child{c_sect->children_ref()[c_entry.next++]};
+
+        if (this->impl_match(child, ancestors)) {
+            ret.push_back(&child);
+
+            if (first) {
+                return ret;
+            }
+        }
+
+        // descend as soon as a section is found, and resume after it when it is done, as Section::get does
+        if (const Section* c_child = std::get_if<Section>(&child)) {
+            if (!c_child->tag_view().empty()) {
+                ancestors.push_back(c_child);
+            }
+
+            s_stack.push_back({c_child, 0});
+        }
+    }
+
+    return ret;
+}
+
+std::vector<const docpp::HTML::Section::node_type*> docpp::HTML::Selector::impl_query(const QueryIndex& index, const bool first) const {
+    const std::vector<QueryIndex::impl_node>& nodes{index.impl_nodes()};
+    const InternedString id{"id"};
+    const InternedString cls{"class"};
+    std::vector<size_type> candidates{};
+    std::vector<const Section*> ancestors{};
+    std::vector<const Section::node_type*> ret{};
+
+    // only the nodes with the id or class of the last compound can match; a selector with neither looks at every node
+    for (const std::vector<impl_compound>& it : this->selectors) {
+        const std::vector<size_type>* found{nullptr};
+        bool indexed{false};
+
+        for (const impl_attribute& attribute : it.back().attributes) {
+            const std::unordered_map<std::string_view, std::vector<size_type>>* map{nullptr};
+
+            if (attribute.key == id && attribute.op == impl_operator::Equals) {
+                map = &index.impl_ids();
+            } else if (attribute.key == cls && attribute.op == impl_operator::Includes) {
+                map = &index.impl_classes();
+            } else {
+                continue;
+            }
+
+            const auto c_it{map->find(attribute.value)};
+            found = c_it != map->end() ? &c_it->second : nullptr;
+            indexed = true;
+            break;
+        }
+
+        if (!indexed) {
+            candidates.resize(nodes.size());
+            for (size_type i{0}; i < nodes.size(); i++) {
+                candidates[i] = i;
+            }
+            break;
+        }
+
+        if (found != nullptr) {
+            candidates.insert(candidates.end(), found->begin(), found->end());
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (const size_type it : candidates) {
+        ancestors.clear();
+
+        for (size_type parent{nodes[it].parent}; parent != QueryIndex::npos; parent = nodes[parent].parent) {
+            ancestors.push_back(std::get_if<Section>(nodes[parent].node));
+        }
+
+        if (!index.section.tag_view().empty()) {
+            ancestors.push_back(&index.section);
+        }
+
+        std::reverse(ancestors.begin(), ancestors.end());
+
+        if (this->impl_match(*nodes[it].node, ancestors)) {
+            ret.push_back(nodes[it].node);
+
+            if (first) {
+                return ret;
+            }
+        }
+    }
+
+    return ret;
+}
+
+const docpp::HTML::Section::node_type* docpp::HTML::Selector::query(const Section& section) const {
+    const std::vector<const Section::node_type*> ret{this->impl_query(section, true)};
+    return ret.empty() ? nullptr : ret.front();
+}
+
+const docpp::HTML::Section::node_type* docpp::HTML::Selector::query(const QueryIndex& index) const {
+    const std::vector<const Section::node_type*> ret{this->impl_query(index, true)};
+    return ret.empty() ? nullptr : ret.front();
+}
+
+std::vector<const docpp::HTML::Section::node_type*> docpp::HTML::Selector::query_all(const Section& section) const {
+    return this->impl_query(section, false);
+}
+
+std::vector<const docpp::HTML::Section::node_type*> docpp::HTML::Selector::query_all(const QueryIndex& index) const {
+    return this->impl_query(index, false);
+}
+
+const std::vector<docpp::HTML::QueryIndex::impl_node>& docpp::HTML::QueryIndex::impl_nodes() const {
+    std::call_once(this->nodes_flag, [this]() {
+        struct Entry {
+            const Section* section{nullptr};
+            size_type next{0};
+            size_type parent{npos};
+        };
+
+        std::vector<Entry> s_stack{};
+        s_stack.push_back({&this->section, 0, npos});
+
+        while (!s_stack.empty()) {
+            Entry& c_entry{s_stack.back()};
+
+            if (c_entry.next == c_entry.section->children_ref().size()) {
+                s_stack.pop_back();
+                continue;
+            }
+
+            const Section::node_type& child{c_entry.section->children_ref()[c_entry.next++]};
+            const size_type parent{c_entry.parent};
+            const impl_query_node node{impl_query_get_node(child)};
+
+            // nodes without a tag are never matched, and sections without one pass their parent on to their children
+            size_type c_parent{parent};
+            if (!node.tag.empty()) {
+                c_parent = this->nodes.size();
+                this->nodes.push_back({&child, parent});
+            }
+
+            if (const Section* section = std::get_if<Section>(&child)) {
+                s_stack.push_back({section, 0, c_parent});
+            }
+        }
+    });
+
+    return this->nodes;
+}
+
+const std::unordered_map<std::string_view, std::vector<docpp::size_type>>& docpp::HTML::QueryIndex::impl_ids() const {
+    std::call_once(this->ids_flag, [this]() {
+        const InternedString id{"id"};
+        const std::vector<impl_node>& c_nodes{this->impl_nodes()};
+
+        for (size_type i{0}; i < c_nodes.size(); i++) {
+            const std::string_view value{impl_query_attribute(*impl_query_get_node(*c_nodes[i].node).properties, id)};
+
+            if (!value.empty()) {
+                this->ids[value].push_back(i);
+            }
+        }
+    });
+
+    return this->ids;
+}
+
+const std::unordered_map<std::string_view, std::vector<docpp::size_type>>& docpp::HTML::QueryIndex::impl_classes() const {
+    std::call_once(this->classes_flag, [this]() {
+        const InternedString cls{"class"};
+        const std::vector<impl_node>& c_nodes{this->impl_nodes()};
+
+        for (size_type i{0}; i < c_nodes.size(); i++) {
+            impl_query_words(impl_query_attribute(*impl_query_get_node(*c_nodes[i].node).properties, cls), [this, i](const std::string_view word) {
+                std::vector<size_type>& indices{this->classes[word]};
+
+                // a class written twice on one node is indexed once
+                if (indices.empty() || indices.back() != i) {
+                    indices.push_back(i);
+                }
+
+                return false;
+            });
+        }
+    });
+
+    return this->classes;
+}
+
+const docpp::HTML::Section::node_type* docpp::HTML::query(const Section& section, const std::string_view selector) {
+    return Selector{selector}.query(section);
+}
+
+std::vector<const docpp::HTML::Section::node_type*> docpp::HTML::query_all(const Section& section, const std::string_view selector) {
+    return Selector{selector}.query_all(section);
+}
\ No newline at end of file
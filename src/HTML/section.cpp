@@ -6,13 +6,290 @@
  */
 
 #include <algorithm>
-#include <sstream>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <stack>
+#include <unordered_map>
+#include <vector>
 #include <docpp/except.hpp>
+#include <docpp/hash.hpp>
 #include <docpp/HTML/tag.hpp>
 #include <docpp/HTML/section.hpp>
+#include <docpp/HTML/minify.hpp>
+#include <docpp/stats.hpp>
+
+struct docpp::HTML::Section::impl_changes {
+    // a child noted as modified, with what it added to the hash of the section when the section was last hashed
+    struct Change {
+        size_type index{0};
+        std::uint64_t hash{0};
+        size_type nodes{0};
+    };
+
+    // identifies the log, so that a record of an incremental write can tell whether it still follows it
+    std::uint64_t generation{0};
+    std::vector<Change> log{};
+    // the sum of what the children added to the hash, and their number of nodes, as of the first hashed entries of the log
+    std::uint64_t sum{0};
+    size_type nodes{0};
+    size_type hashed{0};
+};
+
+namespace {
+    // sections with at least this many children keep a log of the children modified since they were last hashed
+    constexpr docpp::size_type impl_html_logged_children{64};
+
+    // the logs are only changed by const members while holding this, as the sections are not modified meanwhile
+    std::mutex impl_html_changes_mutex{};
+    std::uint64_t impl_html_changes_generation{0};
+
+    // what a child adds to the hash of its section; a sum of these can be updated one child at a time
+    std::uint64_t impl_html_hash_child(const docpp::size_type index, const bool section, const std::uint64_t hash) {
+        if (hash == 0) {
+            return 0;
+        }
+
+        std::uint64_t ret{docpp::impl_hash_basis};
+        docpp::impl_hash_value(ret, index);
+        docpp::impl_hash_value(ret, section ? 1 : 2);
+        docpp::impl_hash_value(ret, hash);
+        return ret;
+    }
+} // namespace
+
+docpp::HTML::Section::Section(const Section& section, const allocator_type& allocator) : tag(section.tag, allocator), properties(section.properties, allocator), children(allocator), prerendered(section.prerendered),
+    incremental(impl_copy_incremental(section.incremental)), cached_hash(section.cached_hash.load(std::memory_order_relaxed)), cached_nodes(section.cached_nodes.load(std::memory_order_relaxed)) {
+    this->children.reserve(section.children.size());
+
+    for (const node_type& it : section.children) {
+        impl_push_back(this->children, it);
+    }
+
+    this->impl_link();
+}
+
+docpp::HTML::Section::Section(Section&& section, const allocator_type& allocator) : tag(std::move(section.tag), allocator), properties(std::move(section.properties), allocator), children(allocator), prerendered(std::move(section.prerendered)),
+    incremental(std::move(section.incremental)), changes(std::move(section.changes)), cached_hash(section.cached_hash.load(std::memory_order_relaxed)), cached_nodes(section.cached_nodes.load(std::memory_order_relaxed)) {
+    if (section.get_allocator() == allocator) {
+        this->children = std::move(section.children);
+    } else {
+        this->children.reserve(section.children.size());
+
+        for (node_type& it : section.children) {
+            impl_push_back(this->children, std::move(it));
+        }
+    }
+
+    this->impl_link();
+    section.impl_modified();
+}
+
+void docpp::HTML::Section::impl_modified() {
+    const std::uint64_t hash{this->cached_hash.exchange(0, std::memory_order_relaxed)};
+
+    // a hash is only cached along with the hashes below it, so above a section without one there is none to reset,
+    // and the section has already been noted in the log of its parent
+    if (hash != 0 && this->parent != nullptr) {
+        this->parent->impl_modified(this, true, hash, this->cached_nodes.load(std::memory_order_relaxed));
+    }
+}
+
+void docpp::HTML::Section::impl_modified(const void* child, const bool section, const std::uint64_t hash, const size_type nodes) {
+    if (this->changes) {
+        // the children are stored in order, so the index follows from the address
+        const std::uintptr_t offset{reinterpret_cast<std::uintptr_t>(child) - reinterpret_cast<std::uintptr_t>(this->children.begin())};
+        const size_type index{offset / sizeof(node_type)};
+        const bool found{index < this->children.size() && (section ? static_cast<const void*>(std::get_if<Section>(&this->children[index])) :
+            static_cast<const void*>(std::get_if<Element>(&this->children[index]))) == child};
+
+        if (found) {
+            this->impl_log(index, section, hash, nodes);
+        } else {
+            this->changes.reset();
+        }
+    }
+
+    this->impl_modified();
+}
+
+void docpp::HTML::Section::impl_log(const size_type index, const bool section, const std::uint64_t hash, const size_type nodes) noexcept {
+    if (!this->changes) {
+        return;
+    }
+
+    // past this point hashing the section again is as quick as reading the log
+    if (this->changes->log.size() >= std::max(impl_html_logged_children, this->children.size() / 4)) {
+        this->changes.reset();
+        return;
+    }
+
+    try {
+        this->changes->log.push_back({index, impl_html_hash_child(index, section, hash), nodes});
+    } catch (...) {
+        this->changes.reset();
+    }
+}
+
+void docpp::HTML::Section::impl_modified(const size_type index) {
+    if (index >= this->children.size() || std::holds_alternative<std::monostate>(this->children[index])) {
+        this->impl_log(index, false, 0, 0);
+    } else if (const Element* element = std::get_if<Element>(&this->children[index])) {
+        // a child without a hash has been noted since the section was last hashed
+        if (const std::uint64_t hash{element->cached_hash.load(std::memory_order_relaxed)}; hash != 0) {
+            this->impl_log(index, false, hash, 1);
+        }
+    } else if (const Section* section = std::get_if<Section>(&this->children[index])) {
+        if (const std::uint64_t hash{section->cached_hash.load(std::memory_order_relaxed)}; hash != 0) {
+            this->impl_log(index, true, hash, section->cached_nodes.load(std::memory_order_relaxed));
+        }
+    }
+
+    this->impl_modified();
+}
+
+void docpp::HTML::Section::impl_link(node_type& node) {
+    if (Element* element = std::get_if<Element>(&node)) {
+        element->parent = this;
+    } else if (Section* section = std::get_if<Section>(&node)) {
+        section->parent = this;
+    }
+}
+
+void docpp::HTML::Section::impl_link() {
+    for (node_type& it : this->children) {
+        this->impl_link(it);
+    }
+}
+
+docpp::HTML::Section::node_type& docpp::HTML::Section::impl_link(const size_type index, const node_type* first, const node_type* last) {
+    size_type begin{0};
+    size_type end{this->children.size()};
+
+    if (first != nullptr && first == &this->children.front()) {
+        begin = index;
+    }
+
+    if (last != nullptr && last == &this->children.back()) {
+        end = index + 1;
+    }
+
+    for (size_type i{begin}; i < end; ++i) {
+        this->impl_link(this->children[i]);
+    }
+
+    return this->children[index];
+}
+
+docpp::HTML::Section::node_type& docpp::HTML::Section::impl_emplace(const size_type index, node_type&& node) {
+    const node_type* first{this->children.empty() ? nullptr : &this->children.front()};
+    const node_type* last{this->children.empty() ? nullptr : &this->children.back()};
+
+    const bool append{index == this->children.size()};
+
+    this->children.emplace(this->children.begin() + index, std::move(node));
+
+    // the children after the index have moved, which the log cannot follow
+    if (append) {
+        this->impl_log(index, false, 0, 0);
+    } else {
+        this->changes.reset();
+    }
+
+    return this->impl_link(index, first, last);
+}
 
-docpp::HTML::Section& docpp::HTML::Section::operator=(const docpp::HTML::Section& section) = default;
+void docpp::HTML::Section::impl_push_back(children_type& children, const node_type& node) {
+    if (const Element* element = std::get_if<Element>(&node)) {
+        children.emplace_back(std::in_place_type<Element>, *element, children.get_allocator());
+    } else if (const Section* section = std::get_if<Section>(&node)) {
+        children.emplace_back(std::in_place_type<Section>, *section, children.get_allocator());
+    } else {
+        children.emplace_back();
+    }
+}
+
+void docpp::HTML::Section::impl_push_back(children_type& children, node_type&& node) {
+    if (Element* element = std::get_if<Element>(&node)) {
+        children.emplace_back(std::in_place_type<Element>, std::move(*element), children.get_allocator());
+    } else if (Section* section = std::get_if<Section>(&node)) {
+        children.emplace_back(std::in_place_type<Section>, std::move(*section), children.get_allocator());
+    } else {
+        children.emplace_back();
+    }
+}
+
+docpp::HTML::Section& docpp::HTML::Section::operator=(const docpp::HTML::Section& section) {
+    if (this == &section) {
+        return *this;
+    }
+
+    const std::uint64_t hash{section.cached_hash.load(std::memory_order_relaxed)};
+    const size_type nodes{section.cached_nodes.load(std::memory_order_relaxed)};
+
+    // copied into a new list first, as the section may be a child of this one
+    children_type children{this->children.get_allocator()};
+    children.reserve(section.children.size());
+
+    for (const node_type& it : section.children) {
+        impl_push_back(children, it);
+    }
+
+    // the section keeps its place, so the sections above it have changed
+    this->impl_modified();
+
+    this->tag = InternedString{section.tag, this->get_allocator()};
+    this->properties = section.properties;
+    this->children = std::move(children);
+    this->prerendered = section.prerendered;
+    this->incremental = impl_copy_incremental(section.incremental);
+    this->changes.reset();
+    this->cached_hash.store(hash, std::memory_order_relaxed);
+    this->cached_nodes.store(nodes, std::memory_order_relaxed);
+    this->impl_link();
+
+    return *this;
+}
+
+docpp::HTML::Section& docpp::HTML::Section::operator=(docpp::HTML::Section&& section) {
+    if (this == &section) {
+        return *this;
+    }
+
+    if (section.get_allocator() != this->get_allocator()) {
+        return *this = static_cast<const Section&>(section);
+    }
+
+    // moved out first, as the section may be a child of this one
+    Section moved{std::move(section)};
+
+    this->impl_modified();
+
+    this->tag = moved.tag;
+    this->properties = std::move(moved.properties);
+    this->children = std::move(moved.children);
+    this->prerendered = std::move(moved.prerendered);
+    this->incremental = std::move(moved.incremental);
+    this->changes = std::move(moved.changes);
+    this->cached_hash.store(moved.cached_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->cached_nodes.store(moved.cached_nodes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->impl_link();
+
+    return *this;
+}
+
+docpp::HTML::Section& docpp::HTML::Section::operator+=(docpp::HTML::Element&& element) {
+    this->push_back(std::move(element));
+    return *this;
+}
+
+docpp::HTML::Section& docpp::HTML::Section::operator+=(docpp::HTML::Section&& section) {
+    this->push_back(std::move(section));
+    return *this;
+}
 
 docpp::HTML::Section& docpp::HTML::Section::operator+=(const docpp::HTML::Element& element) {
     this->push_back(element);
@@ -31,8 +308,8 @@ docpp::HTML::Element docpp::HTML::Section::operator[](const docpp::integer_type&
 std::unordered_map<docpp::string_type, docpp::HTML::Element> docpp::HTML::Section::operator[](const docpp::string_type& tag) const {
     std::unordered_map<docpp::string_type, docpp::HTML::Element> ret{};
 
-    for (const Element& it : this->get_elements()) {
-        if (it.get_tag() == tag) {
+    for (const Element& it : this->elements_view()) {
+        if (it.tag_view() == tag) {
             ret[it.get_data()] = it;
         }
     }
@@ -42,9 +319,10 @@ std::unordered_map<docpp::string_type, docpp::HTML::Element> docpp::HTML::Sectio
 
 std::unordered_map<docpp::string_type, docpp::HTML::Element> docpp::HTML::Section::operator[](const Tag tag) const {
     std::unordered_map<docpp::string_type, docpp::HTML::Element> ret{};
+    const std::string_view name{get_tag_name(tag)};
 
-    for (const Element& it : this->get_elements()) {
-        if (it.get_tag() == resolve_tag(tag).first) {
+    for (const Element& it : this->elements_view()) {
+        if (it.tag_view() == name) {
             ret[it.get_data()] = it;
         }
     }
@@ -53,169 +331,284 @@ std::unordered_map<docpp::string_type, docpp::HTML::Element> docpp::HTML::Sectio
 }
 
 bool docpp::HTML::Section::operator==(const docpp::HTML::Section& section) const {
-    return this->tag == section.tag && this->properties == section.properties && this->elements == section.elements && this->sections == section.sections && this->index == section.index;
+    if (this->hash() != section.hash()) {
+        return false;
+    }
+
+    return this->tag == section.tag && this->properties == section.properties && this->children == section.children;
 }
 
 bool docpp::HTML::Section::operator==(const docpp::HTML::Element& element) const {
-    return std::any_of(this->get_elements().begin(), this->get_elements().end(),
+    return std::any_of(this->begin(), this->end(),
                    [&element](const docpp::HTML::Element& it) {
-                       return it.get() == element.get();
+                       return it == element;
                    });
 }
 
 bool docpp::HTML::Section::operator!=(const docpp::HTML::Section& section) const {
-    return this->tag != section.tag || this->properties != section.properties || this->elements != section.elements || this->sections != section.sections || this->index != section.index;
+    return !(*this == section);
 }
 
 bool docpp::HTML::Section::operator!=(const docpp::HTML::Element& element) const {
-    return std::any_of(this->get_elements().begin(), this->get_elements().end(), [&element](const Element& it) {
-        return it.get() == element.get();
+    return std::any_of(this->begin(), this->end(), [&element](const Element& it) {
+        return it == element;
     });
 }
 
 void docpp::HTML::Section::set(const docpp::string_type& tag, const Properties& properties) {
-    this->tag = tag;
+    this->set_tag(tag);
     this->properties = properties;
 }
 
 void docpp::HTML::Section::set_tag(const docpp::string_type& tag) {
-    this->tag = tag;
+    this->impl_modified();
+
+    this->tag = InternedString{tag, this->get_allocator()};
 }
 
 void docpp::HTML::Section::set_tag(const Tag tag) {
-    std::pair<docpp::string_type, docpp::HTML::Type> resolved{resolve_tag(tag)};
-    this->tag = resolved.first;
+    this->impl_modified();
+
+    this->tag = get_interned_tag_name(tag);
 }
 
 void docpp::HTML::Section::set_properties(const Properties& properties) {
+    this->impl_modified();
+
     this->properties = properties;
 }
 
+void docpp::HTML::Section::set_properties(Properties&& properties) {
+    this->impl_modified();
+
+    this->properties = std::move(properties);
+}
+
+void docpp::HTML::Section::set_property(const docpp::string_type& key, const docpp::string_type& value) {
+    this->impl_modified();
+
+    this->properties.set(key, value);
+}
+
 void docpp::HTML::Section::set(const Tag tag, const Properties& properties) {
-    this->tag = resolve_tag(tag).first;
+    this->impl_modified();
+
+    this->tag = get_interned_tag_name(tag);
     this->properties = properties;
 }
 
 void docpp::HTML::Section::push_front(const Element& element) {
-    for (size_type i{this->index}; i > 0; i--) {
-        this->elements[i] = this->elements.at(i - 1);
-    }
+    this->impl_modified();
 
-    this->elements[0] = element;
-    this->index++;
+    this->impl_emplace(0, node_type{std::in_place_type<Element>, element, this->get_allocator()});
 }
 
 void docpp::HTML::Section::push_front(const Section& section) {
-    for (size_type i{this->index}; i > 0; i--) {
-        this->sections.at(i) = this->sections.at(i - 1);
-    }
+    this->impl_modified();
 
-    this->sections[0] = section;
-    this->index++;
+    this->impl_emplace(0, node_type{std::in_place_type<Section>, section, this->get_allocator()});
 }
 
 void docpp::HTML::Section::push_back(const Element& element) {
-    this->elements[this->index++] = element;
+    this->impl_modified();
+
+    this->impl_emplace(this->children.size(), node_type{std::in_place_type<Element>, element, this->get_allocator()});
 }
 
 void docpp::HTML::Section::push_back(const Section& section) {
-    this->sections[this->index++] = section;
+    this->impl_modified();
+
+    this->impl_emplace(this->children.size(), node_type{std::in_place_type<Section>, section, this->get_allocator()});
 }
 
-void docpp::HTML::Section::erase(const size_type index) {
-    bool erased{false};
+void docpp::HTML::Section::push_front(Element&& element) {
+    this->impl_modified();
 
-    if (this->elements.find(index) != this->elements.end()) {
-        this->elements.erase(index);
-        erased = true;
-    } else if (this->sections.find(index) != this->sections.end()) {
-        this->sections.erase(index);
-        erased = true;
-    }
+    this->impl_emplace(0, node_type{std::in_place_type<Element>, std::move(element), this->get_allocator()});
+}
+
+void docpp::HTML::Section::push_front(Section&& section) {
+    this->impl_modified();
+
+    this->impl_emplace(0, node_type{std::in_place_type<Section>, std::move(section), this->get_allocator()});
+}
 
-    if (!erased) {
+void docpp::HTML::Section::push_back(Element&& element) {
+    this->impl_modified();
+
+    this->impl_emplace(this->children.size(), node_type{std::in_place_type<Element>, std::move(element), this->get_allocator()});
+}
+
+void docpp::HTML::Section::push_back(Section&& section) {
+    this->impl_modified();
+
+    this->impl_emplace(this->children.size(), node_type{std::in_place_type<Section>, std::move(section), this->get_allocator()});
+}
+
+void docpp::HTML::Section::erase(const size_type index) {
+    if (index >= this->children.size() || std::holds_alternative<std::monostate>(this->children[index])) {
         throw docpp::out_of_range("Index out of range");
     }
+
+    this->impl_modified(index);
+
+    this->children[index] = std::monostate{};
 }
 
 void docpp::HTML::Section::erase(const Section& section) {
-    for (size_type i{0}; i < this->size(); i++) {
-        const Section it = this->get_sections().at(i);
+    const size_type index{this->find(section)};
 
-        if (it.get() == section.get()) {
-            this->erase(i);
-            return;
-        }
+    if (index == docpp::HTML::Section::npos) {
+        throw docpp::out_of_range("Section not found");
     }
 
-    throw docpp::out_of_range("Section not found");
+    this->erase(index);
 }
 
 void docpp::HTML::Section::erase(const Element& element) {
-    for (size_type i{0}; i < this->size(); i++) {
-        const Element it = this->get_elements().at(i);
+    const size_type index{this->find(element)};
 
-        if (it.get() == element.get()) {
-            this->erase(i);
-            return;
-        }
+    if (index == docpp::HTML::Section::npos) {
+        throw docpp::out_of_range("Element not found");
     }
 
-    throw docpp::out_of_range("Element not found");
+    this->erase(index);
 }
 
 void docpp::HTML::Section::insert(const size_type index, const Element& element) {
-    if (this->sections.find(index) != this->sections.end()) {
+    if (index < this->children.size() && std::holds_alternative<Section>(this->children[index])) {
         throw docpp::invalid_argument("Index already occupied by a section");
-    } else {
-        this->elements[index] = element;
     }
 
-    this->index = std::max(this->index, index) + 1;
+    this->impl_modified(index);
+
+    // copied first, as the element may be a child of this section
+    Element node{element, this->get_allocator()};
+
+    const node_type* first{this->children.empty() ? nullptr : &this->children.front()};
+    const node_type* last{this->children.empty() ? nullptr : &this->children.back()};
+    this->children.resize(std::max(this->children.size(), index + 1));
+    this->children[index].emplace<Element>(std::move(node));
+    this->impl_link(index, first, last);
 }
 
 void docpp::HTML::Section::insert(const size_type index, const Section& section) {
-    this->sections[index] = section;
-    this->index = std::max(this->index, index) + 1;
+    this->impl_modified(index);
+
+    Section node{section, this->get_allocator()};
+
+    const node_type* first{this->children.empty() ? nullptr : &this->children.front()};
+    const node_type* last{this->children.empty() ? nullptr : &this->children.back()};
+    this->children.resize(std::max(this->children.size(), index + 1));
+    this->children[index].emplace<Section>(std::move(node));
+    this->impl_link(index, first, last);
+}
+
+void docpp::HTML::Section::insert(const size_type index, Element&& element) {
+    if (index < this->children.size() && std::holds_alternative<Section>(this->children[index])) {
+        throw docpp::invalid_argument("Index already occupied by a section");
+    }
+
+    this->impl_modified(index);
+
+    Element node{std::move(element), this->get_allocator()};
+
+    const node_type* first{this->children.empty() ? nullptr : &this->children.front()};
+    const node_type* last{this->children.empty() ? nullptr : &this->children.back()};
+    this->children.resize(std::max(this->children.size(), index + 1));
+    this->children[index].emplace<Element>(std::move(node));
+    this->impl_link(index, first, last);
+}
+
+void docpp::HTML::Section::insert(const size_type index, Section&& section) {
+    this->impl_modified(index);
+
+    Section node{std::move(section), this->get_allocator()};
+
+    const node_type* first{this->children.empty() ? nullptr : &this->children.front()};
+    const node_type* last{this->children.empty() ? nullptr : &this->children.back()};
+    this->children.resize(std::max(this->children.size(), index + 1));
+    this->children[index].emplace<Section>(std::move(node));
+    this->impl_link(index, first, last);
+}
+
+void docpp::HTML::Section::insert_before(const size_type index, const Element& element) {
+    if (index > this->children.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->impl_modified();
+
+    this->impl_emplace(index, node_type{std::in_place_type<Element>, element, this->get_allocator()});
+}
+
+void docpp::HTML::Section::insert_before(const size_type index, const Section& section) {
+    if (index > this->children.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->impl_modified();
+
+    this->impl_emplace(index, node_type{std::in_place_type<Section>, section, this->get_allocator()});
+}
+
+void docpp::HTML::Section::insert_before(const size_type index, Element&& element) {
+    if (index > this->children.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->impl_modified();
+
+    this->impl_emplace(index, node_type{std::in_place_type<Element>, std::move(element), this->get_allocator()});
+}
+
+void docpp::HTML::Section::insert_before(const size_type index, Section&& section) {
+    if (index > this->children.size()) {
+        throw docpp::out_of_range("Index out of range");
+    }
+
+    this->impl_modified();
+
+    this->impl_emplace(index, node_type{std::in_place_type<Section>, std::move(section), this->get_allocator()});
 }
 
 docpp::HTML::Element docpp::HTML::Section::at(const size_type index) const {
-    if (this->elements.find(index) != this->elements.end()) {
-        return this->elements.at(index);
+    if (index < this->children.size() && std::holds_alternative<Element>(this->children[index])) {
+        return std::get<Element>(this->children[index]);
     }
 
     throw docpp::out_of_range("Index out of range");
 }
 
 docpp::HTML::Element& docpp::HTML::Section::at(const size_type index) {
-    if (this->elements.find(index) != this->elements.end()) {
-        return this->elements.at(index);
+    if (index < this->children.size() && std::holds_alternative<Element>(this->children[index])) {
+        return std::get<Element>(this->children[index]);
     }
 
     throw docpp::out_of_range("Index out of range");
 }
 
 docpp::HTML::Section docpp::HTML::Section::at_section(const size_type index) const {
-    if (this->sections.find(index) != this->sections.end()) {
-        return this->sections.at(index);
+    if (index < this->children.size() && std::holds_alternative<Section>(this->children[index])) {
+        return std::get<Section>(this->children[index]);
     }
 
     throw docpp::out_of_range("Index out of range");
 }
 
 docpp::HTML::Section& docpp::HTML::Section::at_section(const size_type index) {
-    if (this->sections.find(index) != this->sections.end()) {
-        return this->sections.at(index);
+    if (index < this->children.size() && std::holds_alternative<Section>(this->children[index])) {
+        return std::get<Section>(this->children[index]);
     }
 
     throw docpp::out_of_range("Index out of range");
 }
 
 docpp::size_type docpp::HTML::Section::find(const Element& element) const {
-    for (size_type i{0}; i < this->size(); i++) {
-        const Element it = this->get_elements().at(i);
+    const std::uint64_t hash{element.hash()};
 
-        if (it.get() == element.get()) {
+    for (size_type i{0}; i < this->children.size(); i++) {
+        if (const Element* it = std::get_if<Element>(&this->children[i]); it != nullptr && it->hash() == hash && *it == element) {
             return i;
         }
     }
@@ -224,10 +617,10 @@ docpp::size_type docpp::HTML::Section::find(const Element& element) const {
 }
 
 docpp::size_type docpp::HTML::Section::find(const Section& section) const {
-    for (size_type i{0}; i < this->size(); i++) {
-        const Section it = this->get_sections().at(i);
+    const std::uint64_t hash{section.hash()};
 
-        if (it.get() == section.get()) {
+    for (size_type i{0}; i < this->children.size(); i++) {
+        if (const Section* it = std::get_if<Section>(&this->children[i]); it != nullptr && it->hash() == hash && *it == section) {
             return i;
         }
     }
@@ -236,27 +629,15 @@ docpp::size_type docpp::HTML::Section::find(const Section& section) const {
 }
 
 docpp::size_type docpp::HTML::Section::find(const docpp::string_type& str) const {
-    const std::vector<docpp::HTML::Element> elements{this->get_elements()};
-
-    for (size_type i{0}; i < this->size(); i++) {
-        if (elements.size() <= i) {
-            break;
-        }
-
-        if (elements.at(i).get().find(str) != docpp::HTML::Section::npos) {
-            return i;
-        }
-    }
-
-    const std::vector<docpp::HTML::Section> sections{this->get_sections()};
-
-    for (size_type i{0}; i < this->size(); i++) {
-        if (elements.size() <= i) {
-            break;
-        }
-
-        if (elements.at(i).get().find(str) != docpp::HTML::Section::npos) {
-            return i;
+    for (size_type i{0}; i < this->children.size(); i++) {
+        if (std::holds_alternative<Element>(this->children[i])) {
+            if (std::get<Element>(this->children[i]).get().find(str) != docpp::string_type::npos) {
+                return i;
+            }
+        } else if (std::holds_alternative<Section>(this->children[i])) {
+            if (std::get<Section>(this->children[i]).get().find(str) != docpp::string_type::npos) {
+                return i;
+            }
         }
     }
 
@@ -264,200 +645,1196 @@ docpp::size_type docpp::HTML::Section::find(const docpp::string_type& str) const
 }
 
 docpp::HTML::Element docpp::HTML::Section::front() const {
-    if (this->elements.find(0) != this->elements.end()) {
-        return this->elements.at(0);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at(0);
 }
 
 docpp::HTML::Element& docpp::HTML::Section::front() {
-    if (this->elements.find(0) != this->elements.end()) {
-        return this->elements.at(0);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at(0);
 }
 
 docpp::HTML::Section docpp::HTML::Section::front_section() const {
-    if (this->sections.find(0) != this->sections.end()) {
-        return this->sections.at(0);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at_section(0);
 }
 
 docpp::HTML::Section& docpp::HTML::Section::front_section() {
-    if (this->sections.find(0) != this->sections.end()) {
-        return this->sections.at(0);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at_section(0);
 }
 
 docpp::HTML::Element docpp::HTML::Section::back() const {
-    if (this->elements.find(this->index - 1) != this->elements.end()) {
-        return this->elements.at(this->index - 1);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at(this->children.size() - 1);
 }
 
 docpp::HTML::Element& docpp::HTML::Section::back() {
-    if (this->elements.find(this->index - 1) != this->elements.end()) {
-        return this->elements.at(this->index - 1);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at(this->children.size() - 1);
 }
 
 docpp::HTML::Section docpp::HTML::Section::back_section() const {
-    if (this->sections.find(this->index - 1) != this->sections.end()) {
-        return this->sections.at(this->index - 1);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at_section(this->children.size() - 1);
 }
 
 docpp::HTML::Section& docpp::HTML::Section::back_section() {
-    if (this->sections.find(this->index - 1) != this->sections.end()) {
-        return this->sections.at(this->index - 1);
-    }
-
-    throw docpp::out_of_range("Index out of range");
+    return this->at_section(this->children.size() - 1);
 }
 
 docpp::size_type docpp::HTML::Section::size() const {
-    return this->index;
+    return this->children.size();
 }
 
 void docpp::HTML::Section::clear() {
-    this->tag.clear();
+    this->impl_modified();
+
+    this->tag = InternedString{};
     this->properties.clear();
-    this->elements.clear();
-    this->sections.clear();
-    this->index = 0;
+    this->children.clear();
+    this->changes.reset();
 }
 
 bool docpp::HTML::Section::empty() const {
-    return this->index == 0;
+    return this->children.empty();
 }
 
 std::vector<docpp::HTML::Element> docpp::HTML::Section::get_elements() const {
     std::vector<docpp::HTML::Element> ret{};
-    ret.reserve(this->index);
-    for (size_type i{0}; i < this->index; i++) {
-        if (this->elements.find(i) != this->elements.end()) {
-            ret.push_back(this->elements.at(i));
+    ret.reserve(this->children.size());
+
+    for (const node_type& it : this->children) {
+        if (std::holds_alternative<Element>(it)) {
+            ret.push_back(std::get<Element>(it));
         }
     }
+
     return ret;
 }
 
 std::vector<docpp::HTML::Section> docpp::HTML::Section::get_sections() const {
     std::vector<docpp::HTML::Section> ret{};
-    ret.reserve(this->index);
 
-    for (size_type i{0}; i < this->index; i++) {
-        if (this->sections.find(i) != this->sections.end()) {
-            ret.push_back(this->sections.at(i));
+    for (const node_type& it : this->children) {
+        if (std::holds_alternative<Section>(it)) {
+            ret.push_back(std::get<Section>(it));
         }
     }
 
     return ret;
 }
 
-docpp::string_type docpp::HTML::Section::get(const Formatting formatting, const docpp::integer_type tabc) const {
-    std::ostringstream ret{};
+struct docpp::HTML::Section::impl_prerendered {
+    struct Entry {
+        std::uint64_t hash{0};
+        Formatting formatting{Formatting::None};
+        docpp::integer_type tabc{0};
+        bool escaping{false};
+        bool preformatted{false};
+        bool close{true};
+        std::shared_ptr<const docpp::string_type> output{};
+    };
+
+    std::mutex mutex{};
+    std::vector<Entry> entries{};
+};
+
+namespace {
+    // the number of outputs cached per frozen section; copies that are changed in different ways need one each
+    constexpr docpp::size_type impl_html_prerendered_entries{16};
+} // namespace
+
+void docpp::HTML::Section::freeze() {
+    if (!this->prerendered) {
+        this->prerendered = std::make_shared<impl_prerendered>();
+    }
+}
+
+void docpp::HTML::Section::thaw() {
+    this->prerendered.reset();
+}
+
+bool docpp::HTML::Section::is_frozen() const {
+    return this->prerendered != nullptr;
+}
+
+std::uint64_t docpp::HTML::Section::hash() const {
+    if (const std::uint64_t hash{this->cached_hash.load(std::memory_order_acquire)}; hash != 0) {
+        return hash;
+    }
 
     struct Entry {
         const Section* section{nullptr};
-        docpp::integer_type tabc{tabc};
-        bool processing{false};
+        // the sum of what the children add to the hash; each adds a hash of its index, kind and hash
+        std::uint64_t sum{0};
+        size_type nodes{1};
+        // the children to hash, if the section keeps a log: those in it since the section was last hashed
+        std::vector<size_type> indices{};
+        bool logged{false};
+        size_type log_size{0};
+        size_type next{0};
+        size_type index{0};
+    };
+
+    const auto push = [](std::stack<Entry>& s_stack, const Section* section) {
+        Entry& entry{s_stack.emplace(Entry{section})};
+
+        if (section->children.size() < impl_html_logged_children) {
+            return;
+        }
+
+        const std::lock_guard<std::mutex> lock{impl_html_changes_mutex};
+        const impl_changes* changes{section->changes.get()};
+
+        if (changes == nullptr) {
+            return;
+        }
+
+        entry.sum = changes->sum;
+        entry.nodes = changes->nodes;
+        entry.logged = true;
+        entry.log_size = changes->log.size();
+
+        // the first entry of a child holds what it added when the section was last hashed; later ones came from hashing it on its own
+        std::vector<std::pair<size_type, size_type>> order{};
+        order.reserve(changes->log.size() - changes->hashed);
+
+        for (size_type i{changes->hashed}; i < changes->log.size(); ++i) {
+            order.emplace_back(changes->log[i].index, i);
+        }
+
+        std::sort(order.begin(), order.end());
+        entry.indices.reserve(order.size());
+
+        for (size_type i{0}; i < order.size(); ++i) {
+            if (i != 0 && order[i].first == order[i - 1].first) {
+                continue;
+            }
+
+            entry.sum -= changes->log[order[i].second].hash;
+            entry.nodes -= changes->log[order[i].second].nodes;
+            entry.indices.push_back(order[i].first);
+        }
     };
 
+    std::uint64_t ret{0};
     std::stack<Entry> s_stack{};
-    s_stack.push({this, tabc, false});
+    push(s_stack, this);
 
     while (!s_stack.empty()) {
         Entry& c_entry{s_stack.top()};
         const Section* c_sect{c_entry.section};
-        docpp::integer_type c_tabc{c_entry.tabc};
+        bool descended{false};
 
-        if (!c_entry.processing) {
-            if (c_sect->tag.empty() && c_sect->properties.empty() && c_sect->sections.empty() && c_sect->elements.empty()) {
-                s_stack.pop();
+        while (c_entry.next < (c_entry.logged ? c_entry.indices.size() : c_sect->children.size())) {
+            const size_type i{c_entry.logged ? c_entry.indices[c_entry.next++] : c_entry.next++};
+
+            if (i >= c_sect->children.size()) {
                 continue;
             }
 
-            if (formatting == docpp::HTML::Formatting::Pretty) {
-                for (size_type i{0}; i < c_tabc; i++) {
-                    ret << "\t";
+            const node_type& child{c_sect->children[i]};
+
+            if (const Section* section = std::get_if<Section>(&child)) {
+                // nested sections that have not been modified since they were last hashed are not walked again
+                if (const std::uint64_t hash{section->cached_hash.load(std::memory_order_acquire)}; hash != 0) {
+                    c_entry.sum += impl_html_hash_child(i, true, hash);
+                    c_entry.nodes += section->cached_nodes.load(std::memory_order_relaxed);
+                    continue;
                 }
+
+                c_entry.index = i;
+                push(s_stack, section);
+                descended = true;
+                break;
+            } else if (const Element* element = std::get_if<Element>(&child)) {
+                c_entry.sum += impl_html_hash_child(i, false, element->hash());
+                ++c_entry.nodes;
             }
+        }
 
-            if (!c_sect->tag.empty()) {
-                ret << "<" + c_sect->tag;
+        if (descended) {
+            continue;
+        }
 
-                for (const Property& it : c_sect->properties.get_properties()) {
-                    if (it.get_key().empty() || it.get_value().empty()) {
-                        continue;
+        std::uint64_t hash{impl_hash_basis};
+        impl_hash_string(hash, c_sect->tag.view());
+        impl_hash_properties(hash, c_sect->properties);
+        impl_hash_value(hash, c_entry.sum);
+
+        ret = impl_hash_finish(hash);
+        const size_type nodes{c_entry.nodes};
+
+        if (c_sect->children.size() >= impl_html_logged_children) {
+            const std::lock_guard<std::mutex> lock{impl_html_changes_mutex};
+
+            // start a log, or mark the entries read as hashed
+            if (!c_sect->changes) {
+                c_sect->changes = std::make_shared<impl_changes>();
+                c_sect->changes->generation = ++impl_html_changes_generation;
+            }
+
+            c_sect->changes->sum = c_entry.sum;
+            c_sect->changes->nodes = nodes;
+            c_sect->changes->hashed = c_entry.logged ? c_entry.log_size : c_sect->changes->log.size();
+        }
+
+        // the node count is published along with the hash
+        c_sect->cached_nodes.store(nodes, std::memory_order_relaxed);
+        c_sect->cached_hash.store(ret, std::memory_order_release);
+        s_stack.pop();
+
+        if (!s_stack.empty()) {
+            Entry& p_entry{s_stack.top()};
+            p_entry.sum += impl_html_hash_child(p_entry.index, true, ret);
+            p_entry.nodes += nodes;
+        }
+    }
+
+    return ret;
+}
+
+void docpp::HTML::Section::impl_write_prerendered(Sink& sink, const Formatting formatting, const docpp::integer_type tabc, const bool preformatted, const bool close) const {
+    const std::uint64_t hash{this->hash()};
+    const bool escaping{sink.is_escaping()};
+    std::shared_ptr<const docpp::string_type> output{};
+
+    const auto find = [&]() {
+        for (const impl_prerendered::Entry& it : this->prerendered->entries) {
+            if (it.hash == hash && it.formatting == formatting && it.tabc == tabc && it.escaping == escaping && it.preformatted == preformatted && it.close == close) {
+                return it.output;
+            }
+        }
+
+        return std::shared_ptr<const docpp::string_type>{};
+    };
+
+    {
+        const std::lock_guard<std::mutex> lock{this->prerendered->mutex};
+        output = find();
+    }
+
+    if (!output) {
+        docpp::string_type str{};
+        StringSink p_sink{str};
+        p_sink.set_escaping(escaping);
+
+        this->impl_write(p_sink, formatting, tabc, false, preformatted, close);
+
+        const std::lock_guard<std::mutex> lock{this->prerendered->mutex};
+
+        // another thread may have rendered it in the meantime
+        output = find();
+
+        if (!output) {
+            std::vector<impl_prerendered::Entry>& entries{this->prerendered->entries};
+
+            if (entries.size() >= impl_html_prerendered_entries) {
+                entries.erase(entries.begin());
+            }
+
+            output = std::make_shared<const docpp::string_type>(std::move(str));
+            entries.push_back({hash, formatting, tabc, escaping, preformatted, close, output});
+        }
+    }
+
+    sink.write(*output);
+}
+
+struct docpp::HTML::Section::impl_incremental {
+    struct Node;
+
+    // a child of a section that is walked: the output of a small subtree, or the record of a section that is walked as well
+    struct Child {
+        std::uint64_t hash{0};
+        docpp::string_type output{};
+        std::unique_ptr<Node> node{};
+    };
+
+    // a section that is walked: its start and end tags, and one child per child of the section, in order
+    struct Node {
+        std::uint64_t hash{0};
+        docpp::integer_type tabc{0};
+        bool preformatted{false};
+        // the log of the section and how much of it had been written when the record was made, if the section keeps one
+        std::uint64_t generation{0};
+        size_type logged{0};
+        docpp::string_type open{};
+        docpp::string_type close{};
+        std::vector<Child> children{};
+        size_type size{0};
+    };
+
+    std::mutex mutex{};
+    std::unique_ptr<Node> root{};
+    Formatting formatting{Formatting::None};
+    bool escaping{false};
+};
+
+namespace {
+    // subtrees of at most this many nodes are kept as a whole; larger ones are walked, so that a change only renders a small subtree again
+    constexpr docpp::size_type impl_html_incremental_nodes{64};
+} // namespace
+
+void docpp::HTML::Section::set_incremental(const bool incremental) {
+    if (!incremental) {
+        this->incremental.reset();
+    } else if (!this->incremental) {
+        this->incremental = std::make_shared<impl_incremental>();
+    }
+}
+
+bool docpp::HTML::Section::is_incremental() const {
+    return this->incremental != nullptr;
+}
+
+std::shared_ptr<docpp::HTML::Section::impl_incremental> docpp::HTML::Section::impl_copy_incremental(const std::shared_ptr<impl_incremental>& incremental) {
+    return incremental ? std::make_shared<impl_incremental>() : nullptr;
+}
+
+void docpp::HTML::Section::impl_write_incremental(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    using Child = impl_incremental::Child;
+    using Node = impl_incremental::Node;
+
+    const bool escaping{sink.is_escaping()};
+    const bool newline{formatting == docpp::HTML::Formatting::Pretty || formatting == docpp::HTML::Formatting::Newline};
+    const bool minified{formatting == docpp::HTML::Formatting::Minified};
+    const auto is_small = [](const Section& section) {
+        return section.prerendered || section.cached_nodes.load(std::memory_order_relaxed) <= impl_html_incremental_nodes;
+    };
+
+    // only the sections modified since the last write are hashed again, which also counts their nodes
+    const std::uint64_t hash{this->hash()};
+
+    if (is_small(*this)) {
+        CountingSink counting{};
+        counting.set_escaping(escaping);
+        this->impl_write(counting, formatting, tabc, true);
+
+        sink.reserve(counting.size());
+        this->impl_write(sink, formatting, tabc, true);
+        return;
+    }
+
+    struct Entry {
+        const Section* section{nullptr};
+        Node* node{nullptr};
+        // the record of the section from the last write; its children are reused where they still match
+        std::unique_ptr<Node> old{};
+        std::unordered_multimap<std::uint64_t, size_type> index{};
+        // the children to walk, if the record follows the log of the section: those noted in it since the last write
+        std::vector<size_type> indices{};
+        bool logged{false};
+        docpp::integer_type tabc{0};
+        size_type next{0};
+        // whether whitespace is kept in the children, with Formatting::Minified
+        bool preformatted{false};
+    };
+
+    impl_incremental& cache{*this->incremental};
+    const std::lock_guard<std::mutex> lock{cache.mutex};
+
+    if (cache.formatting != formatting || cache.escaping != escaping) {
+        cache.root.reset();
+        cache.formatting = formatting;
+        cache.escaping = escaping;
+    }
+
+    // take the child of the last write with the same hash, preferably at the same index, so that it is not rendered again
+    const auto take = [](Entry& entry, const size_type i, const std::uint64_t c_hash, const bool node) {
+        Child ret{};
+
+        if (!entry.old) {
+            return ret;
+        }
+
+        std::vector<Child>& children{entry.old->children};
+        const auto matches = [&](const size_type j) {
+            return j < children.size() && children[j].hash == c_hash && (children[j].node != nullptr) == node;
+        };
+
+        size_type j{i};
+        if (!matches(j)) {
+            if (entry.index.empty()) {
+                entry.index.reserve(children.size());
+
+                for (size_type k{0}; k < children.size(); ++k) {
+                    entry.index.emplace(children[k].hash, k);
+                }
+            }
+
+            j = npos;
+            for (auto [it, end] = entry.index.equal_range(c_hash); it != end; ++it) {
+                if (matches(it->second)) {
+                    j = it->second;
+                    break;
+                }
+            }
+
+            if (j == npos) {
+                return ret;
+            }
+        }
+
+        ret = std::move(children[j]);
+        children[j].hash = 0;
+
+        return ret;
+    };
+
+    // with Formatting::Minified the output of a child also depends on what surrounds it, so that is part of the hash it is matched by
+    const auto key = [minified](std::uint64_t c_hash, const bool preformatted, const bool close) {
+        if (minified) {
+            impl_hash_value(c_hash, static_cast<std::uint64_t>(preformatted) << 1 | static_cast<std::uint64_t>(close));
+            c_hash = impl_hash_finish(c_hash);
+        }
+
+        return c_hash;
+    };
+
+    // erased children and empty sections write nothing, so with Formatting::Minified the end tag of a child depends on the next one that is neither
+    const auto skipped = [](const node_type& child) {
+        const Section* section{std::get_if<Section>(&child)};
+        return std::holds_alternative<std::monostate>(child) || (section && section->tag.empty() && section->properties.empty() && section->children.empty());
+    };
+
+    // render the tags of a section that has changed, and start a new record of its children
+    const auto push = [&](std::stack<Entry>& s_stack, const Section* section, Node* node, std::unique_ptr<Node> old, const docpp::integer_type c_tabc, const bool preformatted, const bool close) {
+        impl_stats_add_node();
+
+        node->hash = section->hash();
+        node->tabc = c_tabc;
+        node->preformatted = preformatted;
+
+        Entry& entry{s_stack.emplace(Entry{section, node, nullptr, {}, {}, false, c_tabc, 0, section->impl_keeps_whitespace(formatting, preformatted)})};
+
+        if (section->tag.empty()) { // if Section is just a container, we don't need to indent
+            --entry.tabc;
+        } else {
+            StringSink open{node->open};
+            open.set_escaping(escaping);
+            section->impl_write_open(open, formatting, c_tabc);
+
+            if (close) {
+                StringSink close_sink{node->close};
+                section->impl_write_close(close_sink, formatting, c_tabc);
+
+                // nested sections are followed by a newline like elements are, the outermost one is not
+                if (newline && s_stack.size() > 1) {
+                    close_sink.write("\n");
+                }
+            }
+        }
+
+        // a record made while following the log of the section only needs the children noted in it since
+        if (section->children.size() >= impl_html_logged_children) {
+            const std::lock_guard<std::mutex> lock{impl_html_changes_mutex};
+
+            if (const impl_changes* changes = section->changes.get()) {
+                node->generation = changes->generation;
+                node->logged = changes->log.size();
+
+                if (old && old->generation == changes->generation && old->logged <= changes->log.size() && old->tabc == c_tabc &&
+                    old->preformatted == preformatted && old->open == node->open && old->children.size() <= section->children.size()) {
+                    entry.logged = true;
+
+                    for (size_type i{old->logged}; i < changes->log.size(); ++i) {
+                        entry.indices.push_back(changes->log[i].index);
+                    }
+                }
+            }
+        }
+
+        if (!entry.logged) {
+            entry.old = std::move(old);
+            node->children.reserve(section->children.size());
+            return;
+        }
+
+        for (size_type i{old->children.size()}; i < section->children.size(); ++i) {
+            entry.indices.push_back(i);
+        }
+
+        if (minified) {
+            for (size_type k{0}, count{entry.indices.size()}; k < count; ++k) {
+                for (size_type j{entry.indices[k]}; j-- > 0;) {
+                    entry.indices.push_back(j);
+
+                    if (j < section->children.size() && !skipped(section->children[j])) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::sort(entry.indices.begin(), entry.indices.end());
+        entry.indices.erase(std::unique(entry.indices.begin(), entry.indices.end()), entry.indices.end());
+
+        // the size of the children; the children that are walked are taken out of it and added back
+        node->size = old->size - old->open.size() - old->close.size();
+        node->children = std::move(old->children);
+        node->children.resize(section->children.size());
+    };
+
+    const auto size_of = [](const Child& child) {
+        return child.node ? child.node->size : child.output.size();
+    };
+
+    // update the record, rendering only the subtrees that have changed since the last write
+    if (!cache.root || cache.root->hash != hash || cache.root->tabc != tabc) {
+        std::unique_ptr<Node> old{std::move(cache.root)};
+        std::stack<Entry> s_stack{};
+
+        cache.root = std::make_unique<Node>();
+
+        try {
+            push(s_stack, this, cache.root.get(), old && old->tabc == tabc ? std::move(old) : nullptr, tabc, false, true);
+
+            while (!s_stack.empty()) {
+                Entry& c_entry{s_stack.top()};
+                const Section* c_sect{c_entry.section};
+                Node* c_node{c_entry.node};
+
+                bool descended{false};
+                while (c_entry.next < (c_entry.logged ? c_entry.indices.size() : c_sect->children.size())) {
+                    const size_type i{c_entry.logged ? c_entry.indices[c_entry.next++] : c_entry.next++};
+
+                    if (i >= c_sect->children.size()) {
+                        continue;
+                    }
+
+                    const node_type& child{c_sect->children[i]};
+                    const Section* section{std::get_if<Section>(&child)};
+                    const Element* element{std::get_if<Element>(&child)};
+                    const bool c_close{!minified || c_sect->impl_minify_close(i)};
+
+                    // a record that follows the log is updated in place, starting from the child of the last write at the same index
+                    Child previous{};
+                    if (c_entry.logged) {
+                        previous = std::move(c_node->children[i]);
+                        c_node->size -= size_of(previous);
+                    }
+
+                    const auto reuse = [&](const std::uint64_t c_hash, const bool node) {
+                        if (!c_entry.logged) {
+                            return take(c_entry, i, c_hash, node);
+                        }
+
+                        return previous.hash == c_hash && (previous.node != nullptr) == node ? std::move(previous) : Child{};
+                    };
+
+                    const auto place = [&](Child&& c_child) -> Child& {
+                        if (!c_entry.logged) {
+                            return c_node->children.emplace_back(std::move(c_child));
+                        }
+
+                        c_node->children[i] = std::move(c_child);
+                        return c_node->children[i];
+                    };
+
+                    if (section && !is_small(*section)) {
+                        const std::uint64_t c_hash{key(section->hash(), c_entry.preformatted, c_close)};
+                        Child c_child{reuse(c_hash, true)};
+
+                        if (c_child.node) {
+                            const Child& placed{place(std::move(c_child))};
+                            c_node->size += c_entry.logged ? size_of(placed) : 0;
+                            continue;
+                        }
+
+                        // the section has changed; the record at the same index is the one most likely to still be of use
+                        std::unique_ptr<Node> old_child{};
+                        if (c_entry.logged) {
+                            old_child = std::move(previous.node);
+                        } else if (c_entry.old && i < c_entry.old->children.size() && c_entry.old->children[i].node) {
+                            old_child = std::move(c_entry.old->children[i].node);
+                            c_entry.old->children[i].hash = 0;
+                        }
+
+                        c_child.hash = c_hash;
+                        c_child.node = std::make_unique<Node>();
+
+                        Node* node{c_child.node.get()};
+                        const docpp::integer_type c_tabc{c_entry.tabc + 1};
+                        place(std::move(c_child));
+
+                        push(s_stack, section, node, std::move(old_child), c_tabc, c_entry.preformatted, c_close);
+                        descended = true;
+                        break;
+                    }
+
+                    // erased children write nothing
+                    if (!section && !element) {
+                        place(Child{});
+                        continue;
                     }
 
-                    ret << " " + it.get_key() + "=\"" + it.get_value() + "\"";
+                    const std::uint64_t c_hash{key(section ? section->hash() : element->hash(), c_entry.preformatted, c_close)};
+                    Child c_child{reuse(c_hash, false)};
+
+                    if (c_child.hash == 0) {
+                        c_child.hash = c_hash;
+                        StringSink p_sink{c_child.output};
+                        p_sink.set_escaping(escaping);
+
+                        if (section) {
+                            section->impl_write(p_sink, formatting, c_entry.tabc + 1, true, c_entry.preformatted, c_close);
+
+                            if (newline && !section->tag.empty()) {
+                                p_sink.write("\n");
+                            }
+                        } else {
+                            element->impl_write(p_sink, formatting, c_entry.tabc + 1, c_entry.preformatted, c_close);
+                        }
+                    }
+
+                    const Child& placed{place(std::move(c_child))};
+                    c_node->size += c_entry.logged ? size_of(placed) : 0;
+                }
+
+                if (descended) {
+                    continue;
                 }
 
-                ret << ">";
+                if (c_entry.logged) {
+                    c_node->size += c_node->open.size() + c_node->close.size();
+                } else {
+                    c_node->size = c_node->open.size() + c_node->close.size();
+
+                    for (const Child& it : c_node->children) {
+                        c_node->size += size_of(it);
+                    }
+                }
+
+                s_stack.pop();
+
+                // the size of a section walked in place is only known once it is done
+                if (!s_stack.empty() && s_stack.top().logged) {
+                    s_stack.top().node->size += c_node->size;
+                }
+            }
+        } catch (...) {
+            // the record is left incomplete, so the next write starts over
+            cache.root.reset();
+            throw;
+        }
+    }
+
+    sink.reserve(cache.root->size);
+
+    // write the record
+    struct Replay {
+        const Node* node{nullptr};
+        size_type next{0};
+    };
+
+    std::stack<Replay> s_stack{};
+    s_stack.push({cache.root.get(), 0});
+    sink.write(cache.root->open);
+
+    while (!s_stack.empty()) {
+        Replay& c_entry{s_stack.top()};
+
+        bool descended{false};
+        while (c_entry.next < c_entry.node->children.size()) {
+            const Child& child{c_entry.node->children[c_entry.next++]};
+
+            if (child.node) {
+                sink.write(child.node->open);
+                s_stack.push({child.node.get(), 0});
+                descended = true;
+                break;
+            }
+
+            sink.write(child.output);
+        }
+
+        if (descended) {
+            continue;
+        }
+
+        sink.write(c_entry.node->close);
+        s_stack.pop();
+    }
+}
+
+void docpp::HTML::Section::impl_write_open(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    if (formatting == docpp::HTML::Formatting::Pretty) {
+        sink.indent(tabc);
+    }
+
+    sink.write("<");
+    sink.write(this->tag.view());
+
+    for (const Property& it : this->properties) {
+        if (it.key_view().empty() || it.value_view().empty()) {
+            continue;
+        }
+
+        const bool quote{formatting != docpp::HTML::Formatting::Minified || !impl_minify_unquoted(it.value_view())};
+
+        sink.write(" ");
+        sink.write(it.key_view());
+        sink.write(quote ? "=\"" : "=");
+
+        if (sink.is_escaping()) {
+            sink.write_escaped(it.value_view());
+        } else {
+            sink.write(it.value_view());
+        }
+
+        if (quote) {
+            sink.write("\"");
+        }
+    }
+
+    sink.write(">");
+
+    if (formatting == docpp::HTML::Formatting::Pretty || formatting == docpp::HTML::Formatting::Newline) {
+        sink.write("\n");
+    }
+}
+
+void docpp::HTML::Section::impl_write_close(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    if (formatting == docpp::HTML::Formatting::Pretty) {
+        sink.indent(tabc);
+    }
+
+    sink.write("</");
+    sink.write(this->tag.view());
+    sink.write(">");
+}
+
+void docpp::HTML::Section::write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    if (scope.top_level()) {
+        impl_stats_sink counting{sink};
+        this->write(counting, formatting, tabc);
+        scope.add_bytes(counting.size());
+        return;
+    }
+
+    if (this->incremental && !sink.collects_slots()) {
+        this->impl_write_incremental(sink, formatting, tabc);
+    } else {
+        this->impl_write(sink, formatting, tabc, true);
+    }
+}
 
-                if (formatting == docpp::HTML::Formatting::Pretty || formatting == docpp::HTML::Formatting::Newline) {
-                    ret << "\n";
+void docpp::HTML::Section::impl_write(Sink& sink, const Formatting formatting, const docpp::integer_type tabc, const bool prerendered, const bool preformatted, const bool close) const {
+    struct Entry {
+        const Section* section{nullptr};
+        docpp::integer_type tabc{0};
+        size_type next{0};
+        bool processing{false};
+        bool preformatted{false};
+        bool close{true};
+    };
+
+    const bool newline{formatting == docpp::HTML::Formatting::Pretty || formatting == docpp::HTML::Formatting::Newline};
+    const bool minified{formatting == docpp::HTML::Formatting::Minified};
+    // the cached output of a frozen section holds no slots, so it is rendered for a sink that collects them
+    const bool cached{!sink.collects_slots()};
+
+    std::stack<Entry> s_stack{};
+    s_stack.push({this, tabc, 0, false, preformatted, close});
+
+    while (!s_stack.empty()) {
+        Entry& c_entry{s_stack.top()};
+        const Section* c_sect{c_entry.section};
+
+        if (!c_entry.processing) {
+            if (c_sect->tag.empty() && c_sect->properties.empty() && c_sect->children.empty()) {
+                s_stack.pop();
+                continue;
+            }
+
+            impl_stats_add_node();
+
+            if (cached && c_sect->prerendered && (prerendered || c_sect != this)) {
+                c_sect->impl_write_prerendered(sink, formatting, c_entry.tabc, c_entry.preformatted, c_entry.close);
+
+                if (newline && s_stack.size() > 1 && !c_sect->tag.empty()) {
+                    sink.write("\n");
                 }
+
+                s_stack.pop();
+                continue;
+            }
+
+            if (!c_sect->tag.empty()) {
+                c_sect->impl_write_open(sink, formatting, c_entry.tabc);
             } else { // if Section is just a container, we don't need to indent
-                --c_tabc;
+                --c_entry.tabc;
             }
 
             c_entry.processing = true;
+        }
+
+        // children are written in order; descend as soon as a section is found, and resume after it when it is done
+        const bool c_preformatted{c_sect->impl_keeps_whitespace(formatting, c_entry.preformatted)};
+        bool descended{false};
+        while (c_entry.next < c_sect->children.size()) {
+            const size_type i{c_entry.next++};
+            const node_type& child{c_sect->children[i]};
+
+            if (const Section* section = std::get_if<Section>(&child)) {
+                s_stack.push({section, c_entry.tabc + 1, 0, false, c_preformatted, !minified || c_sect->impl_minify_close(i)});
+                descended = true;
+                break;
+            } else if (const Element* element = std::get_if<Element>(&child)) {
+                element->impl_write(sink, formatting, c_entry.tabc + 1, c_preformatted, !minified || c_sect->impl_minify_close(i));
+            }
+        }
+
+        if (descended) {
+            continue;
+        }
+
+        if (!c_sect->tag.empty() && c_entry.close) {
+            c_sect->impl_write_close(sink, formatting, c_entry.tabc);
+
+            // nested sections are followed by a newline like elements are, the outermost one is not
+            if (newline && s_stack.size() > 1) {
+                sink.write("\n");
+            }
+        }
+
+        s_stack.pop();
+    }
+}
+
+bool docpp::HTML::Section::impl_keeps_whitespace(const Formatting formatting, const bool preformatted) const {
+    return formatting == docpp::HTML::Formatting::Minified && (preformatted || impl_minify_preformatted(this->tag.view()));
+}
+
+bool docpp::HTML::Section::impl_minify_close(const size_type index) const {
+    const node_type& child{this->children[index]};
+    const Section* section{std::get_if<Section>(&child)};
+    const Element* element{std::get_if<Element>(&child)};
+    const std::string_view tag{section ? section->tag_view() : element ? element->tag_view() : std::string_view{}};
+
+    if (!impl_minify_optional_end(tag) || (element && element->get_type() != docpp::HTML::Type::Non_Self_Closing)) {
+        return true;
+    }
+
+    for (size_type i{index + 1}; i < this->children.size(); ++i) {
+        const node_type& next{this->children[i]};
+
+        if (const Section* n_sect = std::get_if<Section>(&next)) {
+            // empty sections write nothing, and the content of a container could be anything
+            if (n_sect->tag.empty() && n_sect->properties.empty() && n_sect->children.empty()) {
+                continue;
+            }
+
+            return !impl_minify_omit_end(tag, n_sect->tag.view(), false, this->tag.view());
+        } else if (const Element* n_element = std::get_if<Element>(&next)) {
+            const docpp::HTML::Type type{n_element->get_type()};
+            const bool tagged{type == docpp::HTML::Type::Non_Self_Closing || type == docpp::HTML::Type::Self_Closing || type == docpp::HTML::Type::Non_Closed};
+
+            return !impl_minify_omit_end(tag, tagged ? n_element->tag_view() : std::string_view{}, false, this->tag.view());
+        }
+    }
+
+    // the end of a container is not the end of its parent
+    return this->tag.empty() || !impl_minify_omit_end(tag, {}, true, this->tag.view());
+}
 
-            for (size_type i = 0; i < c_sect->index; i++) {
-                if (c_sect->sections.find(i) != c_sect->sections.end()) {
-                    s_stack.push({&c_sect->sections.at(i), c_tabc + 1, false});
-                } else if (c_sect->elements.find(i) != c_sect->elements.end()) {
-                    ret << c_sect->elements.at(i).get(formatting, c_tabc + 1);
+docpp::size_type docpp::HTML::Section::rendered_size(const Formatting formatting, const docpp::integer_type tabc) const {
+    CountingSink sink{};
+
+    this->write(sink, formatting, tabc);
+
+    return sink.size();
+}
+
+docpp::string_type docpp::HTML::Section::get(const Formatting formatting, const docpp::integer_type tabc) const {
+    impl_stats_scope scope{};
+    docpp::string_type ret{};
+
+    // the string grows as it is written rather than being sized up front, which would write the section twice;
+    // an incremental section reserves the space it needs once it knows its size
+    StringSink sink{ret};
+
+    this->write(sink, formatting, tabc);
+
+    scope.add_bytes(ret.size());
+    impl_stats_add_string(ret.size());
+
+    return ret;
+}
+
+docpp::string_type docpp::HTML::Section::get_parallel(const Formatting formatting, ThreadPool& pool, const docpp::integer_type tabc) const {
+    // the number of nodes in, and the number of sections in, the subtree of every section, in the order the sections are written
+    struct Subtree {
+        size_type nodes{1};
+        size_type sections{1};
+    };
+
+    std::vector<Subtree> subtrees{};
+
+    {
+        struct Entry {
+            const Section* section{nullptr};
+            size_type index{0};
+            size_type next{0};
+        };
+
+        std::stack<Entry> s_stack{};
+        s_stack.push({this, 0, 0});
+        subtrees.emplace_back();
+
+        while (!s_stack.empty()) {
+            Entry& c_entry{s_stack.top()};
+            bool descended{false};
+
+            while (c_entry.next < c_entry.section->children.size()) {
+                const node_type& child{c_entry.section->children[c_entry.next++]};
+
+                if (const Section* section = std::get_if<Section>(&child)) {
+                    s_stack.push({section, subtrees.size(), 0});
+                    subtrees.emplace_back();
+                    descended = true;
+                    break;
+                } else if (std::holds_alternative<Element>(child)) {
+                    ++subtrees[c_entry.index].nodes;
                 }
             }
-        } else {
-            if (!c_sect->tag.empty()) {
-                if (formatting == docpp::HTML::Formatting::Pretty) {
-                    for (size_type i{0}; i < c_tabc; i++) {
-                        ret << "\t";
+
+            if (descended) {
+                continue;
+            }
+
+            const Subtree subtree{subtrees[c_entry.index]};
+            s_stack.pop();
+
+            if (!s_stack.empty()) {
+                subtrees[s_stack.top().index].nodes += subtree.nodes;
+                subtrees[s_stack.top().index].sections += subtree.sections;
+            }
+        }
+    }
+
+    // aim for several pieces per worker, so that workers that finish early can steal the remaining ones
+    const size_type piece_nodes{std::max<size_type>(256, subtrees.front().nodes / (pool.size() * 8))};
+
+    if (subtrees.front().nodes <= piece_nodes || this->prerendered) {
+        return this->get(formatting, tabc);
+    }
+
+    impl_stats_scope scope{};
+
+    const bool newline{formatting == docpp::HTML::Formatting::Pretty || formatting == docpp::HTML::Formatting::Newline};
+    const bool minified{formatting == docpp::HTML::Formatting::Minified};
+
+    // the output, in document order: the text written here, alternating with the output of the pieces
+    std::deque<docpp::string_type> parts(1);
+    CallbackSink sink{[&parts](const std::string_view data) { parts.back().append(data); }, 0};
+
+    std::mutex mutex{};
+    std::condition_variable condition{};
+    size_type remaining{0};
+    std::exception_ptr error{};
+
+    // render a run of children of a section into its own part
+    const auto submit = [&](const Section* section, const size_type first, const size_type last, const docpp::integer_type c_tabc, const bool preformatted) {
+        docpp::string_type* part{&parts.emplace_back()};
+        parts.emplace_back();
+
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            ++remaining;
+        }
+
+        try {
+            pool.push([&, part, section, first, last, c_tabc, preformatted]() {
+                try {
+                    impl_stats_scope p_scope{};
+                    StringSink p_sink{*part};
+
+                    for (size_type i{first}; i < last; ++i) {
+                        const node_type& child{section->children[i]};
+                        const bool close{!minified || section->impl_minify_close(i)};
+
+                        if (const Section* c_sect = std::get_if<Section>(&child)) {
+                            c_sect->impl_write(p_sink, formatting, c_tabc, true, preformatted, close);
+
+                            if (newline && !c_sect->tag.empty()) {
+                                p_sink.write("\n");
+                            }
+                        } else if (const Element* element = std::get_if<Element>(&child)) {
+                            element->impl_write(p_sink, formatting, c_tabc, preformatted, close);
+                        }
+                    }
+
+                    p_scope.add_bytes(part->size());
+                } catch (...) {
+                    const std::lock_guard<std::mutex> lock{mutex};
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+
+                const std::lock_guard<std::mutex> lock{mutex};
+                if (--remaining == 0) {
+                    condition.notify_all();
+                }
+            });
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock{mutex};
+            --remaining;
+            throw;
+        }
+    };
+
+    // pieces refer to the parts and the section, so they must be done before returning, even when an exception is thrown
+    const auto wait = [&]() {
+        // help running the pieces; once none are queued, the rest are running on the workers
+        while (pool.run_one()) {
+            const std::lock_guard<std::mutex> lock{mutex};
+            if (remaining == 0) {
+                break;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [&remaining]() { return remaining == 0; });
+    };
+
+    // sections larger than a piece are written here, and their children are split into pieces of about piece_nodes nodes
+    struct Entry {
+        const Section* section{nullptr};
+        docpp::integer_type tabc{0};
+        size_type next{0};
+        size_type next_index{0};
+        // whether whitespace is kept in the children, and whether the section writes its end tag, with Formatting::Minified
+        bool preformatted{false};
+        bool close{true};
+    };
+
+    try {
+        std::stack<Entry> s_stack{};
+        s_stack.push({this, this->tag.empty() ? tabc - 1 : tabc, 0, 1, this->impl_keeps_whitespace(formatting, false), true});
+
+        if (!this->tag.empty()) {
+            this->impl_write_open(sink, formatting, tabc);
+        }
+
+        impl_stats_add_node();
+
+        while (!s_stack.empty()) {
+            Entry& c_entry{s_stack.top()};
+            const Section* c_sect{c_entry.section};
+
+            size_type first{c_entry.next};
+            size_type nodes{0};
+            bool descended{false};
+
+            while (c_entry.next < c_sect->children.size()) {
+                const size_type index{c_entry.next++};
+                const Section* section{std::get_if<Section>(&c_sect->children[index])};
+
+                if (section == nullptr) {
+                    ++nodes;
+                } else if (const Subtree subtree{subtrees[c_entry.next_index]}; subtree.nodes > piece_nodes && !section->prerendered) {
+                    if (first != index) {
+                        submit(c_sect, first, index, c_entry.tabc + 1, c_entry.preformatted);
                     }
+
+                    s_stack.push({section, section->tag.empty() ? c_entry.tabc : c_entry.tabc + 1, 0, c_entry.next_index + 1,
+                                  section->impl_keeps_whitespace(formatting, c_entry.preformatted), !minified || c_sect->impl_minify_close(index)});
+                    c_entry.next_index += subtree.sections;
+
+                    if (!section->tag.empty()) {
+                        section->impl_write_open(sink, formatting, c_entry.tabc + 1);
+                    }
+
+                    impl_stats_add_node();
+
+                    descended = true;
+                    break;
+                } else {
+                    // frozen sections are copied from their cache
+                    nodes += section->prerendered ? 1 : subtree.nodes;
+                    c_entry.next_index += subtree.sections;
+                }
+
+                if (nodes >= piece_nodes) {
+                    submit(c_sect, first, c_entry.next, c_entry.tabc + 1, c_entry.preformatted);
+                    first = c_entry.next;
+                    nodes = 0;
+                }
+            }
+
+            if (descended) {
+                continue;
+            }
+
+            if (first != c_entry.next) {
+                submit(c_sect, first, c_entry.next, c_entry.tabc + 1, c_entry.preformatted);
+            }
+
+            if (!c_sect->tag.empty() && c_entry.close) {
+                c_sect->impl_write_close(sink, formatting, c_entry.tabc);
+
+                if (newline && s_stack.size() > 1) {
+                    sink.write("\n");
                 }
-                ret << "</" + c_sect->tag + ">";
             }
 
             s_stack.pop();
         }
+    } catch (...) {
+        wait();
+        throw;
+    }
+
+    wait();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    size_type size{0};
+    size_type written{0};
+    for (size_type i{0}; i < parts.size(); ++i) {
+        size += parts[i].size();
+
+        // the pieces count their own bytes, on the thread that wrote them
+        if (i % 2 == 0) {
+            written += parts[i].size();
+        }
     }
 
-    return ret.str();
+    docpp::string_type ret{};
+    ret.reserve(size);
+
+    for (const docpp::string_type& it : parts) {
+        ret.append(it);
+    }
+
+    scope.add_bytes(written);
+    impl_stats_add_string(ret.size());
+
+    return ret;
 }
 
 docpp::string_type docpp::HTML::Section::get_tag() const {
-    return this->tag;
+    impl_stats_add_string(this->tag.size());
+    return docpp::string_type(this->tag.view());
 }
 
 docpp::HTML::Properties docpp::HTML::Section::get_properties() const {
     return this->properties;
 }
 
+docpp::HTML::Section::allocator_type docpp::HTML::Section::get_allocator() const {
+    return this->children.get_allocator();
+}
+
 void docpp::HTML::Section::swap(const size_type index1, const size_type index2) {
-    if (this->elements.find(index1) != this->elements.end() && this->elements.find(index2) != this->elements.end()) {
-        std::swap(this->elements[index1], this->elements[index2]);
-    } else if (this->sections.find(index1) != this->sections.end() && this->sections.find(index2) != this->sections.end()) {
-        std::swap(this->sections[index1], this->sections[index2]);
-    } else {
+    if (index1 >= this->children.size() || index2 >= this->children.size() || this->children[index1].index() != this->children[index2].index() || std::holds_alternative<std::monostate>(this->children[index1])) {
         throw docpp::out_of_range("Index out of range");
     }
+
+    this->impl_modified(index1);
+    this->impl_modified(index2);
+
+    std::swap(this->children[index1], this->children[index2]);
 }
 
 void docpp::HTML::Section::swap(const Element& element1, const Element& element2) {
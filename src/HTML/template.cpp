@@ -0,0 +1,148 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <functional>
+#include <docpp/except.hpp>
+#include <docpp/HTML/template.hpp>
+#include <docpp/stats.hpp>
+
+namespace {
+    // records the output of a section or document, cutting it into a new piece at every slot
+    class impl_html_template_sink : public docpp::Sink {
+        private:
+            docpp::string_type& markup;
+            std::vector<docpp::string_type>& slots;
+            std::function<void(docpp::size_type, docpp::size_type, bool)> push;
+            docpp::size_type start{0};
+        public:
+            impl_html_template_sink(docpp::string_type& markup, std::vector<docpp::string_type>& slots, std::function<void(docpp::size_type, docpp::size_type, bool)> push)
+                : markup(markup), slots(slots), push(std::move(push)) {};
+            ~impl_html_template_sink() override = default;
+
+            void write(const std::string_view data) override {
+                this->markup.append(data.data(), data.size());
+            }
+
+            [[nodiscard]] bool collects_slots() const override {
+                return true;
+            }
+
+            void write_slot(const std::string_view name, const bool escape) override {
+                const auto it{std::find(this->slots.begin(), this->slots.end(), name)};
+                const docpp::size_type index{static_cast<docpp::size_type>(it - this->slots.begin())};
+
+                if (it == this->slots.end()) {
+                    this->slots.emplace_back(name);
+                }
+
+                this->push(this->markup.size() - this->start, index, escape);
+                this->start = this->markup.size();
+            }
+
+            [[nodiscard]] docpp::size_type remaining() const {
+                return this->markup.size() - this->start;
+            }
+    };
+} // namespace
+
+template <typename T> void docpp::HTML::Template::impl_build(const T& node, const Formatting formatting, const docpp::integer_type tabc) {
+    impl_html_template_sink sink{this->markup, this->slots, [this](const size_type size, const size_type slot, const bool escape) {
+        this->pieces.push_back({size, slot, escape});
+    }};
+
+    node.write(sink, formatting, tabc);
+
+    // the markup after the last slot
+    this->pieces.push_back({sink.remaining(), npos, false});
+    this->markup.shrink_to_fit();
+}
+
+docpp::HTML::Template::Template(const Section& section, const Formatting formatting, const docpp::integer_type tabc) {
+    this->impl_build(section, formatting, tabc);
+}
+
+docpp::HTML::Template::Template(const Document& document, const Formatting formatting, const docpp::integer_type tabc) {
+    this->impl_build(document, formatting, tabc);
+}
+
+const std::vector<docpp::string_type>& docpp::HTML::Template::get_slots() const {
+    return this->slots;
+}
+
+docpp::size_type docpp::HTML::Template::find(const std::string_view name) const {
+    for (size_type i{0}; i < this->slots.size(); i++) {
+        if (this->slots[i] == name) {
+            return i;
+        }
+    }
+
+    return docpp::HTML::Template::npos;
+}
+
+docpp::size_type docpp::HTML::Template::size() const {
+    return this->slots.size();
+}
+
+docpp::size_type docpp::HTML::Template::static_size() const {
+    return this->markup.size();
+}
+
+void docpp::HTML::Template::write(Sink& sink, const std::vector<std::string_view>& values) const {
+    if (values.size() != this->slots.size()) {
+        throw docpp::invalid_argument{"Expected one value per slot"};
+    }
+
+    impl_stats_scope scope{};
+    if (scope.top_level()) {
+        impl_stats_sink counting{sink};
+        this->write(counting, values);
+        scope.add_bytes(counting.size());
+        return;
+    }
+
+    size_type offset{0};
+
+    for (const impl_piece& it : this->pieces) {
+        if (it.size != 0) {
+            sink.write(std::string_view(this->markup.data() + offset, it.size));
+            offset += it.size;
+        }
+
+        if (it.slot == npos) {
+            continue;
+        }
+
+        if (it.escape) {
+            sink.write_escaped(values[it.slot]);
+        } else {
+            sink.write(values[it.slot]);
+        }
+    }
+}
+
+docpp::size_type docpp::HTML::Template::rendered_size(const std::vector<std::string_view>& values) const {
+    CountingSink sink{};
+
+    this->write(sink, values);
+
+    return sink.size();
+}
+
+docpp::string_type docpp::HTML::Template::get(const std::vector<std::string_view>& values) const {
+    impl_stats_scope scope{};
+    docpp::string_type ret{};
+    ret.reserve(this->rendered_size(values));
+    StringSink sink{ret};
+
+    this->write(sink, values);
+
+    scope.add_bytes(ret.size());
+    impl_stats_add_string(ret.size());
+
+    return ret;
+}
\ No newline at end of file
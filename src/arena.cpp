@@ -0,0 +1,24 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <docpp/arena.hpp>
+
+std::pmr::memory_resource* docpp::Arena::get_resource() {
+    return &this->resource;
+}
+
+docpp::allocator_type docpp::Arena::get_allocator() {
+    return docpp::allocator_type{&this->resource};
+}
+
+void docpp::Arena::release() {
+    this->resource.release();
+}
+
+docpp::Arena::operator docpp::allocator_type() {
+    return this->get_allocator();
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <docpp/deflate.hpp>
+
+#ifdef DOCPP_WITH_ZLIB
+#include <algorithm>
+#include <climits>
+#include <zlib.h>
+#include <docpp/except.hpp>
+
+struct docpp::DeflateSink::impl_stream {
+    z_stream stream{};
+    unsigned char output[16384]{};
+};
+
+namespace {
+    // writes are gathered into chunks of this size before they are compressed, as the encoder is slow to start on small inputs
+    constexpr docpp::size_type impl_deflate_buffer_size{16384};
+    // the largest input passed to the encoder at once, as z_stream counts in unsigned int
+    constexpr docpp::size_type impl_deflate_max_input{static_cast<docpp::size_type>(UINT_MAX) & ~static_cast<docpp::size_type>(0xffff)};
+
+    // raw deflate is used for every format, the header and trailer are written by hand, so that precompressed chunks
+    // can be spliced into the stream and their checksums combined
+    void impl_deflate_init(z_stream& stream, const docpp::integer_type level) {
+        if (level < -1 || level > 9 || deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw docpp::invalid_argument{"Invalid compression level"};
+        }
+    }
+
+    // runs the encoder over the input, handing the output to a callback a buffer at a time
+    template <typename T> void impl_deflate_run(z_stream& stream, unsigned char* output, const docpp::size_type output_size,
+            std::string_view data, const int flush, T&& callback) {
+        do {
+            const docpp::size_type size{std::min(data.size(), impl_deflate_max_input)};
+            const int c_flush{size == data.size() ? flush : Z_NO_FLUSH};
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = static_cast<uInt>(size);
+
+            do {
+                stream.next_out = output;
+                stream.avail_out = static_cast<uInt>(output_size);
+
+                const int ret{::deflate(&stream, c_flush)};
+
+                if (ret == Z_STREAM_ERROR) {
+                    throw docpp::io_error{"Failed to compress data"};
+                }
+
+                if (stream.avail_out != output_size) {
+                    callback(std::string_view(reinterpret_cast<const char*>(output), output_size - stream.avail_out));
+                }
+            } while (stream.avail_out == 0);
+
+            data.remove_prefix(size);
+        } while (!data.empty());
+    }
+
+    void impl_deflate_put32(unsigned char* out, const std::uint32_t value, const bool big_endian) {
+        for (int i{0}; i < 4; ++i) {
+            out[big_endian ? 3 - i : i] = static_cast<unsigned char>(value >> (8 * i));
+        }
+    }
+} // namespace
+
+docpp::DeflatedChunk docpp::deflate_chunk(const std::string_view data, const docpp::integer_type level) {
+    DeflatedChunk ret{};
+    z_stream stream{};
+    unsigned char output[16384];
+
+    impl_deflate_init(stream, level);
+
+    try {
+        // a sync flush ends the chunk on a byte boundary, without marking it as the last block of the stream
+        impl_deflate_run(stream, output, sizeof(output), data, Z_SYNC_FLUSH, [&ret](const std::string_view out) {
+            ret.data.append(out.data(), out.size());
+        });
+    } catch (...) {
+        deflateEnd(&stream);
+        throw;
+    }
+
+    deflateEnd(&stream);
+
+    ret.crc32 = static_cast<std::uint32_t>(::crc32_z(0, reinterpret_cast<const Bytef*>(data.data()), data.size()));
+    ret.adler32 = static_cast<std::uint32_t>(::adler32_z(1, reinterpret_cast<const Bytef*>(data.data()), data.size()));
+    ret.size = data.size();
+    ret.data.shrink_to_fit();
+
+    return ret;
+}
+
+docpp::DeflateSink::DeflateSink(Sink& sink, const DeflateFormat format, const docpp::integer_type level, const size_type flush_size)
+    : sink(sink), stream(std::make_unique<impl_stream>()), format(format), flush_size(flush_size) {
+    impl_deflate_init(this->stream->stream, level);
+    this->buffer.reserve(impl_deflate_buffer_size);
+
+    if (format == DeflateFormat::Gzip) {
+        static constexpr unsigned char header[]{0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff};
+
+        this->checksum = static_cast<std::uint32_t>(::crc32(0, nullptr, 0));
+        this->sink.write(std::string_view(reinterpret_cast<const char*>(header), sizeof(header)));
+    } else if (format == DeflateFormat::Zlib) {
+        // the compression level hint in the second byte, as zlib writes it, with the check bits making the header a multiple of 31
+        const unsigned int hint{level == -1 || level == 6 ? 2U : level < 2 ? 0U : level < 6 ? 1U : 3U};
+        const unsigned int header{(0x78U << 8) | (hint << 6)};
+        const unsigned char bytes[]{0x78, static_cast<unsigned char>((hint << 6) + 31 - header % 31)};
+
+        this->checksum = static_cast<std::uint32_t>(::adler32(0, nullptr, 0));
+        this->sink.write(std::string_view(reinterpret_cast<const char*>(bytes), sizeof(bytes)));
+    }
+}
+
+docpp::DeflateSink::~DeflateSink() {
+    try {
+        this->finish();
+    } catch (...) {}
+
+    deflateEnd(&this->stream->stream);
+}
+
+void docpp::DeflateSink::impl_deflate(const std::string_view data, const int flush) {
+    if (this->format == DeflateFormat::Gzip) {
+        this->checksum = static_cast<std::uint32_t>(::crc32_z(this->checksum, reinterpret_cast<const Bytef*>(data.data()), data.size()));
+    } else if (this->format == DeflateFormat::Zlib) {
+        this->checksum = static_cast<std::uint32_t>(::adler32_z(this->checksum, reinterpret_cast<const Bytef*>(data.data()), data.size()));
+    }
+
+    this->total += data.size();
+    this->aligned = flush != Z_NO_FLUSH;
+
+    impl_deflate_run(this->stream->stream, this->stream->output, sizeof(this->stream->output), data, flush, [this](const std::string_view out) {
+        this->sink.write(out);
+    });
+}
+
+void docpp::DeflateSink::write(const std::string_view data) {
+    if (this->finished) {
+        throw docpp::invalid_argument{"Cannot write to a finished DeflateSink"};
+    }
+
+    if (this->buffer.size() + data.size() > impl_deflate_buffer_size) {
+        this->impl_deflate(this->buffer, Z_NO_FLUSH);
+        this->buffer.clear();
+    }
+
+    if (data.size() >= impl_deflate_buffer_size) {
+        this->impl_deflate(data, Z_NO_FLUSH);
+    } else {
+        this->buffer.append(data.data(), data.size());
+    }
+
+    this->unflushed += data.size();
+
+    if (this->flush_size != 0 && this->unflushed >= this->flush_size) {
+        this->flush();
+    }
+}
+
+void docpp::DeflateSink::flush() {
+    if (this->finished) {
+        return;
+    }
+
+    // a sync flush with nothing to flush would write an empty block
+    if (!this->buffer.empty() || !this->aligned) {
+        this->impl_deflate(this->buffer, Z_SYNC_FLUSH);
+        this->buffer.clear();
+    }
+
+    this->unflushed = 0;
+    this->sink.flush();
+}
+
+void docpp::DeflateSink::write_deflated(const DeflatedChunk& chunk) {
+    if (this->finished) {
+        throw docpp::invalid_argument{"Cannot write to a finished DeflateSink"};
+    }
+
+    if (chunk.size == 0) {
+        return;
+    }
+
+    // the chunk must start on a byte boundary
+    if (!this->buffer.empty() || !this->aligned) {
+        this->impl_deflate(this->buffer, Z_SYNC_FLUSH);
+        this->buffer.clear();
+    }
+
+    this->sink.write(chunk.data);
+
+    if (this->format == DeflateFormat::Gzip) {
+        this->checksum = static_cast<std::uint32_t>(::crc32_combine(this->checksum, chunk.crc32, static_cast<z_off_t>(chunk.size)));
+    } else if (this->format == DeflateFormat::Zlib) {
+        this->checksum = static_cast<std::uint32_t>(::adler32_combine(this->checksum, chunk.adler32, static_cast<z_off_t>(chunk.size)));
+    }
+
+    this->total += chunk.size;
+
+    // the encoder does not know what the chunk contains, so it must not refer back past it
+    if (deflateReset(&this->stream->stream) != Z_OK) {
+        throw docpp::io_error{"Failed to compress data"};
+    }
+}
+
+void docpp::DeflateSink::finish() {
+    if (this->finished) {
+        return;
+    }
+
+    this->finished = true;
+    this->impl_deflate(this->buffer, Z_FINISH);
+    this->buffer.clear();
+
+    unsigned char trailer[8]{};
+
+    if (this->format == DeflateFormat::Gzip) {
+        impl_deflate_put32(trailer, this->checksum, false);
+        impl_deflate_put32(trailer + 4, static_cast<std::uint32_t>(this->total), false);
+        this->sink.write(std::string_view(reinterpret_cast<const char*>(trailer), 8));
+    } else if (this->format == DeflateFormat::Zlib) {
+        impl_deflate_put32(trailer, this->checksum, true);
+        this->sink.write(std::string_view(reinterpret_cast<const char*>(trailer), 4));
+    }
+
+    this->sink.flush();
+}
+
+docpp::size_type docpp::DeflateSink::size() const {
+    return this->total + this->buffer.size();
+}
+#endif
\ No newline at end of file
@@ -7,15 +7,30 @@
 
 // NOLINTBEGIN
 #include <src/version.cpp>
+#include <src/arena.cpp>
+#include <src/deflate.cpp>
+#include <src/escape.cpp>
+#include <src/intern.cpp>
+#include <src/mapped_file.cpp>
+#include <src/sink.cpp>
+#include <src/stats.cpp>
+#include <src/thread_pool.cpp>
 #include <src/CSS/property.cpp>
 #include <src/CSS/element.cpp>
+#include <src/CSS/optimize.cpp>
+#include <src/CSS/parser.cpp>
 #include <src/CSS/stylesheet.cpp>
 #include <src/CSS/color.cpp>
 #include <src/CSS/impl/color_conversions.cpp>
 #include <src/HTML/document.cpp>
 #include <src/HTML/element.cpp>
+#include <src/HTML/minify.cpp>
+#include <src/HTML/parser.cpp>
 #include <src/HTML/properties.cpp>
 #include <src/HTML/property.cpp>
 #include <src/HTML/section.cpp>
 #include <src/HTML/tag.cpp>
+#include <src/HTML/template.cpp>
+#include <src/HTML/patch.cpp>
+#include <src/HTML/query.cpp>
 // NOLINTEND
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DOCPP_ESCAPE_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DOCPP_ESCAPE_SSE2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <docpp/escape.hpp>
+
+namespace {
+    constexpr bool impl_needs_escape(const char c) {
+        return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+    }
+
+#if defined(DOCPP_ESCAPE_AVX2) || defined(DOCPP_ESCAPE_SSE2)
+    /* index of the lowest set bit of a non-zero mask */
+    docpp::size_type impl_lowest_bit(const unsigned int mask) {
+#ifdef _MSC_VER
+        unsigned long ret{};
+        _BitScanForward(&ret, mask);
+        return static_cast<docpp::size_type>(ret);
+#else
+        return static_cast<docpp::size_type>(__builtin_ctz(mask));
+#endif
+    }
+#endif
+} // namespace
+
+docpp::size_type docpp::impl_find_escape(const std::string_view str) {
+    const char* data{str.data()};
+    const docpp::size_type size{str.size()};
+    docpp::size_type i{0};
+
+    // compare a whole block against each of the five characters, and only look at single characters once one matches
+#ifdef DOCPP_ESCAPE_AVX2
+    const __m256i amp{_mm256_set1_epi8('&')};
+    const __m256i lt{_mm256_set1_epi8('<')};
+    const __m256i gt{_mm256_set1_epi8('>')};
+    const __m256i quot{_mm256_set1_epi8('"')};
+    const __m256i apos{_mm256_set1_epi8('\'')};
+
+    for (; i + 32 <= size; i += 32) {
+        const __m256i block{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))};
+        const __m256i match{_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, amp), _mm256_cmpeq_epi8(block, lt)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, gt), _mm256_cmpeq_epi8(block, quot)), _mm256_cmpeq_epi8(block, apos)))};
+        const unsigned int mask{static_cast<unsigned int>(_mm256_movemask_epi8(match))};
+
+        if (mask != 0) {
+            return i + impl_lowest_bit(mask);
+        }
+    }
+#endif
+#ifdef DOCPP_ESCAPE_SSE2
+    const __m128i amp16{_mm_set1_epi8('&')};
+    const __m128i lt16{_mm_set1_epi8('<')};
+    const __m128i gt16{_mm_set1_epi8('>')};
+    const __m128i quot16{_mm_set1_epi8('"')};
+    const __m128i apos16{_mm_set1_epi8('\'')};
+
+    for (; i + 16 <= size; i += 16) {
+        const __m128i block{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))};
+        const __m128i match{_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, amp16), _mm_cmpeq_epi8(block, lt16)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, gt16), _mm_cmpeq_epi8(block, quot16)), _mm_cmpeq_epi8(block, apos16)))};
+        const unsigned int mask{static_cast<unsigned int>(_mm_movemask_epi8(match))};
+
+        if (mask != 0) {
+            return i + impl_lowest_bit(mask);
+        }
+    }
+#endif
+
+    for (; i < size; i++) {
+        if (impl_needs_escape(data[i])) {
+            return i;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+std::string_view docpp::impl_escape_entity(const char c) {
+    switch (c) {
+        case '&':
+            return "&amp;";
+        case '<':
+            return "&lt;";
+        case '>':
+            return "&gt;";
+        case '"':
+            return "&quot;";
+        case '\'':
+            return "&#39;";
+        default:
+            return {};
+    }
+}
+
+docpp::string_type docpp::escape(std::string_view str) {
+    docpp::string_type ret{};
+    ret.reserve(str.size());
+
+    for (docpp::size_type i{impl_find_escape(str)}; i != std::string_view::npos; i = impl_find_escape(str)) {
+        ret.append(str.data(), i);
+        ret.append(impl_escape_entity(str[i]));
+        str.remove_prefix(i + 1);
+    }
+
+    ret.append(str.data(), str.size());
+
+    return ret;
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <docpp/hash.hpp>
+#include <docpp/intern.hpp>
+#include <docpp/HTML/tag.hpp>
+
+namespace {
+    // the pool is split by hash, so that threads interning different strings rarely wait for each other
+    constexpr docpp::size_type impl_intern_shards{16};
+
+    // the names the pool starts out with besides the tag names: common HTML attributes and CSS properties
+    constexpr std::array<std::string_view, 139> impl_intern_attributes{
+        "accept", "accept-charset", "accesskey", "action", "align", "allow", "alt", "as", "async", "autocapitalize", "autocomplete",
+        "autofocus", "autoplay", "background", "bgcolor", "border", "charset", "checked", "cite", "class", "color", "cols", "colspan",
+        "content", "contenteditable", "controls", "coords", "crossorigin", "data", "datetime", "decoding", "default", "defer", "dir",
+        "dirname", "disabled", "download", "draggable", "enctype", "enterkeyhint", "for", "form", "formaction", "formenctype",
+        "formmethod", "formnovalidate", "formtarget", "headers", "height", "hidden", "high", "href", "hreflang", "http-equiv", "id",
+        "inert", "inputmode", "integrity", "is", "itemid", "itemprop", "itemref", "itemscope", "itemtype", "kind", "label", "lang",
+        "language", "list", "loading", "loop", "low", "max", "maxlength", "media", "method", "min", "minlength", "multiple", "muted",
+        "name", "nonce", "novalidate", "onblur", "onchange", "onclick", "onfocus", "oninput", "onkeydown", "onkeyup", "onload",
+        "onmousedown", "onmouseout", "onmouseover", "onmouseup", "onsubmit", "open", "optimum", "pattern", "ping", "placeholder",
+        "playsinline", "popover", "poster", "preload", "readonly", "referrerpolicy", "rel", "required", "reversed", "role", "rows",
+        "rowspan", "sandbox", "scope", "selected", "shape", "size", "sizes", "slot", "span", "spellcheck", "src", "srcdoc", "srclang",
+        "srcset", "start", "step", "style", "tabindex", "target", "title", "translate", "type", "usemap", "value", "width", "wrap",
+        "xmlns",
+    };
+
+    constexpr std::array<std::string_view, 187> impl_intern_properties{
+        "align-content", "align-items", "align-self", "all", "animation", "animation-delay", "animation-direction", "animation-duration",
+        "animation-fill-mode", "animation-iteration-count", "animation-name", "animation-play-state", "animation-timing-function",
+        "appearance", "aspect-ratio", "backdrop-filter", "backface-visibility", "background-attachment", "background-blend-mode",
+        "background-clip", "background-color", "background-image", "background-origin", "background-position", "background-repeat",
+        "background-size", "border-bottom", "border-bottom-color", "border-bottom-left-radius", "border-bottom-right-radius",
+        "border-bottom-style", "border-bottom-width", "border-collapse", "border-color", "border-image", "border-left",
+        "border-left-color", "border-left-style", "border-left-width", "border-radius", "border-right", "border-right-color",
+        "border-right-style", "border-right-width", "border-spacing", "border-style", "border-top", "border-top-color",
+        "border-top-left-radius", "border-top-right-radius", "border-top-style", "border-top-width", "border-width", "bottom",
+        "box-shadow", "box-sizing", "caption-side", "caret-color", "clear", "clip", "clip-path", "column-count", "column-gap",
+        "column-rule", "column-width", "columns", "counter-increment", "counter-reset", "cursor", "direction", "display", "empty-cells",
+        "fill", "filter", "flex", "flex-basis", "flex-direction", "flex-flow", "flex-grow", "flex-shrink", "flex-wrap", "float", "font",
+        "font-family", "font-feature-settings", "font-size", "font-stretch", "font-style", "font-variant", "font-weight", "gap", "grid",
+        "grid-area", "grid-auto-columns", "grid-auto-flow", "grid-auto-rows", "grid-column", "grid-column-end", "grid-column-start",
+        "grid-row", "grid-row-end", "grid-row-start", "grid-template", "grid-template-areas", "grid-template-columns",
+        "grid-template-rows", "hyphens", "inset", "isolation", "justify-content", "justify-items", "justify-self", "left",
+        "letter-spacing", "line-height", "list-style", "list-style-image", "list-style-position", "list-style-type", "margin",
+        "margin-bottom", "margin-left", "margin-right", "margin-top", "mask", "max-height", "max-width", "min-height", "min-width",
+        "mix-blend-mode", "object-fit", "object-position", "opacity", "order", "outline", "outline-color", "outline-offset",
+        "outline-style", "outline-width", "overflow", "overflow-wrap", "overflow-x", "overflow-y", "padding", "padding-bottom",
+        "padding-left", "padding-right", "padding-top", "place-content", "place-items", "pointer-events", "position", "quotes", "resize",
+        "right", "row-gap", "scroll-behavior", "stroke", "stroke-width", "tab-size", "table-layout", "text-align", "text-decoration",
+        "text-decoration-color", "text-decoration-line", "text-indent", "text-overflow", "text-shadow", "text-transform", "top",
+        "transform", "transform-origin", "transition", "transition-delay", "transition-duration", "transition-property",
+        "transition-timing-function", "user-select", "vertical-align", "visibility", "white-space", "will-change", "word-break",
+        "word-spacing", "word-wrap", "writing-mode", "z-index",
+    };
+
+    /* a name that is not interned, with the count of the handles holding it and the memory it is allocated from; the characters follow it */
+    struct impl_intern_owned {
+        std::string_view view{};
+        std::atomic<docpp::size_type> count{1};
+        std::pmr::memory_resource* resource{nullptr};
+    };
+
+    impl_intern_owned* impl_intern_get_owned(const std::string_view* entry) {
+        // the view is the first member, so the entry points to the start of the allocation
+        return reinterpret_cast<impl_intern_owned*>(const_cast<std::string_view*>(entry));
+    }
+} // namespace
+
+struct docpp::InternPool::impl_shard {
+    struct impl_hash {
+        size_type operator()(const std::string_view str) const {
+            std::uint64_t hash{impl_hash_basis};
+            impl_hash_string(hash, str);
+            return static_cast<size_type>(hash);
+        }
+    };
+
+    static size_type impl_index(const std::string_view str) {
+        return impl_hash{}(str) % impl_intern_shards;
+    }
+
+    mutable std::shared_mutex mutex{};
+    // the views point into memory, and the elements of an unordered_set do not move, so handles point to the views
+    std::unordered_set<std::string_view, impl_hash> strings{};
+    std::pmr::monotonic_buffer_resource memory{};
+};
+
+docpp::InternedString::InternedString(const std::string_view str) : InternedString(str, allocator_type{}) {}
+
+docpp::InternedString::InternedString(const std::string_view str, const allocator_type& allocator) {
+    if (str.empty()) {
+        return;
+    }
+
+    if (const std::optional<InternedString> interned{InternPool::get().find(str)}) {
+        this->entry = interned->entry;
+        return;
+    }
+
+    this->impl_copy(str, allocator.resource());
+}
+
+docpp::InternedString::InternedString(const InternedString& str, const allocator_type& allocator) : entry(str.entry), owned(str.owned) {
+    if (!this->owned) {
+        return;
+    }
+
+    if (*impl_intern_get_owned(this->entry)->resource == *allocator.resource()) {
+        this->impl_retain();
+        return;
+    }
+
+    this->impl_copy(str.view(), allocator.resource());
+}
+
+docpp::InternedString::InternedString(InternedString&& str, const allocator_type& allocator) : InternedString(static_cast<const InternedString&>(str), allocator) {
+    str = InternedString{};
+}
+
+void docpp::InternedString::impl_copy(const std::string_view str, std::pmr::memory_resource* resource) {
+    void* memory{resource->allocate(sizeof(impl_intern_owned) + str.size(), alignof(impl_intern_owned))};
+    char* data{static_cast<char*>(memory) + sizeof(impl_intern_owned)};
+    std::memcpy(data, str.data(), str.size());
+
+    this->entry = &(new (memory) impl_intern_owned{std::string_view{data, str.size()}, 1, resource})->view;
+    this->owned = true;
+}
+
+void docpp::InternedString::impl_retain() const {
+    impl_intern_get_owned(this->entry)->count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void docpp::InternedString::impl_release() {
+    impl_intern_owned* owned{impl_intern_get_owned(this->entry)};
+
+    if (owned->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::pmr::memory_resource* resource{owned->resource};
+        const docpp::size_type size{sizeof(impl_intern_owned) + owned->view.size()};
+
+        owned->~impl_intern_owned();
+        resource->deallocate(owned, size, alignof(impl_intern_owned));
+    }
+}
+
+docpp::InternPool::InternPool() : shards(std::make_unique<impl_shard[]>(impl_intern_shards)) {
+    for (const HTML::impl_tag_entry& it : HTML::impl_tag_table) {
+        static_cast<void>(this->intern(it.name));
+    }
+
+    for (const std::string_view it : impl_intern_attributes) {
+        static_cast<void>(this->intern(it));
+    }
+
+    for (const std::string_view it : impl_intern_properties) {
+        static_cast<void>(this->intern(it));
+    }
+}
+
+docpp::InternPool::~InternPool() = default;
+
+docpp::InternPool& docpp::InternPool::get() {
+    // never destroyed, as handles held by objects with static storage duration may outlive any destructor
+    static InternPool* pool{new InternPool{}};
+    return *pool;
+}
+
+docpp::InternedString docpp::InternPool::intern(const std::string_view str) {
+    if (str.empty()) {
+        return InternedString{};
+    }
+
+    impl_shard& shard{this->shards[impl_shard::impl_index(str)]};
+
+    {
+        const std::shared_lock<std::shared_mutex> lock{shard.mutex};
+        const auto it{shard.strings.find(str)};
+
+        if (it != shard.strings.end()) {
+            return InternedString{&*it};
+        }
+    }
+
+    const std::lock_guard<std::shared_mutex> lock{shard.mutex};
+    const auto it{shard.strings.find(str)};
+
+    if (it != shard.strings.end()) {
+        return InternedString{&*it};
+    }
+
+    char* data{static_cast<char*>(shard.memory.allocate(str.size(), 1))};
+    std::memcpy(data, str.data(), str.size());
+
+    return InternedString{&*shard.strings.emplace(data, str.size()).first};
+}
+
+std::optional<docpp::InternedString> docpp::InternPool::find(const std::string_view str) const {
+    if (str.empty()) {
+        return InternedString{};
+    }
+
+    const impl_shard& shard{this->shards[impl_shard::impl_index(str)]};
+    const std::shared_lock<std::shared_mutex> lock{shard.mutex};
+    const auto it{shard.strings.find(str)};
+
+    if (it == shard.strings.end()) {
+        return std::nullopt;
+    }
+
+    return InternedString{&*it};
+}
+
+docpp::size_type docpp::InternPool::size() const {
+    size_type ret{0};
+
+    for (size_type i{0}; i < impl_intern_shards; ++i) {
+        const std::shared_lock<std::shared_mutex> lock{this->shards[i].mutex};
+        ret += this->shards[i].strings.size();
+    }
+
+    return ret;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <docpp/except.hpp>
+#include <docpp/mapped_file.hpp>
+
+#ifdef _WIN32
+docpp::MappedFile::MappedFile(const docpp::string_type& path) {
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file) {
+        throw docpp::io_error{"Failed to open file"};
+    }
+
+    std::ostringstream stream{};
+    stream << file.rdbuf();
+
+    this->buffer = stream.str();
+    this->data = this->buffer.data();
+    this->length = this->buffer.size();
+}
+
+docpp::MappedFile::~MappedFile() = default;
+#else
+docpp::MappedFile::MappedFile(const docpp::string_type& path) {
+    const int fd{::open(path.c_str(), O_RDONLY)};
+
+    if (fd < 0) {
+        throw docpp::io_error{"Failed to open file"};
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw docpp::io_error{"Failed to stat file"};
+    }
+
+    this->length = static_cast<size_type>(st.st_size);
+
+    // mapping an empty file fails, and there is nothing to map anyway
+    if (this->length == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* mapping{::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0)};
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        throw docpp::io_error{"Failed to map file"};
+    }
+
+    ::madvise(mapping, this->length, MADV_SEQUENTIAL);
+
+    this->data = static_cast<const char*>(mapping);
+}
+
+docpp::MappedFile::~MappedFile() {
+    if (this->data != nullptr) {
+        ::munmap(const_cast<char*>(this->data), this->length);
+    }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <cerrno>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <docpp/escape.hpp>
+#include <docpp/except.hpp>
+#include <docpp/sink.hpp>
+
+void docpp::Sink::indent(const docpp::integer_type count) {
+    static constexpr std::string_view tabs{"\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"};
+
+    for (docpp::integer_type remaining{count}; remaining > 0; remaining -= static_cast<docpp::integer_type>(tabs.size())) {
+        this->write(tabs.substr(0, std::min(static_cast<size_type>(remaining), tabs.size())));
+    }
+}
+
+void docpp::Sink::write_escaped(std::string_view data) {
+    for (size_type i{impl_find_escape(data)}; i != std::string_view::npos; i = impl_find_escape(data)) {
+        if (i != 0) {
+            this->write(data.substr(0, i));
+        }
+
+        this->write(impl_escape_entity(data[i]));
+        data.remove_prefix(i + 1);
+    }
+
+    if (!data.empty()) {
+        this->write(data);
+    }
+}
+
+void docpp::Sink::set_escaping(const bool escaping) {
+    this->escaping = escaping;
+}
+
+bool docpp::Sink::is_escaping() const {
+    return this->escaping;
+}
+
+void docpp::StringSink::write(const std::string_view data) {
+    this->str.append(data.data(), data.size());
+}
+
+void docpp::StringSink::reserve(const docpp::size_type size) {
+    this->str.reserve(this->str.size() + size);
+}
+
+void docpp::CountingSink::write(const std::string_view data) {
+    this->count += data.size();
+}
+
+docpp::size_type docpp::CountingSink::size() const {
+    return this->count;
+}
+
+void docpp::StreamSink::write(const std::string_view data) {
+    this->stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+void docpp::StreamSink::flush() {
+    this->stream.flush();
+}
+
+docpp::CallbackSink::CallbackSink(std::function<void(std::string_view)> callback, const size_type chunk_size) : callback(std::move(callback)), chunk_size(chunk_size) {
+    this->buffer.reserve(chunk_size);
+}
+
+docpp::CallbackSink::~CallbackSink() {
+    try {
+        this->flush();
+    } catch (...) {}
+}
+
+void docpp::CallbackSink::write(const std::string_view data) {
+    if (this->chunk_size == 0) {
+        this->callback(data);
+        return;
+    }
+
+    if (this->buffer.size() + data.size() > this->chunk_size) {
+        this->flush();
+    }
+
+    if (data.size() >= this->chunk_size) {
+        this->callback(data);
+    } else {
+        this->buffer.append(data.data(), data.size());
+    }
+}
+
+void docpp::CallbackSink::flush() {
+    if (this->buffer.empty()) {
+        return;
+    }
+
+    this->callback(std::string_view(this->buffer.data(), this->buffer.size()));
+    this->buffer.clear();
+}
+
+namespace {
+    void write_fd(const int fd, std::string_view data) {
+        while (!data.empty()) {
+#ifdef _WIN32
+            const int written{::_write(fd, data.data(), static_cast<unsigned int>(data.size()))};
+#else
+            const ssize_t written{::write(fd, data.data(), data.size())};
+#endif
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                throw docpp::io_error{"Failed to write to file descriptor"};
+            }
+
+            data.remove_prefix(static_cast<docpp::size_type>(written));
+        }
+    }
+} // namespace
+
+docpp::FileDescriptorSink::FileDescriptorSink(const int fd, const size_type chunk_size) : fd(fd), chunk_size(chunk_size) {
+    if (fd < 0) {
+        throw docpp::invalid_argument{"Invalid file descriptor"};
+    }
+
+    this->buffer.reserve(chunk_size);
+}
+
+docpp::FileDescriptorSink::~FileDescriptorSink() {
+    try {
+        this->flush();
+    } catch (...) {}
+}
+
+void docpp::FileDescriptorSink::write(const std::string_view data) {
+    if (this->buffer.size() + data.size() > this->chunk_size) {
+        this->flush();
+    }
+
+    if (data.size() >= this->chunk_size) {
+        write_fd(this->fd, data);
+    } else {
+        this->buffer.append(data.data(), data.size());
+    }
+}
+
+void docpp::FileDescriptorSink::flush() {
+    if (this->buffer.empty()) {
+        return;
+    }
+
+    write_fd(this->fd, std::string_view(this->buffer.data(), this->buffer.size()));
+    this->buffer.clear();
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <atomic>
+#include <memory>
+#include <docpp/stats.hpp>
+
+namespace {
+    struct impl_stats_totals {
+        std::atomic<docpp::size_type> renders{0};
+        std::atomic<docpp::size_type> nodes_visited{0};
+        std::atomic<docpp::size_type> bytes_emitted{0};
+        std::atomic<docpp::size_type> string_allocations{0};
+        std::atomic<docpp::size_type> tag_resolutions{0};
+        std::atomic<std::chrono::nanoseconds::rep> render_time{0};
+    };
+
+    impl_stats_totals& impl_stats_get_totals() {
+        static impl_stats_totals totals{};
+        return totals;
+    }
+
+    // replaced as a whole and loaded atomically, so the callback can be changed while other threads render, even from the callback itself
+    std::shared_ptr<const docpp::stats_callback_type>& impl_stats_callback() {
+        static std::shared_ptr<const docpp::stats_callback_type> callback{};
+        return callback;
+    }
+} // namespace
+
+docpp::Stats docpp::get_stats() {
+    const impl_stats_totals& totals{impl_stats_get_totals()};
+
+    Stats stats{};
+    stats.renders = totals.renders.load(std::memory_order_relaxed);
+    stats.nodes_visited = totals.nodes_visited.load(std::memory_order_relaxed);
+    stats.bytes_emitted = totals.bytes_emitted.load(std::memory_order_relaxed);
+    stats.string_allocations = totals.string_allocations.load(std::memory_order_relaxed);
+    stats.tag_resolutions = totals.tag_resolutions.load(std::memory_order_relaxed);
+    stats.render_time = std::chrono::nanoseconds{totals.render_time.load(std::memory_order_relaxed)};
+
+    return stats;
+}
+
+void docpp::reset_stats() {
+    impl_stats_totals& totals{impl_stats_get_totals()};
+
+    totals.renders.store(0, std::memory_order_relaxed);
+    totals.nodes_visited.store(0, std::memory_order_relaxed);
+    totals.bytes_emitted.store(0, std::memory_order_relaxed);
+    totals.string_allocations.store(0, std::memory_order_relaxed);
+    totals.tag_resolutions.store(0, std::memory_order_relaxed);
+    totals.render_time.store(0, std::memory_order_relaxed);
+}
+
+void docpp::set_stats_callback(stats_callback_type callback) {
+    std::shared_ptr<const stats_callback_type> ptr{};
+
+    if (callback) {
+        ptr = std::make_shared<const stats_callback_type>(std::move(callback));
+    }
+
+    std::atomic_store(&impl_stats_callback(), std::move(ptr));
+}
+
+#ifdef DOCPP_ENABLE_STATS
+docpp::impl_stats_counters& docpp::impl_stats_local() {
+    thread_local impl_stats_counters counters{};
+    return counters;
+}
+
+void docpp::impl_stats_add_string_allocation() {
+    ++impl_stats_local().string_allocations;
+    impl_stats_get_totals().string_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void docpp::impl_stats_add_tag_resolution() {
+    ++impl_stats_local().tag_resolutions;
+    impl_stats_get_totals().tag_resolutions.fetch_add(1, std::memory_order_relaxed);
+}
+
+docpp::impl_stats_scope::impl_stats_scope() : counters(impl_stats_local()) {
+    if (this->counters.depth++ == 0) {
+        // strings and tags are counted outside of get() and write() too, so only what happens from here on belongs to this call
+        this->counters.nodes_visited = 0;
+        this->counters.bytes_emitted = 0;
+        this->counters.string_allocations = 0;
+        this->counters.tag_resolutions = 0;
+        this->start = std::chrono::steady_clock::now();
+    }
+}
+
+docpp::impl_stats_scope::~impl_stats_scope() {
+    if (--this->counters.depth != 0) {
+        return;
+    }
+
+    Stats stats{};
+    stats.renders = 1;
+    stats.nodes_visited = this->counters.nodes_visited;
+    stats.bytes_emitted = this->counters.bytes_emitted;
+    stats.string_allocations = this->counters.string_allocations;
+    stats.tag_resolutions = this->counters.tag_resolutions;
+    stats.render_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start);
+
+    impl_stats_totals& totals{impl_stats_get_totals()};
+    totals.renders.fetch_add(1, std::memory_order_relaxed);
+    totals.nodes_visited.fetch_add(stats.nodes_visited, std::memory_order_relaxed);
+    totals.bytes_emitted.fetch_add(stats.bytes_emitted, std::memory_order_relaxed);
+    totals.render_time.fetch_add(stats.render_time.count(), std::memory_order_relaxed);
+
+    const std::shared_ptr<const stats_callback_type> callback{std::atomic_load(&impl_stats_callback())};
+    if (callback) {
+        try {
+            (*callback)(stats);
+        } catch (...) {
+            // the scope may be destroyed while an exception unwinds, so errors in the callback cannot be reported
+        }
+    }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * docpp - C++ library for generating HTML, CSS and SGML-like documents.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ * Copyright (c) 2024 speedie <speedie@speedie.site>
+ */
+
+#include <algorithm>
+#include <docpp/thread_pool.hpp>
+
+namespace {
+    // the pool the current thread is a worker of, and its index in that pool
+    thread_local const docpp::ThreadPool* impl_current_pool{nullptr};
+    thread_local docpp::size_type impl_current_index{docpp::ThreadPool::npos};
+} // namespace
+
+docpp::ThreadPool::ThreadPool(size_type threads) {
+    if (threads == 0) {
+        threads = std::max<size_type>(std::thread::hardware_concurrency(), 1);
+    }
+
+    this->queues.reserve(threads);
+    for (size_type i{0}; i < threads; ++i) {
+        this->queues.push_back(std::make_unique<impl_queue>());
+    }
+
+    this->threads.reserve(threads);
+    for (size_type i{0}; i < threads; ++i) {
+        this->threads.emplace_back([this, i]() { this->impl_work(i); });
+    }
+}
+
+docpp::ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard<std::mutex> lock{this->mutex};
+        this->stop = true;
+    }
+
+    this->condition.notify_all();
+
+    for (std::thread& it : this->threads) {
+        it.join();
+    }
+}
+
+bool docpp::ThreadPool::impl_pop(const size_type index, std::function<void()>& task) {
+    if (index != npos) {
+        impl_queue& queue{*this->queues[index]};
+        const std::lock_guard<std::mutex> lock{queue.mutex};
+
+        // the most recently queued task of a worker is the most likely to still be in its cache
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            this->pending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const size_type start{index == npos ? 0 : index + 1};
+
+    for (size_type i{0}; i < this->queues.size(); ++i) {
+        impl_queue& queue{*this->queues[(start + i) % this->queues.size()]};
+        const std::lock_guard<std::mutex> lock{queue.mutex};
+
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            this->pending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void docpp::ThreadPool::impl_work(const size_type index) {
+    impl_current_pool = this;
+    impl_current_index = index;
+
+    std::function<void()> task{};
+
+    while (true) {
+        if (this->impl_pop(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{this->mutex};
+        this->condition.wait(lock, [this]() { return this->stop || this->pending.load() != 0; });
+
+        if (this->stop && this->pending.load() == 0) {
+            return;
+        }
+    }
+}
+
+void docpp::ThreadPool::push(std::function<void()> task) {
+    const size_type index{impl_current_pool == this ? impl_current_index : this->next.fetch_add(1, std::memory_order_relaxed) % this->queues.size()};
+
+    {
+        impl_queue& queue{*this->queues[index]};
+        const std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+        this->pending.fetch_add(1);
+    }
+
+    // taking the lock orders the notification after the check of a worker that is about to wait
+    {
+        const std::lock_guard<std::mutex> lock{this->mutex};
+    }
+
+    this->condition.notify_one();
+}
+
+bool docpp::ThreadPool::run_one() {
+    std::function<void()> task{};
+
+    if (!this->impl_pop(impl_current_pool == this ? impl_current_index : npos, task)) {
+        return false;
+    }
+
+    task();
+
+    return true;
+}
+
+docpp::size_type docpp::ThreadPool::size() const {
+    return this->threads.size();
+}
\ No newline at end of file
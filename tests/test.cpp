@@ -1,6 +1,11 @@
+#include <atomic>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <src/docpp.cpp>
 #include <catch2/catch_test_macros.hpp>
 
@@ -14,6 +19,27 @@ inline namespace HTML {
 
         for (const auto& it : expected_values) {
             REQUIRE((docpp::HTML::resolve_tag(it.first).first == it.second.first && docpp::HTML::resolve_tag(it.first).second == it.second.second));
+            REQUIRE(docpp::HTML::get_tag_name(it.first) == it.second.first);
+            REQUIRE(docpp::HTML::get_tag_type(it.first) == it.second.second);
+            REQUIRE(docpp::HTML::get_tag_name(docpp::HTML::find_tag(it.second.first).value()) == it.second.first);
+            REQUIRE(docpp::HTML::get_tag_name(docpp::HTML::resolve_tag(it.second.first)) == it.second.first);
+        }
+
+        static_assert(docpp::HTML::get_tag_name(docpp::HTML::Tag::Div) == "div");
+        static_assert(docpp::HTML::get_tag_type(docpp::HTML::Tag::Img) == docpp::HTML::Type::Self_Closing);
+        static_assert(docpp::HTML::find_tag("blockquote") == docpp::HTML::Tag::Blockquote);
+
+        REQUIRE(docpp::HTML::resolve_tag("b") == docpp::HTML::Tag::Bold);
+        REQUIRE(docpp::HTML::resolve_tag("a") == docpp::HTML::Tag::Anchor);
+        REQUIRE(docpp::HTML::resolve_tag("") == docpp::HTML::Tag::Empty);
+        REQUIRE(docpp::HTML::find_tag("notatag").has_value() == false);
+        REQUIRE(docpp::HTML::find_tag("DIV").has_value() == false);
+
+        try {
+            static_cast<void>(docpp::HTML::resolve_tag("notatag"));
+            REQUIRE(false);
+        } catch (const docpp::invalid_argument& e) {
+            REQUIRE(std::string(e.what()) == "Invalid tag");
         }
     }
 
@@ -372,6 +398,54 @@ inline namespace HTML {
             REQUIRE(new_properties3.size() == 1);
         };
 
+        const auto test_keys = []() {
+            using namespace docpp::HTML;
+
+            Properties properties{Property{"class", "card"}, Property{"data-class", "x"}, Property{"id", "intro"}};
+
+            // exact keys, unlike find()
+            REQUIRE(properties.get("id") == "intro");
+            REQUIRE(properties.get("class") == "card");
+            REQUIRE(properties.get("clas").has_value() == false);
+            REQUIRE(properties.find("clas") == 0);
+
+            properties.set("class", "card wide");
+            properties.set("href", "/");
+
+            REQUIRE(properties.size() == 4);
+            REQUIRE(properties.at(0).get_value() == "card wide");
+            REQUIRE(properties.back().get_key() == "href");
+            REQUIRE(properties.get("href") == "/");
+
+            // the first properties are stored inline, without allocating; keys that are not interned are copied with the allocator
+            Properties small{std::pmr::null_memory_resource()};
+            for (docpp::size_type i{0}; i < docpp::HTML::inline_properties; ++i) {
+                static_cast<void>(docpp::InternPool::get().intern("key" + std::to_string(i)));
+                small.set("key" + std::to_string(i), "value");
+            }
+
+            REQUIRE(small.size() == docpp::HTML::inline_properties);
+
+            try {
+                small.set("one-too-many", "value");
+                REQUIRE(false);
+            } catch (const std::bad_alloc&) {
+                REQUIRE(small.size() == docpp::HTML::inline_properties);
+            }
+
+            Element element{Tag::Anchor, Properties{Property{"href", "/old"}}, "link"};
+            const std::uint64_t hash{element.hash()};
+            element.set_property("href", "/new");
+            element.set_property("rel", "next");
+
+            REQUIRE(element.hash() != hash);
+            REQUIRE(element.get() == "<a href=\"/new\" rel=\"next\">link</a>");
+
+            Section section{Tag::Div};
+            section.set_property("id", "main");
+            REQUIRE(section.properties_ref().get("id") == "main");
+        };
+
         test_get_and_set();
         test_copy_properties();
         test_iterators();
@@ -382,6 +456,7 @@ inline namespace HTML {
         test_size_empty_and_clear();
         test_push_front_and_back();
         test_constructors();
+        test_keys();
     }
 
     void test_element() {
@@ -487,9 +562,19 @@ inline namespace HTML {
             REQUIRE(element.get<std::string>(docpp::HTML::Formatting::None) == "<h1>data</h1>");
             REQUIRE(element.get<std::string>(docpp::HTML::Formatting::Pretty) == "<h1>data</h1>\n");
             REQUIRE(element.get<std::string>(docpp::HTML::Formatting::Newline) == "<h1>data</h1>\n");
+            REQUIRE(element.get<std::string>(docpp::HTML::Formatting::Minified) == "<h1>data</h1>");
 
             element.set_type(docpp::HTML::Type::Non_Opened);
             REQUIRE(element.get<std::string>() == "</h1>");
+
+            // without a parent, the end tag is always written
+            Element paragraph{Tag::P, make_properties(Property{"class", "a b"}, Property{"id", "first"}, Property{"title", ""}), "  some\n\ttext  "};
+            REQUIRE(paragraph.get(Formatting::Minified) == "<p class=\"a b\" id=first> some text </p>");
+            REQUIRE(paragraph.rendered_size(Formatting::Minified) == paragraph.get(Formatting::Minified).size());
+
+            REQUIRE(Element{Tag::Pre, {}, "  some\n\ttext  "}.get(Formatting::Minified) == "<pre>  some\n\ttext  </pre>");
+            REQUIRE(Element{Tag::Img, make_properties(Property{"src", "a.png"})}.get(Formatting::Minified) == "<img src=\"a.png\"/>");
+            REQUIRE(Element{Tag::Empty_No_Formatting, {}, "a  b"}.get(Formatting::Minified) == "a b");
         };
 
         test_get_and_set();
@@ -820,6 +905,10 @@ inline namespace HTML {
             REQUIRE(section.at(pos2) == element);
             REQUIRE(section.get_elements().at(pos2) == element);
             REQUIRE(section.get_elements().at(pos2).get_tag() == "h2");
+            REQUIRE(section.size() == 5);
+
+            section.insert(7, element);
+            REQUIRE(section.size() == 8);
         };
 
         const auto test_swap = []() {
@@ -901,6 +990,61 @@ inline namespace HTML {
 
             REQUIRE(section.back().get_tag() == "h3");
             REQUIRE(section.back().get_data() == "data");
+
+            // prepending and appending in turn, with the storage growing at both ends
+            Section list{"ul"};
+            for (int i{0}; i < 1000; ++i) {
+                if (i % 3 == 0) {
+                    list.push_back(Element{Tag::Li, {}, std::to_string(i)});
+                } else {
+                    list.push_front(Element{Tag::Li, {}, std::to_string(i)});
+                }
+            }
+
+            REQUIRE(list.size() == 1000);
+            REQUIRE(list.front().get_data() == "998");
+            REQUIRE(list.back().get_data() == "999");
+            REQUIRE(list.at(666).get_data() == "0");
+            REQUIRE(list.at(667).get_data() == "3");
+
+            // a child prepended to its own section is copied before the children are moved
+            for (int i{0}; i < 100; ++i) {
+                list.push_front(list.back());
+            }
+
+            REQUIRE(list.size() == 1100);
+            REQUIRE(list.front().get_data() == "999");
+            REQUIRE(list.at(99).get_data() == "999");
+            REQUIRE(list.at(100).get_data() == "998");
+
+            // inserting between children moves the ones after it back, on either side of the middle
+            Section nav{"ul", {}, std::vector<Element>{Element{Tag::Li, {}, "A"}, Element{Tag::Li, {}, "D"}}};
+            nav.insert_before(1, Element{Tag::Li, {}, "C"});
+            nav.insert_before(1, Section{"ul", {}, std::vector<Element>{Element{Tag::Li, {}, "B"}}});
+            nav.insert_before(0, Element{Tag::Li, {}, "Start"});
+            nav.insert_before(nav.size(), Element{Tag::Li, {}, "End"});
+            REQUIRE(nav.emplace<Element>(4, Tag::Li, Properties{}, "C2").get_data() == "C2");
+            REQUIRE(nav.get() == "<ul><li>Start</li><li>A</li><ul><li>B</li></ul><li>C</li><li>C2</li><li>D</li><li>End</li></ul>");
+
+            for (int i{0}; i < 500; ++i) {
+                nav.insert_before(nav.size() / 2, Element{Tag::Li, {}, std::to_string(i)});
+            }
+            REQUIRE(nav.size() == 507);
+            REQUIRE(nav.at(nav.size() / 2).get_data() == "499");
+            REQUIRE(nav.front().get_data() == "Start");
+            REQUIRE(nav.back().get_data() == "End");
+
+            // and children moved by it stay linked to the section
+            const docpp::string_type before{nav.get()};
+            nav.at_section(2).at(0).set_data("Nested");
+            REQUIRE(nav.get() != before);
+
+            try {
+                nav.insert_before(nav.size() + 1, Element{Tag::Li});
+                REQUIRE(false);
+            } catch (const docpp::out_of_range& e) {
+                REQUIRE(std::string(e.what()) == "Index out of range");
+            }
         };
 
         const auto test_string_get = []() {
@@ -981,6 +1125,155 @@ inline namespace HTML {
             REQUIRE(retrieved_elem3.get_data() == "data");
         };
 
+        const auto test_mixed_children = []() {
+            using namespace docpp::HTML;
+
+            Section section{docpp::HTML::Tag::Div, {}};
+
+            section.push_back(Element{docpp::HTML::Tag::P, {}, "1"});
+            section.push_front(Section{docpp::HTML::Tag::Span, {}, std::vector<Element>{Element{docpp::HTML::Tag::B, {}, "0"}}});
+            section.push_front(Section{docpp::HTML::Tag::Span, {}, std::vector<Element>{Element{docpp::HTML::Tag::I, {}, "-1"}}});
+            section.push_back(Element{docpp::HTML::Tag::P, {}, "2"});
+
+            REQUIRE(section.size() == 4);
+            REQUIRE(section.get() == "<div><span><i>-1</i></span><span><b>0</b></span><p>1</p><p>2</p></div>");
+            REQUIRE(section.at_section(0).get() == "<span><i>-1</i></span>");
+            REQUIRE(section.at(2).get_data() == "1");
+            REQUIRE(section.get_sections().size() == 2);
+            REQUIRE(section.get_elements().size() == 2);
+
+            std::size_t count{0};
+            for (const Element& it : section) {
+                REQUIRE(it.get_tag() == "p");
+                ++count;
+            }
+            REQUIRE(count == 2);
+
+            section.erase(1);
+
+            REQUIRE(section.size() == 4);
+            REQUIRE(section.get() == "<div><span><i>-1</i></span><p>1</p><p>2</p></div>");
+            REQUIRE(section.find(Element{docpp::HTML::Tag::P, {}, "2"}) == 3);
+            REQUIRE(section.find("<b>") == Section::npos);
+            REQUIRE(section.find("<i>") == 0);
+
+            try {
+                section.erase(1);
+                REQUIRE(false);
+            } catch (const docpp::out_of_range& e) {
+                REQUIRE(std::string(e.what()) == "Index out of range");
+            }
+        };
+
+        const auto test_write = []() {
+            using namespace docpp::HTML;
+
+            Section section{docpp::HTML::Tag::Html, {}, std::vector<Section>{
+                Section{docpp::HTML::Tag::Head, {}, std::vector<Element>{Element{docpp::HTML::Tag::Title, {}, "Title"}}},
+                Section{docpp::HTML::Tag::Body, {}, std::vector<Element>{Element{docpp::HTML::Tag::H1, {}, "Hello"}}},
+            }};
+
+            section.push_back(Element{docpp::HTML::Tag::P, {}, "after"});
+
+            REQUIRE(section.get() == "<html><head><title>Title</title></head><body><h1>Hello</h1></body><p>after</p></html>");
+            REQUIRE(section.get(docpp::HTML::Formatting::Pretty) == "<html>\n\t<head>\n\t\t<title>Title</title>\n\t</head>\n\t<body>\n\t\t<h1>Hello</h1>\n\t</body>\n\t<p>after</p>\n</html>");
+
+            for (const auto formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                std::ostringstream stream{};
+                docpp::StreamSink stream_sink{stream};
+                section.write(stream_sink, formatting);
+
+                REQUIRE(stream.str() == section.get(formatting));
+
+                std::string chunked{};
+                std::size_t chunks{0};
+                {
+                    docpp::CallbackSink callback_sink{[&chunked, &chunks](std::string_view chunk) {
+                        REQUIRE(chunk.size() <= 16);
+                        chunked += chunk;
+                        ++chunks;
+                    }, 16};
+                    section.write(callback_sink, formatting);
+                }
+
+                REQUIRE(chunked == section.get(formatting));
+                REQUIRE(chunks > 1);
+            }
+
+#ifndef _WIN32
+            std::FILE* file = std::tmpfile();
+            REQUIRE(file != nullptr);
+            {
+                docpp::FileDescriptorSink fd_sink{fileno(file)};
+                Document{section}.write(fd_sink, Formatting::Pretty);
+            }
+
+            std::rewind(file);
+            std::string written{};
+            for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+                written += static_cast<char>(c);
+            }
+            std::fclose(file);
+
+            REQUIRE(written == Document{section}.get(Formatting::Pretty));
+#endif
+        };
+
+        const auto test_arena = []() {
+            using namespace docpp::HTML;
+
+            docpp::Arena arena{};
+            std::pmr::memory_resource* resource{arena.get_resource()};
+
+            Document document{arena};
+            Section& html{document.get_section()};
+
+            html.set_tag(Tag::Html);
+
+            // built on the heap, copied into the arena when added
+            Section body{Tag::Body, {}};
+            body.push_back(Element{Tag::P, make_properties(Property{"class", "a-class-name-long-enough-to-allocate"}), "Some paragraph text that does not fit in a small string"});
+            body.push_back(Section{Tag::Div, {}, std::vector<Element>{Element{Tag::Span, {}, "span"}}});
+
+            html.push_back(body);
+            html.insert(3, Element{Tag::Footer, {}, "footer"});
+
+            REQUIRE(document.get_allocator().resource() == resource);
+            REQUIRE(html.get_allocator().resource() == resource);
+            REQUIRE(html.at_section(0).get_allocator().resource() == resource);
+            REQUIRE(html.at_section(0).at(0).get_allocator().resource() == resource);
+            REQUIRE(html.at_section(0).at_section(1).at(0).get_allocator().resource() == resource);
+            REQUIRE(html.at(3).get_allocator().resource() == resource);
+            REQUIRE(body.get_allocator().resource() == std::pmr::get_default_resource());
+
+            REQUIRE(document.get() == "<!DOCTYPE html><html><body><p class=\"a-class-name-long-enough-to-allocate\">Some paragraph text that does not fit in a small string</p><div><span>span</span></div></body><footer>footer</footer></html>");
+
+            // copies without an allocator leave the arena
+            Section copy{html};
+            REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+            REQUIRE(copy.at_section(0).get_allocator().resource() == std::pmr::get_default_resource());
+            REQUIRE(copy == html);
+
+            // and copies with one go into it
+            Section arena_copy{copy, arena};
+            REQUIRE(arena_copy.at_section(0).at_section(1).get_allocator().resource() == resource);
+            REQUIRE(arena_copy == html);
+
+            // as do assignments into a section that lives in the arena
+            html.at_section(0) = copy;
+            REQUIRE(html.at_section(0).at_section(0).get_allocator().resource() == resource);
+            REQUIRE(html.at_section(0).get() == copy.get());
+
+            Section section{Tag::Div, {}, arena};
+            for (int i{0}; i < 100; ++i) {
+                section.push_back(Element{Tag::P, {}, "Paragraph number " + std::to_string(i) + " of the section"});
+            }
+
+            REQUIRE(section.size() == 100);
+            REQUIRE(section.at(99).get_allocator().resource() == resource);
+            REQUIRE(section.at(99).get_data() == "Paragraph number 99 of the section");
+        };
+
         const auto the_test_to_end_all_tests = []() {
             using namespace docpp::HTML;
 
@@ -1026,9 +1319,758 @@ inline namespace HTML {
             REQUIRE(Section().get<std::string>() == "");
         };
 
+        const auto test_views = []() {
+            using namespace docpp::HTML;
+
+            Section section{Tag::Div, make_properties(Property{"id", "container"})};
+            section.push_back(Element{Tag::P, make_properties(Property{"class", "first"}, Property{"style", "color: red"}), "First"});
+            section.push_back(Section{Tag::Span, {}});
+            section.push_back(Element{Tag::P, {}, "Second"});
+            section.push_back(Section{Tag::Footer, {}});
+            section.erase(2);
+
+            REQUIRE(section.tag_view() == "div");
+            REQUIRE(section.properties_ref().at(0).key_view() == "id");
+            REQUIRE(section.properties_ref().at(0).value_view() == "container");
+
+            const Element& element{section.at(0)};
+            REQUIRE(element.tag_view() == "p");
+            REQUIRE(element.data_view() == "First");
+            REQUIRE(element.properties_ref().size() == 2);
+            REQUIRE(&element.properties_ref() == &section.at(0).properties_ref());
+
+            std::string keys{};
+            for (const Property& it : element.properties_ref().properties_view()) {
+                keys += it.key_view();
+            }
+            REQUIRE(keys == "classstyle");
+            REQUIRE(element.properties_ref().properties_view().size() == 2);
+
+            const auto elements{section.elements_view()};
+            REQUIRE(elements.size() == 1);
+            REQUIRE(&*elements.begin() == &section.at(0));
+
+            std::string tags{};
+            for (const Section& it : section.sections_view()) {
+                tags += it.tag_view();
+            }
+            REQUIRE(tags == "spanfooter");
+            REQUIRE(section.sections_view().size() == 2);
+            REQUIRE(Section{}.sections_view().empty());
+
+            const Document document{section};
+            REQUIRE(document.doctype_view() == "<!DOCTYPE html>");
+            REQUIRE(document.section_ref().tag_view() == "div");
+        };
+
+        const auto test_rendered_size = []() {
+            using namespace docpp::HTML;
+
+            Section section{Tag::Div, make_properties(Property{"id", "container"})};
+            section.push_back(Element{Tag::H1, {}, "Title"});
+            section.push_back(Element{Tag::Br});
+            section.push_back(Section{Tag::Span, {}, {Element{Tag::P, make_properties(Property{"class", "text"}), "Text"}}});
+            section.push_back(Element{Tag::Empty, {}, "Plain"});
+
+            const Document document{section};
+
+            for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                for (const docpp::integer_type tabc : {0, 1, 3}) {
+                    REQUIRE(section.rendered_size(formatting, tabc) == section.get(formatting, tabc).size());
+                    REQUIRE(section.at(0).rendered_size(formatting, tabc) == section.at(0).get(formatting, tabc).size());
+                    REQUIRE(document.rendered_size(formatting, tabc) == document.get(formatting, tabc).size());
+                }
+            }
+
+            REQUIRE(Section{}.rendered_size() == Section{}.get().size());
+            REQUIRE(section.get().capacity() >= section.rendered_size());
+
+            docpp::CountingSink sink{};
+            section.write(sink, Formatting::Pretty);
+            section.write(sink, Formatting::Pretty);
+            REQUIRE(sink.size() == 2 * section.get(Formatting::Pretty).size());
+        };
+
+        const auto test_get_parallel = []() {
+            using namespace docpp::HTML;
+
+            Section table{Tag::Table, make_properties(Property{"class", "report"})};
+            Section body{Tag::Tbody};
+
+            for (int i{0}; i < 2000; ++i) {
+                Section row{Tag::Tr, make_properties(Property{"data-row", std::to_string(i)})};
+                row.push_back(Element{Tag::Td, {}, "Cell " + std::to_string(i)});
+                row.push_back(Element{Tag::Td, {}, "Value"});
+
+                if (i % 100 == 0) {
+                    row.push_back(make_section_container(Element{Tag::Empty, {}, "Contained"}, Section{Tag::Span, {}, {Element{Tag::Br}}}));
+                }
+
+                body.push_back(std::move(row));
+
+                if (i % 250 == 0) {
+                    body.push_back(Element{Tag::Empty, {}, "Text"});
+                }
+            }
+
+            // a chain of nested sections, each too large to be a single piece
+            Section chain{Tag::Div};
+            for (int i{0}; i < 600; ++i) {
+                chain.push_back(Element{Tag::P, {}, "Paragraph"});
+            }
+            for (int i{0}; i < 3; ++i) {
+                Section outer{Tag::Div, make_properties(Property{"class", "level"})};
+                outer.push_back(std::move(chain));
+                outer.push_back(Element{Tag::Br});
+                chain = std::move(outer);
+            }
+
+            table.push_back(Element{Tag::Caption, {}, "Report"});
+            table.push_back(std::move(body));
+            table.push_back(Element{Tag::Br});
+            table.erase(2);
+
+            Section page{Tag::Empty};
+            page.push_back(std::move(table));
+            page.push_back(make_section_container(std::move(chain)));
+            page.push_back(Section{});
+
+            docpp::ThreadPool pool{3};
+            docpp::ThreadPool single{1};
+
+            for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                for (const docpp::integer_type tabc : {0, 2}) {
+                    const docpp::string_type expected{page.get(formatting, tabc)};
+
+                    REQUIRE(page.get_parallel(formatting, pool, tabc) == expected);
+                    REQUIRE(page.get_parallel(formatting, single, tabc) == expected);
+                    REQUIRE(page.at_section(0).get_parallel(formatting, pool, tabc) == page.at_section(0).get(formatting, tabc));
+                }
+            }
+
+            const Section small{Tag::Div, {}, {Element{Tag::P, {}, "Small"}}};
+            REQUIRE(small.get_parallel(Formatting::Pretty, pool) == small.get(Formatting::Pretty));
+            REQUIRE(Section{}.get_parallel(Formatting::None, pool).empty());
+
+            // a worker of the pool helps running the pieces instead of waiting for itself
+            docpp::string_type nested{};
+            std::atomic<bool> done{false};
+            single.push([&]() {
+                nested = page.get_parallel(Formatting::Pretty, single);
+                done = true;
+            });
+
+            while (!done) {
+                std::this_thread::yield();
+            }
+
+            REQUIRE(nested == page.get(Formatting::Pretty));
+        };
+
+        const auto test_prerendered = []() {
+            using namespace docpp::HTML;
+
+            Section header{Tag::Header, make_properties(Property{"id", "header"})};
+            header.push_back(Element{Tag::H1, {}, "Title & more"});
+            header.push_back(Section{Tag::Nav, {}, {Element{Tag::Anchor, make_properties(Property{"href", "/"}), "Home"}}});
+
+            Section frozen{header};
+            REQUIRE(!frozen.is_frozen());
+            frozen.freeze();
+            REQUIRE(frozen.is_frozen());
+
+            Section page{Tag::Div};
+            page.push_back(frozen);
+            page.push_back(Element{Tag::P, {}, "Content"});
+
+            Section expected{Tag::Div};
+            expected.push_back(header);
+            expected.push_back(Element{Tag::P, {}, "Content"});
+
+            for (int i{0}; i < 2; ++i) {
+                for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                    for (const docpp::integer_type tabc : {0, 1, 3}) {
+                        REQUIRE(page.get(formatting, tabc) == expected.get(formatting, tabc));
+                        REQUIRE(frozen.get(formatting, tabc) == header.get(formatting, tabc));
+                        REQUIRE(page.rendered_size(formatting, tabc) == expected.get(formatting, tabc).size());
+                    }
+                }
+            }
+
+            // copies share the cache, and changes to a copy are picked up
+            Section copy{frozen};
+            REQUIRE(copy.is_frozen());
+            REQUIRE(copy.get() == header.get());
+
+            copy.at_section(1).push_back(Element{Tag::Anchor, make_properties(Property{"href", "/about"}), "About"});
+            header.at_section(1).push_back(Element{Tag::Anchor, make_properties(Property{"href", "/about"}), "About"});
+            REQUIRE(copy.get(Formatting::Pretty) == header.get(Formatting::Pretty));
+            REQUIRE(frozen.get(Formatting::Pretty) != header.get(Formatting::Pretty));
+
+            copy.at(0).set_data("Changed");
+            REQUIRE(copy.get() != header.get());
+            REQUIRE(copy.get().find("Changed") != docpp::string_type::npos);
+
+            // the escaping of the sink is part of the key
+            const Document document{page};
+            Document escaped{page};
+            escaped.set_escaping(true);
+            REQUIRE(document.get().find("Title & more") != docpp::string_type::npos);
+            REQUIRE(escaped.get().find("Title &amp; more") != docpp::string_type::npos);
+            REQUIRE(document.get().find("Title & more") != docpp::string_type::npos);
+
+            Section arena_copy{frozen, docpp::allocator_type{}};
+            REQUIRE(arena_copy.is_frozen());
+
+            frozen.thaw();
+            REQUIRE(!frozen.is_frozen());
+            REQUIRE(copy.is_frozen());
+
+            docpp::ThreadPool pool{2};
+            Section large{Tag::Div};
+            for (int i{0}; i < 2000; ++i) {
+                large.push_back(page);
+            }
+            REQUIRE(large.get_parallel(Formatting::Pretty, pool) == large.get(Formatting::Pretty));
+            large.freeze();
+            REQUIRE(large.get_parallel(Formatting::Pretty, pool) == large.get(Formatting::Pretty));
+
+            // a frozen section picks up changes made through a reference to a child kept from before it was written
+            Element& home{page.at_section(0).at_section(1).at(0)};
+            const docpp::string_type before{page.get()};
+            REQUIRE(page.at_section(0).is_frozen());
+            home.set_data("Kept");
+            REQUIRE(page.get() != before);
+            REQUIRE(page.get().find("Kept") != docpp::string_type::npos);
+
+            // moving a child out of a frozen section empties it, which the section picks up
+            Section moved_from{Tag::Div, {}, {Element{Tag::P, {}, "hello"}}};
+            Section nested{Tag::Div, {}, {Section{Tag::Div, {}, {Element{Tag::P, {}, "nested"}}}}};
+            moved_from.freeze();
+            nested.freeze();
+            REQUIRE(moved_from.get() == "<div><p>hello</p></div>");
+            REQUIRE(nested.get() == "<div><div><p>nested</p></div></div>");
+
+            const Element element{std::move(moved_from.at(0))};
+            const Section section{std::move(nested.at_section(0))};
+            REQUIRE(element.get() == "<p>hello</p>");
+            REQUIRE(section.get() == "<div><p>nested</p></div>");
+            REQUIRE(moved_from.get() == Section{Tag::Div, {}, {Element{}}}.get());
+            REQUIRE(moved_from == Section{Tag::Div, {}, {Element{}}});
+            REQUIRE(nested.get() == "<div></div>");
+            REQUIRE(nested == Section{Tag::Div, {}, {Section{}}});
+        };
+
+        const auto test_hash = []() {
+            using namespace docpp::HTML;
+
+            const auto make = []() {
+                Section section{Tag::Div, make_properties(Property{"id", "content"})};
+                section.push_back(Element{Tag::H1, {}, "Title"});
+                section.push_back(Section{Tag::Nav, {}, {Element{Tag::Anchor, make_properties(Property{"href", "/"}), "Home"}}});
+                return section;
+            };
+
+            Section section{make()};
+            const Section same{make()};
+
+            REQUIRE(section.hash() == same.hash());
+            REQUIRE(section.hash() != 0);
+            REQUIRE(section == same);
+            REQUIRE(std::hash<Section>{}(section) == std::hash<Section>{}(same));
+
+            // changes anywhere in the tree change the hash, and changing them back restores it
+            section.at_section(1).at(0).set_data("Start");
+            REQUIRE(section.hash() != same.hash());
+            REQUIRE(section != same);
+            section.at_section(1).at(0).set_data("Home");
+            REQUIRE(section.hash() == same.hash());
+            REQUIRE(section == same);
+
+            // and through references kept from before the section was hashed
+            Element& home{section.at_section(1).at(0)};
+            home.set_data("Kept");
+            REQUIRE(section.hash() != same.hash());
+            REQUIRE(std::hash<Section>{}(section) != std::hash<Section>{}(same));
+            home.set_data("Home");
+            REQUIRE(section.hash() == same.hash());
+
+            section.set_tag(Tag::Span);
+            REQUIRE(section.hash() != same.hash());
+            section.set_tag(Tag::Div);
+
+            for (Element& it : section) {
+                it.set_escaping(true);
+            }
+            REQUIRE(section.hash() != same.hash());
+
+            // an element and a section holding it are told apart, and so are a child and a sibling
+            Section nested{Tag::Div};
+            nested.push_back(Section{Tag::Div, {}, {Element{Tag::P, {}, "Text"}}});
+            Section flat{Tag::Div};
+            flat.push_back(Section{Tag::Div});
+            flat.push_back(Element{Tag::P, {}, "Text"});
+            REQUIRE(nested.hash() != flat.hash());
+            REQUIRE(nested != flat);
+
+            const Element element{Tag::P, make_properties(Property{"class", "note"}), "Note"};
+            Element other{element};
+            REQUIRE(element.hash() == other.hash());
+            REQUIRE(std::hash<Element>{}(element) == std::hash<Element>{}(other));
+            other.set_type(Type::Text);
+            REQUIRE(element.hash() != other.hash());
+            REQUIRE(element != other);
+            other = element;
+            REQUIRE(element == other);
+            other += "!";
+            REQUIRE(element != other);
+
+            // find compares the children instead of rendering them
+            Section list{Tag::Div};
+            list.push_back(Element{Tag::P, {}, "First"});
+            list.push_back(make());
+            list.push_back(element);
+            REQUIRE(list.find(element) == 2);
+            REQUIRE(list.find(same) == 1);
+            REQUIRE(list.find(other) == Section::npos);
+            REQUIRE(list.find(nested) == Section::npos);
+
+            std::unordered_set<Section> fragments{};
+            for (int i{0}; i < 8; ++i) {
+                fragments.insert(make());
+                fragments.insert(nested);
+            }
+            fragments.insert(flat);
+            REQUIRE(fragments.size() == 3);
+
+            Document document{make()};
+            Document copy{make()};
+            REQUIRE(document == copy);
+            REQUIRE(document.hash() == copy.hash());
+            REQUIRE(std::hash<Document>{}(document) == std::hash<Document>{}(copy));
+            copy.set_doctype("<!DOCTYPE html5>");
+            REQUIRE(document != copy);
+            REQUIRE(document.hash() != copy.hash());
+        };
+
+        const auto test_escaping = []() {
+            using namespace docpp::HTML;
+
+            REQUIRE(docpp::escape("") == "");
+            REQUIRE(docpp::escape("clean text") == "clean text");
+            REQUIRE(docpp::escape("<a href=\"x\">Tom & Jerry's</a>") == "&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&#39;s&lt;/a&gt;");
+
+            // every length and position, to cover the vectorized blocks and the scalar tail
+            for (std::size_t size{0}; size < 80; size++) {
+                const std::string clean(size, 'x');
+                REQUIRE(docpp::impl_find_escape(clean) == std::string::npos);
+
+                for (std::size_t i{0}; i < size; i++) {
+                    for (const char c : {'&', '<', '>', '"', '\''}) {
+                        std::string str{clean};
+                        str[i] = c;
+                        str[size - 1] = size - 1 == i ? c : '<';
+                        REQUIRE(docpp::impl_find_escape(str) == i);
+                    }
+                }
+            }
+
+            Element element{Tag::P, make_properties(Property{"title", "\"quoted\" & <b>"}), "1 < 2 & 3 > 2"};
+            REQUIRE(element.get() == "<p title=\"\"quoted\" & <b>\">1 < 2 & 3 > 2</p>");
+
+            element.set_escaping(true);
+            REQUIRE(element.is_escaping());
+            REQUIRE(element.get() == "<p title=\"&quot;quoted&quot; &amp; &lt;b&gt;\">1 &lt; 2 &amp; 3 &gt; 2</p>");
+            REQUIRE(element.rendered_size() == element.get().size());
+            REQUIRE(element != Element{Tag::P, make_properties(Property{"title", "\"quoted\" & <b>"}), "1 < 2 & 3 > 2"});
+
+            Section section{Tag::Div, make_properties(Property{"data-x", "a'b"})};
+            section.push_back(Element{Tag::Span, {}, "<script>"});
+            section.push_back(Element{Tag::Raw, {}, "<b>trusted</b>"});
+            section.push_back(Element{Tag::Empty_No_Formatting, {}, "Q&A"});
+            REQUIRE(Element{Tag::Raw, {}, "<b>"}.get_type() == Type::Raw);
+
+            Document document{section};
+            REQUIRE(document.get() == "<!DOCTYPE html><div data-x=\"a'b\"><span><script></span><b>trusted</b>Q&A</div>");
+
+            document.set_escaping(true);
+            REQUIRE(document.is_escaping());
+            const std::string escaped{"<!DOCTYPE html><div data-x=\"a&#39;b\"><span>&lt;script&gt;</span><b>trusted</b>Q&amp;A</div>"};
+            REQUIRE(document.get() == escaped);
+            REQUIRE(document.rendered_size() == escaped.size());
+            REQUIRE(document.get(Formatting::Pretty).find("\t<span>&lt;script&gt;</span>\n") != std::string::npos);
+
+            Element raw{Tag::Raw, {}, "<b>trusted</b>"};
+            raw.set_escaping(true);
+            REQUIRE(raw.get() == "<b>trusted</b>");
+
+            std::string out{};
+            docpp::StringSink sink{out};
+            REQUIRE(sink.is_escaping() == false);
+            document.write(sink);
+            REQUIRE(out == escaped);
+            REQUIRE(sink.is_escaping() == false);
+
+            sink.set_escaping(true);
+            out.clear();
+            section.write(sink);
+            REQUIRE(out == escaped.substr(std::string("<!DOCTYPE html>").size()));
+
+            const Section parsed{parse("<!-- <comment> --><p>a &amp; b</p>")};
+            REQUIRE(parsed.at(0).get_type() == Type::Raw);
+        };
+
+        const auto test_move = []() {
+            using namespace docpp::HTML;
+
+            const std::string data{"A paragraph that is long enough not to be stored inline in the string"};
+
+            Element element{Tag::P, make_properties(Property{"class", "paragraph"}), data};
+
+            Section section{Tag::Div, {}};
+            section.push_back(std::move(element));
+
+            REQUIRE(section.size() == 1);
+            REQUIRE(section.at(0).get_data() == data);
+            REQUIRE(element.get_data().empty());
+
+            Section nested{Tag::Section, {}, std::vector<Element>{Element{Tag::H1, {}, "Title"}}};
+            section.push_front(std::move(nested));
+            section.insert(2, Element{Tag::Footer, {}, "footer"});
+            section += Element{Tag::Br};
+
+            REQUIRE(section.get() == "<div><section><h1>Title</h1></section><p class=\"paragraph\">" + data + "</p><footer>footer</footer><br/></div>");
+            REQUIRE(nested.empty());
+
+            Element& emplaced{section.emplace_back<Element>(Tag::Span, Properties{}, "span")};
+            REQUIRE(emplaced.get() == "<span>span</span>");
+
+            Section& emplaced_section{section.emplace_front<Section>(Tag::Header)};
+            emplaced_section.emplace_back<Element>(Tag::H2, Properties{}, "Header");
+            REQUIRE(section.at_section(0).get() == "<header><h2>Header</h2></header>");
+
+            Properties properties{};
+            properties.emplace_back("id", "first");
+            properties.emplace(0, "class", "second");
+            properties.push_back(Property{"style", "third"});
+            REQUIRE(properties.size() == 3);
+            REQUIRE(properties.at(0).get_key() == "class");
+            REQUIRE(properties.at(2).get_value() == "third");
+
+            Section moved{std::move(section)};
+            REQUIRE(moved.size() == 6);
+            REQUIRE(section.empty());
+
+            section = std::move(moved);
+            REQUIRE(section.size() == 6);
+
+            // moving a child into its parent replaces the parent with it
+            section = std::move(section.at_section(0));
+            REQUIRE(section.get() == "<header><h2>Header</h2></header>");
+
+            Document document{std::move(section)};
+            REQUIRE(document.get() == "<!DOCTYPE html><header><h2>Header</h2></header>");
+
+            // moving between allocators copies, so everything ends up in the arena
+            docpp::Arena arena{};
+            Section arena_section{Tag::Div, {}, arena};
+            Section heap_section{Tag::Div, {}, std::vector<Element>{Element{Tag::P, {}, data}}};
+
+            arena_section.push_back(std::move(heap_section));
+            REQUIRE(arena_section.at_section(0).get_allocator().resource() == arena.get_resource());
+            REQUIRE(arena_section.at_section(0).at(0).get_allocator().resource() == arena.get_resource());
+            REQUIRE(arena_section.at_section(0).at(0).get_data() == data);
+
+            Element& arena_element{arena_section.emplace_back<Element>(Tag::P, Properties{}, data)};
+            REQUIRE(arena_element.get_allocator().resource() == arena.get_resource());
+        };
+
+        const auto test_minified = []() {
+            using namespace docpp::HTML;
+
+            Section list{"ul", make_properties(Property{"class", "menu items"})};
+            list.push_back(Element{Tag::Li, make_properties(Property{"id", "a"}), "One  \n two"});
+            list.push_back(Element{Tag::Li, {}, "Three"});
+            list.push_back(Section{Tag::Li, {}, {Element{Tag::P, {}, "Para"}, Element{Tag::Div, {}, "Block"}}});
+
+            Section table{Tag::Table};
+            Section row{Tag::Tr, {}, {Element{Tag::Td, {}, "1"}, Element{Tag::Td, {}, "2"}}};
+            table.push_back(row);
+            table.push_back(row);
+
+            Section body{Tag::Body};
+            body.push_back(list);
+            body.push_back(Section{Tag::Pre, {}, {Element{Tag::Span, {}, "a   b"}, Element{Tag::Empty, {}, "  c\n"}}});
+            body.push_back(table);
+            body.push_back(Element{Tag::P, {}, "Followed by text"});
+            body.push_back(Element{Tag::Empty_No_Formatting, {}, "tail"});
+            body.push_back(Element{Tag::P, {}, "Last"});
+
+            const std::string expected{
+                "<body><ul class=\"menu items\"><li id=a>One two<li>Three<li><p>Para<div>Block</div></ul>"
+                "<pre><span>a   b</span>  c\n</pre><table><tr><td>1<td>2<tr><td>1<td>2</table>"
+                "<p>Followed by text</p>tail<p>Last</body>"};
+
+            REQUIRE(body.get(Formatting::Minified) == expected);
+            REQUIRE(body.rendered_size(Formatting::Minified) == expected.size());
+            REQUIRE(Document{body}.get(Formatting::Minified) == "<!DOCTYPE html>" + expected);
+
+            // the other formattings are unchanged
+            REQUIRE(body.get().find("</li>") != std::string::npos);
+
+            // erased and empty children are skipped when looking at what follows, and containers keep the end tag
+            Section holes{"ul"};
+            holes.push_back(Element{Tag::Li, {}, "A"});
+            holes.push_back(Element{Tag::Li, {}, "B"});
+            holes.push_back(Section{Tag::Empty});
+            holes.push_back(Element{Tag::Li, {}, "C"});
+            holes.erase(1);
+            REQUIRE(holes.get(Formatting::Minified) == "<ul><li>A<li>C</ul>");
+            REQUIRE(make_section_container(Element{Tag::Li, {}, "A"}).get(Formatting::Minified) == "<li>A</li>");
+
+            // a p element keeps its end tag at the end of a link
+            REQUIRE(Section{"a", {}, {Element{Tag::P, {}, "A"}}}.get(Formatting::Minified) == "<a><p>A</p></a>");
+
+            // frozen, incremental and parallel output match
+            Section page{Tag::Main};
+            for (int i{0}; i < 2000; ++i) {
+                Section item{"ul", make_properties(Property{"data-index", std::to_string(i)})};
+                item.push_back(Element{Tag::Li, {}, "Item  " + std::to_string(i)});
+                item.push_back(Section{Tag::Li, {}, {Element{Tag::P, {}, "Text"}}});
+
+                if (i % 100 == 0) {
+                    item.freeze();
+                }
+
+                page.push_back(std::move(item));
+            }
+            page.push_back(Section{Tag::Pre, {}, {Section{"ul", {}, {Element{Tag::Li, {}, "  x  "}}}}});
+
+            const std::string output{page.get(Formatting::Minified)};
+            REQUIRE(output.find("</li>") == std::string::npos);
+            REQUIRE(output.find("<li>  x  </ul>") != std::string::npos);
+            REQUIRE(page.get(Formatting::Minified) == output);
+
+            docpp::ThreadPool pool{4};
+            REQUIRE(page.get_parallel(Formatting::Minified, pool) == output);
+
+            page.set_incremental(true);
+            REQUIRE(page.get(Formatting::Minified) == output);
+            REQUIRE(page.get(Formatting::Minified) == output);
+
+            // changing the next sibling changes whether the end tag before it is written
+            page.at_section(5).push_back(Element{Tag::Span, {}, "After"});
+            const std::string changed{page.get(Formatting::Minified)};
+            REQUIRE(changed.find("<li><p>Text</li><span>After</span>") != std::string::npos);
+
+            page.set_incremental(false);
+            REQUIRE(page.get(Formatting::Minified) == changed);
+        };
+
         test_get_and_set();
         test_copy_section();
         test_operators();
+        const auto test_incremental = []() {
+            using namespace docpp::HTML;
+
+            const auto make_card = [](const int i) {
+                Section card{Tag::Article, make_properties(Property{"class", "card"}, Property{"data-index", std::to_string(i)})};
+                card.push_back(Element{Tag::H2, {}, "Card " + std::to_string(i) + " & more"});
+                card.push_back(Section{"ul", {}, {Element{Tag::Li, {}, "First"}, Element{Tag::Li, {}, "Second"}}});
+                return card;
+            };
+
+            Section main{Tag::Main, make_properties(Property{"id", "content"})};
+            for (int i{0}; i < 100; ++i) {
+                main.push_back(make_card(i));
+            }
+
+            Section wrapper{Tag::Empty};
+            wrapper.push_back(Element{Tag::P, {}, "Before"});
+            wrapper.push_back(main);
+
+            Section html{Tag::Html};
+            html.push_back(Section{Tag::Head, {}, {Element{Tag::Title, {}, "Page"}}});
+            html.push_back(Section{Tag::Body, {}, std::vector<Section>{wrapper}});
+
+            Document document{html};
+            REQUIRE(!document.is_incremental());
+            document.set_incremental(true);
+            REQUIRE(document.is_incremental());
+            REQUIRE(document.section_ref().is_incremental());
+
+            const auto check = [&document]() {
+                Document expected{document};
+                expected.set_incremental(false);
+
+                for (int i{0}; i < 2; ++i) {
+                    for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                        for (const docpp::integer_type tabc : {0, 2}) {
+                            REQUIRE(document.get(formatting, tabc) == expected.get(formatting, tabc));
+                            REQUIRE(document.rendered_size(formatting, tabc) == expected.get(formatting, tabc).size());
+                            REQUIRE(document.section_ref().get(formatting, tabc) == expected.section_ref().get(formatting, tabc));
+                        }
+                    }
+
+                    document.set_escaping(!document.is_escaping());
+                    expected.set_escaping(!expected.is_escaping());
+                }
+            };
+
+            check();
+
+            Section& body_main{document.get_section().at_section(1).at_section(0).at_section(1)};
+            REQUIRE(body_main.get_tag() == "main");
+
+            // changes through references to children are picked up, as they reset the hashes of the sections above them
+            body_main.at_section(5).at(0).set_data("Changed");
+            body_main.at_section(50).at_section(1).push_back(Element{Tag::Li, {}, "Third"});
+            check();
+
+            body_main.insert(0, Section{make_card(-1)});
+            body_main.erase(10);
+            body_main.swap(20, 30);
+            body_main.push_back(make_card(100));
+            check();
+
+            // references kept from at() and at_section() across writes
+            Element& heading{body_main.at_section(7).at(0)};
+            Section& list{body_main.at_section(8).at_section(1)};
+            const docpp::string_type before{document.get()};
+            heading.set_data("Kept");
+            REQUIRE(document.get() != before);
+            REQUIRE(document.get().find("Kept") != docpp::string_type::npos);
+            list.push_front(Element{Tag::Li, {}, "Zeroth"});
+            list.at(1) = Element{Tag::Li, {}, "Assigned"};
+            check();
+
+            // identical cards are written from the same output
+            body_main.at_section(40) = make_card(41);
+            body_main.at_section(60).freeze();
+            check();
+
+            document.get_section().at_section(1).set_tag("section");
+            body_main.clear();
+            check();
+
+            // copies are incremental as well, with a cache of their own
+            Document copy{document};
+            REQUIRE(copy.is_incremental());
+            copy.get_section().at_section(0).at(0).set_data("Copy");
+            REQUIRE(copy.get() != document.get());
+            REQUIRE(copy.get().find("Copy") != docpp::string_type::npos);
+
+            document.set_incremental(false);
+            REQUIRE(!document.is_incremental());
+            REQUIRE(copy.is_incremental());
+
+            // moving a child out of an incremental section empties it, which the next write picks up
+            Section source{Tag::Div};
+            for (int i{0}; i < 200; ++i) {
+                source.push_back(make_card(i % 20));
+            }
+            source.set_incremental(true);
+            static_cast<void>(source.get(Formatting::Pretty));
+
+            const Section card{std::move(source.at_section(100))};
+            const Element title{std::move(source.at_section(50).at(0))};
+            Section full{source};
+            full.set_incremental(false);
+            REQUIRE(source.get(Formatting::Pretty) == full.get(Formatting::Pretty));
+            REQUIRE(source.get() == full.get());
+
+            // sections with many children only walk the children modified since the last write, which they keep a log of
+            const auto make_list = [&make_card]() {
+                Section list{"ul"};
+                for (int i{0}; i < 100; ++i) {
+                    if (i % 2 == 0) {
+                        list.push_back(Element{Tag::Li, {}, "Item " + std::to_string(i)});
+                    } else {
+                        list.push_back(make_card(i));
+                    }
+                }
+
+                Section nested{"ul"};
+                for (int i{0}; i < 80; ++i) {
+                    nested.push_back(Element{Tag::Li, {}, "Nested " + std::to_string(i)});
+                }
+                list.push_back(std::move(nested));
+                return list;
+            };
+
+            const std::vector<std::function<void(Section&)>> steps{
+                [](Section& list) { list.at(2).set_data("Changed"); },
+                [](Section& list) { list.at_section(1).at(0).set_data("Card changed"); },
+                [](Section& list) { list.at_section(100).at(10).set_data("Nested changed"); },
+                [](Section& list) { list.erase(4); },
+                [](Section& list) { list.insert(4, Element{Tag::Li, {}, "Inserted"}); },
+                [](Section& list) {
+                    for (int i{0}; i < 40; ++i) {
+                        list.push_back(Element{Tag::Li, {}, "Appended"});
+                    }
+                },
+                [](Section& list) { list.swap(6, 8); },
+                [&make_card](Section& list) { list.at_section(5) = make_card(-1); },
+                [](Section& list) { list.at(10) = Element{Tag::P, {}, "Paragraph"}; },
+                [](Section& list) { list.at_section(100).push_back(Element{Tag::Li, {}, "Nested appended"}); },
+                [](Section& list) { list.at_section(100).set_tag("ol"); },
+                [](Section& list) { list.at_section(23).clear(); },
+                [](Section& list) { const Element moved{std::move(list.at(20))}; },
+                [](Section& list) { list.insert_before(2, Element{Tag::Li, {}, "Before"}); },
+                [](Section& list) { list.at(0).set_data("After moving"); },
+                [](Section& list) { list.set_tag("ol"); },
+            };
+
+            for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Minified}) {
+                Section list{make_list()};
+                list.set_incremental(true);
+                static_cast<void>(list.get(formatting));
+
+                for (docpp::size_type i{0}; i < steps.size(); ++i) {
+                    steps[i](list);
+
+                    // rebuilt without hashing in between, so that its hash is computed from all of its children
+                    Section expected{make_list()};
+                    for (docpp::size_type j{0}; j <= i; ++j) {
+                        steps[j](expected);
+                    }
+
+                    REQUIRE(list.hash() == expected.hash());
+                    REQUIRE(list == expected);
+                    REQUIRE(list.get(formatting) == expected.get(formatting));
+                }
+            }
+
+            // small sections are written as they are
+            Section small{Tag::Div, {}, {Element{Tag::P, {}, "Small"}}};
+            small.set_incremental(true);
+            REQUIRE(small.get() == "<div><p>Small</p></div>");
+
+            docpp::ThreadPool pool{2};
+            Section large{Tag::Div};
+            for (int i{0}; i < 200; ++i) {
+                large.push_back(make_card(i % 20));
+            }
+            large.set_incremental(true);
+            const docpp::string_type output{large.get(Formatting::Pretty)};
+
+            // concurrent writes take turns with the cache
+            std::atomic<int> matching{0};
+            std::vector<std::thread> threads{};
+            for (int i{0}; i < 4; ++i) {
+                threads.emplace_back([&large, &output, &matching]() {
+                    for (int j{0}; j < 10; ++j) {
+                        matching += large.get(Formatting::Pretty) == output;
+                    }
+                });
+            }
+            for (std::thread& it : threads) {
+                it.join();
+            }
+            REQUIRE(matching == 40);
+            REQUIRE(large.get_parallel(Formatting::Pretty, pool) == output);
+        };
+
         test_constructors();
         test_iterators();
         test_find();
@@ -1042,6 +2084,18 @@ inline namespace HTML {
         test_handle_elements();
         test_handle_sections();
         the_test_to_end_all_tests();
+        test_mixed_children();
+        test_write();
+        test_arena();
+        test_move();
+        test_views();
+        test_rendered_size();
+        test_get_parallel();
+        test_prerendered();
+        test_hash();
+        test_incremental();
+        test_minified();
+        test_escaping();
     }
 
     void test_document() {
@@ -1218,6 +2272,647 @@ inline namespace HTML {
         test_constructors();
     }
 
+    void test_parser() {
+        const auto test_round_trip = []() {
+            using namespace docpp::HTML;
+
+            Section section{Tag::Html, {}, {
+                Section(Tag::Head, {}, {
+                    Element(Tag::Title, {}, "Title <with> markup"),
+                    Element(Tag::Meta, make_properties(Property{"charset", "utf-8"})),
+                    Element(Tag::Style, {}, "p { color: red; }"),
+                }),
+                Section(Tag::Body, make_properties(Property{"class", "main"}), {
+                    Element(Tag::H1, make_properties(Property{"id", "title"}, Property{"style", "color: blue"}), "Hello, World!"),
+                    Element(Tag::Br),
+                    Element(Tag::P, {}, "a < b && c > d"),
+                    Element(Tag::P, {}, ""),
+                    Element(Tag::Script, {}, "if (a < b) { document.write('</p>'); }"),
+                }),
+            }};
+            section.at_section(1).push_back(Section{Tag::Div, {}, {Element(Tag::Span, {}, "Nested")}});
+            section.at_section(1).push_back(Element{Tag::Empty, {}, "Plain text"});
+
+            const std::string markup{section.get()};
+            const Section parsed{parse(markup)};
+
+            REQUIRE(parsed.get() == markup);
+
+            const Section& html{*parsed.sections_view().begin()};
+            REQUIRE(parsed.get_tag().empty());
+            REQUIRE(parsed.size() == 1);
+            REQUIRE(html.tag_view() == "html");
+            REQUIRE(html.sections_view().size() == 2);
+
+            const Section& head{*html.sections_view().begin()};
+            REQUIRE(head.elements_view().size() == 3);
+            REQUIRE(head.elements_view().begin()->data_view() == "Title <with> markup");
+            REQUIRE(head.at(1).get_type() == Type::Self_Closing);
+            REQUIRE(head.at(1).get_properties().at(0).get_value() == "utf-8");
+
+            const Section quoted{parse("<p title='say \"hi\"' data-x=\"it's\">q</p>")};
+            REQUIRE(quoted.at(0).properties_ref().at(0).value_view() == "say &quot;hi&quot;");
+            REQUIRE(quoted.get() == "<p title=\"say &quot;hi&quot;\" data-x=\"it's\">q</p>");
+            REQUIRE(parse(quoted.get()).get() == quoted.get());
+
+            // the end tags Formatting::Minified leaves out are implied by the start tags that follow them
+            Section row{Tag::Tr, {}, {Element{Tag::Td, {}, "1"}, Element{Tag::Td, {}, "2"}}};
+            Section minified{Tag::Div};
+            minified.push_back(Element{Tag::P, {}, "a"});
+            minified.push_back(Element{Tag::P, {}, "b"});
+            minified.push_back(Section{Tag::Table, {}, {row, row}});
+            minified.push_back(Section{"ul", {}, {Element{Tag::Li, {}, "One"}, Element{Tag::Li, {}, "Two"}}});
+            minified.push_back(Section{Tag::Dl, {}, {Element{Tag::Dt, {}, "Term"}, Element{Tag::Dd, {}, "Definition"}, Element{Tag::Dt, {}, "Other"}}});
+            minified.push_back(Section{"select", {}, {Element{Tag::Option, {}, "A"}, Element{Tag::Option, {}, "B"}}});
+
+            const std::string compact{minified.get(Formatting::Minified)};
+            REQUIRE(compact == "<div><p>a<p>b<table><tr><td>1<td>2<tr><td>1<td>2</table><ul><li>One<li>Two</ul>"
+                "<dl><dt>Term<dd>Definition<dt>Other</dt></dl><select><option>A<option>B</select></div>");
+
+            const Section reparsed{parse(compact)};
+            REQUIRE(reparsed.get(Formatting::Minified) == compact);
+            REQUIRE(reparsed.get() == minified.get());
+
+            const Section table{reparsed.at_section(0).at_section(2)};
+            REQUIRE(table.size() == 2);
+            REQUIRE(table.at_section(0).size() == 2);
+            REQUIRE(reparsed.at_section(0).at_section(1).size() == 1);
+
+            // end tags are only implied inside the element that holds them
+            REQUIRE(parse("<ul><li>a<ul><li>b</ul></ul>").get() == "<ul><li>a<ul><li>b</li></ul></li></ul>");
+            REQUIRE(parse("<p>a<span>b<div>c</div>").get() == "<p>a<span>b</span></p><div>c</div>");
+            REQUIRE(parse("<table><tr><td><table><tr><td>a</table><td>b</table>").get(Formatting::Minified)
+                == "<table><tr><td><table><tr><td>a</table><td>b</table>");
+
+            // whitespace is only left out where it lays out the markup
+            REQUIRE(parse("<p><b>Hello</b> <i>world</i></p>").get() == "<p><b>Hello</b> <i>world</i></p>");
+            REQUIRE(parse("<pre>  <b>x</b></pre>").get() == "<pre>  <b>x</b></pre>");
+            REQUIRE(parse("<textarea>\n</textarea>").get() == "<textarea>\n</textarea>");
+            REQUIRE(parse("<p>a</p> <b>b</b> <p>c</p>").get() == "<p>a</p> <b>b</b> <p>c</p>");
+            REQUIRE(parse("<div>\n\t<span>a</span>\n</div>").get() == "<div>\n\t<span>a</span>\n</div>");
+            REQUIRE(parse("<div>\n\t<p>a</p>\n\t<p>b</p>\n</div>").get() == "<div><p>a</p><p>b</p></div>");
+            REQUIRE(parse("<ul>\n\t<li>a</li>\n\t<li>b</li>\n</ul>").get() == "<ul><li>a</li><li>b</li></ul>");
+            REQUIRE(parse("<table> <tr> <td>a</td> </tr> </table>").get() == "<table><tr><td>a</td></tr></table>");
+        };
+
+        const auto test_types = []() {
+            using namespace docpp::HTML;
+
+            const Section section{parse("<DIV Class=box data-x='1' hidden>Text</DIV><img src=a.png/><br><custom-tag></custom-tag></span>")};
+
+            REQUIRE(section.size() == 5);
+            REQUIRE(section.at(0).get_tag() == "div");
+            REQUIRE(section.at(0).get_data() == "Text");
+            REQUIRE(section.at(0).get_type() == Type::Non_Self_Closing);
+            REQUIRE(section.at(0).properties_ref().size() == 3);
+            REQUIRE(section.at(0).properties_ref().at(0).key_view() == "class");
+            REQUIRE(section.at(0).properties_ref().at(0).value_view() == "box");
+            REQUIRE(section.at(0).properties_ref().at(1).value_view() == "1");
+            REQUIRE(section.at(0).properties_ref().at(2).value_view() == "hidden");
+            REQUIRE(section.at(1).get_type() == Type::Non_Closed);
+            REQUIRE(section.at(1).properties_ref().at(0).value_view() == "a.png/");
+            REQUIRE(section.at(2).get_tag() == "br");
+            REQUIRE(section.at(2).get_type() == Type::Non_Closed);
+            REQUIRE(section.at(3).get_tag() == "custom-tag");
+            REQUIRE(section.at(4).get_type() == Type::Non_Opened);
+            REQUIRE(section.get() == "<div class=\"box\" data-x=\"1\" hidden=\"hidden\">Text</div><img src=\"a.png/\"><br><custom-tag></custom-tag></span>");
+            REQUIRE(parse("<Custom-Tag DATA-X=1><b>a</b></Custom-Tag>").get() == "<custom-tag data-x=\"1\"><b>a</b></custom-tag>");
+
+            const Section self_closing{parse("<hr/><input type=\"text\" />")};
+            REQUIRE(self_closing.at(0).get_type() == Type::Self_Closing);
+            REQUIRE(self_closing.at(1).get_type() == Type::Self_Closing);
+            REQUIRE(self_closing.get() == "<hr/><input type=\"text\"/>");
+
+            const Section text{parse("before<!-- a <comment> --><b>bold</b> after <p>unclosed<i>x</i>")};
+            REQUIRE(text.size() == 5);
+            REQUIRE(text.at(0).get_type() == Type::Text_No_Formatting);
+            REQUIRE(text.at(1).get_data() == "<!-- a <comment> -->");
+            REQUIRE(text.at(3).get_data() == " after ");
+            REQUIRE(text.at_section(4).get_tag() == "p");
+            REQUIRE(text.get() == "before<!-- a <comment> --><b>bold</b> after <p>unclosed<i>x</i></p>");
+
+            REQUIRE(parse("").empty());
+            REQUIRE(parse("  \n\t ").empty());
+            REQUIRE(parse("<div><p>a</p><div><p>b</p></div></div>").get() == "<div><p>a</p><div><p>b</p></div></div>");
+        };
+
+        const auto test_document = []() {
+            using namespace docpp::HTML;
+
+            const Document document{Section{Tag::Html, {}, {
+                Section(Tag::Head, {}, {Element(Tag::Title, {}, "Title")}),
+                Section(Tag::Body, {}, {Element(Tag::H1, {}, "Hello, World!")}),
+            }}};
+
+            const Document parsed{parse_document(document.get(Formatting::Pretty))};
+            REQUIRE(parsed.get() == document.get());
+            REQUIRE(parsed.get_doctype() == "<!DOCTYPE html>");
+            REQUIRE(parsed.section_ref().tag_view() == "html");
+
+            const Document fragment{parse_document("<p>a</p><p>b</p>")};
+            REQUIRE(fragment.get_doctype().empty());
+            REQUIRE(fragment.section_ref().tag_view().empty());
+            REQUIRE(fragment.get() == "<p>a</p><p>b</p>");
+
+            docpp::Arena arena{};
+            const Document allocated{parse_document(document.get(), arena)};
+            REQUIRE(allocated.get() == document.get());
+            REQUIRE(allocated.get_allocator() == arena.get_allocator());
+            REQUIRE(allocated.section_ref().get_allocator() == arena.get_allocator());
+
+            const std::string path{"docpp_parser_test.html"};
+            std::FILE* file{std::fopen(path.c_str(), "wb")};
+            REQUIRE(file != nullptr);
+            const std::string markup{document.get(Formatting::Pretty)};
+            std::fwrite(markup.data(), 1, markup.size(), file);
+            std::fclose(file);
+
+            REQUIRE(parse_file(path).get() == document.get());
+            std::remove(path.c_str());
+
+            try {
+                static_cast<void>(parse_file("docpp_parser_test_missing.html"));
+                REQUIRE(false);
+            } catch (const docpp::io_error& e) {
+                REQUIRE(std::string(e.what()) == "Failed to open file");
+            }
+        };
+
+        const auto test_errors = []() {
+            using namespace docpp::HTML;
+
+            for (const char* input : {"<div class=\"a", "<div class=", "<p>text</p><div", "<!-- comment", "</div"}) {
+                try {
+                    static_cast<void>(parse(input));
+                    REQUIRE(false);
+                } catch (const docpp::invalid_argument& e) {
+                    REQUIRE(std::string(e.what()).rfind("Unterminated", 0) == 0);
+                }
+            }
+        };
+
+        test_round_trip();
+        test_types();
+        test_document();
+        test_errors();
+    }
+
+    void test_template() {
+        const auto test_slots = []() {
+            using namespace docpp::HTML;
+
+            // the same page, with slots or with the values of the slots filled in
+            const auto make = [](const bool slots, const Type type, const docpp::string_type& title, const docpp::string_type& user) {
+                const auto fill = [&](const docpp::string_type& name, const docpp::string_type& value) {
+                    return slots ? make_slot(name) : Element{"", {}, value, type};
+                };
+
+                Section section{Tag::Div, make_properties(Property{"id", "page"})};
+                section.push_back(Section{Tag::Header, {}, {Element{Tag::H1, {}, "Site"}}});
+                section.push_back(fill("title", title));
+                section.push_back(Section{Tag::Nav, {}, {Element{Tag::Anchor, make_properties(Property{"href", "/"}), "Home"}}});
+                section.push_back(Section{Tag::P, {}, {fill("user", user), Element{Tag::Span, {}, "says hello to"}, fill("user", user)}});
+                section.push_back(Element{Tag::Footer, {}, "Footer"});
+                return section;
+            };
+
+            for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                const Type type{formatting == Formatting::Pretty ? Type::Text : Type::Text_No_Formatting};
+                const Template t{make(true, type, "", ""), formatting};
+
+                REQUIRE(t.size() == 2);
+                REQUIRE(t.get_slots().at(0) == "title");
+                REQUIRE(t.get_slots().at(1) == "user");
+                REQUIRE(t.find("user") == 1);
+                REQUIRE(t.find("missing") == Template::npos);
+                REQUIRE(t.static_size() == make(false, type, "", "").get(formatting).size());
+
+                for (const auto& values : std::vector<std::vector<std::string_view>>{{"Welcome", "Anna"}, {"", ""}, {"A much longer title, with a <tag>", "Bob"}}) {
+                    const docpp::string_type expected{make(false, type, docpp::string_type(values[0]), docpp::string_type(values[1])).get(formatting)};
+
+                    REQUIRE(t.get(values) == expected);
+                    REQUIRE(t.rendered_size(values) == expected.size());
+
+                    std::ostringstream stream{};
+                    docpp::StreamSink sink{stream};
+                    t.write(sink, values);
+                    REQUIRE(stream.str() == expected);
+                }
+            }
+
+            // slots are written as nothing outside of a template
+            Section section{Tag::Div};
+            section.push_back(make_slot("name"));
+            REQUIRE(section.get() == "<div></div>");
+            REQUIRE(Template{section}.get({"value"}) == "<div>value</div>");
+
+            // and inside frozen and incremental sections, whose cached output holds no slots
+            Section body{Tag::Body};
+            body.push_back(section);
+            body.at_section(0).freeze();
+            REQUIRE(body.get() == "<body><div></div></body>");
+            REQUIRE(Template{body}.get({"X"}) == "<body><div>X</div></body>");
+            REQUIRE(body.get() == "<body><div></div></body>");
+            body.set_incremental(true);
+            REQUIRE(body.get() == "<body><div></div></body>");
+            REQUIRE(Template{body}.get({"X"}) == "<body><div>X</div></body>");
+            REQUIRE(Template{Document{body}}.get({"X"}) == "<!DOCTYPE html><body><div>X</div></body>");
+        };
+
+        const auto test_escaping = []() {
+            using namespace docpp::HTML;
+
+            Section section{Tag::P};
+            section.push_back(make_slot("raw"));
+            section.push_back(make_slot("escaped", true));
+
+            const Template t{section};
+            REQUIRE(t.get({"<b>", "<b>"}) == "<p><b>&lt;b&gt;</p>");
+
+            Document document{section};
+            document.set_escaping(true);
+            const Template escaped{document};
+            REQUIRE(escaped.get({"<b>", "&"}) == "<!DOCTYPE html><p>&lt;b&gt;&amp;</p>");
+        };
+
+        const auto test_errors = []() {
+            using namespace docpp::HTML;
+
+            Section section{Tag::P};
+            section.push_back(make_slot("a"));
+            section.push_back(make_slot("b"));
+            section.push_back(make_slot("a"));
+
+            const Template t{section};
+            REQUIRE(t.size() == 2);
+            REQUIRE(t.get({"1", "2"}) == "<p>121</p>");
+
+            try {
+                static_cast<void>(t.get({"1"}));
+                REQUIRE(false);
+            } catch (const docpp::invalid_argument& e) {
+                REQUIRE(true);
+            }
+
+            const Template empty{};
+            REQUIRE(empty.size() == 0);
+            REQUIRE(empty.get({}).empty());
+
+            const Template no_slots{Section{Tag::Div, {}, {Element{Tag::P, {}, "Static"}}}};
+            REQUIRE(no_slots.get({}) == "<div><p>Static</p></div>");
+        };
+
+        test_slots();
+        test_escaping();
+        test_errors();
+    }
+
+    void test_patch() {
+        const auto test_diff = []() {
+            using namespace docpp::HTML;
+
+            const auto make = []() {
+                Section list{"ul", make_properties(Property{"class", "items"})};
+                for (int i{0}; i < 50; ++i) {
+                    list.push_back(Section{Tag::Li, make_properties(Property{"data-index", std::to_string(i)}), {Element{Tag::Span, {}, "Item " + std::to_string(i)}}});
+                }
+
+                Section section{Tag::Div, make_properties(Property{"id", "page"}, Property{"class", "light"})};
+                section.push_back(Element{Tag::H1, make_properties(Property{"class", "title"}), "Title"});
+                section.push_back(std::move(list));
+                section.push_back(Element{Tag::P, {}, "Footer"});
+                return section;
+            };
+
+            const Section old_section{make()};
+            REQUIRE(diff(old_section, make()).empty());
+
+            Section new_section{make()};
+            new_section.at(0).set_data("New title");
+            new_section.at_section(1).at_section(10).at(0).set_data("Changed");
+            new_section.at_section(1).at_section(20).set_properties(make_properties(Property{"data-index", "20"}, Property{"class", "active"}));
+            new_section.at_section(1).erase(30);
+            new_section.at_section(1).push_back(Section{Tag::Li, {}, {Element{Tag::Span, {}, "Added"}}});
+            new_section.set_properties(make_properties(Property{"id", "page"}, Property{"class", "dark"}));
+            new_section.at(2) = Element{Tag::Footer, {}, "Footer"};
+
+            const Patch patch{diff(old_section, new_section)};
+            REQUIRE(patch.size() == 7);
+
+            docpp::size_type counts[5]{};
+            for (const Change& it : patch) {
+                ++counts[static_cast<docpp::size_type>(it.get_operation())];
+            }
+            REQUIRE(counts[static_cast<docpp::size_type>(Operation::Insert)] == 1);
+            REQUIRE(counts[static_cast<docpp::size_type>(Operation::Remove)] == 1);
+            REQUIRE(counts[static_cast<docpp::size_type>(Operation::Replace)] == 1);
+            REQUIRE(counts[static_cast<docpp::size_type>(Operation::Set_Attribute)] == 2);
+            REQUIRE(counts[static_cast<docpp::size_type>(Operation::Set_Text)] == 2);
+
+            Section applied{old_section};
+            apply(applied, patch);
+            REQUIRE(applied == new_section);
+            REQUIRE(applied.get(Formatting::Pretty) == new_section.get(Formatting::Pretty));
+            REQUIRE(diff(applied, new_section).empty());
+
+            // attributes that cannot be changed in place replace the node
+            Section reordered{make()};
+            reordered.at(0).set_properties(make_properties(Property{"id", "heading"}, Property{"class", "title"}));
+            reordered.at_section(1).set_tag("ol");
+            const Patch replace{diff(old_section, reordered)};
+            REQUIRE(replace.size() == 2);
+            REQUIRE(replace.at(0).get_operation() == Operation::Replace);
+            REQUIRE(replace.at(1).get_operation() == Operation::Replace);
+
+            applied = old_section;
+            apply(applied, replace);
+            REQUIRE(applied.get() == reordered.get());
+
+            // a different root is replaced as a whole
+            const Section other{Tag::Span, {}, {Element{Tag::P, {}, "Other"}}};
+            const Patch root{diff(old_section, other)};
+            REQUIRE(root.size() == 1);
+            REQUIRE(root.at(0).get_index() == Change::npos);
+            applied = old_section;
+            apply(applied, root);
+            REQUIRE(applied == other);
+
+            // removed attributes are set to an empty value
+            Section removed{make()};
+            removed.set_properties(make_properties(Property{"id", "page"}));
+            const Patch attributes{diff(old_section, removed)};
+            REQUIRE(attributes.size() == 1);
+            REQUIRE(attributes.at(0).get_key() == "class");
+            REQUIRE(attributes.at(0).get_value().empty());
+            applied = old_section;
+            apply(applied, attributes);
+            REQUIRE(applied == removed);
+            REQUIRE(applied.properties_ref().size() == 1);
+
+            // children are matched by hash, so adding one to the front inserts it rather than changing every child after it
+            Section items{"ul"};
+            for (int i{0}; i < 5; ++i) {
+                items.push_back(Element{Tag::Li, {}, "Item " + std::to_string(i)});
+            }
+
+            Section shifted{items};
+            shifted.push_front(Element{Tag::Li, {}, "First"});
+            const Patch inserted{diff(items, shifted)};
+            REQUIRE(inserted.size() == 1);
+            REQUIRE(inserted.at(0).get_operation() == Operation::Insert);
+            REQUIRE(inserted.at(0).get_index() == 0);
+            applied = items;
+            apply(applied, inserted);
+            REQUIRE(applied.get() == shifted.get());
+
+            // moving a child removes it and inserts it again
+            Section moved{items};
+            moved.erase(4);
+            moved.push_front(Element{Tag::Li, {}, "Item 4"});
+            const Patch move{diff(items, moved)};
+            REQUIRE(move.size() == 2);
+            applied = items;
+            apply(applied, move);
+            REQUIRE(applied.get() == moved.get());
+
+            // removing a child in the middle and changing another
+            Section changed{items};
+            changed.erase(1);
+            changed.at(3).set_data("Changed");
+            const Patch middle{diff(items, changed)};
+            REQUIRE(middle.size() == 2);
+            applied = items;
+            apply(applied, middle);
+            REQUIRE(applied.get() == changed.get());
+            REQUIRE(diff(applied, changed).empty());
+
+            // a child changed through a kept reference is found by the next diff
+            Section kept{items};
+            Element& item{kept.at(2)};
+            REQUIRE(diff(items, kept).empty());
+            item.set_data("Kept");
+            const Patch reference{diff(items, kept)};
+            REQUIRE(reference.size() == 1);
+            REQUIRE(reference.at(0).get_operation() == Operation::Set_Text);
+            applied = items;
+            apply(applied, reference);
+            REQUIRE(applied.get() == kept.get());
+        };
+
+        const auto test_write = []() {
+            using namespace docpp::HTML;
+
+            Patch patch{};
+            REQUIRE(patch.get() == "[]");
+
+            patch.push_back(Change{Operation::Set_Text, {1, 0}, 2, {}, "Say \"hi\"\n"});
+            patch.push_back(Change{Operation::Set_Attribute, {}, Change::npos, "class", "dark"});
+            patch.push_back(Change{Operation::Insert, {0}, 3, Element{Tag::P, {}, "<b>"}});
+            patch.push_back(Change{Operation::Remove, {0}, 4});
+
+            REQUIRE(patch.get() == "[{\"op\":\"set-text\",\"path\":[1,0],\"index\":2,\"value\":\"Say \\\"hi\\\"\\n\"},"
+                "{\"op\":\"set-attribute\",\"path\":[],\"key\":\"class\",\"value\":\"dark\"},"
+                "{\"op\":\"insert\",\"path\":[0],\"index\":3,\"html\":\"<p><b></p>\"},"
+                "{\"op\":\"remove\",\"path\":[0],\"index\":4}]");
+
+            docpp::string_type escaped{};
+            docpp::StringSink sink{escaped};
+            sink.set_escaping(true);
+            patch.write(sink);
+            REQUIRE(escaped.find("\"html\":\"<p>&lt;b&gt;</p>\"") != docpp::string_type::npos);
+
+            patch.clear();
+            REQUIRE(patch.empty());
+        };
+
+        const auto test_errors = []() {
+            using namespace docpp::HTML;
+
+            Section section{Tag::Div, {}, {Element{Tag::P, {}, "Text"}}};
+
+            try {
+                apply(section, Patch{{Change{Operation::Set_Text, {0}, 0, {}, "Text"}}});
+                REQUIRE(false);
+            } catch (const docpp::out_of_range& e) {
+                REQUIRE(true);
+            }
+
+            try {
+                apply(section, Patch{{Change{Operation::Insert, {}, 1}}});
+                REQUIRE(false);
+            } catch (const docpp::invalid_argument& e) {
+                REQUIRE(true);
+            }
+
+            try {
+                apply(section, Patch{{Change{Operation::Remove, {}, Change::npos}}});
+                REQUIRE(false);
+            } catch (const docpp::invalid_argument& e) {
+                REQUIRE(true);
+            }
+
+            try {
+                static_cast<void>(Patch{}.at(0));
+                REQUIRE(false);
+            } catch (const docpp::out_of_range& e) {
+                REQUIRE(true);
+            }
+        };
+
+        test_diff();
+        test_write();
+        test_errors();
+    }
+
+    void test_query() {
+        const auto make = []() {
+            using namespace docpp::HTML;
+
+            Section items{"ul", make_properties(Property{"class", "items"})};
+            for (int i{0}; i < 3; ++i) {
+                items.push_back(Element{Tag::Li, make_properties(Property{"data-index", std::to_string(i)}, Property{"class", i == 1 ? "item active" : "item"}), "Item " + std::to_string(i)});
+            }
+
+            Section container{};
+            container.push_back(Element{Tag::P, {}, "Contained"});
+
+            Section nested{Tag::Div};
+            nested.push_back(Section{"section", {}, {Element{Tag::P, {}, "Deep"}}});
+
+            Section content{Tag::Div, make_properties(Property{"class", "content main"})};
+            content.push_back(Element{Tag::P, make_properties(Property{"id", "intro"}, Property{"class", "lead"}), "Intro"});
+            content.push_back(std::move(container));
+            content.push_back(std::move(items));
+            content.push_back(std::move(nested));
+
+            Section body{Tag::Body};
+            body.push_back(std::move(content));
+            body.push_back(Element{Tag::P, make_properties(Property{"title", ""}), "Outside"});
+            body.push_back(Element{Tag::Empty_No_Formatting, {}, "Text"});
+            return body;
+        };
+
+        // the data of each element that matches, and the tag of each section
+        const auto names = [](const std::vector<const docpp::HTML::Section::node_type*>& nodes) {
+            std::vector<std::string> ret{};
+            for (const docpp::HTML::Section::node_type* it : nodes) {
+                if (const docpp::HTML::Element* element = std::get_if<docpp::HTML::Element>(it)) {
+                    ret.push_back(element->get_data());
+                } else {
+                    ret.push_back(std::get<docpp::HTML::Section>(*it).get_tag());
+                }
+            }
+            return ret;
+        };
+
+        const auto test_query_all = [&make, &names]() {
+            using namespace docpp::HTML;
+
+            const Section body{make()};
+
+            const Section::node_type* intro{query(body, "div.content > p#intro")};
+            REQUIRE(intro != nullptr);
+            REQUIRE(std::get<Element>(*intro).get_data() == "Intro");
+            REQUIRE(query(body, "h1") == nullptr);
+            REQUIRE(std::get<Section>(*query(body, "ul")).get_tag() == "ul");
+
+            REQUIRE(names(query_all(body, "p")) == std::vector<std::string>{"Intro", "Contained", "Deep", "Outside"});
+            REQUIRE(names(query_all(body, "p")) == names(query_all(body, "P")));
+
+            // the children of a section without a tag are children of the section around it, as they are written
+            REQUIRE(names(query_all(body, "div > p")) == std::vector<std::string>{"Intro", "Contained"});
+            REQUIRE(names(query_all(body, "div p")) == std::vector<std::string>{"Intro", "Contained", "Deep"});
+
+            // the root is not matched, but it is an ancestor
+            REQUIRE(names(query_all(body, "body > p")) == std::vector<std::string>{"Outside"});
+            REQUIRE(query_all(body, "body").empty());
+
+            // the nearest div fails, and the one around it is tried
+            REQUIRE(names(query_all(body, "body > div p")) == std::vector<std::string>{"Intro", "Contained", "Deep"});
+            REQUIRE(names(query_all(body, "body > div > div p")) == std::vector<std::string>{"Deep"});
+
+            REQUIRE(names(query_all(body, "li.active")) == std::vector<std::string>{"Item 1"});
+            REQUIRE(names(query_all(body, ".item.active")) == std::vector<std::string>{"Item 1"});
+            REQUIRE(query_all(body, "[data-index]").size() == 3);
+            REQUIRE(names(query_all(body, "[data-index='2']")) == std::vector<std::string>{"Item 2"});
+            REQUIRE(query_all(body, "[class~=main]").size() == 1);
+            REQUIRE(query_all(body, "[class^=cont]").size() == 1);
+            REQUIRE(query_all(body, "[class$=main]").size() == 1);
+            REQUIRE(query_all(body, "[class*=\"ent ma\"]").size() == 1);
+            REQUIRE(query_all(body, "[class|=content]").empty());
+
+            // empty attributes are not written, so they are not matched
+            REQUIRE(query_all(body, "[title]").empty());
+
+            // the text is not matched, as it has no tag
+            REQUIRE(query_all(body, "*").size() == 11);
+
+            // each node is listed once, in document order
+            REQUIRE(names(query_all(body, "ul, p#intro, .lead")) == std::vector<std::string>{"Intro", "ul"});
+
+            // a compiled selector can be used with any tree
+            const Selector selector{"ul > li"};
+            REQUIRE(selector.query_all(body).size() == 3);
+            REQUIRE(selector.query_all(Section{"ul", {}, std::vector<Element>{Element{Tag::Li, {}, "Other"}}}).size() == 1);
+
+            // parsed names are matched whatever their case in the markup
+            const Section parsed{parse("<DIV><P CLASS=x DATA-DOCPP-QUERY=1>a</P><Docpp-Query-Tag>b</Docpp-Query-Tag></DIV>")};
+            REQUIRE(names(query_all(parsed, ".x")) == std::vector<std::string>{"a"});
+            REQUIRE(names(query_all(parsed, "div > P[data-docpp-query]")) == std::vector<std::string>{"a"});
+            REQUIRE(names(query_all(parsed, "DOCPP-QUERY-TAG")) == std::vector<std::string>{"b"});
+
+            // selectors look names up without adding them to the intern pool
+            const docpp::size_type size{docpp::InternPool::get().size()};
+            REQUIRE(query_all(body, "docpp-missing-tag[data-docpp-missing]").empty());
+            REQUIRE(docpp::InternPool::get().size() == size);
+        };
+
+        const auto test_index = [&make, &names]() {
+            using namespace docpp::HTML;
+
+            const Section body{make()};
+            const QueryIndex index{body};
+
+            for (const char* it : {"#intro", "p#intro", ".active", "li.item", "div > p", "body > div p", "ul, p#intro, .lead", "[data-index]", ".missing", "#missing, p", "*"}) {
+                const Selector selector{it};
+                REQUIRE(names(selector.query_all(index)) == names(selector.query_all(body)));
+                REQUIRE(selector.query(index) == selector.query(body));
+            }
+
+            // the index is built once, by whichever thread uses it first
+            const QueryIndex shared{body};
+            const Selector selector{".item"};
+            std::vector<std::vector<const Section::node_type*>> results(4);
+            std::vector<std::thread> threads{};
+            for (std::vector<const Section::node_type*>& it : results) {
+                threads.emplace_back([&it, &selector, &shared]() { it = selector.query_all(shared); });
+            }
+            for (std::thread& it : threads) {
+                it.join();
+            }
+            for (const std::vector<const Section::node_type*>& it : results) {
+                REQUIRE(it == selector.query_all(body));
+            }
+        };
+
+        const auto test_errors = []() {
+            using namespace docpp::HTML;
+
+            for (const char* it : {"", " ", "div >", "> p", "p,", "a:hover", "a + b", "a ~ b", "[href", "[href=]", "[href=\"x]", "#", ".", "a..b"}) {
+                try {
+                    static_cast<void>(Selector{it});
+                    REQUIRE(false);
+                } catch (const docpp::invalid_argument& e) {
+                    REQUIRE(true);
+                }
+            }
+        };
+
+        test_query_all();
+        test_index();
+        test_errors();
+    }
+
     void test_html() {
         test_tag();
         test_property();
@@ -1225,6 +2920,10 @@ inline namespace HTML {
         test_element();
         test_section();
         test_document();
+        test_parser();
+        test_template();
+        test_patch();
+        test_query();
     }
 } // namespace HTML
 
@@ -1864,6 +3563,200 @@ inline namespace CSS {
             }
         };
 
+        const auto test_hash = []() {
+            using namespace docpp::CSS;
+
+            const auto make = []() {
+                Element media{"@media (max-width: 600px)", {}};
+                media.push_back_rule(Element{"p", {{"margin", "0"}}});
+
+                Stylesheet stylesheet{};
+                stylesheet.push_back(Element{"p", {{"color", "red"}, {"font-size", "12px"}}});
+                stylesheet.push_back(media);
+                return stylesheet;
+            };
+
+            Stylesheet stylesheet{make()};
+            const Stylesheet same{make()};
+
+            REQUIRE(stylesheet.hash() == same.hash());
+            REQUIRE(stylesheet == same);
+            REQUIRE(std::hash<Stylesheet>{}(stylesheet) == std::hash<Stylesheet>{}(same));
+
+            for (Element& it : stylesheet) {
+                it.push_back(Property{"display", "block"});
+            }
+            REQUIRE(stylesheet.hash() != same.hash());
+            REQUIRE(stylesheet != same);
+
+            stylesheet = make();
+            REQUIRE(stylesheet == same);
+
+            const Element element{"p", {{"color", "red"}, {"font-size", "12px"}}};
+            Element other{element};
+            REQUIRE(element == other);
+            REQUIRE(std::hash<Element>{}(element) == std::hash<Element>{}(other));
+            other.at(0).set_value("blue");
+            REQUIRE(element != other);
+            REQUIRE(element.hash() != other.hash());
+
+            // nested rules are part of the hash
+            Element media{"@media print", {}};
+            Element media_other{"@media print", {}};
+            media.push_back_rule(element);
+            media_other.push_back_rule(other);
+            REQUIRE(media.hash() != media_other.hash());
+            REQUIRE(media != media_other);
+
+            REQUIRE(stylesheet.find(element) == 0);
+            REQUIRE(stylesheet.find(other) == Stylesheet::npos);
+
+            std::unordered_set<Element> elements{element, other, Element{element}};
+            REQUIRE(elements.size() == 2);
+
+            // writes through references kept after hashing are seen
+            Element kept{element};
+            Property& value{kept.at(0)};
+            Property& last{kept.back()};
+            REQUIRE(kept == element);
+            value.set_value("blue");
+            REQUIRE(kept == other);
+            REQUIRE(kept.hash() == other.hash());
+            last.set_value("14px");
+            REQUIRE(kept != other);
+
+            Stylesheet sheet{make()};
+            Element& first{sheet.emplace_back("a", std::vector<Property>{{"color", "red"}})};
+            const Stylesheet::iterator begin{sheet.begin()};
+            REQUIRE(sheet.find(Element{"a", {{"color", "red"}}}) == 2);
+            first.push_back(Property{"margin", "0"});
+            REQUIRE(sheet.find(Element{"a", {{"color", "red"}}}) == Stylesheet::npos);
+            REQUIRE(sheet.find(Element{"a", {{"color", "red"}, {"margin", "0"}}}) == 2);
+
+            Stylesheet copy{sheet};
+            REQUIRE(copy == sheet);
+            begin->push_back(Property{"display", "block"});
+            REQUIRE(copy != sheet);
+            REQUIRE(copy.hash() != sheet.hash());
+            copy.begin()->push_back(Property{"display", "block"});
+            REQUIRE(copy == sheet);
+        };
+
+        const auto test_optimize = []() {
+            using namespace docpp::CSS;
+
+            Element element{"a", {
+                Property{"color", "#FFFFFF"},
+                Property{"margin", "0px  auto"},
+                Property{"width", "calc( 100% - 0px )"},
+                Property{"background", "url(a b.png) no-repeat , #aabbccff"},
+                Property{"font-family", "\"Times   New\",  serif"},
+                Property{"transition", "opacity 0s"},
+                Property{"color", "rgb(255, 0, 0)"},
+            }};
+
+            REQUIRE(element.get(Formatting::Minified) == "a{color:#FFFFFF;margin:0px  auto;width:calc( 100% - 0px );"
+                "background:url(a b.png) no-repeat , #aabbccff;font-family:\"Times   New\",  serif;transition:opacity 0s;color:rgb(255, 0, 0)}");
+
+            element.optimize();
+            REQUIRE(element.get(Formatting::Minified) == "a{margin:0 auto;width:calc(100% - 0px);background:url(a b.png) no-repeat,#abc;"
+                "font-family:\"Times   New\",serif;transition:opacity 0s;color:#f00}");
+
+            // an earlier !important declaration is not overridden
+            Element important{"p", {Property{"margin-top", "1px !important"}, Property{"margin-top", "2px"}}};
+            important.optimize();
+            REQUIRE(important.get(Formatting::Minified) == "p{margin-top:1px!important}");
+
+            // custom properties are kept as they are, and the flex shorthand keeps the unit of a zero basis
+            Element units{"div", {
+                Property{"--gap", "0px"},
+                Property{"--color", "#FFFFFF  "},
+                Property{"flex", "1 0px"},
+                Property{"-webkit-flex", "1  0%"},
+                Property{"flex-basis", "0px"},
+            }};
+            units.optimize();
+            REQUIRE(units.get(Formatting::Minified) == "div{--gap:0px;--color:#FFFFFF  ;flex:1 0px;-webkit-flex:1 0%;flex-basis:0}");
+
+            Stylesheet stylesheet{
+                Element{"@import url(base.css)", {}},
+                Element{"a", {Property{"color", "red"}}},
+                Element{"b", {Property{"padding", "0.0em"}}},
+                Element{"a", {Property{"margin", "1px"}}},
+                Element{"i", {Property{"padding", "0"}}},
+                Element{"q", {Property{"margin", "3px"}}},
+                Element{"p", {Property{"margin-top", "1px"}}},
+                Element{"q", {Property{"margin-top", "2px"}}},
+                Element{"p", {Property{"margin-bottom", "1px"}}},
+                Element{"em", {}},
+                Element{"::-moz-selection", {Property{"color", "red"}}},
+                Element{"::selection", {Property{"color", "red"}}},
+                Element{"@media screen", {}, {Element{"a", {Property{"top", "0"}}}, Element{"a", {Property{"left", "0"}}}}},
+            };
+
+            stylesheet.optimize();
+
+            // b is moved past a, which sets no padding, but p is not moved past q, which sets its margin
+            REQUIRE(stylesheet.get(Formatting::Minified) == "@import url(base.css);a{color:red;margin:1px}b,i{padding:0}q{margin:3px}"
+                "p{margin-top:1px}q{margin-top:2px}p{margin-bottom:1px}::-moz-selection{color:red}::selection{color:red}"
+                "@media screen{a{top:0;left:0}}");
+            REQUIRE(stylesheet.rendered_size(Formatting::Minified) == stylesheet.get(Formatting::Minified).size());
+
+            // an optimized stylesheet is optimized already
+            const Stylesheet copy{stylesheet};
+            stylesheet.optimize();
+            REQUIRE(stylesheet == copy);
+
+            // shorthands override longhands that do not share their name, so a rule is not moved past them
+            const auto optimized = [](const docpp::string_type& property, const docpp::string_type& shorthand) {
+                Stylesheet shorthands{
+                    Element{".a", {Property{"color", "red"}}},
+                    Element{".b", {Property{property, "1"}}},
+                    Element{".a", {Property{shorthand, "2"}}},
+                };
+
+                shorthands.optimize();
+                return shorthands.get(Formatting::Minified);
+            };
+
+            REQUIRE(optimized("line-height", "font") == ".a{color:red}.b{line-height:1}.a{font:2}");
+            REQUIRE(optimized("column-width", "columns") == ".a{color:red}.b{column-width:1}.a{columns:2}");
+            REQUIRE(optimized("column-count", "columns") == ".a{color:red}.b{column-count:1}.a{columns:2}");
+            REQUIRE(optimized("grid-gap", "gap") == ".a{color:red}.b{grid-gap:1}.a{gap:2}");
+            REQUIRE(optimized("grid-row-gap", "row-gap") == ".a{color:red}.b{grid-row-gap:1}.a{row-gap:2}");
+            REQUIRE(optimized("grid-column-gap", "gap") == ".a{color:red}.b{grid-column-gap:1}.a{gap:2}");
+            REQUIRE(optimized("text-wrap-mode", "white-space") == ".a{color:red}.b{text-wrap-mode:1}.a{white-space:2}");
+            REQUIRE(optimized("-webkit-line-clamp", "max-lines") == ".a{color:red}.b{-webkit-line-clamp:1}.a{max-lines:2}");
+            REQUIRE(optimized("top", "inset") == ".a{color:red}.b{top:1}.a{inset:2}");
+            REQUIRE(optimized("justify-items", "place-items") == ".a{color:red}.b{justify-items:1}.a{place-items:2}");
+
+            // unrelated properties do not keep it from being moved
+            REQUIRE(optimized("opacity", "font") == ".a{color:red;font:2}.b{opacity:1}");
+            REQUIRE(optimized("column-gap", "columns") == ".a{color:red;columns:2}.b{column-gap:1}");
+
+            // selectors using pseudo-classes and pseudo-elements that not every browser knows are not grouped
+            const auto grouped = [](const docpp::string_type& selector) {
+                Stylesheet rules{
+                    Element{".b", {Property{"color", "#fff"}}},
+                    Element{selector, {Property{"color", "#fff"}}},
+                };
+
+                rules.optimize();
+                return rules.get(Formatting::Minified);
+            };
+
+            REQUIRE(grouped(".c:focus-visible") == ".b{color:#fff}.c:focus-visible{color:#fff}");
+            REQUIRE(grouped(".c::-moz-selection") == ".b{color:#fff}.c::-moz-selection{color:#fff}");
+            REQUIRE(grouped(".c:is(.d)") == ".b{color:#fff}.c:is(.d){color:#fff}");
+            REQUIRE(grouped(".c:not(.d, .e)") == ".b{color:#fff}.c:not(.d, .e){color:#fff}");
+            REQUIRE(grouped(".c:not(.d:has(.e))") == ".b{color:#fff}.c:not(.d:has(.e)){color:#fff}");
+            REQUIRE(grouped(".c") == ".b,.c{color:#fff}");
+            REQUIRE(grouped("a:hover") == ".b,a:hover{color:#fff}");
+            REQUIRE(grouped("li:nth-child(2n+1)::before") == ".b,li:nth-child(2n+1)::before{color:#fff}");
+            REQUIRE(grouped("a[href=\":x\"]") == ".b,a[href=\":x\"]{color:#fff}");
+            REQUIRE(grouped(".w\\:full") == ".b,.w\\:full{color:#fff}");
+        };
+
         test_get_and_set();
         test_copy_section();
         test_operators();
@@ -1873,6 +3766,51 @@ inline namespace CSS {
         test_size_empty_and_clear();
         test_insert();
         test_iterators();
+        test_hash();
+        test_optimize();
+
+        using namespace docpp::CSS;
+
+        Stylesheet stylesheet{Element{"p", {Property{"color", "red"}, Property{"margin", "0"}}}, Element{"div", {Property{"display", "block"}}}};
+        std::ostringstream stream{};
+        docpp::StreamSink sink{stream};
+        stylesheet.write(sink, docpp::CSS::Formatting::Pretty);
+
+        REQUIRE(stream.str() == stylesheet.get(docpp::CSS::Formatting::Pretty));
+        REQUIRE(stylesheet.get() == "p {color: red;margin: 0;}div {display: block;}");
+
+        Element moved_element{"span", {}};
+        moved_element.emplace_back("color", "blue");
+        moved_element.emplace(0, "display", "inline");
+        moved_element.push_back(Property{"margin", "0"});
+        REQUIRE(moved_element.get() == "span {display: inline;color: blue;margin: 0;}");
+
+        stylesheet.push_back(std::move(moved_element));
+        stylesheet.emplace_back("a", make_properties(Property{"color", "green"}));
+        stylesheet.emplace(0, "body", std::vector<Property>{});
+        REQUIRE(moved_element.empty());
+        REQUIRE(stylesheet.size() == 5);
+
+        Stylesheet moved_stylesheet{std::move(stylesheet)};
+        REQUIRE(moved_stylesheet.get() == "body {}p {color: red;margin: 0;}div {display: block;}span {display: inline;color: blue;margin: 0;}a {color: green;}");
+        REQUIRE(stylesheet.empty());
+
+        std::string tags{};
+        for (const Element& it : moved_stylesheet.elements_view()) {
+            tags += it.tag_view();
+        }
+        REQUIRE(tags == "bodypdivspana");
+        REQUIRE(moved_stylesheet.at(1).properties_view().size() == 2);
+        REQUIRE(moved_stylesheet.at(1).properties_view().begin()->key_view() == "color");
+        REQUIRE(moved_stylesheet.at(1).properties_view().begin()->value_view() == "red");
+
+        for (const docpp::CSS::Formatting formatting : {docpp::CSS::Formatting::None, docpp::CSS::Formatting::Pretty, docpp::CSS::Formatting::Newline}) {
+            for (const docpp::integer_type tabc : {0, 2}) {
+                REQUIRE(moved_stylesheet.rendered_size(formatting, tabc) == moved_stylesheet.get(formatting, tabc).size());
+                REQUIRE(moved_stylesheet.at(1).rendered_size(formatting, tabc) == moved_stylesheet.at(1).get(formatting, tabc).size());
+            }
+        }
+        REQUIRE(Stylesheet{}.rendered_size() == 0);
     }
 
     void test_color_conversions() {
@@ -1912,6 +3850,10 @@ inline namespace CSS {
         REQUIRE(formatter.get<std::string>(docpp::CSS::ColorFormatting::Hex_A) == "#ffff00ff");
         REQUIRE(formatter.get<std::string>(docpp::CSS::ColorFormatting::Rgb) == "rgb(255, 255, 0)");
         REQUIRE(formatter.get<std::string>(docpp::CSS::ColorFormatting::Rgb_A) == "rgba(255, 255, 0, 255)");
+        REQUIRE(formatter.get<std::string>(docpp::CSS::ColorFormatting::Hex_Short) == "#ff0");
+
+        formatter.set_color_struct(docpp::CSS::from_hex("#AABBCD"));
+        REQUIRE(formatter.get<std::string>(docpp::CSS::ColorFormatting::Hex_Short) == "#aabbcd");
 
         formatter.set_formatting(docpp::CSS::ColorFormatting::Hex_A);
         formatter.set_color_struct(docpp::CSS::from_rgba(0, 0, 0, 255));
@@ -1919,12 +3861,101 @@ inline namespace CSS {
         REQUIRE(formatter.get<std::string>() == "#000000ff");
     }
 
+    void test_parser() {
+        const auto test_round_trip = []() {
+            using namespace docpp::CSS;
+
+            Element media{"@media (max-width: 600px)", {}, {
+                Element{"p", {Property{"margin", "0"}}},
+                Element{"div.box > a:hover", {Property{"color", "#FF0000"}, Property{"background", "url(\"a;b}.png\")"}}},
+            }};
+            const Stylesheet stylesheet{
+                Element{"@import url(\"theme.css\")", {}},
+                Element{"body", {Property{"font-family", "\"Open Sans\", sans-serif"}, Property{"color", "red !important"}}},
+                Element{"@font-face", {Property{"font-family", "Icons"}, Property{"src", "url(data:font/woff2;base64,AAAA) format(\"woff2\")"}}},
+                media,
+                Element{"a::after", {Property{"content", "'}'"}}},
+            };
+
+            for (const Formatting formatting : {Formatting::None, Formatting::Pretty, Formatting::Newline}) {
+                REQUIRE(parse(stylesheet.get(formatting)).get(formatting) == stylesheet.get(formatting));
+            }
+
+            REQUIRE(stylesheet.get() == "@import url(\"theme.css\");body {font-family: \"Open Sans\", sans-serif;color: red !important;}"
+                "@font-face {font-family: Icons;src: url(data:font/woff2;base64,AAAA) format(\"woff2\");}"
+                "@media (max-width: 600px) {p {margin: 0;}div.box > a:hover {color: #FF0000;background: url(\"a;b}.png\");}}a::after {content: '}';}");
+            REQUIRE(stylesheet.get(Formatting::Pretty).find("@media (max-width: 600px) {\n\tp {\n\t\tmargin: 0;\n\t}\n") != std::string::npos);
+
+            const Stylesheet parsed{parse(stylesheet.get())};
+            REQUIRE(parsed.size() == 5);
+            REQUIRE(parsed.at(3).tag_view() == "@media (max-width: 600px)");
+            REQUIRE(parsed.at(3).empty() == false);
+            REQUIRE(parsed.at(3).get_rules().size() == 2);
+            REQUIRE(parsed.at(3).rules_view().begin()->tag_view() == "p");
+            REQUIRE(parsed.at(1).at(0).key_view() == "font-family");
+            REQUIRE(parsed.at(1).at(0).value_view() == "\"Open Sans\", sans-serif");
+        };
+
+        const auto test_comments_and_recovery = []() {
+            using namespace docpp::CSS;
+
+            const Stylesheet stylesheet{parse(
+                "/* header; { } */\n"
+                "h1, h2 /* headings */ {\n"
+                "  color : blue ; /* trailing */\n"
+                "  content: \"/* not a comment */\";\n"
+                "  invalid;\n"
+                "  margin:;\n"
+                "  ;\n"
+                "}\n"
+                "}\n"
+                "garbage;\n"
+                "@charset \"utf-8\";\n"
+                "p { padding: 1px 2px"
+            )};
+
+            REQUIRE(stylesheet.get() == "h1, h2 {color: blue;content: \"/* not a comment */\";}@charset \"utf-8\";p {padding: 1px 2px;}");
+            REQUIRE(stylesheet.at(0).size() == 2);
+            REQUIRE(parse("").empty());
+            REQUIRE(parse("  /* only a comment */  ").empty());
+
+            for (const char* input : {"p { color: \"red; }", "/* comment", "p { content: 'a }"}) {
+                try {
+                    static_cast<void>(parse(input));
+                    REQUIRE(false);
+                } catch (const docpp::invalid_argument& e) {
+                    REQUIRE(std::string(e.what()).rfind("Unterminated", 0) == 0);
+                }
+            }
+        };
+
+        const auto test_file = []() {
+            using namespace docpp::CSS;
+
+            const Stylesheet stylesheet{Element{"p", {Property{"color", "red"}}}, Element{"div", {Property{"display", "block"}}}};
+            const std::string path{"docpp_parser_test.css"};
+            std::FILE* file{std::fopen(path.c_str(), "wb")};
+            REQUIRE(file != nullptr);
+            const std::string css{stylesheet.get(Formatting::Pretty)};
+            std::fwrite(css.data(), 1, css.size(), file);
+            std::fclose(file);
+
+            REQUIRE(parse_file(path) == stylesheet);
+            std::remove(path.c_str());
+        };
+
+        test_round_trip();
+        test_comments_and_recovery();
+        test_file();
+    }
+
     void test_css() {
         test_property();
         test_element();
         test_stylesheet();
         test_color_conversions();
         test_color_formatter();
+        test_parser();
     }
 
 } // namespace CSS
@@ -1967,6 +3998,390 @@ inline namespace General {
         REQUIRE(docpp::CSS::Stylesheet::npos == -1);
     }
 
+    void test_stats() {
+        using namespace docpp::HTML;
+
+        Section section{Tag::Div};
+        section.push_back(Element{Tag::P, {}, "A paragraph with text long enough to be allocated"});
+        section.push_back(Section{Tag::Span, {}, {Element{Tag::Br}}});
+
+        docpp::reset_stats();
+
+        std::vector<docpp::Stats> calls{};
+        docpp::set_stats_callback([&calls](const docpp::Stats& stats) { calls.push_back(stats); });
+
+        const docpp::string_type html{section.get()};
+
+        docpp::CountingSink sink{};
+        section.write(sink, Formatting::Pretty);
+
+        static_cast<void>(resolve_tag("div"));
+
+        docpp::set_stats_callback({});
+        static_cast<void>(section.get());
+
+        const docpp::Stats stats{docpp::get_stats()};
+
+        if (!docpp::stats_enabled()) {
+            REQUIRE(calls.empty());
+            REQUIRE(stats.renders == 0);
+            REQUIRE(stats.nodes_visited == 0);
+            REQUIRE(stats.bytes_emitted == 0);
+            REQUIRE(stats.tag_resolutions == 0);
+            return;
+        }
+
+        REQUIRE(calls.size() == 2);
+        REQUIRE(calls.at(0).renders == 1);
+        REQUIRE(calls.at(0).nodes_visited == 8);
+        REQUIRE(calls.at(0).bytes_emitted == html.size());
+        REQUIRE(calls.at(0).string_allocations == 1);
+        REQUIRE(calls.at(1).nodes_visited == 4);
+        REQUIRE(calls.at(1).bytes_emitted == sink.size());
+        REQUIRE(calls.at(1).string_allocations == 0);
+
+        REQUIRE(stats.renders == 3);
+        REQUIRE(stats.nodes_visited == 20);
+        REQUIRE(stats.bytes_emitted == 2 * html.size() + sink.size());
+        REQUIRE(stats.tag_resolutions == 1);
+        REQUIRE(stats.render_time >= calls.at(0).render_time + calls.at(1).render_time);
+
+        docpp::reset_stats();
+        REQUIRE(docpp::get_stats().renders == 0);
+        REQUIRE(docpp::get_stats().render_time.count() == 0);
+    }
+
+    void test_thread_pool() {
+        docpp::ThreadPool pool{4};
+        REQUIRE(pool.size() == 4);
+        REQUIRE(docpp::ThreadPool{}.size() >= 1);
+
+        std::atomic<int> count{0};
+        for (int i{0}; i < 1000; ++i) {
+            pool.push([&count, &pool, i]() {
+                count.fetch_add(1);
+
+                // tasks queued by a worker go to its own queue, and are stolen by the others
+                if (i % 10 == 0) {
+                    pool.push([&count]() { count.fetch_add(1); });
+                }
+            });
+        }
+
+        while (count.load() != 1100) {
+            if (!pool.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+
+        REQUIRE(count.load() == 1100);
+
+        std::atomic<int> remaining{0};
+
+        {
+            docpp::ThreadPool destroyed{2};
+
+            for (int i{0}; i < 100; ++i) {
+                ++remaining;
+                destroyed.push([&remaining]() { --remaining; });
+            }
+        }
+
+        // destroying the pool runs the remaining tasks
+        REQUIRE(remaining.load() == 0);
+    }
+
+    void test_deflate() {
+#ifdef DOCPP_WITH_ZLIB
+        using namespace docpp::HTML;
+
+        // gzip and zlib streams are told apart by their header
+        const auto inflate = [](const std::string& data, const bool raw) {
+            z_stream stream{};
+            std::string ret{};
+            unsigned char output[4096];
+
+            REQUIRE(inflateInit2(&stream, raw ? -MAX_WBITS : MAX_WBITS + 32) == Z_OK);
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+
+            int ret_code{Z_OK};
+            while (ret_code == Z_OK) {
+                stream.next_out = output;
+                stream.avail_out = sizeof(output);
+                ret_code = ::inflate(&stream, Z_NO_FLUSH);
+                ret.append(reinterpret_cast<const char*>(output), sizeof(output) - stream.avail_out);
+            }
+
+            // a raw stream has no trailer to check, so it ends with the last block
+            REQUIRE(ret_code == Z_STREAM_END);
+            REQUIRE(stream.avail_in == 0);
+            inflateEnd(&stream);
+
+            return ret;
+        };
+
+        Section section{Tag::Div};
+        for (int i{0}; i < 2000; ++i) {
+            section.push_back(Element{Tag::P, {}, "Paragraph number " + std::to_string(i)});
+        }
+
+        const std::string html{section.get()};
+
+        for (const docpp::DeflateFormat format : {docpp::DeflateFormat::Gzip, docpp::DeflateFormat::Zlib, docpp::DeflateFormat::Raw}) {
+            std::string compressed{};
+
+            {
+                docpp::StringSink string_sink{compressed};
+                docpp::DeflateSink sink{string_sink, format};
+                section.write(sink);
+                REQUIRE(sink.size() == html.size());
+            }
+
+            REQUIRE(compressed.size() < html.size() / 4);
+            REQUIRE(inflate(compressed, format == docpp::DeflateFormat::Raw) == html);
+        }
+
+        // a flush pushes everything written so far to the underlying sink, which can be inflated before the stream is finished
+        std::string streamed{};
+        int flushes{0};
+        docpp::CallbackSink callback_sink{[&streamed, &flushes](const std::string_view chunk) {
+            streamed.append(chunk.data(), chunk.size());
+            ++flushes;
+        }, 0};
+
+        {
+            docpp::DeflateSink sink{callback_sink, docpp::DeflateFormat::Raw, 9, 1024};
+            section.write(sink);
+            REQUIRE(flushes > static_cast<int>(html.size() / 1024) / 2);
+
+            std::string partial{};
+            z_stream stream{};
+            REQUIRE(inflateInit2(&stream, -MAX_WBITS) == Z_OK);
+            partial.resize(html.size());
+            stream.next_in = reinterpret_cast<Bytef*>(streamed.data());
+            stream.avail_in = static_cast<uInt>(streamed.size());
+            stream.next_out = reinterpret_cast<Bytef*>(partial.data());
+            stream.avail_out = static_cast<uInt>(partial.size());
+            REQUIRE(::inflate(&stream, Z_SYNC_FLUSH) == Z_OK);
+            partial.resize(partial.size() - stream.avail_out);
+            inflateEnd(&stream);
+
+            REQUIRE(partial.size() >= html.size() - 1024);
+            REQUIRE(html.compare(0, partial.size(), partial) == 0);
+        }
+
+        REQUIRE(inflate(streamed, true) == html);
+
+        // precompressed chunks are spliced into the stream, and their checksums combined with the rest
+        const Section header{Tag::Header, {}, {Element{Tag::H1, {}, "A header that is the same on every page"}}};
+        const docpp::DeflatedChunk chunk{docpp::deflate_chunk(header.get())};
+        REQUIRE(chunk.size == header.get().size());
+
+        for (const docpp::DeflateFormat format : {docpp::DeflateFormat::Gzip, docpp::DeflateFormat::Zlib, docpp::DeflateFormat::Raw}) {
+            std::string compressed{};
+
+            {
+                docpp::StringSink string_sink{compressed};
+                docpp::DeflateSink sink{string_sink, format};
+                sink.write("<main>");
+                sink.write_deflated(chunk);
+                section.write(sink);
+                sink.write_deflated(chunk);
+                sink.write_deflated(chunk);
+                sink.finish();
+                REQUIRE(sink.size() == 6 + 3 * chunk.size + html.size());
+
+                try {
+                    sink.write("</main>");
+                    REQUIRE(false);
+                } catch (const docpp::invalid_argument& e) {
+                    REQUIRE(std::string(e.what()) == "Cannot write to a finished DeflateSink");
+                }
+            }
+
+            REQUIRE(inflate(compressed, format == docpp::DeflateFormat::Raw) == "<main>" + header.get() + html + header.get() + header.get());
+        }
+
+        std::string empty{};
+        {
+            docpp::StringSink string_sink{empty};
+            docpp::DeflateSink sink{string_sink};
+        }
+        REQUIRE(inflate(empty, false).empty());
+
+        try {
+            docpp::StringSink string_sink{empty};
+            docpp::DeflateSink sink{string_sink, docpp::DeflateFormat::Gzip, 10};
+            REQUIRE(false);
+        } catch (const docpp::invalid_argument& e) {
+            REQUIRE(std::string(e.what()) == "Invalid compression level");
+        }
+#endif
+    }
+
+    void test_devector() {
+        std::pmr::monotonic_buffer_resource resource{};
+        docpp::Devector<std::pmr::string> devector{&resource};
+
+        for (int i{0}; i < 10; ++i) {
+            devector.emplace_back(std::to_string(i));
+        }
+
+        // inserted near the front, moving the objects before it, and near the back, moving the objects after it
+        REQUIRE(*devector.emplace(devector.begin() + 2, "a") == "a");
+        REQUIRE(*devector.emplace(devector.end() - 2, "b") == "b");
+        devector.emplace_front("c");
+
+        const std::vector<std::string_view> expected{"c", "0", "1", "a", "2", "3", "4", "5", "6", "7", "b", "8", "9"};
+        REQUIRE(devector.size() == expected.size());
+        REQUIRE(std::equal(devector.begin(), devector.end(), expected.begin()));
+        REQUIRE(std::equal(devector.rbegin(), devector.rend(), expected.rbegin()));
+        REQUIRE(devector[0].get_allocator().resource() == &resource);
+
+        // copies use the default allocator, as std::pmr::vector does
+        const docpp::Devector<std::pmr::string> copy{devector};
+        REQUIRE(copy == devector);
+        REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+
+        devector.resize(3);
+        REQUIRE(devector.back() == "1");
+        devector.resize(5);
+        REQUIRE(devector.back().empty());
+        REQUIRE(devector != copy);
+
+        devector = copy;
+        REQUIRE(devector == copy);
+        REQUIRE(devector.get_allocator().resource() == &resource);
+
+        devector.clear();
+        REQUIRE(devector.empty());
+    }
+
+    void test_intern() {
+        const std::string key{"data-docpp-intern"};
+        REQUIRE_FALSE(docpp::InternPool::get().find(key).has_value());
+
+        // names that are not in the pool are copied rather than added to it
+        const docpp::size_type size{docpp::InternPool::get().size()};
+        const docpp::InternedString copied{key};
+        REQUIRE_FALSE(copied.is_interned());
+        REQUIRE(copied.view() == key);
+        REQUIRE(copied.view().data() != key.data());
+        REQUIRE(docpp::InternedString{std::string{key}} == copied);
+        REQUIRE(docpp::InternedString{"data-docpp-intern2"} != copied);
+        REQUIRE_FALSE(docpp::InternPool::get().find(key).has_value());
+
+        const docpp::HTML::Section parsed{docpp::HTML::parse("<custom-docpp-tag data-docpp-parsed=1>a</custom-docpp-tag>")};
+        REQUIRE(parsed.at(0).get_properties().get("data-docpp-parsed") == "1");
+        REQUIRE(docpp::InternPool::get().size() == size);
+
+        // known names are in the pool from the start
+        REQUIRE(docpp::InternedString{"class"}.is_interned());
+        REQUIRE(docpp::InternedString{"margin-top"}.is_interned());
+        REQUIRE(docpp::InternedString{"div"}.is_interned());
+
+        const docpp::InternedString interned{docpp::InternPool::get().intern(key)};
+        REQUIRE(interned.is_interned());
+        REQUIRE(interned.view() == key);
+        REQUIRE(docpp::InternPool::get().find(key) == interned);
+        REQUIRE(docpp::InternedString{std::string{key}} == interned);
+        REQUIRE(docpp::InternedString{std::string{key}}.is_interned());
+        REQUIRE(copied == interned);
+        REQUIRE(docpp::InternPool::get().size() == size + 1);
+
+        // copies of a name outlive the handle they were copied from
+        docpp::InternedString moved{};
+        {
+            const docpp::InternedString owner{"data-docpp-owned"};
+            docpp::InternedString copy{owner};
+            moved = std::move(copy);
+        }
+        REQUIRE(moved.view() == "data-docpp-owned");
+
+        // the empty string is the empty handle, and is never stored
+        REQUIRE(docpp::InternedString{""} == docpp::InternedString{});
+        REQUIRE(docpp::InternPool::get().find("") == docpp::InternedString{});
+        REQUIRE(docpp::InternedString{}.view().empty());
+
+        // threads interning the same strings all get the same handles
+        std::vector<std::vector<docpp::InternedString>> handles(4);
+        std::vector<std::thread> threads{};
+        for (std::vector<docpp::InternedString>& it : handles) {
+            threads.emplace_back([&it]() {
+                for (int i{0}; i < 256; ++i) {
+                    it.push_back(docpp::InternPool::get().intern("data-docpp-thread-" + std::to_string(i)));
+                }
+            });
+        }
+        for (std::thread& it : threads) {
+            it.join();
+        }
+        for (const std::vector<docpp::InternedString>& it : handles) {
+            REQUIRE(it == handles.front());
+        }
+        REQUIRE(handles.front()[255].view() == "data-docpp-thread-255");
+        REQUIRE(handles.front()[255].is_interned());
+
+        // tags and keys of equal elements share one copy of each name
+        const docpp::HTML::Element a{docpp::HTML::Tag::Div, docpp::HTML::Properties{docpp::HTML::Property{key, "a"}}};
+        const docpp::HTML::Element b{"div", docpp::HTML::Properties{docpp::HTML::Property{key, "b"}}};
+        REQUIRE(a.tag_view().data() == b.tag_view().data());
+        REQUIRE(a.get_properties().front().interned_key() == interned);
+        REQUIRE(b.get_properties().front().interned_key() == interned);
+        REQUIRE(docpp::HTML::get_interned_tag_name(docpp::HTML::Tag::Div).view() == "div");
+
+        const docpp::CSS::Property property{"color", "red"};
+        REQUIRE(property.interned_key() == docpp::InternedString{"color"});
+        REQUIRE(property == docpp::CSS::Property{"color", "red"});
+        REQUIRE(property != docpp::CSS::Property{"colour", "red"});
+
+        // names that are not interned are copied once per parse, with the allocator of the nodes
+        std::vector<std::byte> buffer(1 << 20);
+        const auto in_buffer = [&buffer](const std::string_view str) {
+            return str.data() >= reinterpret_cast<const char*>(buffer.data()) && str.data() < reinterpret_cast<const char*>(buffer.data() + buffer.size());
+        };
+
+        std::string markup{};
+        for (int i{0}; i < 1000; ++i) {
+            markup += "<docpp-arena-tag data-docpp-index=" + std::to_string(i) + ">x</docpp-arena-tag>";
+        }
+
+        docpp::HTML::Element outside{};
+        {
+            docpp::Arena arena{buffer.data(), buffer.size()};
+            const docpp::HTML::Section spans{docpp::HTML::parse(markup, arena)};
+            REQUIRE(spans.size() == 1000);
+
+            const docpp::HTML::Element& first{*spans.elements_view().begin()};
+            const std::string_view tag{first.tag_view()};
+            const std::string_view name{first.properties_ref().begin()->key_view()};
+            REQUIRE(in_buffer(tag));
+            REQUIRE(in_buffer(name));
+
+            for (const docpp::HTML::Element& it : spans.elements_view()) {
+                REQUIRE(it.tag_view().data() == tag.data());
+                REQUIRE(it.properties_ref().begin()->key_view().data() == name.data());
+            }
+
+            // copies with another allocator hold their own copy of the names
+            outside = first;
+            REQUIRE_FALSE(in_buffer(outside.tag_view()));
+            REQUIRE_FALSE(in_buffer(outside.properties_ref().begin()->key_view()));
+
+            const docpp::HTML::Element inside{first, arena.get_allocator()};
+            REQUIRE(inside.tag_view().data() == tag.data());
+
+            const docpp::CSS::Stylesheet stylesheet{docpp::CSS::parse("a{--docpp-gap:0}b{--docpp-gap:1}")};
+            const auto rules = stylesheet.elements_view();
+            REQUIRE(rules.begin()->begin()->key_view().data() == std::next(rules.begin())->begin()->key_view().data());
+        }
+        std::fill(buffer.begin(), buffer.end(), std::byte{0});
+        REQUIRE(outside.get() == "<docpp-arena-tag data-docpp-index=\"0\">x</docpp-arena-tag>");
+        REQUIRE_FALSE(docpp::InternPool::get().find("docpp-arena-tag").has_value());
+    }
+
     void test_version() {
         std::tuple<int, int, int> version = docpp::version();
 
@@ -1982,6 +4397,11 @@ inline namespace General {
 SCENARIO("Test general", "[GENERAL]") {
     General::test_exceptions();
     General::test_npos_values();
+    General::test_stats();
+    General::test_thread_pool();
+    General::test_deflate();
+    General::test_devector();
+    General::test_intern();
     General::test_version();
 }
 